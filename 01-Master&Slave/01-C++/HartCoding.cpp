@@ -97,7 +97,7 @@ void CCoding::PutFloat(TY_Float data_, TY_Byte offset_, TY_Byte* data_ref_, EN_E
 
     // Copy the pattern
     // Note: Operationg system has to code as IEEE754
-    *((TY_Float*)&u32) = data_;
+    memcpy(&u32, &data_, sizeof(u32));
 
     // Handle NaN
     if ((u32 & 0x7F800000) == 0x7F800000)
@@ -114,7 +114,7 @@ void CCoding::PutDFloat(TY_DFloat data_, TY_Byte offset_, TY_Byte* data_ref_, EN
     TY_UInt64 u64;
 
     // Copy the pattern
-    *((TY_DFloat*)&u64) = data_;
+    memcpy(&u64, &data_, sizeof(u64));
 
     // Handle NaN
     if ((u64 & 0x7FF0000000000000) == 0x7FF0000000000000)
@@ -337,7 +337,7 @@ TY_Float CCoding::PickFloat(TY_Byte offset_, TY_Byte* data_ref_, EN_Endian endia
 
     // Copy the pattern to the float value
     // Note: Operationg system has to code as IEEE754
-    result = *((TY_Float*)&u32);
+    memcpy(&result, &u32, sizeof(result));
 
     return result;
 }
@@ -359,7 +359,7 @@ TY_DFloat CCoding::PickDouble(TY_Byte offset_, TY_Byte* data_ref_, EN_Endian end
 
     // Copy the pattern to the float value
     // Note: Operationg system has to code as IEEE754
-    result = *((TY_DFloat*)&u64);
+    memcpy(&result, &u64, sizeof(result));
 
     return result;
 }
@@ -426,4 +426,35 @@ void CCoding::PickString(TY_Byte* string_ref_, TY_Byte string_max_len_, TY_Byte
             }
         }
     }
-}
\ No newline at end of file
+}
+
+// Frames
+TY_Byte CCoding::CheckSum(const TY_Byte* data_ref_, TY_Word len_)
+{
+    // Longitudinal parity of a byte stream, i.e. the check byte of a
+    // hart frame. The XOR is built over 8 bytes per step, the partial
+    // sum is folded into one byte at the end. The compiler vectorizes
+    // the loop where the target allows it.
+    TY_DWord  pos = 0;
+    TY_UInt64 word;
+    TY_UInt64 sum = 0;
+    TY_Byte   chk = 0;
+
+    for (; (len_ - pos) >= sizeof(word); pos += sizeof(word))
+    {
+        memcpy(&word, data_ref_ + pos, sizeof(word));
+        sum ^= word;
+    }
+
+    sum ^= sum >> 32;
+    sum ^= sum >> 16;
+    sum ^= sum >> 8;
+    chk = (TY_Byte)sum;
+
+    for (; pos < len_; pos++)
+    {
+        chk ^= data_ref_[pos];
+    }
+
+    return chk;
+}
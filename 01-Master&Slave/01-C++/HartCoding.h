@@ -41,5 +41,8 @@ public:
     static void      PickPackedASCII(TY_Byte* string_ref_, TY_Byte string_max_len_, TY_Byte offset_, TY_Byte* data_ref_);
     static void           PickOctets(TY_Byte* stream_ref_, TY_Byte stream_len_, TY_Byte offset_, TY_Byte* data_ref_);
     static void           PickString(TY_Byte* string_ref_, TY_Byte string_max_len_, TY_Byte offset_, TY_Byte* data_ref_);
+
+    // Frames
+    static TY_Byte          CheckSum(const TY_Byte* data_ref_, TY_Word len_);
 };
 #endif // #ifndef __ccoding_h__
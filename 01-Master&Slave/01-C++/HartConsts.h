@@ -56,6 +56,7 @@ public:
     public:
         static const TY_Byte UNIQUE_ADDR = 0x80;
         static const TY_Byte PRIM_MASTER = 0x80;
+        static const TY_Byte  BURST_MODE = 0x40;
         static const TY_Byte EXT_CMD_FLAG = 31;
     };
 
@@ -15,8 +15,10 @@
  * Copyright 2006-2025 Walter Borst, Cuxhaven, Germany
  */
 
+#include <string.h>
 #include "HartFrame.h"
 #include "HartConsts.h"
+#include "HartCoding.h"
 
 // Initialization/Construction
 CFrame::CFrame()
@@ -48,10 +50,7 @@ CFrame::CFrame()
     m_actual_chk = 0;
     m_start_time = 0;
     m_end_time = 0;
-    COSAL::CMem::Set(m_short_tag, 0, 6);
-    COSAL::CMem::Set(m_long_tag, 0, 24);
-    COSAL::CMem::Set(m_req_primitive, 0, MAX_TXRX_SIZE);
-    m_req_prim_len = 0;
+    m_tx_buffer = NULL;
     m_burst_frame = EN_Bool::FALSE8;
     m_burst_mode = EN_Bool::FALSE8;
     m_rcv_byte_count = 0;
@@ -110,10 +109,12 @@ CFrame& CFrame::operator=(const CFrame& other_)
         m_actual_chk = other_.m_actual_chk;
         m_start_time = other_.m_start_time;
         m_end_time = other_.m_end_time;
-        COSAL::CMem::Copy(m_short_tag, other_.m_short_tag, 6);
-        COSAL::CMem::Copy(m_long_tag, other_.m_long_tag, 24);
-        m_req_prim_len = other_.m_req_prim_len;
-        COSAL::CMem::Copy(m_req_primitive, other_.m_req_primitive, m_req_prim_len);
+        // The buffers stay with their owners, only the content is copied
+        if ((m_tx_buffer != NULL) && (other_.m_tx_buffer != NULL))
+        {
+            m_tx_buffer->Len = other_.m_tx_buffer->Len;
+            COSAL::CMem::Copy(m_tx_buffer->Bytes, other_.m_tx_buffer->Bytes, m_tx_buffer->Len);
+        }
         m_burst_frame = other_.m_burst_frame;
         m_burst_mode = other_.m_burst_mode;
         m_rcv_byte_count = other_.m_rcv_byte_count;
@@ -173,6 +174,14 @@ EN_Bool CFrame::TryParse(TY_Word* bytes_parsed_, TY_Byte* new_data_, TY_Byte* ne
     //COSAL::CMem::Set(test, 0 , 256);
     //COSAL::CMem::Copy(test, new_data_, new_data_len_ );
 
+    // A frame which is contained completely in the new data is
+    // decoded in one go. Everything else, e.g. a frame arriving
+    // byte by byte on the uart, is left to the state machine.
+    if ((Status == EN_Status::PARSE_PREAMBLE) && (m_rcv_byte_count == 0))
+    {
+        bytes_parsed = ParseBlock(new_data_, new_data_len_);
+    }
+
     while ((bytes_parsed < new_data_len_) &&
         (Status != EN_Status::FRAME_COMPLETED) &&
         (Status != EN_Status::INVALID_FRAME) &&
@@ -453,10 +462,19 @@ EN_Bool CFrame::ParseByte(TY_Byte new_byte_, TY_Byte new_err_, EN_Bool gap_time_
 
 void CFrame::SetRequestPrimitive(TY_Byte* data_, TY_Word len_)
 {
-    if (len_ > 0)
+    if ((m_tx_buffer != NULL) && (len_ > 0) && (len_ <= MAX_TXRX_SIZE))
+    {
+        COSAL::CMem::Copy(m_tx_buffer->Bytes, data_, len_);
+        m_tx_buffer->Len = len_;
+    }
+}
+
+void CFrame::AttachTxBuffer(ST_TxBuffer* tx_buffer_)
+{
+    m_tx_buffer = tx_buffer_;
+    if (m_tx_buffer != NULL)
     {
-        COSAL::CMem::Copy(m_req_primitive, data_, len_);
-        m_req_prim_len = len_;
+        m_tx_buffer->Len = 0;
     }
 }
 
@@ -480,16 +498,6 @@ void CFrame::SetPollAddr(TY_Byte poll_addr_)
     m_address[0] = poll_addr_;
 }
 
-void CFrame::SetShortTag(TY_Byte* short_tag_)
-{
-    COSAL::CMem::Copy(m_short_tag, short_tag_, 6);
-}
-
-void CFrame::SetLongTag(TY_Byte* long_tag_)
-{
-    COSAL::CMem::Copy(m_long_tag, long_tag_, 24);
-}
-
 void CFrame::SetBurstFrame(EN_Bool burst_frame_)
 {
     m_burst_frame = burst_frame_;
@@ -503,12 +511,12 @@ void CFrame::SetLocalMaster(EN_Bool primary_master_)
 // Getting Frame data
 TY_Byte* CFrame::GetTxData(TY_Word* len_)
 {
-    if (m_req_primitive != NULL)
+    if (m_tx_buffer != NULL)
     {
-        if (m_req_prim_len > 0)
+        if (m_tx_buffer->Len > 0)
         {
-            *len_ = m_req_prim_len;
-            return m_req_primitive;
+            *len_ = m_tx_buffer->Len;
+            return m_tx_buffer->Bytes;
         }
     }
     return NULL;
@@ -519,16 +527,6 @@ TY_Byte CFrame::GetShortAddr()
     return m_address[0];
 }
 
-void CFrame::GetShortTag(TY_Byte* short_tag_)
-{
-    COSAL::CMem::Copy(short_tag_, m_short_tag, 6);
-}
-
-void CFrame::GetLongTag(TY_Byte* long_tag_)
-{
-    COSAL::CMem::Copy(long_tag_, m_long_tag, 24);
-}
-
 EN_Bool CFrame::GetBurstFrame()
 {
     return m_burst_frame;
@@ -539,6 +537,11 @@ EN_Bool CFrame::GetLocalMaster()
     return m_local_master;
 }
 
+EN_Bool CFrame::GetRemoteMaster()
+{
+    return m_remote_master;
+}
+
 CFrame::EN_Status CFrame::GetStatus()
 {
     return Status;
@@ -805,6 +808,12 @@ CFrame::EN_Status CFrame::ParseDataLen(TY_Byte data_, TY_Byte error_)
     if (m_delimiter == CHart::CDelimiter::STX)
     {
         PayloadSize = data_;
+        if (PayloadSize > MAX_PAYLOAD_SIZE)
+        {
+            // Would not fit into the payload buffer
+            return EN_Status::INVALID_FRAME;
+        }
+
         if (PayloadSize > 0)
         {
             return EN_Status::PARSE_PAYLOAD;
@@ -816,7 +825,7 @@ CFrame::EN_Status CFrame::ParseDataLen(TY_Byte data_, TY_Byte error_)
     }
     else
     {
-        if (data_ >= 2)
+        if ((data_ >= 2) && ((data_ - 2) <= MAX_PAYLOAD_SIZE))
         {
             PayloadSize = data_ - 2;
             return EN_Status::PARSE_RESP1;
@@ -890,6 +899,179 @@ CFrame::EN_Status CFrame::ParsingGarbage(TY_Byte data_, TY_Byte error_)
     return EN_Status::PARSING_GARBAGE;
 }
 
+// Block parsing
+TY_Word CFrame::ParseBlock(TY_Byte* data_, TY_Word len_)
+{
+    // Returns the number of bytes used or 0 if the frame has to
+    // be parsed by the state machine. The result is the same as
+    // if the state machine would have been used.
+    TY_Word  pos = 0;
+    TY_Word  num_preambles = 0;
+    TY_Word  start = 0;
+    TY_Word  end = 0;
+    TY_Byte  delimiter = 0;
+    TY_Byte  num_exp_bytes = 0;
+    TY_Byte  addr_len = 1;
+    TY_Word  data_len = 0;
+    TY_Word  payload_size = 0;
+
+    if (NoPreamb == EN_Bool::TRUE8)
+    {
+        if ((len_ == 0) || (IsDelimiter(data_[0]) == EN_Bool::FALSE8))
+        {
+            return 0;
+        }
+    }
+    else
+    {
+        // Look for at least two preambles followed by a delimiter,
+        // everything before is skipped as by the state machine
+        for (;;)
+        {
+            TY_Byte* found = (TY_Byte*)memchr(data_ + pos, 0xff, len_ - pos);
+
+            if (found == NULL)
+            {
+                return 0;
+            }
+
+            pos = (TY_Word)(found - data_);
+            num_preambles = SkipPreambles(data_ + pos, len_ - pos);
+            pos += num_preambles;
+            if ((pos >= len_) || (num_preambles > CHart::CLimit::MAX_NUM_PREAMBLES))
+            {
+                return 0;
+            }
+
+            if ((num_preambles >= 2) && (IsDelimiter(data_[pos]) == EN_Bool::TRUE8))
+            {
+                break;
+            }
+
+            // The byte following the preambles is dropped
+            pos++;
+        }
+    }
+
+    // Header: delimiter, address, expansion bytes, command, byte count
+    start = pos;
+    delimiter = data_[start];
+    num_exp_bytes = (TY_Byte)((delimiter & CHart::CMask::NUM_EXP_BYTES) >> 5);
+    if (IsLongAddress(delimiter) == EN_Bool::TRUE8)
+    {
+        addr_len = CHart::CSize::NUM_ADDR_BYTES;
+    }
+
+    pos = start + 1 + addr_len + num_exp_bytes + 1;
+    if (pos >= len_)
+    {
+        return 0;
+    }
+
+    data_len = data_[pos];
+    payload_size = data_len;
+    if ((delimiter & CHart::CMask::DELIMITER) != CHart::CDelimiter::STX)
+    {
+        if (data_len < 2)
+        {
+            return 0;
+        }
+        payload_size = data_len - 2;
+    }
+
+    // Payload and checksum
+    end = pos + 1 + data_len + 1;
+    if ((end > len_) || (payload_size > MAX_PAYLOAD_SIZE))
+    {
+        return 0;
+    }
+
+    // The whole frame is there, so take it over
+    m_delimiter = delimiter & CHart::CMask::DELIMITER;
+    m_num_exp_bytes = num_exp_bytes;
+    if (NoPreamb == EN_Bool::FALSE8)
+    {
+        NumPreambles = (TY_Byte)num_preambles;
+    }
+
+    pos = start + 1;
+    if (addr_len == CHart::CSize::NUM_ADDR_BYTES)
+    {
+        AddrMode = CHart::CAddrMode::UNIQUE;
+        COSAL::CMem::Copy(&m_address[1], &data_[pos + 1], CHart::CSize::NUM_ADDR_BYTES - 1);
+    }
+    else
+    {
+        AddrMode = CHart::CAddrMode::POLLING;
+    }
+
+    m_address[0] = data_[pos] & CHart::CMask::HIGH_ADDR;
+    m_remote_master = IsPrimaryMaster(data_[pos]);
+    m_burst_mode = IsBurstModeFlag(data_[pos]);
+    m_addr_byte_count = addr_len;
+    pos += addr_len;
+
+    if (num_exp_bytes > 0)
+    {
+        COSAL::CMem::Copy(m_exp_bytes, &data_[pos], num_exp_bytes);
+        m_exp_bytes_count = num_exp_bytes;
+        pos += num_exp_bytes;
+    }
+
+    Command = data_[pos];
+    pos += 2;
+    if (payload_size != data_len)
+    {
+        m_rsp1 = data_[pos];
+        m_rsp2 = data_[pos + 1];
+        pos += 2;
+    }
+
+    PayloadSize = payload_size;
+    if (payload_size > 0)
+    {
+        COSAL::CMem::Copy(PayloadData, &data_[pos], payload_size);
+        PayloadCount = payload_size;
+    }
+
+    m_target_chk = CCoding::CheckSum(&data_[start], (TY_Word)(end - 1 - start));
+    m_actual_chk = data_[end - 1];
+    if (m_actual_chk == m_target_chk)
+    {
+        Status = EN_Status::FRAME_COMPLETED;
+    }
+    else
+    {
+        Status = EN_Status::CHECKSUM_ERR;
+    }
+
+    return end;
+}
+
+TY_Word CFrame::SkipPreambles(TY_Byte* data_, TY_Word len_)
+{
+    // Compares 8 preambles at once
+    TY_Word   count = 0;
+    TY_UInt64 word;
+
+    while ((TY_DWord)(len_ - count) >= sizeof(word))
+    {
+        memcpy(&word, data_ + count, sizeof(word));
+        if (word != ~(TY_UInt64)0)
+        {
+            break;
+        }
+        count += sizeof(word);
+    }
+
+    while ((count < len_) && (data_[count] == 0xff))
+    {
+        count++;
+    }
+
+    return count;
+}
+
 // Query Functions
 EN_Bool CFrame::IsDelimiter(TY_Byte byte_)
 {
@@ -21,6 +21,15 @@
 #include "OSAL.h"
 #include "WbHartUser.h"
 
+// Octets of an encoded frame. Most frames are only parsed,
+// so the buffer is held by the owner of a frame which is sent
+// and attached to it.
+typedef struct st_TxBuffer
+{
+    TY_Byte       Bytes[MAX_TXRX_SIZE];
+    TY_Word         Len;
+} ST_TxBuffer;
+
 class CFrame
 {
 public:
@@ -91,14 +100,13 @@ public:
     static void        ParseData(CFrame* frame_);
     EN_Bool            ParseByte(TY_Byte new_byte_, TY_Byte new_err_, EN_Bool gap_time_out_);
     void     SetRequestPrimitive(TY_Byte* data_, TY_Word len_);
+    void          AttachTxBuffer(ST_TxBuffer* tx_buffer_);
     void                  Encode();
 
     // Setting Frame Data
     void                 SetData(TY_Byte* data_, TY_Word len_);
     void           SetUniqueAddr(TY_Byte* bytes_of_unique_id_);
     void             SetPollAddr(TY_Byte short_addr_);
-    void             SetShortTag(TY_Byte* short_tag_);
-    void              SetLongTag(TY_Byte* long_tag_);
     void           SetBurstFrame(EN_Bool burst_frame_);
     void          SetLocalMaster(EN_Bool primary_master_);
 
@@ -110,8 +118,6 @@ public:
     void        GetOtherUniqueID(TY_Byte* bytes_of_unique_id_);
     TY_Byte         GetShortAddr();
     EN_Bool      GetRemoteMaster();
-    void             GetShortTag(TY_Byte* short_tag_);
-    void              GetLongTag(TY_Byte* long_tag_);
     EN_Bool        GetBurstFrame();
     EN_Bool          GetAnyFrame();
     EN_Bool       GetLocalMaster();
@@ -158,6 +164,10 @@ private:
     EN_Status        ParseCheckSum(TY_Byte data_, TY_Byte error_);
     EN_Status         ParseGarbage(TY_Byte data_, TY_Byte error_);
     EN_Status     ParsingGarbage(TY_Byte data_, TY_Byte error_);
+
+    // Block parsing, for frames which are received completely
+    TY_Word           ParseBlock(TY_Byte* data_, TY_Word len_);
+    static TY_Word  SkipPreambles(TY_Byte* data_, TY_Word len_);
     
     // Query Functions
     static EN_Bool     IsDelimiter(TY_Byte byte_);
@@ -176,7 +186,7 @@ private:
     // Control
     EN_Status Status;
 
-    // Frame info
+    // Frame info, used by the parser
     TY_Byte   m_delimiter;
     TY_Byte   m_address[5];
     TY_Byte   m_addr_byte_count;
@@ -189,12 +199,6 @@ private:
     TY_Byte   m_rsp2;
     TY_Byte   m_target_chk;
     TY_Byte   m_actual_chk;
-    TY_DWord  m_start_time;
-    TY_DWord  m_end_time;
-    TY_Byte   m_short_tag[6];
-    TY_Byte   m_long_tag[24];
-    TY_Byte   m_req_primitive[MAX_TXRX_SIZE];
-    TY_Word   m_req_prim_len;
     EN_Bool   m_burst_frame;
     EN_Bool   m_burst_mode;
     TY_Word   m_rcv_byte_count;
@@ -202,6 +206,11 @@ private:
     TY_Byte   m_jab_octet;
     EN_Bool   m_jab_octet_flag;
     EN_Bool   m_active;
+    TY_DWord  m_start_time;
+    TY_DWord  m_end_time;
+
+    // Encoding, not owned by the frame
+    ST_TxBuffer* m_tx_buffer;
 };
 
 #endif // __hartframe_h__
\ No newline at end of file
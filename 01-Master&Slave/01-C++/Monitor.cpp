@@ -20,17 +20,22 @@
 #include "WbHartUser.h"
 #include "Monitor.h"
 
-// Data
-
-EN_Bool                             CMonitor::m_is_monitor_active;
-TY_Word                             CMonitor::m_wr_idx;
-TY_Word                             CMonitor::m_rd_idx;
-TY_MonFrame                         CMonitor::m_mon_frames[MON_MAX_NUM_FRAMES];
-TY_Byte                             CMonitor::m_additional_data[MAX_IP_TXRX_SIZE];
-TY_Word                             CMonitor::m_additional_data_len = 0;
+// The free running positions are indexed by a mask
+static_assert((MON_LOG_SIZE & (MON_LOG_SIZE - 1)) == 0, "MON_LOG_SIZE must be a power of two");
 
 // Methods
 
+CMonitor::CMonitor()
+{
+    m_is_monitor_active = EN_Bool::FALSE8;
+    m_wr_pos.store(0, std::memory_order_relaxed);
+    m_rd_pos.store(0, std::memory_order_relaxed);
+    m_num_dropped.store(0, std::memory_order_relaxed);
+    COSAL::CMem::Set((TY_Byte*)&m_active_frame, 0, sizeof(m_active_frame));
+    COSAL::CMem::Set(m_additional_data, 0, sizeof(m_additional_data));
+    m_additional_data_len = 0;
+}
+
 void CMonitor::Init()
 {
     ResetReceive();
@@ -52,26 +57,48 @@ void CMonitor::Stop()
 
 EN_Bool CMonitor::GetData(TY_MonFrame* mon_frame_)
 {
-    TY_MonFrame* active_frame = &m_mon_frames[m_rd_idx];
-
-    if (m_rd_idx != m_wr_idx)
+    if (GetData(mon_frame_, 1) > 0)
     {
-        if (active_frame->IsReceiveReady == EN_Bool::TRUE8)
-        {
-            *mon_frame_ = *active_frame;
-            COSAL::CMem::Set((TY_Byte*)active_frame, 0, sizeof(TY_MonFrame));
-            m_rd_idx += 1;
-            if (m_rd_idx > MON_MAX_NUM_FRAMES)
-            {
-                m_rd_idx = 0;
-            }
-            return EN_Bool::TRUE8;
-        }
+        return EN_Bool::TRUE8;
     }
 
     return EN_Bool::FALSE8;
 }
 
+TY_Word CMonitor::GetData(TY_MonFrame* mon_frames_, TY_Word max_frames_)
+{
+    // Note: Called by the reader only
+    TY_DWord rd_pos = m_rd_pos.load(std::memory_order_relaxed);
+    // Acquire: The records up to the write position are complete
+    TY_DWord wr_pos = m_wr_pos.load(std::memory_order_acquire);
+    TY_Word  num_frames = 0;
+
+    while ((rd_pos != wr_pos) && (num_frames < max_frames_))
+    {
+        TY_MonFrame* mon_frame = &mon_frames_[num_frames++];
+        ST_Record    record;
+
+        ReadLog(rd_pos, (TY_Byte*)&record, sizeof(ST_Record));
+        mon_frame->StartTime = record.StartTime;
+        mon_frame->EndTime = record.EndTime;
+        mon_frame->Len = record.Len;
+        mon_frame->IsFrameStarted = EN_Bool::TRUE8;
+        mon_frame->Detail = record.Detail;
+        mon_frame->IsValidFrame = record.IsValidFrame;
+        mon_frame->IsReceiveReady = EN_Bool::TRUE8;
+        ReadLog(rd_pos + sizeof(ST_Record), mon_frame->BytesOfData, record.Len);
+        rd_pos += sizeof(ST_Record) + record.Len;
+    }
+
+    if (num_frames > 0)
+    {
+        // Release: The writer may reuse the records
+        m_rd_pos.store(rd_pos, std::memory_order_release);
+    }
+
+    return num_frames;
+}
+
 EN_Bit CMonitor::GetStatus()
 {
     if (m_is_monitor_active == EN_Bool::TRUE8)
@@ -82,6 +109,11 @@ EN_Bit CMonitor::GetStatus()
     return EN_Bit::CLEAR8;
 }
 
+TY_DWord CMonitor::GetNumDropped()
+{
+    return m_num_dropped.load(std::memory_order_relaxed);
+}
+
 EN_Bool CMonitor::IsActive()
 {
     if (m_is_monitor_active == EN_Bool::TRUE8)
@@ -94,35 +126,32 @@ EN_Bool CMonitor::IsActive()
 
 void CMonitor::StartReceive(TY_DWord start_time_)
 {
-        TY_MonFrame* active_frame = &m_mon_frames[m_wr_idx];
-
-        COSAL::CMem::Set((TY_Byte*)active_frame, 0, sizeof(TY_MonFrame));
-        active_frame->StartTime = start_time_;
-        active_frame->IsFrameStarted = EN_Bool::TRUE8;
+    // The octets need no clearing, Len tells how many are valid
+    m_active_frame.StartTime = start_time_;
+    m_active_frame.EndTime = 0;
+    m_active_frame.Len = 0;
+    m_active_frame.IsFrameStarted = EN_Bool::TRUE8;
+    m_active_frame.Detail = 0;
+    m_active_frame.IsValidFrame = EN_Bool::FALSE8;
+    m_active_frame.IsReceiveReady = EN_Bool::FALSE8;
 }
 
 void CMonitor::StartTransmit(TY_DWord start_time_)
 {
-    TY_MonFrame* active_frame = &m_mon_frames[m_wr_idx];
-
-    COSAL::CMem::Set((TY_Byte*)active_frame, 0, sizeof(TY_MonFrame));
-    active_frame->StartTime = start_time_;
-    active_frame->IsFrameStarted = EN_Bool::TRUE8;
-    active_frame->Detail |= CDetail::CLIENT_TX;
+    StartReceive(start_time_);
+    m_active_frame.Detail |= CDetail::CLIENT_TX;
 }
 
 void CMonitor::StoreData(TY_Byte* pu8_Data, TY_Word len_)
 {
     if (len_ > 0)
     {
-        TY_MonFrame* active_frame = &m_mon_frames[m_wr_idx];
-
-        if (active_frame->IsFrameStarted == EN_Bool::TRUE8)
+        if (m_active_frame.IsFrameStarted == EN_Bool::TRUE8)
         {
-            if ((active_frame->Len + len_) <= MON_MAX_FRAME_DATA_SIZE)
+            if ((m_active_frame.Len + len_) <= MON_MAX_FRAME_DATA_SIZE)
             {
-                COSAL::CMem::Copy(&active_frame->BytesOfData[active_frame->Len], pu8_Data, len_);
-                active_frame->Len += len_;
+                COSAL::CMem::Copy(&m_active_frame.BytesOfData[m_active_frame.Len], pu8_Data, len_);
+                m_active_frame.Len += len_;
             }
         }
     }
@@ -132,13 +161,11 @@ void CMonitor::RemoveData(TY_Word len_)
 {
     if (len_ > 0)
     {
-        TY_MonFrame* active_frame = &m_mon_frames[m_wr_idx];
-
-        if (active_frame->IsFrameStarted == EN_Bool::TRUE8)
+        if (m_active_frame.IsFrameStarted == EN_Bool::TRUE8)
         {
-            if (active_frame->Len >= len_)
+            if (m_active_frame.Len >= len_)
             {
-                active_frame->Len -= len_;
+                m_active_frame.Len -= len_;
             }
         }
     }
@@ -146,81 +173,59 @@ void CMonitor::RemoveData(TY_Word len_)
 
 void CMonitor::AbortReceive()
 {
-    TY_MonFrame* active_frame = &m_mon_frames[m_wr_idx];
-
-    active_frame->StartTime = 0;
-    active_frame->EndTime = 0;
-    active_frame->Len = 0;
-    active_frame->IsFrameStarted = EN_Bool::FALSE8;
-    active_frame->Detail = 0;
-    active_frame->IsValidFrame = EN_Bool::FALSE8;
-    active_frame->IsReceiveReady = EN_Bool::FALSE8;
+    m_active_frame.StartTime = 0;
+    m_active_frame.EndTime = 0;
+    m_active_frame.Len = 0;
+    m_active_frame.IsFrameStarted = EN_Bool::FALSE8;
+    m_active_frame.Detail = 0;
+    m_active_frame.IsValidFrame = EN_Bool::FALSE8;
+    m_active_frame.IsReceiveReady = EN_Bool::FALSE8;
 }
 
 void CMonitor::EndTransmit(TY_DWord EndTime)
 {
-    TY_MonFrame* active_frame = &m_mon_frames[m_wr_idx];
-
-    if (active_frame->IsFrameStarted == EN_Bool::TRUE8)
+    if (m_active_frame.IsFrameStarted == EN_Bool::TRUE8)
     {
-        active_frame->EndTime = EndTime;
-        m_wr_idx += 1;
-        if (m_wr_idx >= MON_MAX_NUM_FRAMES)
-        {
-            m_wr_idx = 0;
-        }
-        active_frame->IsValidFrame = EN_Bool::TRUE8;
-        active_frame->IsReceiveReady = EN_Bool::TRUE8;
+        m_active_frame.EndTime = EndTime;
+        m_active_frame.IsValidFrame = EN_Bool::TRUE8;
+        m_active_frame.IsReceiveReady = EN_Bool::TRUE8;
+        PublishFrame();
     }
 }
 
 void CMonitor::EndRcvValidFrame(TY_DWord u32_LastRcvEvtTime)
 {
-    TY_MonFrame* active_frame = &m_mon_frames[m_wr_idx];
-
-    if (active_frame->IsFrameStarted == EN_Bool::TRUE8)
+    if (m_active_frame.IsFrameStarted == EN_Bool::TRUE8)
     {
-        active_frame->EndTime = u32_LastRcvEvtTime;
-        m_wr_idx += 1;
-        if (m_wr_idx >= MON_MAX_NUM_FRAMES)
-        {
-            m_wr_idx = 0;
-        }
-        active_frame->IsValidFrame = EN_Bool::TRUE8;
-        active_frame->IsReceiveReady = EN_Bool::TRUE8;
+        m_active_frame.EndTime = u32_LastRcvEvtTime;
+        m_active_frame.IsValidFrame = EN_Bool::TRUE8;
+        m_active_frame.IsReceiveReady = EN_Bool::TRUE8;
+        PublishFrame();
     }
 }
 
 void CMonitor::EndRcvGapTO(TY_DWord last_rcv_evt_time_)
 {
-    TY_MonFrame* active_frame = &m_mon_frames[m_wr_idx];
-
-    if (active_frame->IsFrameStarted == EN_Bool::TRUE8)
+    if (m_active_frame.IsFrameStarted == EN_Bool::TRUE8)
     {
-        if ((active_frame->IsValidFrame == EN_Bool::TRUE8) || (active_frame->IsReceiveReady == EN_Bool::TRUE8))
+        if ((m_active_frame.IsValidFrame == EN_Bool::TRUE8) || (m_active_frame.IsReceiveReady == EN_Bool::TRUE8))
         {
             // GAP Failed
             return;
         }
 
-        active_frame->EndTime = last_rcv_evt_time_;
-        m_wr_idx += 1;
-        if (m_wr_idx >= MON_MAX_NUM_FRAMES)
-        {
-            m_wr_idx = 0;
-        }
-        active_frame->Detail |= CDetail::GAP_TO;
-        active_frame->IsReceiveReady = EN_Bool::TRUE8;
+        m_active_frame.EndTime = last_rcv_evt_time_;
+        m_active_frame.Detail |= CDetail::GAP_TO;
+        m_active_frame.IsReceiveReady = EN_Bool::TRUE8;
+        PublishFrame();
     }
 }
 
 TY_DWord CMonitor::GetStartTime()
 {
-    TY_MonFrame* active_frame = &m_mon_frames[m_wr_idx];
-
-    if (active_frame->IsFrameStarted == EN_Bool::TRUE8)
+    if (m_active_frame.IsFrameStarted == EN_Bool::TRUE8)
     {
-        return active_frame->StartTime;
+        return m_active_frame.StartTime;
     }
 
     return 0;
@@ -228,11 +233,9 @@ TY_DWord CMonitor::GetStartTime()
 
 TY_Word CMonitor::GetDataLen()
 {
-    TY_MonFrame* active_frame = &m_mon_frames[m_wr_idx];
-
-    if (active_frame->IsFrameStarted == EN_Bool::TRUE8)
+    if (m_active_frame.IsFrameStarted == EN_Bool::TRUE8)
     {
-        return active_frame->Len;
+        return m_active_frame.Len;
     }
 
     return 0;
@@ -240,9 +243,11 @@ TY_Word CMonitor::GetDataLen()
 
 void CMonitor::ResetReceive()
 {
-    m_rd_idx = 0;
-    m_wr_idx = 0;
-    COSAL::CMem::Set((TY_Byte*)&m_mon_frames[0], 0, sizeof(m_mon_frames));
+    // Note: Called by the reader only. The frames not read yet are
+    // skipped, the write position and the frame under construction
+    // belong to the kernel.
+    m_rd_pos.store(m_wr_pos.load(std::memory_order_acquire), std::memory_order_release);
+    m_num_dropped.store(0, std::memory_order_relaxed);
 }
 
 TY_Word CMonitor::GetPayloadData(TY_Byte* data_)
@@ -256,3 +261,56 @@ void CMonitor::SetAdditionalData(TY_Byte* data_, TY_Word data_len_)
     COSAL::CMem::Copy(m_additional_data, data_, data_len_);
     m_additional_data_len = data_len_;
 }
+
+// Helpers
+void CMonitor::PublishFrame()
+{
+    TY_DWord wr_pos = m_wr_pos.load(std::memory_order_relaxed);
+    TY_DWord record_len = sizeof(ST_Record) + m_active_frame.Len;
+    ST_Record record;
+
+    // The positions run freely, their difference is the used part of the log
+    if ((wr_pos - m_rd_pos.load(std::memory_order_acquire)) > (MON_LOG_SIZE - record_len))
+    {
+        // The log is full, the frame is dropped
+        m_active_frame.IsFrameStarted = EN_Bool::FALSE8;
+        m_num_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    record.Len = m_active_frame.Len;
+    record.StartTime = m_active_frame.StartTime;
+    record.EndTime = m_active_frame.EndTime;
+    record.Detail = m_active_frame.Detail;
+    record.IsValidFrame = m_active_frame.IsValidFrame;
+    WriteLog(wr_pos, (TY_Byte*)&record, sizeof(ST_Record));
+    WriteLog(wr_pos + sizeof(ST_Record), m_active_frame.BytesOfData, m_active_frame.Len);
+    m_active_frame.IsFrameStarted = EN_Bool::FALSE8;
+    // Release: The record is complete before the reader sees it
+    m_wr_pos.store(wr_pos + record_len, std::memory_order_release);
+}
+
+void CMonitor::WriteLog(TY_DWord pos_, const TY_Byte* data_, TY_DWord len_)
+{
+    TY_DWord offset = pos_ & (MON_LOG_SIZE - 1);
+    TY_DWord first_len = ((MON_LOG_SIZE - offset) < len_) ? (MON_LOG_SIZE - offset) : len_;
+
+    // A record may wrap at the end of the log
+    COSAL::CMem::Copy(&m_log[offset], data_, first_len);
+    if (first_len < len_)
+    {
+        COSAL::CMem::Copy(m_log, &data_[first_len], len_ - first_len);
+    }
+}
+
+void CMonitor::ReadLog(TY_DWord pos_, TY_Byte* data_, TY_DWord len_)
+{
+    TY_DWord offset = pos_ & (MON_LOG_SIZE - 1);
+    TY_DWord first_len = ((MON_LOG_SIZE - offset) < len_) ? (MON_LOG_SIZE - offset) : len_;
+
+    COSAL::CMem::Copy(data_, &m_log[offset], first_len);
+    if (first_len < len_)
+    {
+        COSAL::CMem::Copy(&data_[first_len], m_log, len_ - first_len);
+    }
+}
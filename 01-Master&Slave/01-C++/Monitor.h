@@ -18,6 +18,8 @@
 #ifndef __monitor_h__
 #define __monitor_h__
 
+#include <atomic>
+
 // Data used for the monitor function
 #pragma pack(push, 1)
 typedef struct ty_mon_frame
@@ -46,38 +48,71 @@ public:
         static const TY_Byte CLIENT_TX = 0x02;
     };
 
+    // Construction
+              CMonitor();
     // Support of external functions
-    static void          Init();
-    static void     Terminate();
-    static void         Start();
-    static void          Stop();
-    static EN_Bool    GetData(TY_MonFrame* mon_frame_);
-    static EN_Bit   GetStatus();
+    void          Init();
+    void     Terminate();
+    void         Start();
+    void          Stop();
+    EN_Bool    GetData(TY_MonFrame* mon_frame_);
+    // Fetches up to max_frames_ frames, returns the number of frames.
+    // BytesOfData is filled up to Len only.
+    TY_Word    GetData(TY_MonFrame* mon_frames_, TY_Word max_frames_);
+    EN_Bit   GetStatus();
+    // Frames which were lost as the reader did not keep up
+    TY_DWord GetNumDropped();
 
     // Operation
-    static EN_Bool            IsActive();
-    static void           StartReceive(TY_DWord start_time_);
-    static void          StartTransmit(TY_DWord start_time_);
-    static void              StoreData(TY_Byte* data_, TY_Word len_);
-    static void             RemoveData(TY_Word len_);
-    static void            EndTransmit(TY_DWord end_time_);
-    static void       EndRcvValidFrame(TY_DWord last_rcv_evt_time_);
-    static void            EndRcvGapTO(TY_DWord last_rcv_evt_time_);
-    static TY_DWord       GetStartTime();
-    static TY_Word          GetDataLen();
-    static void           AbortReceive();
-    static TY_Word   GetPayloadData(TY_Byte* data_);
-    static void      SetAdditionalData(TY_Byte* data_, TY_Word data_len_);
+    EN_Bool            IsActive();
+    void           StartReceive(TY_DWord start_time_);
+    void          StartTransmit(TY_DWord start_time_);
+    void              StoreData(TY_Byte* data_, TY_Word len_);
+    void             RemoveData(TY_Word len_);
+    void            EndTransmit(TY_DWord end_time_);
+    void       EndRcvValidFrame(TY_DWord last_rcv_evt_time_);
+    void            EndRcvGapTO(TY_DWord last_rcv_evt_time_);
+    TY_DWord       GetStartTime();
+    TY_Word          GetDataLen();
+    void           AbortReceive();
+    TY_Word   GetPayloadData(TY_Byte* data_);
+    void      SetAdditionalData(TY_Byte* data_, TY_Word data_len_);
+
+    // Management, by the reader: The frames not read yet are skipped
+    void     ResetReceive();
+
+private:
+    // Header of a frame in the log, the octets of the frame follow
+#pragma pack(push, 1)
+    typedef struct st_Record
+    {
+        TY_Word             Len;
+        TY_DWord      StartTime;
+        TY_DWord        EndTime;
+        TY_Byte          Detail;
+        EN_Bool    IsValidFrame;
+    } ST_Record;
+#pragma pack(pop)
 
-    // Management
-    static void     ResetReceive();
+    void             PublishFrame();
+    void                 WriteLog(TY_DWord pos_, const TY_Byte* data_, TY_DWord len_);
+    void                  ReadLog(TY_DWord pos_, TY_Byte* data_, TY_DWord len_);
 
     /* Data */
-    static EN_Bool     m_is_monitor_active;
-    static TY_Word     m_wr_idx;
-    static TY_Word     m_rd_idx;
-    static TY_MonFrame m_mon_frames[MON_MAX_NUM_FRAMES];
-    static TY_Byte     m_additional_data[MAX_IP_TXRX_SIZE];
-    static TY_Word     m_additional_data_len;
+    EN_Bool                 m_is_monitor_active;
+    // The frame under construction by the kernel, only the header
+    // is reset for a new frame
+    TY_MonFrame             m_active_frame;
+    // The frames are a byte log with a single writer (the kernel) and a
+    // single reader (the application). Each frame takes a record header
+    // and its octets only. The positions run freely, the log is indexed
+    // modulo its size. A full log drops the new frame and leaves the
+    // ones not yet read untouched.
+    alignas(64) std::atomic<TY_DWord> m_wr_pos;
+    std::atomic<TY_DWord>   m_num_dropped;
+    alignas(64) std::atomic<TY_DWord> m_rd_pos;
+    alignas(64) TY_Byte     m_log[MON_LOG_SIZE];
+    TY_Byte                 m_additional_data[MAX_IP_TXRX_SIZE];
+    TY_Word                 m_additional_data_len;
 };
 #endif // __monitor_h__
\ No newline at end of file
@@ -0,0 +1,307 @@
+/*
+ *          File: MonitorCapture.cpp (CMonitorCapture)
+ *                The blocks are written in the byte order of the host,
+ *                which is marked by the section header. The timestamps
+ *                are milliseconds since 1970, the monitor times are
+ *                mapped to the wall clock when the capture is opened.
+ *
+ *        Author: Walter Borst
+ *
+ *        E-Mail: info@borst-automation.de
+ *          Home: https://www.borst-automation.de
+ *
+ * No Warranties: https://www.borst-automation.com/legal/warranty-disclaimer
+ *
+ * Copyright 2006-2025 Walter Borst, Cuxhaven, Germany
+ */
+
+#include <chrono>
+#include <string.h>
+#include "MonitorCapture.h"
+
+// Methods
+
+CMonitorCapture::CMonitorCapture()
+{
+    mp_file = NULL;
+    m_file_name[0] = 0;
+    m_is_rotating = EN_Bool::FALSE8;
+    m_max_file_size = 0;
+    m_max_file_time = 0;
+    m_file_size = 0;
+    m_file_start = 0;
+    m_num_files = 0;
+    m_num_frames = 0;
+    m_wall_ref = 0;
+    m_kernel_ref = 0;
+}
+
+CMonitorCapture::~CMonitorCapture()
+{
+    Close();
+}
+
+EN_Bool CMonitorCapture::Open(const TY_Char* file_name_, TY_DWord max_file_size_, TY_DWord max_file_time_)
+{
+    size_t len = strlen(file_name_);
+
+    Close();
+    // Room for the sequence number of a rotated file
+    if ((len == 0) || ((len + 8) >= MAX_FILE_NAME_LEN))
+    {
+        return EN_Bool::FALSE8;
+    }
+
+    COSAL::CMem::Copy((TY_Byte*)m_file_name, (const TY_Byte*)file_name_, (TY_DWord)len + 1);
+    m_max_file_size = max_file_size_;
+    m_max_file_time = max_file_time_;
+    m_is_rotating = ((max_file_size_ > 0) || (max_file_time_ > 0)) ? EN_Bool::TRUE8 : EN_Bool::FALSE8;
+    m_num_files = 0;
+    m_num_frames = 0;
+    m_wall_ref = (TY_UInt64)std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    m_kernel_ref = COSAL::CTimer::GetTime();
+    m_file_start = m_wall_ref;
+    return OpenFile();
+}
+
+void CMonitorCapture::Close()
+{
+    CloseFile();
+}
+
+EN_Bool CMonitorCapture::IsOpen()
+{
+    return (mp_file != NULL) ? EN_Bool::TRUE8 : EN_Bool::FALSE8;
+}
+
+EN_Bool CMonitorCapture::Write(TY_MonFrame* frame_)
+{
+    TY_UInt64 timestamp;
+    TY_DWord  flags;
+    TY_DWord  len = 0;
+    TY_Word   data_len = frame_->Len;
+    TY_Word   pad_len;
+
+    if (mp_file == NULL)
+    {
+        return EN_Bool::FALSE8;
+    }
+
+    if (data_len > MON_MAX_FRAME_DATA_SIZE)
+    {
+        data_len = MON_MAX_FRAME_DATA_SIZE;
+    }
+
+    pad_len = (TY_Word)((4 - (data_len & 3)) & 3);
+    timestamp = GetTimestamp(frame_->StartTime);
+    if (m_is_rotating == EN_Bool::TRUE8)
+    {
+        TY_DWord record_len = 44 + data_len + pad_len;
+
+        // A frame out of order may be older than the file
+        if (((m_max_file_size > 0) && ((m_file_size + record_len) > m_max_file_size)) ||
+            ((m_max_file_time > 0) && (timestamp > m_file_start) &&
+             ((timestamp - m_file_start) >= ((TY_UInt64)m_max_file_time * 1000))))
+        {
+            CloseFile();
+            m_file_start = timestamp;
+            if (OpenFile() == EN_Bool::FALSE8)
+            {
+                return EN_Bool::FALSE8;
+            }
+        }
+    }
+
+    flags = ((frame_->Detail & CMonitor::CDetail::CLIENT_TX) != 0) ? CFlags::OUTBOUND : CFlags::INBOUND;
+    if ((frame_->Detail & CMonitor::CDetail::GAP_TO) != 0)
+    {
+        flags |= CFlags::GAP_ERR;
+    }
+
+    // Enhanced packet block
+    len += PutDWord(&m_record[len], CBlock::ENHANCED_PACKET);
+    len += PutDWord(&m_record[len], 0);
+    len += PutDWord(&m_record[len], 0);
+    len += PutDWord(&m_record[len], (TY_DWord)(timestamp >> 32));
+    len += PutDWord(&m_record[len], (TY_DWord)timestamp);
+    len += PutDWord(&m_record[len], data_len);
+    len += PutDWord(&m_record[len], data_len);
+    COSAL::CMem::Copy(&m_record[len], frame_->BytesOfData, data_len);
+    len += data_len;
+    COSAL::CMem::Set(&m_record[len], 0, pad_len);
+    len += pad_len;
+    len += PutWord(&m_record[len], COption::EPB_FLAGS);
+    len += PutWord(&m_record[len], 4);
+    len += PutDWord(&m_record[len], flags);
+    len += PutWord(&m_record[len], COption::END_OF_OPT);
+    len += PutWord(&m_record[len], 0);
+    len += PutDWord(&m_record[len], len + 4);
+    PutDWord(&m_record[4], len);
+
+    if (WriteRecord(m_record, len) == EN_Bool::FALSE8)
+    {
+        return EN_Bool::FALSE8;
+    }
+
+    m_num_frames++;
+    return EN_Bool::TRUE8;
+}
+
+TY_DWord CMonitorCapture::Serve(CMonitor* monitor_)
+{
+    TY_DWord num_written = 0;
+    TY_Word  num_frames;
+
+    if (mp_file == NULL)
+    {
+        return 0;
+    }
+
+    do
+    {
+        num_frames = monitor_->GetData(m_frames, BATCH_SIZE);
+        for (TY_Word e = 0; e < num_frames; e++)
+        {
+            if (Write(&m_frames[e]) == EN_Bool::FALSE8)
+            {
+                return num_written;
+            }
+
+            num_written++;
+        }
+    } while (num_frames == BATCH_SIZE);
+
+    // Whatever was served is on the disk, even if the application dies
+    fflush(mp_file);
+    return num_written;
+}
+
+TY_DWord CMonitorCapture::GetNumFrames()
+{
+    return m_num_frames;
+}
+
+TY_DWord CMonitorCapture::GetNumFiles()
+{
+    return m_num_files;
+}
+
+// Helpers
+EN_Bool CMonitorCapture::OpenFile()
+{
+    TY_Char file_name[MAX_FILE_NAME_LEN];
+
+    if (m_is_rotating == EN_Bool::TRUE8)
+    {
+        // trace.pcapng -> trace_00001.pcapng
+        const TY_Char* ext = strrchr(m_file_name, '.');
+        int base_len = (ext != NULL) ? (int)(ext - m_file_name) : (int)strlen(m_file_name);
+
+        snprintf(file_name, sizeof(file_name), "%.*s_%05u%s", base_len, m_file_name,
+            m_num_files + 1, (ext != NULL) ? ext : "");
+    }
+    else
+    {
+        snprintf(file_name, sizeof(file_name), "%s", m_file_name);
+    }
+
+    mp_file = fopen(file_name, "wb");
+    if (mp_file == NULL)
+    {
+        return EN_Bool::FALSE8;
+    }
+
+    m_num_files++;
+    m_file_size = 0;
+    if (WriteHeader() == EN_Bool::FALSE8)
+    {
+        return EN_Bool::FALSE8;
+    }
+
+    return EN_Bool::TRUE8;
+}
+
+void CMonitorCapture::CloseFile()
+{
+    if (mp_file != NULL)
+    {
+        fclose(mp_file);
+        mp_file = NULL;
+    }
+}
+
+EN_Bool CMonitorCapture::WriteHeader()
+{
+    static const TY_Char if_name[] = "HART";
+    TY_DWord len = 0;
+    TY_DWord start;
+
+    // Section header block, the length of the section is not known
+    len += PutDWord(&m_record[len], CBlock::SECTION_HEADER);
+    len += PutDWord(&m_record[len], 28);
+    len += PutDWord(&m_record[len], CBlock::BYTE_ORDER_MAGIC);
+    len += PutWord(&m_record[len], 1);
+    len += PutWord(&m_record[len], 0);
+    len += PutDWord(&m_record[len], 0xffffffff);
+    len += PutDWord(&m_record[len], 0xffffffff);
+    len += PutDWord(&m_record[len], 28);
+
+    // Interface description block with a resolution of 1 ms
+    start = len;
+    len += PutDWord(&m_record[len], CBlock::INTERFACE);
+    len += PutDWord(&m_record[len], 0);
+    len += PutWord(&m_record[len], LINK_TYPE_USER0);
+    len += PutWord(&m_record[len], 0);
+    len += PutDWord(&m_record[len], MON_MAX_FRAME_DATA_SIZE);
+    len += PutWord(&m_record[len], COption::IF_NAME);
+    len += PutWord(&m_record[len], sizeof(if_name) - 1);
+    COSAL::CMem::Copy(&m_record[len], (const TY_Byte*)if_name, sizeof(if_name) - 1);
+    len += sizeof(if_name) - 1;
+    len += PutWord(&m_record[len], COption::IF_TSRESOL);
+    len += PutWord(&m_record[len], 1);
+    // 10^-3 s, padded to 32 bits
+    len += PutDWord(&m_record[len], 0);
+    m_record[len - 4] = 3;
+    len += PutWord(&m_record[len], COption::END_OF_OPT);
+    len += PutWord(&m_record[len], 0);
+    len += PutDWord(&m_record[len], len - start + 4);
+    PutDWord(&m_record[start + 4], len - start);
+
+    return WriteRecord(m_record, len);
+}
+
+EN_Bool CMonitorCapture::WriteRecord(TY_Byte* record_, TY_DWord len_)
+{
+    if (fwrite(record_, 1, len_, mp_file) != len_)
+    {
+        // Disk full or the like, the capture is stopped
+        CloseFile();
+        return EN_Bool::FALSE8;
+    }
+
+    m_file_size += len_;
+    return EN_Bool::TRUE8;
+}
+
+TY_UInt64 CMonitorCapture::GetTimestamp(TY_DWord start_time_)
+{
+    // The monitor times wrap after 49 days and may be slightly out of order
+    TY_Int32 delta = (TY_Int32)(start_time_ - m_kernel_ref);
+
+    m_wall_ref += (TY_UInt64)(long long)delta;
+    m_kernel_ref = start_time_;
+    return m_wall_ref;
+}
+
+TY_DWord CMonitorCapture::PutWord(TY_Byte* dst_, TY_Word value_)
+{
+    COSAL::CMem::Copy(dst_, (const TY_Byte*)&value_, 2);
+    return 2;
+}
+
+TY_DWord CMonitorCapture::PutDWord(TY_Byte* dst_, TY_DWord value_)
+{
+    COSAL::CMem::Copy(dst_, (const TY_Byte*)&value_, 4);
+    return 4;
+}
@@ -0,0 +1,106 @@
+/*
+ *          File: MonitorCapture.h (CMonitorCapture)
+ *                Streaming of the monitor frames into pcapng files. Each
+ *                frame becomes an enhanced packet block holding only the
+ *                octets of the frame, the start time and the direction.
+ *                The files are rotated by size and/or time, so long
+ *                traces are split into files of a handy size.
+ *
+ *        Author: Walter Borst
+ *
+ *        E-Mail: info@borst-automation.de
+ *          Home: https://www.borst-automation.de
+ *
+ * No Warranties: https://www.borst-automation.com/legal/warranty-disclaimer
+ *
+ * Copyright 2006-2025 Walter Borst, Cuxhaven, Germany
+ */
+
+// Once
+#ifndef __monitorcapture_h__
+#define __monitorcapture_h__
+
+#include <stdio.h>
+#include "OSAL.h"
+#include "WbHartUser.h"
+#include "Monitor.h"
+
+class CMonitorCapture
+{
+public:
+    // There is no registered link type for Hart,
+    // the first one reserved for private use is taken
+    static const TY_Word   LINK_TYPE_USER0 = 147;
+    static const TY_Word MAX_FILE_NAME_LEN = 260;
+
+                      CMonitorCapture();
+                     ~CMonitorCapture();
+    // max_file_size_ in bytes, max_file_time_ in seconds, 0: no rotation
+    EN_Bool                      Open(const TY_Char* file_name_, TY_DWord max_file_size_, TY_DWord max_file_time_);
+    void                        Close();
+    EN_Bool                    IsOpen();
+    EN_Bool                     Write(TY_MonFrame* frame_);
+    // Moves the frames of the monitor to the file. The capture is
+    // then the only reader of the monitor. Returns the number of frames.
+    TY_DWord                    Serve(CMonitor* monitor_);
+    TY_DWord             GetNumFrames();
+    TY_DWord              GetNumFiles();
+
+private:
+    class CBlock
+    {
+    public:
+        static const TY_DWord   SECTION_HEADER = 0x0a0d0d0a;
+        static const TY_DWord        INTERFACE = 0x00000001;
+        static const TY_DWord  ENHANCED_PACKET = 0x00000006;
+        static const TY_DWord BYTE_ORDER_MAGIC = 0x1a2b3c4d;
+    };
+
+    class COption
+    {
+    public:
+        static const TY_Word END_OF_OPT = 0;
+        static const TY_Word    IF_NAME = 2;
+        static const TY_Word IF_TSRESOL = 9;
+        static const TY_Word  EPB_FLAGS = 2;
+    };
+
+    class CFlags
+    {
+    public:
+        static const TY_DWord  INBOUND = 0x00000001;
+        static const TY_DWord OUTBOUND = 0x00000002;
+        // Link layer dependent error: wrong inter frame gap
+        static const TY_DWord  GAP_ERR = 0x08000000;
+    };
+
+    // Frames moved from the monitor per call
+    static const TY_Word      BATCH_SIZE = 64;
+    // Block header, timestamp, lengths, flags option, trailer and padding
+    static const TY_Word MAX_RECORD_SIZE = 44 + MON_MAX_FRAME_DATA_SIZE + 4;
+
+    EN_Bool                  OpenFile();
+    void                    CloseFile();
+    EN_Bool               WriteHeader();
+    EN_Bool               WriteRecord(TY_Byte* record_, TY_DWord len_);
+    TY_UInt64            GetTimestamp(TY_DWord start_time_);
+    static TY_DWord           PutWord(TY_Byte* dst_, TY_Word value_);
+    static TY_DWord          PutDWord(TY_Byte* dst_, TY_DWord value_);
+
+    FILE*        mp_file;
+    TY_Char      m_file_name[MAX_FILE_NAME_LEN];
+    EN_Bool      m_is_rotating;
+    TY_DWord     m_max_file_size;
+    TY_DWord     m_max_file_time;
+    TY_DWord     m_file_size;
+    TY_UInt64    m_file_start;
+    TY_DWord     m_num_files;
+    TY_DWord     m_num_frames;
+    // Wall clock in ms matching m_kernel_ref of the monitor times
+    TY_UInt64    m_wall_ref;
+    TY_DWord     m_kernel_ref;
+    TY_Byte      m_record[MAX_RECORD_SIZE];
+    TY_MonFrame  m_frames[BATCH_SIZE];
+};
+
+#endif // __monitorcapture_h__
@@ -64,6 +64,11 @@ public:
     static void                   Wait(TY_DWord u32_Time);
     static void                   Lock(void);
     static void                 Unlock(void);
+    // Leaves the lock at any depth of the calling thread and
+    // enters it again to the same depth, e.g. for a wait for
+    // a thread which may need the lock meanwhile
+    static TY_Word         ReleaseLock(void);
+    static void            RestoreLock(TY_Word depth_);
     static bool     IsInvalidIntHandle(WRD_Handle handle_);
     static void           CopyRcvBytes(ST_RcvByte* dst_, ST_RcvByte* src_, TY_Word len_);
     static void        ExtractRcvBytes(TY_Byte* dst_, ST_RcvByte* src_, TY_Word len_);
@@ -83,6 +88,42 @@ public:
         void Unlock(void);
     };
 
+    class CSignal
+    {
+        // Wakes up all threads waiting for a change of the
+        // counter. In addition a handle of the operating system
+        // is signaled, so the application may wait for several
+        // signals at once (Linux: eventfd, Windows: event).
+    private:
+        PTR_Handle m_signal_data;
+    public:
+        // Construction/Deconstruction
+        CSignal(void);
+        ~CSignal(void);
+        // Operation
+        void Set(void);
+        TY_DWord GetCount(void);
+        EN_Bool Wait(TY_DWord count_, TY_DWord timeout_ms_);
+        PTR_Handle GetWaitHandle(void);
+    };
+
+    class CFileMap
+    {
+        // Maps a file read only into the address space, the
+        // operating system reads the pages as they are touched
+    private:
+        PTR_Handle m_map_data;
+    public:
+        // Construction/Deconstruction
+        CFileMap(void);
+        ~CFileMap(void);
+        // Operation
+        EN_Bool Open(const TY_Char* file_name_);
+        void Close(void);
+        const TY_Byte* GetData(void);
+        TY_UInt64 GetSize(void);
+    };
+
     class CTimer
     {
     public:
@@ -91,6 +132,9 @@ public:
         void                    Restart();
         void                   Continue(TY_DWord u32_ms);
         void                       Stop();
+        // A running timer is expired as of now, e.g. on a
+        // simulated bus which takes no time
+        void                     Expire();
         EN_Bool               IsExpired();
         EN_Bool                IsActive();
         static void                Init();
@@ -102,13 +146,20 @@ public:
         static void                Wait(TY_DWord ms_);
         static void         BeginPeriod(TY_DWord ms_);
         static void           EndPeriod(TY_DWord ms_);
+        // Earliest expiry of the timers started or polled by the
+        // calling thread since the last clear (event driven kernels only)
+        static void     ClearNextExpiry();
+        static EN_Bool    GetNextExpiry(TY_DWord* time_);
     private:
+        static void      RegisterExpiry(TY_DWord expiry_);
         EN_Bool         m_locked;
         EN_Bool         m_active;
         TY_DWord        m_start_time;
         TY_DWord        m_time_limit;
         TY_DWord        m_last_time_limit;
         static TY_DWord s_time;
+        static thread_local TY_DWord s_next_expiry;
+        static thread_local EN_Bool  s_has_next_expiry;
     };
 
     class CTask
@@ -42,7 +42,11 @@ enum class EN_SRV_Result : TY_Byte {
     SUCCESSFUL = 5,
     RESOURCE_ERROR = 6,
     TOO_FEW_DATA_BYTES = 7,
-    OBSOLETE = 8
+    OBSOLETE = 8,
+    // Master only: Dropped before it was sent
+    DEADLINE_MISSED = 9,
+    // Master only: Not sent, the device is offline
+    DEVICE_OFFLINE = 10
 };
 
 enum class EN_Endian : TY_Byte
@@ -75,11 +79,23 @@ enum class EN_Wait : TY_Byte
     WAIT = 1
 };
 
+// Master only: Priority class of a request, the kernel serves
+// the classes in this order
+enum class EN_Priority : TY_Byte
+{
+    ALARM = 0,
+    OPERATOR = 1,
+    CYCLIC = 2,
+    BACKGROUND = 3
+};
+
 enum class EN_CommType : TY_Byte
 {
     NONE = 0,
     UART = 1,
-    HART_IP = 2
+    HART_IP = 2,
+    // Master only: Simulated devices on a virtual wire
+    LOOPBACK = 3
 };
 
 enum class EN_Master : TY_Byte
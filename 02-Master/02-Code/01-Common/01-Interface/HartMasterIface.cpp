@@ -17,393 +17,823 @@
  * Copyright 2006-2025 Walter Borst, Cuxhaven, Germany
  */
 
+#include <new>
 #include "HartMasterIface.h"
 #include "HartCoding.h"
 
-// Channel handling
-EN_Bool CHartMaster::OpenChannel(TY_Word port_number_, EN_CommType type_)
+CChannel                CHartMaster::m_default_channel;
+std::atomic<CChannel*>  CHartMaster::m_channels[MAX_NUM_CHANNELS] = { &CHartMaster::m_default_channel };
+std::atomic<WRD_Handle> CHartMaster::m_handles[MAX_NUM_CHANNELS];
+std::atomic<TY_Word>    CHartMaster::m_num_lookups[MAX_NUM_CHANNELS];
+
+// Channel objects
+WRD_Handle CHartMaster::CreateChannel()
 {
-    EN_Bool result;
+    static_assert(MAX_NUM_CHANNELS <= (CHANNEL_INDEX_MASK + 1), "Too many channels for the handle");
+
+    WRD_Handle h_channel = INVALID_WRD_HANDLE;
+    CChannel*  channel;
+    TY_Word    generation;
+    TY_Word    idx;
 
     COSAL::Lock();
-    result = CChannel::Open(port_number_, type_);
+
+    for (idx = 1; idx < MAX_NUM_CHANNELS; idx++)
+    {
+        if (m_channels[idx] == NULL)
+        {
+            channel = new (std::nothrow) CChannel();
+            if (channel != NULL)
+            {
+                // The handles of the previous channel get stale. An
+                // unused slot has handle 0 and starts with generation 1.
+                generation = (TY_Word)(m_handles[idx] >> CHANNEL_INDEX_BITS) + 1;
+                h_channel = (WRD_Handle)((generation << CHANNEL_INDEX_BITS) | idx);
+                if (h_channel == INVALID_WRD_HANDLE)
+                {
+                    h_channel = idx;
+                }
+
+                m_handles[idx] = h_channel;
+                m_channels[idx] = channel;
+            }
+            break;
+        }
+    }
+
     COSAL::Unlock();
-    return result;
+    return h_channel;
 }
 
-void CHartMaster::CloseChannel()
+void CHartMaster::DeleteChannel(WRD_Handle channel_)
 {
+    CChannel* channel = NULL;
+    TY_Word   idx = channel_ & CHANNEL_INDEX_MASK;
+
     COSAL::Lock();
-    CChannel::Close();
+
+    channel = GetChannel(channel_);
+    if (channel != NULL)
+    {
+        // The default channel is only closed
+        if (channel_ == DEFAULT_CHANNEL)
+        {
+            channel->Close();
+        }
+        else
+        {
+            // Gone for the handlers, the close may wait
+            // for the kernel and lets them in meanwhile.
+            // A call which found the channel before has
+            // pinned it as soon as the lookups are done.
+            m_channels[idx] = NULL;
+            while (m_num_lookups[idx] != 0)
+            {
+            }
+
+            channel->Close();
+            if (channel->IsExecuting() == EN_Bool::TRUE8)
+            {
+                // Called by a handler of the channel, the kernel
+                // takes over the pin of the table
+                channel->DeleteLater();
+            }
+            else
+            {
+                // Deleted now or by the last call using it
+                channel->Unpin();
+            }
+        }
+    }
+
     COSAL::Unlock();
 }
 
-// Configuration
-void CHartMaster::GetConfiguration(TY_Configuration* config_)
+// Channel handling
+EN_Bool CHartMaster::OpenChannel(WRD_Handle channel_, TY_Word port_number_, EN_CommType type_)
 {
+    CChannel* channel = NULL;
+    EN_Bool   result = EN_Bool::FALSE8;
+
     COSAL::Lock();
 
-    config_->BaudRate = CChannel::GetBaudrate();
-    config_->NumPreambles = CChannel::GetNumPreambles();
-    config_->NumRetries = CChannel::GetNumRetries();
-    config_->RetryIfBusy = CChannel::GetRetryIfBusy();
-    config_->MasterType = CChannel::GetMasterType();
-    config_->AddressingMode = CChannel::GetAddressingMode();
-    CChannel::FetchHartIpHostName(config_->HartIpHostName);
-    CChannel::FetchHartIpAddress(config_->HartIpAddress);
-    CChannel::FetchHartIpPort(config_->HartIpPort);
-    config_->HartIpUseAddress = CChannel::GetHartIpUseAddress();
-    config_->HartIpSendKeepAlive = CChannel::HartIpSendKeepAlive;
+    channel = GetChannel(channel_);
+    if (channel == NULL)
+    {
+        COSAL::Unlock();
+        return EN_Bool::FALSE8;
+    }
+
+    result = channel->Open(port_number_, type_);
     COSAL::Unlock();
+    return result;
 }
 
-void CHartMaster::SetConfiguration(TY_Configuration* config_)
+void CHartMaster::CloseChannel(WRD_Handle channel_)
 {
+    CChannel* channel = NULL;
+
     COSAL::Lock();
 
-    CChannel::SetNumPreambles(config_->NumPreambles);
-    CChannel::SetNumRetries(config_->NumRetries);
-    CChannel::SetRetryIfBusy(config_->RetryIfBusy);
-    CChannel::SetMasterType(config_->MasterType);
-    CChannel::SetAddressingMode(config_->AddressingMode);
-    CChannel::SetBaudrate(config_->BaudRate);
-    CChannel::SetHartIpHostName(config_->HartIpHostName);
-    CChannel::SetHartIpAddress(config_->HartIpAddress);
-    CChannel::SetHartIpPort(config_->HartIpPort);
-    CChannel::SetHartIpUseAddress(config_->HartIpUseAddress);
-    CChannel::HartIpSendKeepAlive = config_->HartIpSendKeepAlive;
+    channel = GetChannel(channel_);
+    if (channel != NULL)
+    {
+        channel->Close();
+    }
 
     COSAL::Unlock();
 }
 
-// Information
-TY_Word CHartMaster::GetHartIpStatus()
+// Configuration
+void CHartMaster::GetConfiguration(WRD_Handle channel_, TY_Configuration* config_)
 {
-    return CChannel::GetHartIpStatus();
-}
+    CChannel* channel = NULL;
 
+    COSAL::Lock();
 
-// Connection
-SRV_Handle CHartMaster::ConnectByAddr(TY_Byte address_, EN_Wait qos_, TY_Byte num_retries_)
+    channel = GetChannel(channel_);
+    if (channel == NULL)
+    {
+        COSAL::Unlock();
+        return;
+    }
+
+    config_->BaudRate = channel->GetBaudrate();
+    config_->NumPreambles = channel->GetNumPreambles();
+    config_->NumRetries = channel->GetNumRetries();
+    config_->RetryIfBusy = channel->GetRetryIfBusy();
+    config_->MasterType = channel->GetMasterType();
+    config_->AddressingMode = channel->GetAddressingMode();
+    channel->FetchHartIpHostName(config_->HartIpHostName);
+    channel->FetchHartIpAddress(config_->HartIpAddress);
+    channel->FetchHartIpPort(config_->HartIpPort);
+    config_->HartIpUseAddress = channel->GetHartIpUseAddress();
+    config_->HartIpSendKeepAlive = channel->HartIpSendKeepAlive;
+    COSAL::Unlock();
+}
+
+void CHartMaster::SetConfiguration(WRD_Handle channel_, TY_Configuration* config_)
 {
-    SRV_Handle h_service = INVALID_SRV_HANDLE;
-    CService* p_service = NULL;
-    EN_Bool    is_valid_service = EN_Bool::FALSE8;
+    CChannel* channel = NULL;
 
     COSAL::Lock();
 
-    if (CChannel::IsOpen() == EN_Bool::FALSE8)
+    channel = GetChannel(channel_);
+    if (channel == NULL)
     {
         COSAL::Unlock();
-        return INVALID_SRV_HANDLE;
+        return;
     }
 
-    h_service = CChannel::GetNewService();
-    if (h_service != INVALID_SRV_HANDLE)
+    channel->SetNumPreambles(config_->NumPreambles);
+    channel->SetNumRetries(config_->NumRetries);
+    channel->SetRetryIfBusy(config_->RetryIfBusy);
+    channel->SetMasterType(config_->MasterType);
+    channel->SetAddressingMode(config_->AddressingMode);
+    channel->SetBaudrate(config_->BaudRate);
+    channel->SetHartIpHostName(config_->HartIpHostName);
+    channel->SetHartIpAddress(config_->HartIpAddress);
+    channel->SetHartIpPort(config_->HartIpPort);
+    channel->SetHartIpUseAddress(config_->HartIpUseAddress);
+    channel->HartIpSendKeepAlive = config_->HartIpSendKeepAlive;
+
+    COSAL::Unlock();
+}
+
+EN_Bool CHartMaster::SetNumServices(WRD_Handle channel_, TY_Word num_services_)
+{
+    CChannel* channel = NULL;
+    EN_Bool   result = EN_Bool::FALSE8;
+
+    COSAL::Lock();
+
+    channel = GetChannel(channel_);
+    if (channel != NULL)
     {
-        p_service = CChannel::GetServicePtr(h_service);
-        if (p_service != NULL)
-        {
-            is_valid_service = EN_Bool::TRUE8;
-            p_service->SetCommand(0);
-            p_service->SetAddrMode(CHart::CAddrMode::POLLING);
-            p_service->SetShortAddr(address_);
-            p_service->SetData(NULL, 0);
-            p_service->SetNumRetries(num_retries_);
-            p_service->SetNumPreambles(CChannel::GetNumPreambles());
-            p_service->SetRetryIfBusy(CChannel::GetRetryIfBusy());
-            p_service->SetHandle(h_service);
-            p_service->Launch();
-            // Pass the access of the service to the protocol kernel
-            CChannel::SetServiceOwner(h_service, EN_Owner::PROTOCOL);
-        }
+        result = channel->SetNumServices(num_services_);
     }
 
     COSAL::Unlock();
+    return result;
+}
 
-    /// Debug
-    TY_Word wait_count = 500;
-    /// End debug
+TY_Word CHartMaster::GetNumServices(WRD_Handle channel_)
+{
+    CChannel* channel = PinChannel(channel_);
+    TY_Word   result = 0;
 
-    if ((qos_ == EN_Wait::WAIT) && (is_valid_service == EN_Bool::TRUE8))
+    if (channel != NULL)
     {
-        /* Wait for service completion */
-        while (CChannel::IsServiceCompleted(h_service) == EN_Bool::FALSE8)
-        {
-            COSAL::Wait(10);
-
-            /// Debug
-            if (wait_count-- == 0)
-            {
-                break;
-            }
-            /// End debug
-        }
+        result = channel->GetNumServices();
+        channel->Unpin();
     }
 
-    return h_service;
+    return result;
 }
 
-void CHartMaster::FetchConnection(SRV_Handle service_, TY_Connection* connection_)
+EN_Bool CHartMaster::SetLoopbackConfig(WRD_Handle channel_, TY_LoopbackConfig* config_)
 {
-    CService* srv = NULL;
+    CChannel* channel = NULL;
+    EN_Bool   result = EN_Bool::FALSE8;
 
     COSAL::Lock();
 
-    if (CChannel::IsValidService(service_) == EN_Bool::TRUE8)
+    channel = GetChannel(channel_);
+    if (channel != NULL)
     {
-        TY_Byte len;
+        result = channel->SetLoopbackConfig(config_);
+    }
 
-        srv = CChannel::GetServicePtr(service_);
-        if (srv->IsInProgress() == EN_Bool::TRUE8)
-        {
-            connection_->SrvResultCode = (TY_Byte)EN_SRV_Result::IN_PROGRESS;
-            COSAL::Unlock();
-            return;
-        }
-        if (srv->Failed() == EN_Bool::TRUE8)
-        {
-            connection_->SrvResultCode = (TY_Byte)EN_SRV_Result::NO_DEV_RESP;
-            connection_->UsedRetries = srv->GetUsedRetries();
-            CChannel::FreeService(service_);
-            COSAL::Unlock();
-            return;
-        }
-        len = srv->GetRespLen();
-        if (len < 12)
-        {
-            connection_->SrvResultCode = (TY_Byte)EN_SRV_Result::NO_DEV_RESP;
-            connection_->UsedRetries = srv->GetUsedRetries();
-            CChannel::FreeService(service_);
-            COSAL::Unlock();
-            return;
-        }
+    COSAL::Unlock();
+    return result;
+}
 
-        connection_->SrvResultCode = (TY_Byte)EN_SRV_Result::SUCCESSFUL;
-        connection_->RespCode1 = srv->GetRespCode1();
-        connection_->RespCode2 = srv->GetRespCode2();
-        connection_->ManuId = srv->GetRespDataByte(1);
-        connection_->DevId = srv->GetRespDataByte(2);
-        connection_->NumPreambles = srv->GetRespDataByte(3);
-        connection_->CmdRevNum = srv->GetRespDataByte(4);
-        connection_->SpecRevCode = srv->GetRespDataByte(5);
-        connection_->SwRev = srv->GetRespDataByte(6);
-        connection_->HwRev = srv->GetRespDataByte(7);
-        connection_->HartFlags = srv->GetRespDataByte(8);
-        connection_->BytesOfUniqueID[0] = srv->GetRespDataByte(1);
-        connection_->BytesOfUniqueID[1] = srv->GetRespDataByte(2);
-        connection_->BytesOfUniqueID[2] = srv->GetRespDataByte(9);
-        connection_->BytesOfUniqueID[3] = srv->GetRespDataByte(10);
-        connection_->BytesOfUniqueID[4] = srv->GetRespDataByte(11);
-        connection_->DeviceInBurstMode = (TY_Byte)srv->GetDeviceInBurstMode();
-        connection_->UsedRetries = srv->GetUsedRetries();
-        if (len >= 17)
-        {
-            connection_->MinNumPreambs = srv->GetRespDataByte(12);
-            connection_->MaxNumDVs = srv->GetRespDataByte(13);
-            connection_->CfgChCount = (TY_Word)((srv->GetRespDataByte(14) << 8) + srv->GetRespDataByte(15));
-            connection_->ExtDevStatus = srv->GetRespDataByte(16);
-        }
-        else
-        {
-            connection_->MinNumPreambs = 0;
-            connection_->MaxNumDVs = 0;
-            connection_->CfgChCount = 0;
-            connection_->ExtDevStatus = 0;
-        }
-        if (len >= 22)
-        {
-            connection_->ExtManuID = (TY_Word)((srv->GetRespDataByte(17) << 8) + srv->GetRespDataByte(18));
-            connection_->ExtLabDistID = (TY_Word)((srv->GetRespDataByte(19) << 8) + srv->GetRespDataByte(20));
-            connection_->EDevProfile = srv->GetRespDataByte(21);
-        }
-        else
-        {
-            connection_->ExtManuID = 0;
-            connection_->ExtLabDistID = 0;
-            connection_->EDevProfile = 0;
-        }
+void CHartMaster::GetLoopbackConfig(WRD_Handle channel_, TY_LoopbackConfig* config_)
+{
+    CChannel* channel = NULL;
 
-        CChannel::FreeService(service_);
-    }
-    else
+    COSAL::Lock();
+
+    channel = GetChannel(channel_);
+    if (channel != NULL)
     {
-        connection_->SrvResultCode = (TY_Byte)EN_SRV_Result::EMPTY;
+        channel->GetLoopbackConfig(config_);
     }
 
     COSAL::Unlock();
 }
 
-// Commands
-SRV_Handle CHartMaster::LaunchCommand(TY_Byte command_,
-    EN_Wait qos_,
-    TY_Byte* data_ref_,
-    TY_Byte data_len_,
-    TY_Byte* bytes_of_unique_id_)
+// Information
+TY_Word CHartMaster::GetHartIpStatus(WRD_Handle channel_)
 {
-    CService*  p_service = NULL;
-    SRV_Handle h_service = INVALID_SRV_HANDLE;
-    EN_Bool    is_valid_service = EN_Bool::FALSE8;
-
-    COSAL::Lock();
+    CChannel* channel = PinChannel(channel_);
+    TY_Word   result = 0;
 
-    if (CChannel::IsOpen() == EN_Bool::FALSE8)
+    if (channel != NULL)
     {
-        COSAL::Unlock();
-        return INVALID_SRV_HANDLE;
+        result = channel->GetHartIpStatus();
+        channel->Unpin();
     }
 
-    h_service = CChannel::GetNewService();
-    if (h_service != INVALID_SRV_HANDLE)
+    return result;
+}
+
+EN_Bool CHartMaster::GetLatencyStats(WRD_Handle channel_, TY_Byte* bytes_of_unique_id_,
+    TY_Word command_, TY_LatencyStats* stats_)
+{
+    CChannel* channel = NULL;
+    EN_Bool   result = EN_Bool::FALSE8;
+
+    COSAL::Lock();
+
+    channel = GetChannel(channel_);
+    if (channel != NULL)
     {
-        p_service = CChannel::GetServicePtr(h_service);
-        if (p_service != NULL)
-        {
-            is_valid_service = EN_Bool::TRUE8;
-            p_service->SetCommand(command_);
-            if (CChannel::GetAddressingMode() == 2)
-            {
-                p_service->SetAddrMode(CHart::CAddrMode::POLLING);
-            }
-            else
-            {
-                p_service->SetAddrMode(CHart::CAddrMode::UNIQUE);
-            }
-            p_service->SetUniqueID(bytes_of_unique_id_);
-            p_service->SetData(data_ref_, data_len_);
-            p_service->SetRetryIfBusy(CChannel::GetRetryIfBusy());
-            p_service->SetNumPreambles(CChannel::GetNumPreambles());
-            p_service->SetNumRetries(CChannel::GetNumRetries());
-            p_service->SetMode(CService::EN_Mode::NORMAL);
-            p_service->SetHandle(h_service);
-            p_service->Launch();
-            // Pass the access of the service to the protocol kernel
-            CChannel::SetServiceOwner(h_service, EN_Owner::PROTOCOL);
-        }
-        else
-        {
-            CChannel::FreeService(h_service);
-            h_service = INVALID_SRV_HANDLE;
-        }
+        result = channel->Latency.Query(bytes_of_unique_id_, command_, stats_);
     }
 
     COSAL::Unlock();
+    return result;
+}
 
-    /// Debug
-    TY_Word wait_count = 500;
-    /// End debug
+TY_Word CHartMaster::GetNumLatencyEntries(WRD_Handle channel_)
+{
+    CChannel* channel = PinChannel(channel_);
+    TY_Word   result = 0;
 
-    if ((qos_ == EN_Wait::WAIT) && (is_valid_service == EN_Bool::TRUE8))
+    if (channel != NULL)
     {
-        /* Wait for service completion */
-        while (CChannel::IsServiceCompleted(h_service) == EN_Bool::FALSE8)
-        {
-            COSAL::Wait(10);
-
-            /// Debug
-            if (wait_count-- == 0)
-            {
-                break;
-            }
-            /// End debug
-        }
+        result = channel->Latency.GetNumEntries();
+        channel->Unpin();
     }
 
-    return h_service;
+    return result;
 }
 
-SRV_Handle CHartMaster::LaunchExtCommand(
-    TY_Word  command_,
-    EN_Wait  qos_,
-    TY_Byte* data_ref_,
-    TY_Byte  data_len_,
-    TY_Byte* bytes_of_unique_id_)
+EN_Bool CHartMaster::FetchLatencyEntry(WRD_Handle channel_, TY_Word index_, TY_LatencyStats* stats_)
 {
-    TY_Byte data_bytes[256];
+    CChannel* channel = NULL;
+    EN_Bool   result = EN_Bool::FALSE8;
 
-    if (data_len_ > 254)
+    COSAL::Lock();
+
+    channel = GetChannel(channel_);
+    if (channel != NULL)
     {
-        return INVALID_SRV_HANDLE;
+        result = channel->Latency.FetchEntry(index_, stats_);
     }
 
-    // Pack the 16 bit command at the beginning of the request data 
-    PutInt16(command_, 0, data_bytes, EN_Endian::MSB_First);
-    if (data_len_ > 0)
+    COSAL::Unlock();
+    return result;
+}
+
+void CHartMaster::ResetLatencyStats(WRD_Handle channel_)
+{
+    CChannel* channel = NULL;
+
+    COSAL::Lock();
+
+    channel = GetChannel(channel_);
+    if (channel != NULL)
     {
-        // Only if payload exists
-        PutOctets(data_ref_, data_len_, 0, &data_bytes[2]);
+        channel->Latency.Reset();
     }
 
-    return LaunchCommand(31, qos_, data_bytes, (TY_Byte)(data_len_ + 2), bytes_of_unique_id_);
+    COSAL::Unlock();
 }
 
-
-// Service handling
-void CHartMaster::FetchConfirmation(SRV_Handle service_,
-    TY_Confirmation* conf_data_)
+EN_Bool CHartMaster::GetDeviceHealth(WRD_Handle channel_, TY_Byte* bytes_of_unique_id_, TY_DeviceHealth* health_)
 {
-    CService* p_service = NULL;
+    CChannel* channel = NULL;
+    EN_Bool   result = EN_Bool::FALSE8;
 
     COSAL::Lock();
 
-    if (CChannel::IsValidService(service_) == EN_Bool::TRUE8)
+    channel = GetChannel(channel_);
+    if (channel != NULL)
     {
-        p_service = CChannel::GetServicePtr(service_);
-        if (p_service->IsInProgress() == EN_Bool::TRUE8)
-        {
-            conf_data_->SrvResultCode = EN_SRV_Result::IN_PROGRESS;
-            conf_data_->DataLen = 0;
-            COSAL::Unlock();
-            return;
-        }
-        
-        if (p_service->Failed() == EN_Bool::TRUE8)
+        result = channel->Health.Query(bytes_of_unique_id_, health_);
+    }
+
+    COSAL::Unlock();
+    return result;
+}
+
+TY_Word CHartMaster::GetNumHealthEntries(WRD_Handle channel_)
+{
+    CChannel* channel = PinChannel(channel_);
+    TY_Word   result = 0;
+
+    if (channel != NULL)
+    {
+        result = channel->Health.GetNumEntries();
+        channel->Unpin();
+    }
+
+    return result;
+}
+
+EN_Bool CHartMaster::FetchHealthEntry(WRD_Handle channel_, TY_Word index_, TY_DeviceHealth* health_)
+{
+    CChannel* channel = NULL;
+    EN_Bool   result = EN_Bool::FALSE8;
+
+    COSAL::Lock();
+
+    channel = GetChannel(channel_);
+    if (channel != NULL)
+    {
+        result = channel->Health.FetchEntry(index_, health_);
+    }
+
+    COSAL::Unlock();
+    return result;
+}
+
+void CHartMaster::ResetDeviceHealth(WRD_Handle channel_)
+{
+    CChannel* channel = NULL;
+
+    COSAL::Lock();
+
+    channel = GetChannel(channel_);
+    if (channel != NULL)
+    {
+        channel->Health.Reset();
+    }
+
+    COSAL::Unlock();
+}
+
+EN_Bool CHartMaster::SetHealthConfig(WRD_Handle channel_, TY_HealthConfig* config_)
+{
+    CChannel* channel = NULL;
+    EN_Bool   result = EN_Bool::FALSE8;
+
+    COSAL::Lock();
+
+    channel = GetChannel(channel_);
+    if (channel != NULL)
+    {
+        result = channel->Health.SetConfig(config_);
+    }
+
+    COSAL::Unlock();
+    return result;
+}
+
+void CHartMaster::GetHealthConfig(WRD_Handle channel_, TY_HealthConfig* config_)
+{
+    CChannel* channel = NULL;
+
+    COSAL::Lock();
+
+    channel = GetChannel(channel_);
+    if (channel != NULL)
+    {
+        channel->Health.GetConfig(config_);
+    }
+
+    COSAL::Unlock();
+}
+
+EN_Bool CHartMaster::ReadBurstData(WRD_Handle channel_, TY_Byte* bytes_of_unique_id_,
+    TY_Word command_, TY_BurstData* data_)
+{
+    // Note: No lock required, the cache is a seqlock
+    CChannel* channel = PinChannel(channel_);
+    EN_Bool   result = EN_Bool::FALSE8;
+
+    if (channel != NULL)
+    {
+        result = channel->Bursts.Read(bytes_of_unique_id_, command_, data_);
+        channel->Unpin();
+    }
+
+    return result;
+}
+
+TY_Word CHartMaster::GetNumBurstEntries(WRD_Handle channel_)
+{
+    CChannel* channel = PinChannel(channel_);
+    TY_Word   result = 0;
+
+    if (channel != NULL)
+    {
+        result = channel->Bursts.GetNumEntries();
+        channel->Unpin();
+    }
+
+    return result;
+}
+
+EN_Bool CHartMaster::FetchBurstEntry(WRD_Handle channel_, TY_Word index_, TY_BurstData* data_)
+{
+    CChannel* channel = PinChannel(channel_);
+    EN_Bool   result = EN_Bool::FALSE8;
+
+    if (channel != NULL)
+    {
+        result = channel->Bursts.FetchEntry(index_, data_);
+        channel->Unpin();
+    }
+
+    return result;
+}
+
+void CHartMaster::ResetBurstData(WRD_Handle channel_)
+{
+    CChannel* channel = PinChannel(channel_);
+
+    if (channel != NULL)
+    {
+        channel->Bursts.Reset();
+        channel->Unpin();
+    }
+}
+
+WRD_Handle CHartMaster::SubscribeBurst(WRD_Handle channel_, TY_Byte* bytes_of_unique_id_, TY_Word command_,
+    TY_Byte value_offset_, TY_Float deadband_, TY_BurstHandler handler_, void* context_)
+{
+    CChannel*  channel = PinChannel(channel_);
+    WRD_Handle result = INVALID_WRD_HANDLE;
+
+    if (channel != NULL)
+    {
+        result = channel->Bursts.Subscribe(bytes_of_unique_id_, command_, value_offset_, deadband_, handler_, context_);
+        channel->Unpin();
+    }
+
+    return result;
+}
+
+void CHartMaster::UnsubscribeBurst(WRD_Handle channel_, WRD_Handle subscription_)
+{
+    CChannel* channel = PinChannel(channel_);
+
+    if (channel != NULL)
+    {
+        channel->Bursts.Unsubscribe(subscription_);
+        channel->Unpin();
+    }
+}
+
+
+// Connection
+SRV_Handle CHartMaster::ConnectByAddr(WRD_Handle channel_, TY_Byte address_, EN_Wait qos_, TY_Byte num_retries_)
+{
+    CChannel*  channel = NULL;
+    SRV_Handle h_service = INVALID_SRV_HANDLE;
+    CService* p_service = NULL;
+    EN_Bool    is_valid_service = EN_Bool::FALSE8;
+
+    // Note: No lock required, the service is taken from the
+    // free services of the channel and passed to the kernel
+    // by a queue. The pin keeps the channel while it is used.
+    channel = PinChannel(channel_);
+    if (channel == NULL)
+    {
+        return INVALID_SRV_HANDLE;
+    }
+
+    if (channel->IsOpen() == EN_Bool::FALSE8)
+    {
+        channel->Unpin();
+        return INVALID_SRV_HANDLE;
+    }
+
+    h_service = channel->GetNewService();
+    if (h_service != INVALID_SRV_HANDLE)
+    {
+        p_service = channel->GetServicePtr(h_service);
+        if (p_service != NULL)
+        {
+            is_valid_service = EN_Bool::TRUE8;
+            p_service->SetCommand(0);
+            p_service->SetAddrMode(CHart::CAddrMode::POLLING);
+            p_service->SetShortAddr(address_);
+            p_service->SetData(NULL, 0);
+            p_service->SetNumRetries(num_retries_);
+            p_service->SetNumPreambles(channel->GetNumPreambles());
+            p_service->SetRetryIfBusy(channel->GetRetryIfBusy());
+            p_service->SetHandle(h_service);
+            p_service->Launch();
+            // Pass the access of the service to the protocol kernel
+            channel->SetServiceOwner(h_service, EN_Owner::PROTOCOL);
+        }
+    }
+
+    if ((qos_ == EN_Wait::WAIT) && (is_valid_service == EN_Bool::TRUE8))
+    {
+        /* Wait for service completion */
+        channel->WaitForService(h_service, MAX_SERVICE_WAIT_TIME);
+    }
+
+    channel->Unpin();
+    return h_service;
+}
+
+void CHartMaster::FetchConnection(WRD_Handle channel_, SRV_Handle service_, TY_Connection* connection_)
+{
+    CChannel* channel = NULL;
+    CService* srv = NULL;
+
+    // Note: No lock required, once completed the
+    // service belongs to the caller
+    channel = PinChannel(channel_);
+    if (channel == NULL)
+    {
+        connection_->SrvResultCode = (TY_Byte)EN_SRV_Result::EMPTY;
+        return;
+    }
+
+    if (channel->IsValidService(service_) == EN_Bool::TRUE8)
+    {
+        TY_Byte len;
+
+        srv = channel->GetServicePtr(service_);
+        // Wait until the kernel has passed back the service
+        if (channel->IsServiceCompleted(service_) == EN_Bool::FALSE8)
+        {
+            connection_->SrvResultCode = (TY_Byte)EN_SRV_Result::IN_PROGRESS;
+            channel->Unpin();
+            return;
+        }
+        if (srv->Failed() == EN_Bool::TRUE8)
+        {
+            // Tells a dropped service from a missing response
+            connection_->SrvResultCode = (TY_Byte)srv->GetFailedResult();
+            connection_->UsedRetries = srv->GetUsedRetries();
+            channel->FreeService(service_);
+            channel->Unpin();
+            return;
+        }
+        len = srv->GetRespLen();
+        if (len < 12)
+        {
+            connection_->SrvResultCode = (TY_Byte)EN_SRV_Result::NO_DEV_RESP;
+            connection_->UsedRetries = srv->GetUsedRetries();
+            channel->FreeService(service_);
+            channel->Unpin();
+            return;
+        }
+
+        connection_->SrvResultCode = (TY_Byte)EN_SRV_Result::SUCCESSFUL;
+        connection_->RespCode1 = srv->GetRespCode1();
+        connection_->RespCode2 = srv->GetRespCode2();
+        connection_->ManuId = srv->GetRespDataByte(1);
+        connection_->DevId = srv->GetRespDataByte(2);
+        connection_->NumPreambles = srv->GetRespDataByte(3);
+        connection_->CmdRevNum = srv->GetRespDataByte(4);
+        connection_->SpecRevCode = srv->GetRespDataByte(5);
+        connection_->SwRev = srv->GetRespDataByte(6);
+        connection_->HwRev = srv->GetRespDataByte(7);
+        connection_->HartFlags = srv->GetRespDataByte(8);
+        connection_->BytesOfUniqueID[0] = srv->GetRespDataByte(1);
+        connection_->BytesOfUniqueID[1] = srv->GetRespDataByte(2);
+        connection_->BytesOfUniqueID[2] = srv->GetRespDataByte(9);
+        connection_->BytesOfUniqueID[3] = srv->GetRespDataByte(10);
+        connection_->BytesOfUniqueID[4] = srv->GetRespDataByte(11);
+        connection_->DeviceInBurstMode = (TY_Byte)srv->GetDeviceInBurstMode();
+        connection_->UsedRetries = srv->GetUsedRetries();
+        if (len >= 17)
+        {
+            connection_->MinNumPreambs = srv->GetRespDataByte(12);
+            connection_->MaxNumDVs = srv->GetRespDataByte(13);
+            connection_->CfgChCount = (TY_Word)((srv->GetRespDataByte(14) << 8) + srv->GetRespDataByte(15));
+            connection_->ExtDevStatus = srv->GetRespDataByte(16);
+        }
+        else
+        {
+            connection_->MinNumPreambs = 0;
+            connection_->MaxNumDVs = 0;
+            connection_->CfgChCount = 0;
+            connection_->ExtDevStatus = 0;
+        }
+        if (len >= 22)
+        {
+            connection_->ExtManuID = (TY_Word)((srv->GetRespDataByte(17) << 8) + srv->GetRespDataByte(18));
+            connection_->ExtLabDistID = (TY_Word)((srv->GetRespDataByte(19) << 8) + srv->GetRespDataByte(20));
+            connection_->EDevProfile = srv->GetRespDataByte(21);
+        }
+        else
+        {
+            connection_->ExtManuID = 0;
+            connection_->ExtLabDistID = 0;
+            connection_->EDevProfile = 0;
+        }
+
+        channel->FreeService(service_);
+    }
+    else
+    {
+        connection_->SrvResultCode = (TY_Byte)EN_SRV_Result::EMPTY;
+    }
+
+    channel->Unpin();
+}
+
+// Commands
+SRV_Handle CHartMaster::LaunchCommand(WRD_Handle channel_,
+    TY_Byte command_,
+    EN_Wait qos_,
+    TY_Byte* data_ref_,
+    TY_Byte data_len_,
+    TY_Byte* bytes_of_unique_id_)
+{
+    SRV_Handle h_service = LaunchCommand(channel_, command_, NULL, NULL,
+        data_ref_, data_len_, bytes_of_unique_id_);
+
+    if ((qos_ == EN_Wait::WAIT) && (h_service != INVALID_SRV_HANDLE))
+    {
+        /* Wait for service completion */
+        WaitForService(channel_, h_service, MAX_SERVICE_WAIT_TIME);
+    }
+
+    return h_service;
+}
+
+SRV_Handle CHartMaster::LaunchCommand(WRD_Handle channel_,
+    TY_Byte command_,
+    TY_CompletionHandler handler_,
+    void* context_,
+    TY_Byte* data_ref_,
+    TY_Byte data_len_,
+    TY_Byte* bytes_of_unique_id_)
+{
+    return LaunchCommand(channel_, command_, EN_Priority::CYCLIC, 0, handler_, context_,
+        data_ref_, data_len_, bytes_of_unique_id_);
+}
+
+SRV_Handle CHartMaster::LaunchCommand(WRD_Handle channel_,
+    TY_Byte command_,
+    EN_Priority priority_,
+    TY_DWord deadline_ms_,
+    TY_CompletionHandler handler_,
+    void* context_,
+    TY_Byte* data_ref_,
+    TY_Byte data_len_,
+    TY_Byte* bytes_of_unique_id_)
+{
+    CChannel*  channel = NULL;
+    SRV_Handle h_service = INVALID_SRV_HANDLE;
+
+    // Note: No lock required, the service is taken from the
+    // free services of the channel and passed to the kernel
+    // by a queue. The pin keeps the channel while it is used.
+    channel = PinChannel(channel_);
+    if (channel == NULL)
+    {
+        return INVALID_SRV_HANDLE;
+    }
+
+    if (channel->IsOpen() == EN_Bool::TRUE8)
+    {
+        h_service = channel->PrepareService(command_, data_ref_, data_len_,
+            bytes_of_unique_id_, handler_, context_);
+    }
+
+    if (h_service != INVALID_SRV_HANDLE)
+    {
+        channel->GetServicePtr(h_service)->SetPriority(priority_);
+        channel->GetServicePtr(h_service)->SetDeadline(deadline_ms_);
+        // Pass the access of the service to the protocol kernel
+        channel->SetServiceOwner(h_service, EN_Owner::PROTOCOL);
+    }
+
+    channel->Unpin();
+    return h_service;
+}
+
+SRV_Handle CHartMaster::LaunchExtCommand(
+    WRD_Handle channel_,
+    TY_Word  command_,
+    EN_Wait  qos_,
+    TY_Byte* data_ref_,
+    TY_Byte  data_len_,
+    TY_Byte* bytes_of_unique_id_)
+{
+    SRV_Handle h_service = LaunchExtCommand(channel_, command_, NULL, NULL,
+        data_ref_, data_len_, bytes_of_unique_id_);
+
+    if ((qos_ == EN_Wait::WAIT) && (h_service != INVALID_SRV_HANDLE))
+    {
+        /* Wait for service completion */
+        WaitForService(channel_, h_service, MAX_SERVICE_WAIT_TIME);
+    }
+
+    return h_service;
+}
+
+SRV_Handle CHartMaster::LaunchExtCommand(
+    WRD_Handle channel_,
+    TY_Word  command_,
+    TY_CompletionHandler handler_,
+    void*    context_,
+    TY_Byte* data_ref_,
+    TY_Byte  data_len_,
+    TY_Byte* bytes_of_unique_id_)
+{
+    return LaunchExtCommand(channel_, command_, EN_Priority::CYCLIC, 0, handler_, context_,
+        data_ref_, data_len_, bytes_of_unique_id_);
+}
+
+SRV_Handle CHartMaster::LaunchExtCommand(
+    WRD_Handle channel_,
+    TY_Word  command_,
+    EN_Priority priority_,
+    TY_DWord deadline_ms_,
+    TY_CompletionHandler handler_,
+    void*    context_,
+    TY_Byte* data_ref_,
+    TY_Byte  data_len_,
+    TY_Byte* bytes_of_unique_id_)
+{
+    TY_Byte data_bytes[256];
+
+    if (data_len_ > 254)
+    {
+        return INVALID_SRV_HANDLE;
+    }
+
+    // Pack the 16 bit command at the beginning of the request data 
+    PutInt16(command_, 0, data_bytes, EN_Endian::MSB_First);
+    if (data_len_ > 0)
+    {
+        // Only if payload exists
+        PutOctets(data_ref_, data_len_, 0, &data_bytes[2]);
+    }
+
+    return LaunchCommand(channel_, 31, priority_, deadline_ms_, handler_, context_,
+        data_bytes, (TY_Byte)(data_len_ + 2), bytes_of_unique_id_);
+}
+
+
+// Service handling
+void CHartMaster::FetchConfirmation(WRD_Handle channel_,
+    SRV_Handle service_,
+    TY_Confirmation* conf_data_)
+{
+    CChannel* channel = NULL;
+    CService* p_service = NULL;
+
+    // Note: No lock required, once completed the
+    // service belongs to the caller
+    channel = PinChannel(channel_);
+    if ((channel != NULL) && (channel->IsValidService(service_) == EN_Bool::TRUE8))
+    {
+        p_service = channel->GetServicePtr(service_);
+        // Wait until the kernel has passed back the service
+        if (channel->IsServiceCompleted(service_) == EN_Bool::FALSE8)
         {
-            conf_data_->SrvResultCode = EN_SRV_Result::NO_DEV_RESP;
-            conf_data_->UsedRetries = p_service->GetUsedRetries();
+            conf_data_->SrvResultCode = EN_SRV_Result::IN_PROGRESS;
             conf_data_->DataLen = 0;
-            CChannel::FreeService(service_);
-            COSAL::Unlock();
-            return;
         }
-
-        conf_data_->SrvResultCode = EN_SRV_Result::SUCCESSFUL;
-        conf_data_->RespCode1 = p_service->GetRespCode1();
-        conf_data_->RespCode2 = p_service->GetRespCode2();
-        conf_data_->Cmd = p_service->GetRespCmd();
-        conf_data_->DeviceInBurstMode = p_service->GetDeviceInBurstMode();
-        conf_data_->UsedRetries = p_service->GetUsedRetries();
-        conf_data_->SrvDuration = p_service->GetDuration();
-        conf_data_->DataLen = p_service->GetRespData(conf_data_->BytesOfData);
-        if (p_service->GetRespCmd() == 31)
+        else
         {
-            // Handle extended command
-            if (conf_data_->RespCode1 != 64)
-            {
-                if (conf_data_->DataLen < 2)
-                {
-                    // Extended command format error
-                    conf_data_->SrvResultCode = EN_SRV_Result::TOO_FEW_DATA_BYTES;
-                    conf_data_->ExtCommand = 0xffff;
-                }
-                else
-                {
-                    TY_Byte u8_DataLen = (TY_Byte)(conf_data_->DataLen - 2);
-
-                    // Extended command: correct data and data length
-                    conf_data_->ExtCommand = CCoding::PickWord(0, conf_data_->BytesOfData, EN_Endian::MSB_First);
-                    if (u8_DataLen > 0)
-                    {
-                        // Pull the data two octets foreward
-                        COSAL::CMem::Copy(conf_data_->BytesOfData, &conf_data_->BytesOfData[2], u8_DataLen);
-                    }
-
-                    conf_data_->DataLen = u8_DataLen;
-                }
-            }
+            p_service->GetConfirmation(conf_data_);
+            channel->FreeService(service_);
         }
-        
-        CChannel::FreeService(service_);
     }
     else
     {
@@ -411,14 +841,386 @@ void CHartMaster::FetchConfirmation(SRV_Handle service_,
         conf_data_->DataLen = 0;
     }
 
-    COSAL::Unlock();
+    if (channel != NULL)
+    {
+        channel->Unpin();
+    }
+}
+
+EN_Bool CHartMaster::ViewConfirmation(WRD_Handle channel_,
+    SRV_Handle service_,
+    TY_ConfirmationView* view_)
+{
+    CChannel* channel = NULL;
+    EN_Bool   result = EN_Bool::FALSE8;
+
+    // Note: No lock required, once completed the
+    // service belongs to the caller
+    channel = PinChannel(channel_);
+    view_->SrvResultCode = EN_SRV_Result::EMPTY;
+    view_->DataLen = 0;
+    view_->Data = NULL;
+    if (channel == NULL)
+    {
+        return EN_Bool::FALSE8;
+    }
+
+    if (channel->IsValidService(service_) == EN_Bool::TRUE8)
+    {
+        if (channel->IsServiceCompleted(service_) == EN_Bool::FALSE8)
+        {
+            view_->SrvResultCode = EN_SRV_Result::IN_PROGRESS;
+        }
+        else
+        {
+            // The service keeps the frame until it is released
+            channel->GetServicePtr(service_)->GetConfirmationView(view_);
+            result = EN_Bool::TRUE8;
+        }
+    }
+
+    channel->Unpin();
+    return result;
+}
+
+void CHartMaster::ReleaseService(WRD_Handle channel_, SRV_Handle service_)
+{
+    CChannel* channel = PinChannel(channel_);
+
+    if (channel != NULL)
+    {
+        channel->ReleaseService(service_);
+        channel->Unpin();
+    }
+}
+
+EN_Bool CHartMaster::IsServiceCompleted(WRD_Handle channel_, SRV_Handle service_)
+{
+    CChannel* channel = PinChannel(channel_);
+    EN_Bool   result = EN_Bool::TRUE8;    // Nothing to wait for
+
+    if (channel != NULL)
+    {
+        result = channel->IsServiceCompleted(service_);
+        channel->Unpin();
+    }
+
+    return result;
+}
+
+EN_Bool CHartMaster::WaitForService(WRD_Handle channel_, SRV_Handle service_, TY_DWord timeout_ms_)
+{
+    CChannel* channel = PinChannel(channel_);
+    EN_Bool   result = EN_Bool::FALSE8;
+
+    if (channel != NULL)
+    {
+        result = channel->WaitForService(service_, timeout_ms_);
+        channel->Unpin();
+    }
+
+    return result;
+}
+
+PTR_Handle CHartMaster::GetCompletionHandle(WRD_Handle channel_)
+{
+    CChannel*  channel = PinChannel(channel_);
+    PTR_Handle result = NULL;
+
+    if (channel != NULL)
+    {
+        result = channel->GetCompletionHandle();
+        channel->Unpin();
+    }
+
+    return result;
+}
+
+// Batch handling
+WRD_Handle CHartMaster::LaunchBatch(WRD_Handle channel_,
+    TY_BatchRequest* requests_,
+    TY_Word num_requests_,
+    TY_CompletionHandler handler_,
+    void* context_)
+{
+    CChannel*  channel = PinChannel(channel_);
+    WRD_Handle h_batch = INVALID_WRD_HANDLE;
+
+    if (channel == NULL)
+    {
+        return INVALID_WRD_HANDLE;
+    }
+
+    if (channel->IsOpen() == EN_Bool::TRUE8)
+    {
+        h_batch = channel->LaunchBatch(requests_, num_requests_, handler_, context_);
+    }
+
+    channel->Unpin();
+    return h_batch;
+}
+
+EN_Bool CHartMaster::IsBatchCompleted(WRD_Handle channel_, WRD_Handle batch_)
+{
+    CChannel* channel = PinChannel(channel_);
+    EN_Bool   result = EN_Bool::FALSE8;
+
+    if (channel != NULL)
+    {
+        result = channel->IsBatchCompleted(batch_);
+        channel->Unpin();
+    }
+
+    return result;
+}
+
+EN_Bool CHartMaster::WaitForBatch(WRD_Handle channel_, WRD_Handle batch_, TY_DWord timeout_ms_)
+{
+    CChannel* channel = PinChannel(channel_);
+    EN_Bool   result = EN_Bool::FALSE8;
+
+    if (channel != NULL)
+    {
+        result = channel->WaitForBatch(batch_, timeout_ms_);
+        channel->Unpin();
+    }
+
+    return result;
+}
+
+void CHartMaster::ReleaseBatch(WRD_Handle channel_, WRD_Handle batch_)
+{
+    CChannel* channel = PinChannel(channel_);
+
+    if (channel != NULL)
+    {
+        channel->ReleaseBatch(batch_);
+        channel->Unpin();
+    }
+}
+
+// Prepared requests
+WRD_Handle CHartMaster::PrepareRequest(WRD_Handle channel_,
+    TY_Word  command_,
+    TY_Byte* data_ref_,
+    TY_Byte  data_len_,
+    TY_Byte* bytes_of_unique_id_)
+{
+    CChannel*  channel = PinChannel(channel_);
+    WRD_Handle result = INVALID_WRD_HANDLE;
+
+    if (channel != NULL)
+    {
+        result = channel->PrepareRequest(command_, data_ref_, data_len_, bytes_of_unique_id_);
+        channel->Unpin();
+    }
+
+    return result;
+}
+
+EN_Bool CHartMaster::UpdatePreparedData(WRD_Handle channel_,
+    WRD_Handle prepared_,
+    TY_Byte  offset_,
+    TY_Byte* data_ref_,
+    TY_Byte  len_)
+{
+    CChannel* channel = PinChannel(channel_);
+    EN_Bool   result = EN_Bool::FALSE8;
+
+    if (channel != NULL)
+    {
+        result = channel->UpdatePreparedData(prepared_, offset_, data_ref_, len_);
+        channel->Unpin();
+    }
+
+    return result;
+}
+
+SRV_Handle CHartMaster::LaunchPrepared(WRD_Handle channel_, WRD_Handle prepared_, EN_Wait qos_)
+{
+    SRV_Handle h_service = LaunchPrepared(channel_, prepared_, NULL, NULL);
+
+    if ((qos_ == EN_Wait::WAIT) && (h_service != INVALID_SRV_HANDLE))
+    {
+        /* Wait for service completion */
+        WaitForService(channel_, h_service, MAX_SERVICE_WAIT_TIME);
+    }
+
+    return h_service;
+}
+
+SRV_Handle CHartMaster::LaunchPrepared(WRD_Handle channel_,
+    WRD_Handle prepared_,
+    TY_CompletionHandler handler_,
+    void*    context_)
+{
+    CChannel*  channel = NULL;
+    SRV_Handle h_service = INVALID_SRV_HANDLE;
+
+    channel = PinChannel(channel_);
+    if (channel == NULL)
+    {
+        return INVALID_SRV_HANDLE;
+    }
+
+    if (channel->IsOpen() == EN_Bool::TRUE8)
+    {
+        h_service = channel->LaunchPrepared(prepared_, handler_, context_);
+    }
+
+    if (h_service != INVALID_SRV_HANDLE)
+    {
+        // Pass the access of the service to the protocol kernel
+        channel->SetServiceOwner(h_service, EN_Owner::PROTOCOL);
+    }
+
+    channel->Unpin();
+    return h_service;
+}
+
+void CHartMaster::ReleasePrepared(WRD_Handle channel_, WRD_Handle prepared_)
+{
+    CChannel* channel = PinChannel(channel_);
+
+    if (channel != NULL)
+    {
+        channel->ReleasePrepared(prepared_);
+        channel->Unpin();
+    }
+}
+
+
+// Default channel
+EN_Bool CHartMaster::OpenChannel(TY_Word port_number_, EN_CommType type_)
+{
+    return OpenChannel(DEFAULT_CHANNEL, port_number_, type_);
+}
+
+void CHartMaster::CloseChannel()
+{
+    CloseChannel(DEFAULT_CHANNEL);
+}
+
+void CHartMaster::GetConfiguration(TY_Configuration* config_)
+{
+    GetConfiguration(DEFAULT_CHANNEL, config_);
+}
+
+void CHartMaster::SetConfiguration(TY_Configuration* config_)
+{
+    SetConfiguration(DEFAULT_CHANNEL, config_);
+}
+
+EN_Bool CHartMaster::SetNumServices(TY_Word num_services_)
+{
+    return SetNumServices(DEFAULT_CHANNEL, num_services_);
+}
+
+TY_Word CHartMaster::GetNumServices()
+{
+    return GetNumServices(DEFAULT_CHANNEL);
+}
+
+TY_Word CHartMaster::GetHartIpStatus()
+{
+    return GetHartIpStatus(DEFAULT_CHANNEL);
+}
+
+SRV_Handle CHartMaster::ConnectByAddr(TY_Byte address_, EN_Wait qos_, TY_Byte num_retries_)
+{
+    return ConnectByAddr(DEFAULT_CHANNEL, address_, qos_, num_retries_);
+}
+
+void CHartMaster::FetchConnection(SRV_Handle service_, TY_Connection* connection_)
+{
+    FetchConnection(DEFAULT_CHANNEL, service_, connection_);
+}
+
+SRV_Handle CHartMaster::LaunchCommand(TY_Byte command_,
+    EN_Wait qos_,
+    TY_Byte* data_ref_,
+    TY_Byte data_len_,
+    TY_Byte* bytes_of_unique_id_)
+{
+    return LaunchCommand(DEFAULT_CHANNEL, command_, qos_, data_ref_, data_len_, bytes_of_unique_id_);
+}
+
+SRV_Handle CHartMaster::LaunchExtCommand(
+    TY_Word  command_,
+    EN_Wait  qos_,
+    TY_Byte* data_ref_,
+    TY_Byte  data_len_,
+    TY_Byte* bytes_of_unique_id_)
+{
+    return LaunchExtCommand(DEFAULT_CHANNEL, command_, qos_, data_ref_, data_len_, bytes_of_unique_id_);
+}
+
+void CHartMaster::FetchConfirmation(SRV_Handle service_,
+    TY_Confirmation* conf_data_)
+{
+    FetchConfirmation(DEFAULT_CHANNEL, service_, conf_data_);
+}
+
+EN_Bool CHartMaster::ViewConfirmation(SRV_Handle service_,
+    TY_ConfirmationView* view_)
+{
+    return ViewConfirmation(DEFAULT_CHANNEL, service_, view_);
+}
+
+void CHartMaster::ReleaseService(SRV_Handle service_)
+{
+    ReleaseService(DEFAULT_CHANNEL, service_);
 }
 
 EN_Bool CHartMaster::IsServiceCompleted(SRV_Handle service_)
 {
-    return CChannel::IsServiceCompleted(service_);
+    return IsServiceCompleted(DEFAULT_CHANNEL, service_);
+}
+
+EN_Bool CHartMaster::WaitForService(SRV_Handle service_, TY_DWord timeout_ms_)
+{
+    return WaitForService(DEFAULT_CHANNEL, service_, timeout_ms_);
 }
 
+// Internal handling
+CChannel* CHartMaster::GetChannel(WRD_Handle channel_)
+{
+    // Note: The channel may be deleted by another thread
+    // unless the caller holds the lock or a pin
+    TY_Word idx = channel_ & CHANNEL_INDEX_MASK;
+
+    if ((channel_ == INVALID_WRD_HANDLE) || (idx >= MAX_NUM_CHANNELS) ||
+        (m_handles[idx] != channel_))
+    {
+        return NULL;
+    }
+
+    return m_channels[idx];
+}
+
+CChannel* CHartMaster::PinChannel(WRD_Handle channel_)
+{
+    // Note: No lock required. The lookup is announced first,
+    // a channel which is deleted meanwhile is either not
+    // found or released after the pin.
+    TY_Word   idx = channel_ & CHANNEL_INDEX_MASK;
+    CChannel* channel;
+
+    if (idx >= MAX_NUM_CHANNELS)
+    {
+        return NULL;
+    }
+
+    m_num_lookups[idx]++;
+    channel = GetChannel(channel_);
+    if (channel != NULL)
+    {
+        channel->Pin();
+    }
+
+    m_num_lookups[idx]--;
+    return channel;
+}
 
 // Encoding
 void CHartMaster::PutInt8(TY_Byte data_, TY_Byte offset_,
@@ -21,6 +21,7 @@
 #ifndef __hartm_uartIface_h__
 #define __hartm_uartIface_h__
 
+#include <atomic>
 #include "OSAL.h"
 #include "WbHartUser.h"
 #include "HartFrame.h"
@@ -32,22 +33,148 @@
 class CHartMaster
 {
 public:
+    // The channel which is used by the functions without a channel handle
+    static const WRD_Handle DEFAULT_CHANNEL = 0;
+    // Latency statistics of any command
+    static const TY_Word ALL_COMMANDS = 0xffff;
+    // Burst subscription to any change of the payload
+    static const TY_Byte NO_BURST_VALUE = CBurstCache::NO_VALUE;
+
+    // Channel objects
+    static WRD_Handle    CreateChannel();
+    static void          DeleteChannel(WRD_Handle channel_);
+
     // Channel handling
+    static EN_Bool        OpenChannel(WRD_Handle channel_, TY_Word port_number_, EN_CommType type_);
+    static void          CloseChannel(WRD_Handle channel_);
     static EN_Bool        OpenChannel(TY_Word port_number_, EN_CommType type_);
     static void          CloseChannel();
 
     // Configuration
+    static void      GetConfiguration(WRD_Handle channel_, TY_Configuration* config_);
+    static void      SetConfiguration(WRD_Handle channel_, TY_Configuration* config_);
     static void      GetConfiguration(TY_Configuration* config_);
     static void      SetConfiguration(TY_Configuration* config_);
+    // Size of the service pool, applied by the next OpenChannel()
+    static EN_Bool     SetNumServices(WRD_Handle channel_, TY_Word num_services_);
+    static TY_Word     GetNumServices(WRD_Handle channel_);
+    static EN_Bool     SetNumServices(TY_Word num_services_);
+    static TY_Word     GetNumServices();
+    // Simulated devices of a loopback channel, applied by the next OpenChannel()
+    static EN_Bool  SetLoopbackConfig(WRD_Handle channel_, TY_LoopbackConfig* config_);
+    static void     GetLoopbackConfig(WRD_Handle channel_, TY_LoopbackConfig* config_);
 
     // Information
+    static TY_Word GetHartIpStatus(WRD_Handle channel_);
     static TY_Word GetHartIpStatus();
 
+    // Latency statistics of the completed services, recorded by the
+    // kernel per device and command. A query sums up the entries of
+    // the device (NULL: any device) and the command (ALL_COMMANDS).
+    static EN_Bool    GetLatencyStats(WRD_Handle channel_, TY_Byte* bytes_of_unique_id_,
+        TY_Word command_, TY_LatencyStats* stats_);
+    static TY_Word    GetNumLatencyEntries(WRD_Handle channel_);
+    static EN_Bool    FetchLatencyEntry(WRD_Handle channel_, TY_Word index_, TY_LatencyStats* stats_);
+    static void       ResetLatencyStats(WRD_Handle channel_);
+
+    // Health of the devices as recorded by the kernel. A device which
+    // fails gets fewer retries, requests to a device which is offline
+    // are confirmed with DEVICE_OFFLINE without being sent, except a
+    // probe now and then and command 0.
+    static EN_Bool    GetDeviceHealth(WRD_Handle channel_, TY_Byte* bytes_of_unique_id_, TY_DeviceHealth* health_);
+    static TY_Word    GetNumHealthEntries(WRD_Handle channel_);
+    static EN_Bool    FetchHealthEntry(WRD_Handle channel_, TY_Word index_, TY_DeviceHealth* health_);
+    static void       ResetDeviceHealth(WRD_Handle channel_);
+    // Applied at once, IsAdaptive FALSE8: The health is recorded only
+    static EN_Bool      SetHealthConfig(WRD_Handle channel_, TY_HealthConfig* config_);
+    static void         GetHealthConfig(WRD_Handle channel_, TY_HealthConfig* config_);
+
+    // Latest burst response of a device and a command, read without
+    // a lock and without a request on the bus. FALSE8: None received.
+    static EN_Bool      ReadBurstData(WRD_Handle channel_, TY_Byte* bytes_of_unique_id_,
+        TY_Word command_, TY_BurstData* data_);
+    static TY_Word    GetNumBurstEntries(WRD_Handle channel_);
+    static EN_Bool      FetchBurstEntry(WRD_Handle channel_, TY_Word index_, TY_BurstData* data_);
+    static void         ResetBurstData(WRD_Handle channel_);
+    // Change driven delivery: The handler is called by the kernel with the
+    // first burst and whenever the data changed. value_offset_ selects a
+    // float of the payload which must move by deadband_ (NO_BURST_VALUE:
+    // any change of the payload). Changed response codes are passed always.
+    // The handle of an ended subscription is not valid anymore.
+    static WRD_Handle   SubscribeBurst(WRD_Handle channel_, TY_Byte* bytes_of_unique_id_, TY_Word command_,
+        TY_Byte value_offset_, TY_Float deadband_, TY_BurstHandler handler_, void* context_);
+    static void       UnsubscribeBurst(WRD_Handle channel_, WRD_Handle subscription_);
+
     // Connection
+    static SRV_Handle   ConnectByAddr(WRD_Handle channel_, TY_Byte address_, EN_Wait qos_, TY_Byte num_retries_);
+    static void       FetchConnection(WRD_Handle channel_, SRV_Handle handle_, TY_Connection* connection_);
     static SRV_Handle   ConnectByAddr(TY_Byte address_, EN_Wait qos_, TY_Byte num_retries_);
     static void       FetchConnection(SRV_Handle handle_, TY_Connection* connection_);
 
     // Commands
+    static SRV_Handle LaunchCommand(
+        WRD_Handle channel_,
+        TY_Byte  command_,
+        EN_Wait  qos_,
+        TY_Byte* data_ref_,
+        TY_Byte  data_len_,
+        TY_Byte* bytes_of_unique_id_);
+
+    static SRV_Handle LaunchExtCommand(
+        WRD_Handle channel_,
+        TY_Word  command_,
+        EN_Wait  qos_,
+        TY_Byte* data_ref_,
+        TY_Byte  data_len_,
+        TY_Byte* bytes_of_unique_id_);
+
+    // The handler is called by the kernel thread on completion. A
+    // request which the kernel could not take is returned completed
+    // with RESOURCE_ERROR at once, without a call of the handler.
+    static SRV_Handle LaunchCommand(
+        WRD_Handle channel_,
+        TY_Byte  command_,
+        TY_CompletionHandler handler_,
+        void*    context_,
+        TY_Byte* data_ref_,
+        TY_Byte  data_len_,
+        TY_Byte* bytes_of_unique_id_);
+
+    static SRV_Handle LaunchExtCommand(
+        WRD_Handle channel_,
+        TY_Word  command_,
+        TY_CompletionHandler handler_,
+        void*    context_,
+        TY_Byte* data_ref_,
+        TY_Byte  data_len_,
+        TY_Byte* bytes_of_unique_id_);
+
+    // Scheduled by the kernel: The priority classes are served in order,
+    // within a class the earliest deadline first. A request which is not
+    // on its way deadline_ms_ after the launch is dropped and confirmed
+    // with DEADLINE_MISSED, 0: No deadline. The others are CYCLIC.
+    static SRV_Handle LaunchCommand(
+        WRD_Handle channel_,
+        TY_Byte  command_,
+        EN_Priority priority_,
+        TY_DWord deadline_ms_,
+        TY_CompletionHandler handler_,
+        void*    context_,
+        TY_Byte* data_ref_,
+        TY_Byte  data_len_,
+        TY_Byte* bytes_of_unique_id_);
+
+    static SRV_Handle LaunchExtCommand(
+        WRD_Handle channel_,
+        TY_Word  command_,
+        EN_Priority priority_,
+        TY_DWord deadline_ms_,
+        TY_CompletionHandler handler_,
+        void*    context_,
+        TY_Byte* data_ref_,
+        TY_Byte  data_len_,
+        TY_Byte* bytes_of_unique_id_);
+
     static SRV_Handle LaunchCommand(
         TY_Byte  command_,
         EN_Wait  qos_,
@@ -63,10 +190,72 @@ public:
         TY_Byte* bytes_of_unique_id_);
 
     // Service handling
+    static EN_Bool IsServiceCompleted(WRD_Handle channel_, SRV_Handle service_);
+    static EN_Bool WaitForService(WRD_Handle channel_, SRV_Handle service_, TY_DWord timeout_ms_);
+    // Signaled on every completed service of the channel
+    // (Linux: eventfd, Windows: event handle)
+    static PTR_Handle GetCompletionHandle(WRD_Handle channel_);
+    static void FetchConfirmation(
+        WRD_Handle channel_,
+        SRV_Handle service_,
+        TY_Confirmation* conf_data_);
+    // Like FetchConfirmation, but the data is not copied. The
+    // view is valid until the service is released.
+    static EN_Bool ViewConfirmation(
+        WRD_Handle channel_,
+        SRV_Handle service_,
+        TY_ConfirmationView* view_);
+    static void ReleaseService(WRD_Handle channel_, SRV_Handle service_);
     static EN_Bool IsServiceCompleted(SRV_Handle service_);
+    static EN_Bool WaitForService(SRV_Handle service_, TY_DWord timeout_ms_);
     static void FetchConfirmation(
         SRV_Handle service_,
         TY_Confirmation* conf_data_);
+    static EN_Bool ViewConfirmation(
+        SRV_Handle service_,
+        TY_ConfirmationView* view_);
+    static void ReleaseService(SRV_Handle service_);
+
+    // Batch handling
+    // The requests are sent one after the other without a gap.
+    // The array has to be kept until the batch is completed,
+    // the results are written to the confirmations of the
+    // requests. The handler receives the handle of the batch.
+    // A batch with a request of too much data is rejected.
+    static WRD_Handle LaunchBatch(
+        WRD_Handle channel_,
+        TY_BatchRequest* requests_,
+        TY_Word num_requests_,
+        TY_CompletionHandler handler_,
+        void* context_);
+    static EN_Bool IsBatchCompleted(WRD_Handle channel_, WRD_Handle batch_);
+    static EN_Bool WaitForBatch(WRD_Handle channel_, WRD_Handle batch_, TY_DWord timeout_ms_);
+    static void ReleaseBatch(WRD_Handle channel_, WRD_Handle batch_);
+
+    // Prepared requests
+    // A request which is sent repeatedly is encoded only once,
+    // each launch just copies the frame. Offset and length of an
+    // update refer to the data of the request. A prepared request
+    // must not be used by several threads at a time.
+    static WRD_Handle PrepareRequest(
+        WRD_Handle channel_,
+        TY_Word  command_,
+        TY_Byte* data_ref_,
+        TY_Byte  data_len_,
+        TY_Byte* bytes_of_unique_id_);
+    static EN_Bool UpdatePreparedData(
+        WRD_Handle channel_,
+        WRD_Handle prepared_,
+        TY_Byte  offset_,
+        TY_Byte* data_ref_,
+        TY_Byte  len_);
+    static SRV_Handle LaunchPrepared(WRD_Handle channel_, WRD_Handle prepared_, EN_Wait qos_);
+    static SRV_Handle LaunchPrepared(
+        WRD_Handle channel_,
+        WRD_Handle prepared_,
+        TY_CompletionHandler handler_,
+        void*    context_);
+    static void ReleasePrepared(WRD_Handle channel_, WRD_Handle prepared_);
 
     // Encoding
     static void PutInt8(TY_Byte data_, TY_Byte offset_,
@@ -114,6 +303,26 @@ public:
 
     // Internal handling
     static void FastCyclicHandler(TY_Word time_ms_);
+    static CChannel*   GetChannel(WRD_Handle channel_);
+
+private:
+    // A channel handle carries the index of the channel (low bits)
+    // and a generation (high bits), which is advanced on every
+    // creation. So a handle which is used after the channel was
+    // deleted is rejected.
+    static const TY_Word CHANNEL_INDEX_BITS = 8;
+    static const TY_Word CHANNEL_INDEX_MASK = (1 << CHANNEL_INDEX_BITS) - 1;
+
+    // Channel 0 is always present, the others are created on demand
+    static CChannel    m_default_channel;
+    static std::atomic<CChannel*>  m_channels[MAX_NUM_CHANNELS];
+    static std::atomic<WRD_Handle> m_handles[MAX_NUM_CHANNELS];
+    // Lookups without the lock which are running, a deleted
+    // channel is not released before they are done
+    static std::atomic<TY_Word>    m_num_lookups[MAX_NUM_CHANNELS];
+
+    // The calls without the lock pin the channel while they use it
+    static CChannel*   PinChannel(WRD_Handle channel_);
 };
 
 #endif // __hartm_uartIface_h__
\ No newline at end of file
@@ -89,7 +89,7 @@ typedef struct ty_connection
     // Service completion code
     // 0: Not active, 1: No dev response, 2: Some comm err, 3: Invalid handle
     // 4: Service in progress, 5: Successfully completed, 6: Out of resource,
-    // 7: Reserved for cmd 31
+    // 7: Reserved for cmd 31, 9: Deadline missed, 10: Device offline
     TY_Byte            SrvResultCode;
 
     // Command specific response code
@@ -150,7 +150,7 @@ typedef struct ty_confirmation
     // Service completion code
     // 0: Not active, 1: No dev response, 2: Some comm err, 3: Invalid handle
     // 4: Service in progress, 5: Successfully completed, 6: Out of resource,
-    // 7: Reserved for cmd 31
+    // 7: Reserved for cmd 31, 9: Deadline missed, 10: Device offline
     EN_SRV_Result SrvResultCode;
 
     // Number of retries to complete service
@@ -175,6 +175,300 @@ typedef struct ty_confirmation
     TY_Byte         BytesOfData[MAX_PAYLOAD_SIZE];
 }
 TY_Confirmation;
+
+// One request of a batch, the confirmation is filled
+// in by the kernel as soon as the request is done
+typedef struct ty_batch_request
+{
+    // Command number, extended commands (> 255) are
+    // sent by command 31
+    TY_Word             Command;
+
+    // Address of the device
+    TY_Byte     BytesOfUniqueID[5];
+
+    // Length of payload data, an extended command takes
+    // two bytes of the payload (MAX_PAYLOAD_SIZE - 2)
+    TY_Byte             DataLen;
+
+    // Byte array for the payload data
+    TY_Byte         BytesOfData[MAX_PAYLOAD_SIZE];
+
+    // Result of the request
+    TY_Confirmation Confirmation;
+}
+TY_BatchRequest;
+
+// The response to a command without a copy of the data.
+// Data points to the received frame, which is kept until
+// the service is released.
+typedef struct ty_confirmation_view
+{
+    // Received command
+    TY_Byte                 Cmd;
+
+    // Command specific response code (response byte 1)
+    TY_Byte           RespCode1;
+
+    // Device status (response byte 2)
+    TY_Byte           RespCode2;
+
+    // Service completion code, as in TY_Confirmation
+    EN_SRV_Result SrvResultCode;
+
+    // Number of retries to complete service
+    TY_Byte         UsedRetries;
+
+    // Device in burst mode indication, 1: Device in burst mode
+    EN_Bool   DeviceInBurstMode;
+
+    // Duration of the service conduction in milliseconds
+    TY_Word         SrvDuration;
+
+    // The 16 bit command code
+    TY_Word          ExtCommand;
+
+    // Length of payload data
+    TY_Byte             DataLen;
+
+    // Payload data, NULL if there is none
+    const TY_Byte*         Data;
+}
+TY_ConfirmationView;
+
+// Configuration of a loopback channel (EN_CommType::LOOPBACK).
+// The master talks to simulated devices on a virtual wire,
+// no hardware is required.
+typedef struct ty_loopback_config
+{
+    // Number of simulated devices, they answer at the polling
+    // addresses 0, 1, ... (1..MAX_NUM_LOOP_DEVICES), default: 1
+    TY_Byte          NumDevices;
+
+    // TRUE8: The octets take their time on the wire as given by
+    //        the baud rate of the configuration (default)
+    // FALSE8: Full speed, a frame arrives at once and the bus
+    //         times (RT2, HOLD) expire at once if a request waits
+    EN_Bool       ModelBaudRate;
+
+    // Time from the end of a request to the start of the
+    // response in milliseconds, default: 2
+    TY_Byte      TurnaroundTime;
+
+    // Each device sends a burst message with this period in
+    // milliseconds, whenever the wire is quiet. 0: The devices
+    // are not in burst mode (default)
+    TY_Word         BurstPeriod;
+
+    // Command of the burst messages (1, 2, 3 or 9 with the
+    // dynamic variables), default: 1
+    TY_Byte        BurstCommand;
+}
+TY_LoopbackConfig;
+
+// Distribution of one phase of the transactions in milliseconds.
+// The percentiles are taken from a histogram with buckets which
+// grow with the value (HDR style), they are accurate to 1/8.
+typedef struct ty_latency
+{
+    // Number of transactions which reached the phase
+    TY_DWord              Count;
+
+    TY_DWord                Min;
+    TY_DWord                Max;
+    TY_DWord               Mean;
+    TY_DWord                P50;
+    TY_DWord                P90;
+    TY_DWord                P99;
+}
+TY_Latency;
+
+// Latency statistics of the transactions with a device
+// and a command, or a sum of them
+typedef struct ty_latency_stats
+{
+    // Polling address of the device, 0xff if it was addressed
+    // by the unique ID or if the stats cover several devices
+    TY_Byte         PollAddress;
+
+    // Unique ID of the device (if addressed by it)
+    TY_Byte     BytesOfUniqueID[5];
+
+    // Command number, 0xffff if the stats cover all commands
+    TY_Word             Command;
+
+    // Number of completed and failed transactions
+    TY_DWord    NumTransactions;
+    TY_DWord          NumFailed;
+
+    // Number of transactions by the retries they took, the
+    // last entry counts all with more retries
+    TY_DWord    NumByRetries[NUM_LATENCY_RETRY_COUNTS];
+
+    // From the launch until layer 2 takes the request
+    TY_Latency        QueueWait;
+
+    // From then until the first transmission starts, i.e.
+    // the time of layer 2 in WATCHING and ENABLED
+    TY_Latency          BusWait;
+
+    // Transmission of the request (last attempt)
+    TY_Latency           TxTime;
+
+    // End of the request until the start of the response
+    TY_Latency       Turnaround;
+
+    // From the launch until the service is completed
+    TY_Latency            Total;
+}
+TY_LatencyStats;
+
+// Transactions of a device and a command as found in a
+// capture by the replay, or a sum of them
+typedef struct ty_replay_stats
+{
+    // Polling address of the device, 0xff if it was addressed
+    // by the unique ID or if the stats cover several devices
+    TY_Byte         PollAddress;
+
+    // Unique ID of the device (if addressed by it)
+    TY_Byte     BytesOfUniqueID[5];
+
+    // Command number, extended commands by their 16 bit number,
+    // 0xffff if the stats cover all commands
+    TY_Word             Command;
+
+    // Requests and the responses of the device
+    TY_DWord        NumRequests;
+    TY_DWord       NumResponses;
+
+    // Requests followed by another request, a broken
+    // frame or the end of the capture
+    TY_DWord     NumNoResponses;
+
+    // Responses with a communication error (response code 1,
+    // bit 7) or with a command response code other than 0
+    TY_DWord      NumCommErrors;
+    TY_DWord    NumResponseCodes;
+
+    // Burst responses of the device
+    TY_DWord          NumBursts;
+
+    // From the end of the request to the start of the
+    // response in milliseconds, responses to a request
+    // which was not captured are not taken into account
+    TY_DWord      MinTurnaround;
+    TY_DWord      MaxTurnaround;
+    TY_DWord     MeanTurnaround;
+
+    // Time of the first and the last frame in milliseconds
+    // (pcapng: since 1970, monitor: time of the recording)
+    TY_UInt64         FirstTime;
+    TY_UInt64          LastTime;
+}
+TY_ReplayStats;
+
+// Latest burst response of a device and a command
+typedef struct ty_burst_data
+{
+    // Polling address of the device, 0xff if it
+    // was addressed by the unique ID
+    TY_Byte         PollAddress;
+
+    // Unique ID of the device (if addressed by it)
+    TY_Byte     BytesOfUniqueID[5];
+
+    // Command number, extended commands by their 16 bit number
+    TY_Word             Command;
+
+    // Number of burst responses received so far, a
+    // changed number tells that the data was updated
+    TY_DWord     SequenceNumber;
+
+    // Kernel time of the reception in milliseconds
+    TY_DWord               Time;
+
+    // Command specific response code
+    TY_Byte           RespCode1;
+
+    // Device status
+    TY_Byte           RespCode2;
+
+    // Length of payload data (without the
+    // number of an extended command)
+    TY_Byte             DataLen;
+
+    // Byte array for the payload data
+    TY_Byte         BytesOfData[MAX_CYCLIC_DATA_SIZE];
+}
+TY_BurstData;
+
+// Health of a device as seen by the kernel, which adapts the
+// retries of the requests to it and stops sending requests to
+// a device which is offline
+typedef struct ty_device_health
+{
+    // Polling address of the device, 0xff if it
+    // was addressed by the unique ID
+    TY_Byte         PollAddress;
+
+    // Unique ID of the device (if addressed by it)
+    TY_Byte     BytesOfUniqueID[5];
+
+    // Completed services and those without a valid response
+    TY_DWord        NumServices;
+    TY_DWord          NumFailed;
+
+    // Services which were not sent as the device was offline
+    TY_DWord         NumSkipped;
+
+    // Failed attempts in per mille, smoothed over the
+    // last attempts (retries included)
+    TY_Word           ErrorRate;
+
+    // Smoothed device turnaround in milliseconds, 0 if no
+    // response was received yet
+    TY_DWord         Turnaround;
+
+    // Retries granted to the next request, 0xff: As configured
+    TY_Byte          MaxRetries;
+
+    // TRUE8: The device did not answer several services in a row,
+    //        only probes are sent until it answers again
+    EN_Bool           IsOffline;
+
+    // Time until the next probe of an offline device in milliseconds
+    TY_DWord          NextProbe;
+}
+TY_DeviceHealth;
+
+// Adaption of the kernel to the health of the devices of a channel
+typedef struct ty_health_config
+{
+    // TRUE8: The retries are limited and devices are taken offline (default)
+    // FALSE8: The health is recorded only
+    EN_Bool          IsAdaptive;
+
+    // Services in a row without a response until a device
+    // is offline (1..255), default: 3
+    TY_Byte     OfflineFailures;
+
+    // Time between the probes of an offline device in milliseconds,
+    // doubled with each probe which failed, default: 1000 up to 60000
+    TY_DWord         MinBackoff;
+    TY_DWord         MaxBackoff;
+}
+TY_HealthConfig;
 #pragma pack(pop)
 
+// Called by the kernel thread as soon as a service (or a batch)
+// is completed. The handler may fetch the result, but it must
+// return quickly.
+typedef void (*TY_CompletionHandler)(SRV_Handle service_, void* context_);
+
+// Called by the kernel thread when the burst data of a subscription
+// changed. The data is valid during the call only, the handler must
+// return quickly.
+typedef void (*TY_BurstHandler)(WRD_Handle subscription_, TY_BurstData* data_, void* context_);
+
 #endif // __wbhartm_structures_h__
\ No newline at end of file
@@ -29,15 +29,39 @@ static const TY_Byte MAX_CYCLIC_DATA_SIZE = 128;
 
 // Numbers of objects
 static const TY_Byte MAX_NUM_SERVICES = 10;
+static const TY_Word MAX_SERVICE_POOL_SIZE = 1000;
 static const TY_Byte MAX_NUM_PAYLOAD_BUFFERS = 20;
 static const TY_Byte MAX_NUM_TXRX_BUFFERS = 20;
-static const TY_Byte MAX_NUM_CYCLIC_BUFFERS = 10;
+// Devices and commands held by the burst cache
+static const TY_Byte MAX_NUM_CYCLIC_BUFFERS = 32;
+// Up to 64, the rest of a subscription handle is its generation
+static const TY_Byte MAX_NUM_BURST_SUBSCRIPTIONS = 64;
+// Burst devices whose timing is learned by the uart scheduler
+static const TY_Byte MAX_NUM_BURST_DEVICES = 16;
+static const TY_Word MAX_NUM_CHANNELS = 256;
+static const TY_Byte MAX_NUM_BATCHES = 4;
+static const TY_Byte MAX_NUM_PREPARED_REQUESTS = 32;
+static const TY_Byte MAX_NUM_LOOP_DEVICES = 16;
+
+// Timing
+static const TY_DWord MAX_SERVICE_WAIT_TIME = 5000;
 
 // Identifier
 static const TY_Byte MAX_COMPORT_ID = 254;
 
 // Monitor
 static const TY_Word MON_MAX_FRAME_DATA_SIZE = 256;
-static const TY_Word MON_MAX_NUM_FRAMES = 1000;
+// Bytes of the log of the frames, a power of two
+static const TY_DWord MON_LOG_SIZE = 256 * 1024;
+
+// Latency statistics
+static const TY_Byte MAX_NUM_LATENCY_ENTRIES = 32;
+static const TY_Byte NUM_LATENCY_RETRY_COUNTS = 8;
+
+// Health of the devices
+static const TY_Byte MAX_NUM_HEALTH_ENTRIES = 64;
+
+// Replay of captures
+static const TY_Word MAX_NUM_REPLAY_ENTRIES = 256;
 
 #endif // __wbhartuser_h__
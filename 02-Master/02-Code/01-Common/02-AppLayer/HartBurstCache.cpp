@@ -0,0 +1,392 @@
+/*
+ *          File: HartBurstCache.cpp (CBurstCache)
+ *                The kernel writes an entry in a few octets while its
+ *                sequence is odd. Readers copy the entry and check the
+ *                sequence afterwards, so they neither block the kernel
+ *                nor see a half written value. Extended commands are
+ *                filed under their 16 bit number. The handlers of the
+ *                subscriptions are called by the kernel under the lock,
+ *                so a subscription is never served after it was ended.
+ *
+ *        Author: Walter Borst
+ *
+ *        E-Mail: info@borst-automation.de
+ *          Home: https://www.borst-automation.de
+ *
+ * No Warranties: https://www.borst-automation.com/legal/warranty-disclaimer
+ *
+ * Copyright 2006-2025 Walter Borst, Cuxhaven, Germany
+ */
+
+#include <math.h>
+#include "HartBurstCache.h"
+#include "HartConsts.h"
+#include "HartCoding.h"
+
+// Methods
+CBurstCache::CBurstCache()
+{
+    static_assert(MAX_NUM_BURST_SUBSCRIPTIONS <= (SUBSCRIPTION_INDEX_MASK + 1), "Too many subscriptions for the handle");
+
+    for (TY_Word e = 0; e < MAX_NUM_CYCLIC_BUFFERS; e++)
+    {
+        m_entries[e].Sequence.store(0, std::memory_order_relaxed);
+    }
+
+    m_num_entries.store(0, std::memory_order_relaxed);
+    m_num_dropped.store(0, std::memory_order_relaxed);
+    m_free_subscriptions.Create(MAX_NUM_BURST_SUBSCRIPTIONS);
+    m_num_subscriptions = 0;
+    for (WRD_Handle e = 0; e < MAX_NUM_BURST_SUBSCRIPTIONS; e++)
+    {
+        m_subscriptions[e].IsUsed = EN_Bool::FALSE8;
+        m_subscriptions[e].Handle = INVALID_WRD_HANDLE;
+        m_free_subscriptions.Push(e);
+    }
+}
+
+void CBurstCache::Reset()
+{
+    m_lock.Lock();
+    m_num_entries.store(0, std::memory_order_release);
+    m_num_dropped.store(0, std::memory_order_relaxed);
+    m_lock.Unlock();
+}
+
+void CBurstCache::Store(CFrame* frame_)
+{
+    ST_Entry* entry;
+    TY_Byte   addr_mode = frame_->AddrMode;
+    TY_Byte   address[5] = { 0 };
+    TY_Word   command = frame_->Command;
+    TY_Byte*  data = frame_->PayloadData;
+    TY_Word   data_len = frame_->PayloadSize;
+    TY_Word   num_entries;
+    TY_DWord  sequence;
+
+    if (addr_mode == CHart::CAddrMode::UNIQUE)
+    {
+        frame_->GetUniqueID(address);
+    }
+    else
+    {
+        address[0] = frame_->GetShortAddr();
+    }
+
+    if (data_len > MAX_PAYLOAD_SIZE)
+    {
+        // Not more than the frame holds
+        data_len = MAX_PAYLOAD_SIZE;
+    }
+
+    if ((command == 31) && (data_len >= 2))
+    {
+        command = CCoding::PickWord(0, data, EN_Endian::MSB_First);
+        data += 2;
+        data_len -= 2;
+    }
+
+    if (data_len > MAX_CYCLIC_DATA_SIZE)
+    {
+        data_len = MAX_CYCLIC_DATA_SIZE;
+    }
+
+    m_lock.Lock();
+    num_entries = m_num_entries.load(std::memory_order_relaxed);
+    entry = FindEntry(addr_mode, address, command);
+    if (entry == NULL)
+    {
+        if (num_entries >= MAX_NUM_CYCLIC_BUFFERS)
+        {
+            m_num_dropped.fetch_add(1, std::memory_order_relaxed);
+            m_lock.Unlock();
+            return;
+        }
+
+        entry = &m_entries[num_entries];
+    }
+
+    sequence = entry->Sequence.load(std::memory_order_relaxed);
+    entry->Sequence.store(sequence + 1, std::memory_order_relaxed);
+    // Release: The odd sequence is seen before any of the new octets
+    std::atomic_thread_fence(std::memory_order_release);
+    if (entry == &m_entries[num_entries])
+    {
+        // A new entry, the reset may have left an old key behind
+        entry->AddrMode = addr_mode;
+        COSAL::CMem::Copy(entry->Address, address, 5);
+        entry->Command = command;
+        entry->NumUpdates = 0;
+    }
+
+    entry->NumUpdates++;
+    entry->Time = COSAL::CTimer::GetTime();
+    entry->RspCode1 = frame_->GetRspCode1();
+    entry->RspCode2 = frame_->GetRspCode2();
+    entry->DataLen = (TY_Byte)data_len;
+    COSAL::CMem::Copy(entry->Data, data, data_len);
+    entry->Sequence.store(sequence + 2, std::memory_order_release);
+    if (entry == &m_entries[num_entries])
+    {
+        m_num_entries.store(num_entries + 1, std::memory_order_release);
+    }
+
+    if ((m_num_subscriptions > 0) && (addr_mode == CHart::CAddrMode::UNIQUE))
+    {
+        Notify(entry);
+    }
+
+    m_lock.Unlock();
+}
+
+EN_Bool CBurstCache::Read(TY_Byte* bytes_of_unique_id_, TY_Word command_, TY_BurstData* data_)
+{
+    TY_Word num_entries = m_num_entries.load(std::memory_order_acquire);
+
+    for (TY_Word e = 0; e < num_entries; e++)
+    {
+        ST_Entry* entry = &m_entries[e];
+
+        // A first look at the key, it is checked again with the copy
+        if ((entry->Command == command_) && (entry->AddrMode == CHart::CAddrMode::UNIQUE) &&
+            (COSAL::CMem::IsEqual(entry->Address, bytes_of_unique_id_, 5) == EN_Bool::TRUE8))
+        {
+            ReadEntry(entry, data_);
+            if ((data_->Command == command_) && (data_->PollAddress == 0xff) &&
+                (COSAL::CMem::IsEqual(data_->BytesOfUniqueID, bytes_of_unique_id_, 5) == EN_Bool::TRUE8))
+            {
+                return EN_Bool::TRUE8;
+            }
+        }
+    }
+
+    return EN_Bool::FALSE8;
+}
+
+TY_Word CBurstCache::GetNumEntries()
+{
+    return m_num_entries.load(std::memory_order_acquire);
+}
+
+EN_Bool CBurstCache::FetchEntry(TY_Word index_, TY_BurstData* data_)
+{
+    if (index_ >= m_num_entries.load(std::memory_order_acquire))
+    {
+        return EN_Bool::FALSE8;
+    }
+
+    ReadEntry(&m_entries[index_], data_);
+    return EN_Bool::TRUE8;
+}
+
+TY_DWord CBurstCache::GetNumDropped()
+{
+    return m_num_dropped.load(std::memory_order_relaxed);
+}
+
+WRD_Handle CBurstCache::Subscribe(TY_Byte* bytes_of_unique_id_, TY_Word command_, TY_Byte value_offset_,
+    TY_Float deadband_, TY_BurstHandler handler_, void* context_)
+{
+    WRD_Handle       h_subscription = INVALID_WRD_HANDLE;
+    WRD_Handle       idx;
+    TY_Word          generation;
+    ST_Subscription* subscription;
+
+    if (handler_ == NULL)
+    {
+        return INVALID_WRD_HANDLE;
+    }
+
+    m_lock.Lock();
+    idx = m_free_subscriptions.Pop();
+    if (idx != INVALID_WRD_HANDLE)
+    {
+        subscription = &m_subscriptions[idx];
+        // The handles of the previous subscription get stale. An
+        // unused entry has an invalid handle and starts with 0.
+        generation = (TY_Word)(subscription->Handle >> SUBSCRIPTION_INDEX_BITS) + 1;
+        h_subscription = (WRD_Handle)((generation << SUBSCRIPTION_INDEX_BITS) | idx);
+        if (h_subscription == INVALID_WRD_HANDLE)
+        {
+            h_subscription = idx;
+        }
+
+        subscription->Handle = h_subscription;
+        COSAL::CMem::Copy(subscription->Address, bytes_of_unique_id_, 5);
+        subscription->Command = command_;
+        subscription->ValueOffset = value_offset_;
+        subscription->Deadband = (deadband_ < 0) ? -deadband_ : deadband_;
+        subscription->Handler = handler_;
+        subscription->Context = context_;
+        subscription->IsNotified = EN_Bool::FALSE8;
+        subscription->IsUsed = EN_Bool::TRUE8;
+        m_num_subscriptions++;
+    }
+
+    m_lock.Unlock();
+    return h_subscription;
+}
+
+void CBurstCache::Unsubscribe(WRD_Handle subscription_)
+{
+    WRD_Handle idx = subscription_ & SUBSCRIPTION_INDEX_MASK;
+
+    m_lock.Lock();
+    if ((subscription_ != INVALID_WRD_HANDLE) && (idx < MAX_NUM_BURST_SUBSCRIPTIONS) &&
+        (m_subscriptions[idx].IsUsed == EN_Bool::TRUE8) &&
+        (m_subscriptions[idx].Handle == subscription_))
+    {
+        m_subscriptions[idx].IsUsed = EN_Bool::FALSE8;
+        m_free_subscriptions.Push(idx);
+        m_num_subscriptions--;
+    }
+
+    m_lock.Unlock();
+}
+
+// Helpers
+CBurstCache::ST_Entry* CBurstCache::FindEntry(TY_Byte addr_mode_, TY_Byte* address_, TY_Word command_)
+{
+    // Note: Called by the writer only
+    TY_Word num_entries = m_num_entries.load(std::memory_order_relaxed);
+
+    for (TY_Word e = 0; e < num_entries; e++)
+    {
+        ST_Entry* entry = &m_entries[e];
+
+        if ((entry->Command == command_) && (entry->AddrMode == addr_mode_) &&
+            (COSAL::CMem::IsEqual(entry->Address, address_, 5) == EN_Bool::TRUE8))
+        {
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+void CBurstCache::Notify(ST_Entry* entry_)
+{
+    // Note: Called by the writer under the lock
+    TY_BurstData data;
+    EN_Bool      is_filled = EN_Bool::FALSE8;
+
+    for (WRD_Handle e = 0; e < MAX_NUM_BURST_SUBSCRIPTIONS; e++)
+    {
+        ST_Subscription* subscription = &m_subscriptions[e];
+
+        if ((subscription->IsUsed == EN_Bool::FALSE8) || (subscription->Command != entry_->Command) ||
+            (COSAL::CMem::IsEqual(subscription->Address, entry_->Address, 5) == EN_Bool::FALSE8) ||
+            (IsChanged(subscription, entry_) == EN_Bool::FALSE8))
+        {
+            continue;
+        }
+
+        subscription->IsNotified = EN_Bool::TRUE8;
+        subscription->RspCode1 = entry_->RspCode1;
+        subscription->RspCode2 = entry_->RspCode2;
+        subscription->DataLen = entry_->DataLen;
+        COSAL::CMem::Copy(subscription->Data, entry_->Data, entry_->DataLen);
+        if (((TY_Word)subscription->ValueOffset + 4) <= entry_->DataLen)
+        {
+            subscription->Value = CCoding::PickFloat(subscription->ValueOffset, entry_->Data, EN_Endian::MSB_First);
+        }
+
+        if (is_filled == EN_Bool::FALSE8)
+        {
+            FillData(entry_, &data);
+            is_filled = EN_Bool::TRUE8;
+        }
+
+        // The handler may end the subscription (or any other)
+        subscription->Handler(subscription->Handle, &data, subscription->Context);
+    }
+}
+
+EN_Bool CBurstCache::IsChanged(ST_Subscription* subscription_, ST_Entry* entry_)
+{
+    TY_Float value;
+
+    if ((subscription_->IsNotified == EN_Bool::FALSE8) ||
+        (subscription_->RspCode1 != entry_->RspCode1) ||
+        (subscription_->RspCode2 != entry_->RspCode2))
+    {
+        return EN_Bool::TRUE8;
+    }
+
+    if ((subscription_->ValueOffset == NO_VALUE) ||
+        (((TY_Word)subscription_->ValueOffset + 4) > entry_->DataLen) ||
+        (((TY_Word)subscription_->ValueOffset + 4) > subscription_->DataLen))
+    {
+        // Any change of the octets
+        if ((subscription_->DataLen != entry_->DataLen) ||
+            (COSAL::CMem::IsEqual(subscription_->Data, entry_->Data, entry_->DataLen) == EN_Bool::FALSE8))
+        {
+            return EN_Bool::TRUE8;
+        }
+
+        return EN_Bool::FALSE8;
+    }
+
+    value = CCoding::PickFloat(subscription_->ValueOffset, entry_->Data, EN_Endian::MSB_First);
+    if ((isnan(value) != 0) || (isnan(subscription_->Value) != 0))
+    {
+        // E.g. 0x7fa00000, the value is not available
+        return (isnan(value) != isnan(subscription_->Value)) ? EN_Bool::TRUE8 : EN_Bool::FALSE8;
+    }
+
+    if (subscription_->Deadband == 0)
+    {
+        return (value != subscription_->Value) ? EN_Bool::TRUE8 : EN_Bool::FALSE8;
+    }
+
+    return (fabsf(value - subscription_->Value) >= subscription_->Deadband) ? EN_Bool::TRUE8 : EN_Bool::FALSE8;
+}
+
+void CBurstCache::FillData(ST_Entry* entry_, TY_BurstData* data_)
+{
+    if (entry_->AddrMode == CHart::CAddrMode::UNIQUE)
+    {
+        data_->PollAddress = 0xff;
+        COSAL::CMem::Copy(data_->BytesOfUniqueID, entry_->Address, 5);
+    }
+    else
+    {
+        data_->PollAddress = entry_->Address[0];
+        COSAL::CMem::Set(data_->BytesOfUniqueID, 0, 5);
+    }
+
+    data_->Command = entry_->Command;
+    data_->SequenceNumber = entry_->NumUpdates;
+    data_->Time = entry_->Time;
+    data_->RespCode1 = entry_->RspCode1;
+    data_->RespCode2 = entry_->RspCode2;
+    data_->DataLen = entry_->DataLen;
+    if (data_->DataLen > MAX_CYCLIC_DATA_SIZE)
+    {
+        // Torn, a reader discards the copy
+        data_->DataLen = MAX_CYCLIC_DATA_SIZE;
+    }
+
+    COSAL::CMem::Copy(data_->BytesOfData, entry_->Data, data_->DataLen);
+}
+
+void CBurstCache::ReadEntry(ST_Entry* entry_, TY_BurstData* data_)
+{
+    TY_DWord sequence;
+
+    for (;;)
+    {
+        // Acquire: The octets are read after the sequence
+        sequence = entry_->Sequence.load(std::memory_order_acquire);
+        if ((sequence & 1) == 0)
+        {
+            FillData(entry_, data_);
+            // Acquire: The octets are read before the sequence is checked again
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (entry_->Sequence.load(std::memory_order_relaxed) == sequence)
+            {
+                return;
+            }
+        }
+    }
+}
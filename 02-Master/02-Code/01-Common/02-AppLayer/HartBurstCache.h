@@ -0,0 +1,119 @@
+/*
+ *          File: HartBurstCache.h (CBurstCache)
+ *                The latest burst response of each device and command
+ *                received by a channel. The kernel stores each burst
+ *                frame, the application reads the values at any time
+ *                without a lock and without a request on the bus. Or
+ *                it subscribes to a device and command and is notified
+ *                by the kernel when the data changed.
+ *
+ *        Author: Walter Borst
+ *
+ *        E-Mail: info@borst-automation.de
+ *          Home: https://www.borst-automation.de
+ *
+ * No Warranties: https://www.borst-automation.com/legal/warranty-disclaimer
+ *
+ * Copyright 2006-2025 Walter Borst, Cuxhaven, Germany
+ */
+
+// Once
+#ifndef __hartburstcache_h__
+#define __hartburstcache_h__
+
+#include <atomic>
+#include "OSAL.h"
+#include "WbHartUser.h"
+#include "WbHartM_Structures.h"
+#include "HartFrame.h"
+#include "HartServiceQueue.h"
+
+class CBurstCache
+{
+public:
+    // Subscription to any change of the payload
+    static const TY_Byte NO_VALUE = 0xff;
+
+                          CBurstCache();
+    void                      Reset();
+    // Called by the kernel for each burst frame
+    void                      Store(CFrame* frame_);
+    // Lock free, FALSE8: The device did not burst the command yet
+    EN_Bool                    Read(TY_Byte* bytes_of_unique_id_, TY_Word command_, TY_BurstData* data_);
+    TY_Word           GetNumEntries();
+    EN_Bool              FetchEntry(TY_Word index_, TY_BurstData* data_);
+    // Burst frames which found no free entry
+    TY_DWord          GetNumDropped();
+    // The handler is called with the first burst, whenever the response
+    // codes change and whenever the payload changes. With a value offset
+    // only the float at this offset counts, once it moved by the deadband
+    // (or more) since the last notification.
+    WRD_Handle            Subscribe(TY_Byte* bytes_of_unique_id_, TY_Word command_, TY_Byte value_offset_,
+                              TY_Float deadband_, TY_BurstHandler handler_, void* context_);
+    // The handler is not called anymore once this returns
+    void                Unsubscribe(WRD_Handle subscription_);
+
+private:
+    // A subscription handle carries the index of the subscription
+    // (low bits) and a generation (high bits), which is advanced on
+    // every subscription. So a handle which is used after the
+    // subscription ended is rejected.
+    static const TY_Word SUBSCRIPTION_INDEX_BITS = 6;
+    static const TY_Word SUBSCRIPTION_INDEX_MASK = (1 << SUBSCRIPTION_INDEX_BITS) - 1;
+
+    // An entry is a seqlock: The kernel makes the sequence odd
+    // while it writes, a reader copies the entry and retries
+    // if the sequence was odd or changed meanwhile
+    typedef struct st_Entry
+    {
+        alignas(64) std::atomic<TY_DWord> Sequence;
+        TY_Byte      AddrMode;
+        // Unique ID or the polling address in the first byte
+        TY_Byte      Address[5];
+        TY_Word      Command;
+        TY_DWord     NumUpdates;
+        TY_DWord     Time;
+        TY_Byte      RspCode1;
+        TY_Byte      RspCode2;
+        TY_Byte      DataLen;
+        TY_Byte      Data[MAX_CYCLIC_DATA_SIZE];
+    } ST_Entry;
+
+    typedef struct st_Subscription
+    {
+        EN_Bool          IsUsed;
+        WRD_Handle       Handle;
+        TY_Byte          Address[5];
+        TY_Word          Command;
+        TY_Byte          ValueOffset;
+        TY_Float         Deadband;
+        TY_BurstHandler  Handler;
+        void*            Context;
+        // What was passed with the last notification
+        EN_Bool          IsNotified;
+        TY_Byte          RspCode1;
+        TY_Byte          RspCode2;
+        TY_Float         Value;
+        TY_Byte          DataLen;
+        TY_Byte          Data[MAX_CYCLIC_DATA_SIZE];
+    } ST_Subscription;
+
+    ST_Entry*             FindEntry(TY_Byte addr_mode_, TY_Byte* address_, TY_Word command_);
+    void                     Notify(ST_Entry* entry_);
+    static EN_Bool        IsChanged(ST_Subscription* subscription_, ST_Entry* entry_);
+    static void         FillData(ST_Entry* entry_, TY_BurstData* data_);
+    static void        ReadEntry(ST_Entry* entry_, TY_BurstData* data_);
+
+    ST_Entry       m_entries[MAX_NUM_CYCLIC_BUFFERS];
+    // Entries up to this number carry a key
+    std::atomic<TY_Word>  m_num_entries;
+    std::atomic<TY_DWord> m_num_dropped;
+    ST_Subscription m_subscriptions[MAX_NUM_BURST_SUBSCRIPTIONS];
+    CServiceQueue  m_free_subscriptions;
+    TY_Word        m_num_subscriptions;
+    // Serializes the writers (kernel, reset and subscriptions) and the
+    // notifications, readers never lock
+    COSAL::CLock   m_lock;
+};
+
+#endif // __hartburstcache_h__
@@ -14,38 +14,108 @@
  * Copyright 2006-2025 Walter Borst, Cuxhaven, Germany
  */
 
+#include <new>
 #include "OSAL.h"
 #include "WbHartUser.h"
 #include "HartFrame.h"
 #include "HartService.h"
 #include "HartChannel.h"
-#include "HMuartMacPort.h"
-#include "HMipMacPort.h"
-
-// Data
-EN_Bool     CChannel::m_is_open = EN_Bool::FALSE8;
-EN_CommType CChannel::m_comm_type = EN_CommType::UART;
-TY_Word     CChannel::m_port_number = 0;
-TY_Word     CChannel::m_num_active_services = 0;
-CService    CChannel::m_CService_pool[MAX_NUM_SERVICES];
-TY_DWord    CChannel::m_baudrate = 1200;
-TY_Byte     CChannel::m_num_preambles = 5;
-TY_Byte     CChannel::m_num_retries = 2;
-EN_Bool     CChannel::m_retry_if_busy = EN_Bool::TRUE8;
-EN_Master   CChannel::m_master_type = EN_Master::SECONDARY;
-TY_Byte     CChannel::m_addressing_mode = 0;
-EN_Bool     CChannel::m_hart_enabled = EN_Bool::TRUE8;
-TY_Byte     CChannel::m_hart_version = 7;
-TY_Word     CChannel::m_next_srv_search_idx = 0;
-TY_Byte     CChannel::HartIpHostName[MAX_STRING_LEN] = { 0 };
-TY_Byte     CChannel::HartIpAddress[MAX_STRING_LEN] = { 0 };
-TY_Byte     CChannel::HartIpPort[MAX_STRING_LEN] = { 0 };
-EN_Bool     CChannel::HartIpUseAddress = EN_Bool::FALSE8;
-EN_Bool     CChannel::HartIpSendKeepAlive = EN_Bool::FALSE8;
+#include "HartCoding.h"
+#include "HartConsts.h"
+
+thread_local CChannel* CChannel::s_executing = NULL;
 
 // Methods
+CChannel::CChannel() :
+    UartMacPort(this),
+    UartProtocol(this),
+    UartL2SM(this),
+    UartL2RxSM(this),
+    UartL2TxSM(this),
+    IpMacPort(this),
+    IpProtocol(this),
+    IpL2SM(this),
+    IpL2RxSM(this),
+    IpL2TxSM(this),
+    LoopMacPort(this)
+{
+    m_is_open = EN_Bool::FALSE8;
+    m_close_pending = EN_Bool::FALSE8;
+    m_delete_pending = EN_Bool::FALSE8;
+    // The pin of the channel table
+    m_num_pins.store(1, std::memory_order_relaxed);
+    m_comm_type = EN_CommType::UART;
+    m_port_number = 0;
+    m_protocol = CProtocol::NONE;
+    m_baudrate = 1200;
+    m_num_preambles = 5;
+    m_num_retries = 2;
+    m_retry_if_busy = EN_Bool::TRUE8;
+    m_master_type = EN_Master::SECONDARY;
+    m_addressing_mode = 0;
+    m_hart_enabled = EN_Bool::TRUE8;
+    m_hart_version = 7;
+    m_local_master = EN_Master::SECONDARY;
+    m_loop_config.NumDevices = 1;
+    m_loop_config.ModelBaudRate = EN_Bool::TRUE8;
+    m_loop_config.TurnaroundTime = 2;
+    m_loop_config.BurstPeriod = 0;
+    m_loop_config.BurstCommand = 1;
+    m_retry_service = INVALID_SRV_HANDLE;
+    m_CService_pool = NULL;
+    m_pool_size = 0;
+    m_ready = NULL;
+    m_ready_size = 0;
+    m_num_ready = 0;
+    m_ready_sequence = 0;
+    m_num_services = MAX_NUM_SERVICES;
+    static_assert(MAX_NUM_BATCHES <= (WRD_INDEX_MASK + 1), "Too many batches for the handle");
+    static_assert(MAX_NUM_PREPARED_REQUESTS <= (WRD_INDEX_MASK + 1), "Too many prepared requests for the handle");
+    m_free_batches.Create(MAX_NUM_BATCHES);
+    m_requested_batches.Create(MAX_NUM_BATCHES);
+    for (WRD_Handle e = 0; e < MAX_NUM_BATCHES; e++)
+    {
+        m_batches[e].Requests = NULL;
+        m_batches[e].NumRequests = 0;
+        m_batches[e].NextRequest = 0;
+        m_batches[e].NumCompleted = 0;
+        m_batches[e].Handler = NULL;
+        m_batches[e].Context = NULL;
+        m_batches[e].Handle = INVALID_WRD_HANDLE;
+        m_batches[e].IsUsed = EN_Bool::FALSE8;
+        m_batches[e].IsCompleted.store(EN_Bool::FALSE8, std::memory_order_relaxed);
+        m_free_batches.Push(e);
+    }
+    m_active_batch = INVALID_WRD_HANDLE;
+    m_num_pending_batches.store(0, std::memory_order_relaxed);
+    m_free_prepared.Create(MAX_NUM_PREPARED_REQUESTS);
+    for (WRD_Handle e = 0; e < MAX_NUM_PREPARED_REQUESTS; e++)
+    {
+        m_prepared_handles[e] = INVALID_WRD_HANDLE;
+        m_free_prepared.Push(e);
+    }
+    COSAL::CMem::Set(HartIpHostName, 0, MAX_STRING_LEN);
+    COSAL::CMem::Set(HartIpAddress, 0, MAX_STRING_LEN);
+    COSAL::CMem::Set(HartIpPort, 0, MAX_STRING_LEN);
+    HartIpUseAddress = EN_Bool::FALSE8;
+    HartIpEnabled = EN_Bool::FALSE8;
+    HartIpSendKeepAlive = EN_Bool::FALSE8;
+}
+
+CChannel::~CChannel()
+{
+    Close();
+    DestroyServicePool();
+}
+
 EN_Bool CChannel::Open(TY_Word port_number_, EN_CommType type_)
 {
+    // Not from a handler of the channel itself
+    if (s_executing == this)
+    {
+        return EN_Bool::FALSE8;
+    }
+
     // Close channel if already open by any port
     if (m_is_open == EN_Bool::TRUE8)
     {
@@ -53,13 +123,18 @@ EN_Bool CChannel::Open(TY_Word port_number_, EN_CommType type_)
         m_is_open = EN_Bool::FALSE8;
     }
 
+    if (CreateServicePool() == EN_Bool::FALSE8)
+    {
+        return EN_Bool::FALSE8;
+    }
+
     m_comm_type = type_;
     if (type_ == EN_CommType::UART)
     {
         Init();
         m_port_number = port_number_ - 1;
         m_comm_type = type_;
-        if (CHMuartMacPort::Open(m_port_number, m_baudrate, m_comm_type) == EN_Bool::TRUE8)
+        if (UartMacPort.Open(m_port_number, m_baudrate, m_comm_type) == EN_Bool::TRUE8)
         {
             m_is_open = EN_Bool::TRUE8;
             return EN_Bool::TRUE8;
@@ -70,7 +145,18 @@ EN_Bool CChannel::Open(TY_Word port_number_, EN_CommType type_)
         Init();
         m_port_number = port_number_ - 1;
         m_comm_type = type_;
-        if (CHMipMacPort::Open(HartIpHostName, HartIpPort, m_comm_type) == EN_Bool::TRUE8)
+        if (IpMacPort.Open(HartIpHostName, HartIpPort, m_comm_type) == EN_Bool::TRUE8)
+        {
+            m_is_open = EN_Bool::TRUE8;
+            return EN_Bool::TRUE8;
+        }
+    }
+    else if (type_ == EN_CommType::LOOPBACK)
+    {
+        Init();
+        m_port_number = 0;
+        m_comm_type = type_;
+        if (LoopMacPort.Open(&m_loop_config, m_baudrate) == EN_Bool::TRUE8)
         {
             m_is_open = EN_Bool::TRUE8;
             return EN_Bool::TRUE8;
@@ -82,18 +168,33 @@ EN_Bool CChannel::Open(TY_Word port_number_, EN_CommType type_)
 
 void CChannel::Close()
 {
+    if (s_executing == this)
+    {
+        // Called by a handler, the stack is still in use
+        m_close_pending = EN_Bool::TRUE8;
+        return;
+    }
+
     if (m_is_open == EN_Bool::TRUE8)
     {
+        // Taken first, a handler of the channel may ask
+        // for the close as well while the port is closed
+        m_is_open = EN_Bool::FALSE8;
         if (m_comm_type == EN_CommType::UART)
         {
-            CHMuartMacPort::Close();
-            m_is_open = EN_Bool::FALSE8;
+            UartMacPort.Close();
         }
         else if (m_comm_type == EN_CommType::HART_IP)
         {
-            CHMipMacPort::Close();
-            m_is_open = EN_Bool::FALSE8;
+            IpMacPort.Close();
         }
+        else if (m_comm_type == EN_CommType::LOOPBACK)
+        {
+            LoopMacPort.Close();
+        }
+
+        // Waiters for a service which is not served anymore
+        m_service_completed.Set();
     }
 }
 
@@ -106,42 +207,271 @@ void CChannel::Init()
 {
     if (m_comm_type == EN_CommType::HART_IP)
     {
-        CHMipMacPort::Init();
+        IpMacPort.Init();
+    }
+    else if (m_comm_type == EN_CommType::LOOPBACK)
+    {
+        LoopMacPort.Init();
+    }
+    else
+    {
+        UartMacPort.Init();
+    }
+}
+
+
+void CChannel::Execute(TY_Word time_ms_)
+{
+    CChannel* outer = s_executing;
+
+    s_executing = this;
+    // Call the Hart master protocol handler
+    if (m_comm_type == EN_CommType::HART_IP)
+    {
+        IpMacPort.Execute(time_ms_);
+    }
+    else if (m_comm_type == EN_CommType::LOOPBACK)
+    {
+        LoopMacPort.Execute(time_ms_);
+    }
+    else
+    {
+        UartMacPort.Execute(time_ms_);
+    }
+
+    // Completes a close or delete requested by a handler
+    s_executing = outer;
+    if (m_delete_pending == EN_Bool::TRUE8)
+    {
+        COSAL::Lock();
+        Close();
+        COSAL::Unlock();
+        // The pin of the table, passed by the delete
+        Unpin();
+        return;
+    }
+
+    if (m_close_pending == EN_Bool::TRUE8)
+    {
+        COSAL::Lock();
+        m_close_pending = EN_Bool::FALSE8;
+        Close();
+        COSAL::Unlock();
+    }
+}
+
+void CChannel::WakeUp()
+{
+    if (m_comm_type == EN_CommType::HART_IP)
+    {
+        IpMacPort.WakeUp();
+    }
+    else if (m_comm_type == EN_CommType::LOOPBACK)
+    {
+        LoopMacPort.WakeUp();
     }
     else
     {
-        CHMuartMacPort::Init();
+        UartMacPort.WakeUp();
     }
 }
 
+EN_Bool CChannel::IsExecuting()
+{
+    return (s_executing == this) ? EN_Bool::TRUE8 : EN_Bool::FALSE8;
+}
+
+void CChannel::DeleteLater()
+{
+    m_delete_pending = EN_Bool::TRUE8;
+}
+
+void CChannel::Pin()
+{
+    m_num_pins.fetch_add(1, std::memory_order_relaxed);
+}
+
+void CChannel::Unpin()
+{
+    if (m_num_pins.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        COSAL::Lock();
+        delete this;
+        COSAL::Unlock();
+    }
+}
 
 /* Service handling */
-SRV_Handle CChannel::GetNewService()
+EN_Bool CChannel::SetNumServices(TY_Word num_services_)
+{
+    if ((num_services_ == 0) || (num_services_ > MAX_SERVICE_POOL_SIZE))
+    {
+        return EN_Bool::FALSE8;
+    }
+
+    m_num_services = num_services_;
+    return EN_Bool::TRUE8;
+}
+
+TY_Word CChannel::GetNumServices()
+{
+    return m_num_services;
+}
+
+EN_Bool CChannel::CreateServicePool()
+{
+    // Note: Called while the channel is closed. The allocation
+    // is kept as long as the size is the same.
+    if ((m_CService_pool != NULL) && (m_pool_size == m_num_services))
+    {
+        ResetServicePool();
+        return EN_Bool::TRUE8;
+    }
+
+    DestroyServicePool();
+    // All services of the channel in one block
+    m_CService_pool = new (std::nothrow) CService[m_num_services];
+    if (m_CService_pool == NULL)
+    {
+        return EN_Bool::FALSE8;
+    }
+
+    // A released service may still be queued for the kernel,
+    // so the request queue has to take every service twice
+    m_ready = new (std::nothrow) ST_Ready[2 * m_num_services];
+    if ((m_ready == NULL) ||
+        (m_free_services.Create(m_num_services) == EN_Bool::FALSE8) ||
+        (m_requested_services.Create(2 * m_num_services) == EN_Bool::FALSE8) ||
+        (Frames.Create(m_num_services + NUM_PROTOCOL_FRAMES) == EN_Bool::FALSE8))
+    {
+        DestroyServicePool();
+        return EN_Bool::FALSE8;
+    }
+
+    m_pool_size = m_num_services;
+    m_ready_size = (TY_Word)(2 * m_num_services);
+    ResetServicePool();
+    return EN_Bool::TRUE8;
+}
+
+void CChannel::ResetServicePool()
+{
+    // Note: Called while the channel is closed. Services and
+    // batches which were in flight at the close are dropped,
+    // the handles of the services get stale.
+    UartProtocol.ReleaseFrames();
+    IpProtocol.ReleaseFrames();
+    for (TY_Word e = 0; e < m_pool_size; e++)
+    {
+        m_CService_pool[e].Release();
+    }
+
+    Frames.Reset();
+    m_free_services.Clear();
+    m_requested_services.Clear();
+    for (TY_Word e = 0; e < m_pool_size; e++)
+    {
+        m_free_services.Push(e);
+    }
+
+    m_retry_service = INVALID_SRV_HANDLE;
+    m_num_ready = 0;
+    AbortBatches();
+    // Waiters for a dropped service find an invalid handle
+    m_service_completed.Set();
+}
+
+void CChannel::AbortBatches()
 {
-    SRV_Handle handle = INVALID_SRV_HANDLE;
+    // Note: Called while the channel is closed. The requests
+    // which did not complete are confirmed as not answered,
+    // the handlers are not called.
+    WRD_Handle h_batch = m_active_batch;
 
-    if (m_num_active_services < MAX_NUM_SERVICES)
+    for (;;)
     {
-        for (TY_Word e = 0; e < MAX_NUM_SERVICES; e++)
+        if (h_batch == INVALID_WRD_HANDLE)
         {
-            if (m_CService_pool[e].IsActive() == EN_Bool::FALSE8)
+            h_batch = m_requested_batches.Pop();
+            if (h_batch == INVALID_WRD_HANDLE)
             {
-                handle = e;
-                m_CService_pool[e].Init();
-                m_num_active_services++;
                 break;
             }
         }
+
+        ST_Batch* batch = &m_batches[h_batch];
+
+        for (TY_Word e = batch->NumCompleted; e < batch->NumRequests; e++)
+        {
+            batch->Requests[e].Confirmation.SrvResultCode = EN_SRV_Result::NO_DEV_RESP;
+        }
+
+        batch->NumCompleted = batch->NumRequests;
+        m_num_pending_batches--;
+        batch->IsCompleted.store(EN_Bool::TRUE8, std::memory_order_release);
+        h_batch = INVALID_WRD_HANDLE;
+    }
+
+    m_active_batch = INVALID_WRD_HANDLE;
+}
+
+void CChannel::DestroyServicePool()
+{
+    UartProtocol.ReleaseFrames();
+    IpProtocol.ReleaseFrames();
+    if (m_CService_pool != NULL)
+    {
+        delete[] m_CService_pool;
+        m_CService_pool = NULL;
+    }
+
+    if (m_ready != NULL)
+    {
+        delete[] m_ready;
+        m_ready = NULL;
+    }
+
+    m_pool_size = 0;
+    m_ready_size = 0;
+    m_num_ready = 0;
+    m_free_services.Destroy();
+    m_requested_services.Destroy();
+    Frames.Destroy();
+}
+
+SRV_Handle CChannel::GetNewService()
+{
+    // Note: May be called by any thread without a lock
+    SRV_Handle idx = m_free_services.Pop();
+    CService*  srv = NULL;
+    TY_Word    generation;
+    SRV_Handle handle;
+
+    if (idx == INVALID_SRV_HANDLE)
+    {
+        return INVALID_SRV_HANDLE;
     }
 
+    srv = &m_CService_pool[idx];
+    // The handles of the previous use of the service get stale.
+    // An unused service has an invalid handle and starts with 0.
+    generation = (TY_Word)(srv->GetHandle() >> SRV_INDEX_BITS) + 1;
+    handle = (SRV_Handle)((generation << SRV_INDEX_BITS) | idx);
+    srv->SetHandle(handle);
+    srv->Init(this);
     return handle;
 }
 
 CService* CChannel::GetServicePtr(SRV_Handle handle_)
 {
-    if (handle_ != INVALID_SRV_HANDLE)
+    TY_Word idx = handle_ & SRV_INDEX_MASK;
+
+    if ((handle_ != INVALID_SRV_HANDLE) && (idx < m_pool_size))
     {
-        return &(m_CService_pool[handle_]);
+        if (m_CService_pool[idx].GetHandle() == handle_)
+        {
+            return &(m_CService_pool[idx]);
+        }
     }
 
     return NULL;
@@ -149,36 +479,54 @@ CService* CChannel::GetServicePtr(SRV_Handle handle_)
 
 void CChannel::ReleaseService(SRV_Handle handle_)
 {
+    CService* srv = NULL;
+
     if (IsValidService(handle_) == EN_Bool::TRUE8)
     {
-        m_CService_pool[handle_].SetOwner(EN_Owner::USER);
-        m_CService_pool[handle_].Release();
-        m_num_active_services--;
+        srv = &m_CService_pool[handle_ & SRV_INDEX_MASK];
+        srv->SetOwner(EN_Owner::USER);
+        if (srv->Release() == EN_Bool::TRUE8)
+        {
+            m_free_services.Push(handle_ & SRV_INDEX_MASK);
+            if (m_num_pending_batches.load(std::memory_order_relaxed) > 0)
+            {
+                // A batch may be waiting for a free service
+                WakeUp();
+            }
+        }
     }
 }
 
 EN_Bool CChannel::IsValidService(SRV_Handle handle_)
 {
-    EN_Bool result = EN_Bool::FALSE8;
+    TY_Word idx = handle_ & SRV_INDEX_MASK;
 
-    if (handle_ < MAX_NUM_SERVICES)
+    if ((handle_ != INVALID_SRV_HANDLE) && (idx < m_pool_size))
     {
-        if (GetServicePtr(handle_)->IsActive() == EN_Bool::TRUE8)
+        // Check the handle after the state, a service which
+        // is reused in between has got a new handle then
+        if (m_CService_pool[idx].IsActive() == EN_Bool::TRUE8)
         {
-            result = EN_Bool::TRUE8;
+            if (m_CService_pool[idx].GetHandle() == handle_)
+            {
+                return EN_Bool::TRUE8;
+            }
         }
     }
 
-    return result;
+    return EN_Bool::FALSE8;
 }
 
 EN_Bool CChannel::IsServiceCompleted(SRV_Handle handle_)
 {
+    CService* srv = NULL;
+
     if (IsValidService(handle_) == EN_Bool::TRUE8)
     {
-        if (m_CService_pool[handle_].GetOwner() == EN_Owner::USER)
+        srv = &m_CService_pool[handle_ & SRV_INDEX_MASK];
+        if (srv->GetOwner() == EN_Owner::USER)
         {
-            if (m_CService_pool[handle_].GetStatus() == CService::EN_Status::WAITING)
+            if (srv->GetStatus() == CService::EN_Status::WAITING)
             {
                 return EN_Bool::TRUE8;
             }
@@ -188,19 +536,44 @@ EN_Bool CChannel::IsServiceCompleted(SRV_Handle handle_)
     return EN_Bool::FALSE8;
 }
 
-void CChannel::SetServiceOwner(SRV_Handle handle_, EN_Owner owner_)
+EN_Bool CChannel::SetServiceOwner(SRV_Handle handle_, EN_Owner owner_)
 {
-    if (handle_ < MAX_NUM_SERVICES)
+    CService* srv = GetServicePtr(handle_);
+
+    if (srv == NULL)
     {
-        m_CService_pool[handle_].SetOwner(owner_);
+        return EN_Bool::FALSE8;
     }
+
+    srv->SetOwner(owner_);
+    if (owner_ == EN_Owner::PROTOCOL)
+    {
+        if (m_requested_services.Push(handle_) == EN_Bool::FALSE8)
+        {
+            // Queue full (released services which are still
+            // queued), the kernel won't see the request. It is
+            // passed back to the caller as completed.
+            srv->SetCompletionCode(EN_SRV_Result::RESOURCE_ERROR);
+            srv->SetStatus(CService::EN_Status::WAITING);
+            srv->SetOwner(EN_Owner::USER);
+            m_service_completed.Set();
+            return EN_Bool::FALSE8;
+        }
+
+        // A new request, don't wait for the next timer
+        WakeUp();
+    }
+
+    return EN_Bool::TRUE8;
 }
 
 EN_Owner CChannel::GetServiceOwner(SRV_Handle handle_)
 {
-    if (handle_ < MAX_NUM_SERVICES)
+    CService* srv = GetServicePtr(handle_);
+
+    if (srv != NULL)
     {
-        return m_CService_pool[handle_].GetOwner();
+        return srv->GetOwner();
     }
 
     return EN_Owner::USER;
@@ -211,32 +584,568 @@ void CChannel::FreeService(SRV_Handle handle_)
     ReleaseService(handle_);
 }
 
+SRV_Handle CChannel::PrepareService(TY_Byte command_, TY_Byte* data_ref_, TY_Byte data_len_,
+    TY_Byte* bytes_of_unique_id_, TY_CompletionHandler handler_, void* context_)
+{
+    // Note: The service is launched but still owned by the caller
+    SRV_Handle h_service = GetNewService();
+    CService*  p_service = NULL;
+
+    if (h_service == INVALID_SRV_HANDLE)
+    {
+        return INVALID_SRV_HANDLE;
+    }
+
+    p_service = GetServicePtr(h_service);
+    p_service->SetCommand(command_);
+    if (GetAddressingMode() == 2)
+    {
+        p_service->SetAddrMode(CHart::CAddrMode::POLLING);
+    }
+    else
+    {
+        p_service->SetAddrMode(CHart::CAddrMode::UNIQUE);
+    }
+    p_service->SetUniqueID(bytes_of_unique_id_);
+    p_service->SetData(data_ref_, data_len_);
+    p_service->SetRetryIfBusy(GetRetryIfBusy());
+    p_service->SetNumPreambles(GetNumPreambles());
+    p_service->SetNumRetries(GetNumRetries());
+    p_service->SetMode(CService::EN_Mode::NORMAL);
+    p_service->SetHandle(h_service);
+    p_service->SetCompletionHandler(handler_, context_);
+    p_service->Launch();
+    return h_service;
+}
+
 SRV_Handle CChannel::GetRequestedService()
 {
-    TY_Word   e;
-    SRV_Handle idx = m_next_srv_search_idx;
+    // Note: Called by the kernel only
+    SRV_Handle handle = m_retry_service;
+    CService*  srv = NULL;
+
+    m_retry_service = INVALID_SRV_HANDLE;
+    if (handle != INVALID_SRV_HANDLE)
+    {
+        // The service is repeated before any other request
+        srv = GetServicePtr(handle);
+        if ((srv != NULL) && (srv->GetOwner() == EN_Owner::PROTOCOL) &&
+            (srv->GetStatus() == CService::EN_Status::REQUESTED))
+        {
+            srv->SetStatus(CService::EN_Status::BUSY);
+            return handle;
+        }
+    }
 
-    for (e = 0; e < MAX_NUM_SERVICES; e++)
+    // Take over the new requests, as many as the list holds
+    while (m_num_ready < m_ready_size)
     {
-        if (idx >= MAX_NUM_SERVICES)
+        handle = m_requested_services.Pop();
+        if (handle == INVALID_SRV_HANDLE)
         {
-            idx = 0;
+            break;
         }
+        AddReady(handle);
+    }
 
-        if (m_CService_pool[idx].GetOwner() == EN_Owner::PROTOCOL)
+    for (;;)
+    {
+        // Single requests of the application first, then the batches
+        handle = GetReadyService();
+        if (handle == INVALID_SRV_HANDLE)
         {
-            if (m_CService_pool[idx].GetStatus() == CService::EN_Status::REQUESTED)
-            {
-                m_CService_pool[idx].SetStatus(CService::EN_Status::BUSY);
-                m_next_srv_search_idx = idx;
-                return idx;
-            }
+            handle = GetBatchService();
+        }
+
+        if ((handle == INVALID_SRV_HANDLE) || (AdmitService(handle) == EN_Bool::TRUE8))
+        {
+            return handle;
+        }
+    }
+}
+
+void CChannel::RetryService(SRV_Handle handle_)
+{
+    // The service is repeated before any other request
+    m_retry_service = handle_;
+}
+
+EN_Bool CChannel::WaitForService(SRV_Handle handle_, TY_DWord timeout_ms_)
+{
+    TY_DWord start_time = COSAL::CTimer::GetTime();
+    TY_DWord elapsed;
+    TY_DWord count;
+
+    for (;;)
+    {
+        // Take the counter first, so no completion is missed
+        count = m_service_completed.GetCount();
+        if (IsServiceCompleted(handle_) == EN_Bool::TRUE8)
+        {
+            return EN_Bool::TRUE8;
+        }
+
+        if ((IsValidService(handle_) == EN_Bool::FALSE8) || (m_is_open == EN_Bool::FALSE8))
+        {
+            return EN_Bool::FALSE8;
         }
 
-        idx++;
+        elapsed = COSAL::CTimer::GetTime() - start_time;
+        if (elapsed >= timeout_ms_)
+        {
+            return EN_Bool::FALSE8;
+        }
+
+        // Any completed service of the channel wakes up the waiters
+        m_service_completed.Wait(count, timeout_ms_ - elapsed);
     }
+}
 
-    return INVALID_SRV_HANDLE;
+PTR_Handle CChannel::GetCompletionHandle()
+{
+    return m_service_completed.GetWaitHandle();
+}
+
+/* Batch handling */
+WRD_Handle CChannel::LaunchBatch(TY_BatchRequest* requests_, TY_Word num_requests_,
+    TY_CompletionHandler handler_, void* context_)
+{
+    WRD_Handle idx;
+    ST_Batch*  batch;
+
+    if ((requests_ == NULL) || (num_requests_ == 0))
+    {
+        return INVALID_WRD_HANDLE;
+    }
+
+    for (TY_Word e = 0; e < num_requests_; e++)
+    {
+        // An extended command takes two bytes of the payload
+        TY_Word max_len = (requests_[e].Command > 255) ? (MAX_PAYLOAD_SIZE - 2) : MAX_PAYLOAD_SIZE;
+
+        if (requests_[e].DataLen > max_len)
+        {
+            return INVALID_WRD_HANDLE;
+        }
+    }
+
+    idx = m_free_batches.Pop();
+    if (idx == INVALID_WRD_HANDLE)
+    {
+        return INVALID_WRD_HANDLE;
+    }
+
+    batch = &m_batches[idx];
+    batch->Handle = GetNextHandle(batch->Handle, idx);
+    batch->IsUsed = EN_Bool::TRUE8;
+    batch->Requests = requests_;
+    batch->NumRequests = num_requests_;
+    batch->NextRequest = 0;
+    batch->NumCompleted = 0;
+    batch->Handler = handler_;
+    batch->Context = context_;
+    batch->IsCompleted.store(EN_Bool::FALSE8, std::memory_order_relaxed);
+    for (TY_Word e = 0; e < num_requests_; e++)
+    {
+        requests_[e].Confirmation.SrvResultCode = EN_SRV_Result::IN_PROGRESS;
+        requests_[e].Confirmation.DataLen = 0;
+    }
+
+    m_num_pending_batches++;
+    // Publishes the batch to the kernel
+    m_requested_batches.Push(idx);
+    WakeUp();
+    return batch->Handle;
+}
+
+EN_Bool CChannel::IsBatchCompleted(WRD_Handle batch_)
+{
+    WRD_Handle idx = GetBatchIndex(batch_);
+
+    if (idx == INVALID_WRD_HANDLE)
+    {
+        return EN_Bool::FALSE8;
+    }
+
+    return m_batches[idx].IsCompleted.load(std::memory_order_acquire);
+}
+
+EN_Bool CChannel::WaitForBatch(WRD_Handle batch_, TY_DWord timeout_ms_)
+{
+    TY_DWord start_time = COSAL::CTimer::GetTime();
+    TY_DWord elapsed;
+    TY_DWord count;
+
+    for (;;)
+    {
+        // Take the counter first, so no completion is missed
+        count = m_service_completed.GetCount();
+        if (IsBatchCompleted(batch_) == EN_Bool::TRUE8)
+        {
+            return EN_Bool::TRUE8;
+        }
+
+        if (GetBatchIndex(batch_) == INVALID_WRD_HANDLE)
+        {
+            return EN_Bool::FALSE8;
+        }
+
+        elapsed = COSAL::CTimer::GetTime() - start_time;
+        if (elapsed >= timeout_ms_)
+        {
+            return EN_Bool::FALSE8;
+        }
+
+        m_service_completed.Wait(count, timeout_ms_ - elapsed);
+    }
+}
+
+void CChannel::ReleaseBatch(WRD_Handle batch_)
+{
+    WRD_Handle idx = GetBatchIndex(batch_);
+
+    if ((idx != INVALID_WRD_HANDLE) && (IsBatchCompleted(batch_) == EN_Bool::TRUE8))
+    {
+        m_batches[idx].IsUsed = EN_Bool::FALSE8;
+        m_batches[idx].IsCompleted.store(EN_Bool::FALSE8, std::memory_order_relaxed);
+        m_free_batches.Push(idx);
+    }
+}
+
+WRD_Handle CChannel::GetNextHandle(WRD_Handle handle_, WRD_Handle idx_)
+{
+    // The handles of the previous use get stale. An unused
+    // entry has an invalid handle and starts with 0.
+    TY_Word    generation = (TY_Word)(handle_ >> WRD_INDEX_BITS) + 1;
+    WRD_Handle handle = (WRD_Handle)((generation << WRD_INDEX_BITS) | idx_);
+
+    if (handle == INVALID_WRD_HANDLE)
+    {
+        handle = idx_;
+    }
+
+    return handle;
+}
+
+WRD_Handle CChannel::GetBatchIndex(WRD_Handle batch_)
+{
+    WRD_Handle idx = batch_ & WRD_INDEX_MASK;
+
+    if ((batch_ == INVALID_WRD_HANDLE) || (idx >= MAX_NUM_BATCHES) ||
+        (m_batches[idx].IsUsed == EN_Bool::FALSE8) || (m_batches[idx].Handle != batch_))
+    {
+        return INVALID_WRD_HANDLE;
+    }
+
+    return idx;
+}
+
+WRD_Handle CChannel::GetPreparedIndex(WRD_Handle prepared_)
+{
+    WRD_Handle idx = prepared_ & WRD_INDEX_MASK;
+
+    if ((prepared_ == INVALID_WRD_HANDLE) || (idx >= MAX_NUM_PREPARED_REQUESTS) ||
+        (m_prepared[idx].IsUsed() == EN_Bool::FALSE8) || (m_prepared_handles[idx] != prepared_))
+    {
+        return INVALID_WRD_HANDLE;
+    }
+
+    return idx;
+}
+
+/* Prepared requests */
+WRD_Handle CChannel::PrepareRequest(TY_Word command_, TY_Byte* data_ref_, TY_Byte data_len_,
+    TY_Byte* bytes_of_unique_id_)
+{
+    WRD_Handle idx;
+    TY_Byte    addr_mode = CHart::CAddrMode::UNIQUE;
+
+    idx = m_free_prepared.Pop();
+    if (idx == INVALID_WRD_HANDLE)
+    {
+        return INVALID_WRD_HANDLE;
+    }
+
+    if (GetAddressingMode() == 2)
+    {
+        addr_mode = CHart::CAddrMode::POLLING;
+    }
+
+    if (m_prepared[idx].Prepare(command_, data_ref_, data_len_,
+        bytes_of_unique_id_, addr_mode) == EN_Bool::FALSE8)
+    {
+        m_free_prepared.Push(idx);
+        return INVALID_WRD_HANDLE;
+    }
+
+    m_prepared_handles[idx] = GetNextHandle(m_prepared_handles[idx], idx);
+    return m_prepared_handles[idx];
+}
+
+EN_Bool CChannel::UpdatePreparedData(WRD_Handle prepared_, TY_Byte offset_, TY_Byte* data_ref_, TY_Byte len_)
+{
+    WRD_Handle idx = GetPreparedIndex(prepared_);
+
+    if (idx == INVALID_WRD_HANDLE)
+    {
+        return EN_Bool::FALSE8;
+    }
+
+    return m_prepared[idx].UpdateData(offset_, data_ref_, len_);
+}
+
+SRV_Handle CChannel::LaunchPrepared(WRD_Handle prepared_, TY_CompletionHandler handler_, void* context_)
+{
+    // Note: The service is launched but still owned by the caller
+    WRD_Handle idx = GetPreparedIndex(prepared_);
+    SRV_Handle h_service = INVALID_SRV_HANDLE;
+    CService*  p_service = NULL;
+
+    if (idx == INVALID_WRD_HANDLE)
+    {
+        return INVALID_SRV_HANDLE;
+    }
+
+    h_service = GetNewService();
+    if (h_service == INVALID_SRV_HANDLE)
+    {
+        return INVALID_SRV_HANDLE;
+    }
+
+    p_service = GetServicePtr(h_service);
+    p_service->SetRetryIfBusy(GetRetryIfBusy());
+    p_service->SetNumPreambles(GetNumPreambles());
+    p_service->SetNumRetries(GetNumRetries());
+    p_service->SetMode(CService::EN_Mode::NORMAL);
+    p_service->SetHandle(h_service);
+    p_service->SetCompletionHandler(handler_, context_);
+    p_service->LaunchPrepared(&m_prepared[idx]);
+    return h_service;
+}
+
+void CChannel::ReleasePrepared(WRD_Handle prepared_)
+{
+    WRD_Handle idx = GetPreparedIndex(prepared_);
+
+    if (idx != INVALID_WRD_HANDLE)
+    {
+        m_prepared[idx].Init();
+        m_free_prepared.Push(idx);
+    }
+}
+
+void CChannel::AddReady(SRV_Handle handle_)
+{
+    // Note: Called by the kernel only
+    CService* srv = GetServicePtr(handle_);
+    ST_Ready* ready = &m_ready[m_num_ready];
+
+    if (srv == NULL)
+    {
+        return;
+    }
+
+    ready->Handle = handle_;
+    ready->Priority = srv->GetPriority();
+    ready->HasDeadline = srv->GetDeadline(&ready->Deadline);
+    ready->Sequence = m_ready_sequence++;
+    m_num_ready++;
+}
+
+SRV_Handle CChannel::GetReadyService()
+{
+    // Note: Called by the kernel only
+    TY_DWord  now = COSAL::CTimer::GetTime();
+    TY_Word   best = m_num_ready;
+    TY_Word   e = 0;
+    CService* srv;
+
+    while (e < m_num_ready)
+    {
+        ST_Ready* ready = &m_ready[e];
+
+        // Skip handles of services which were
+        // released in the meantime
+        srv = GetServicePtr(ready->Handle);
+        if ((srv == NULL) || (srv->GetOwner() != EN_Owner::PROTOCOL) ||
+            (srv->GetStatus() != CService::EN_Status::REQUESTED))
+        {
+            RemoveReady(e);
+            continue;
+        }
+
+        // A request which missed its deadline is not sent anymore
+        if ((ready->HasDeadline == EN_Bool::TRUE8) && ((TY_Int32)(now - ready->Deadline) >= 0))
+        {
+            SRV_Handle handle = ready->Handle;
+
+            RemoveReady(e);
+            srv->SetCompletionCode(EN_SRV_Result::DEADLINE_MISSED);
+            srv->SetStatus(CService::EN_Status::WAITING);
+            FireServiceEvent(CServiceEvent::CONFIRMATION, handle, 0);
+            continue;
+        }
+
+        if ((best == m_num_ready) || (IsBefore(ready, &m_ready[best]) == EN_Bool::TRUE8))
+        {
+            best = e;
+        }
+        e++;
+    }
+
+    if (best == m_num_ready)
+    {
+        return INVALID_SRV_HANDLE;
+    }
+
+    SRV_Handle handle = m_ready[best].Handle;
+
+    RemoveReady(best);
+    GetServicePtr(handle)->SetStatus(CService::EN_Status::BUSY);
+    return handle;
+}
+
+EN_Bool CChannel::AdmitService(SRV_Handle handle_)
+{
+    // Note: Called by the kernel only
+    CService* srv = GetServicePtr(handle_);
+    TY_Byte   address[5];
+    TY_Byte   addr_mode;
+    TY_Word   command;
+    TY_Byte   num_retries = srv->GetMaxRetries();
+
+    if (srv->GetMode() != CService::EN_Mode::NORMAL)
+    {
+        return EN_Bool::TRUE8;
+    }
+
+    srv->GetLatencyKey(&addr_mode, address, &command);
+    if (Health.Admit(addr_mode, address, command, &num_retries, COSAL::CTimer::GetTime()) == EN_Bool::TRUE8)
+    {
+        srv->SetNumRetries(num_retries);
+        return EN_Bool::TRUE8;
+    }
+
+    // The device is offline, the bus is not used for it
+    srv->SetCompletionCode(EN_SRV_Result::DEVICE_OFFLINE);
+    srv->SetStatus(CService::EN_Status::WAITING);
+    FireServiceEvent(CServiceEvent::CONFIRMATION, handle_, 0);
+    return EN_Bool::FALSE8;
+}
+
+void CChannel::RemoveReady(TY_Word idx_)
+{
+    // The order of the others is kept
+    for (TY_Word e = idx_ + 1; e < m_num_ready; e++)
+    {
+        m_ready[e - 1] = m_ready[e];
+    }
+    m_num_ready--;
+}
+
+EN_Bool CChannel::IsBefore(ST_Ready* ready_, ST_Ready* other_)
+{
+    if (ready_->Priority != other_->Priority)
+    {
+        return ((TY_Byte)ready_->Priority < (TY_Byte)other_->Priority) ? EN_Bool::TRUE8 : EN_Bool::FALSE8;
+    }
+
+    // Requests with a deadline before the others
+    if (ready_->HasDeadline != other_->HasDeadline)
+    {
+        return ready_->HasDeadline;
+    }
+
+    if ((ready_->HasDeadline == EN_Bool::TRUE8) && (ready_->Deadline != other_->Deadline))
+    {
+        return ((TY_Int32)(ready_->Deadline - other_->Deadline) < 0) ? EN_Bool::TRUE8 : EN_Bool::FALSE8;
+    }
+
+    return ((TY_Int32)(ready_->Sequence - other_->Sequence) < 0) ? EN_Bool::TRUE8 : EN_Bool::FALSE8;
+}
+
+SRV_Handle CChannel::GetBatchService()
+{
+    // Note: Called by the kernel only
+    ST_Batch*        batch;
+    TY_BatchRequest* request;
+    SRV_Handle       h_service;
+    TY_Byte          data_bytes[256];
+
+    if (m_active_batch == INVALID_WRD_HANDLE)
+    {
+        m_active_batch = m_requested_batches.Pop();
+        if (m_active_batch == INVALID_WRD_HANDLE)
+        {
+            return INVALID_SRV_HANDLE;
+        }
+    }
+
+    batch = &m_batches[m_active_batch];
+    if (batch->NextRequest > batch->NumCompleted)
+    {
+        // The previous request is still running
+        return INVALID_SRV_HANDLE;
+    }
+
+    request = &batch->Requests[batch->NextRequest];
+    if (request->Command > 255)
+    {
+        // Pack the 16 bit command at the beginning of the request data
+        CCoding::PutWord(request->Command, 0, data_bytes, EN_Endian::MSB_First);
+        COSAL::CMem::Copy(&data_bytes[2], request->BytesOfData, request->DataLen);
+        h_service = PrepareService(31, data_bytes, (TY_Byte)(request->DataLen + 2),
+            request->BytesOfUniqueID, BatchServiceCompleted, this);
+    }
+    else
+    {
+        h_service = PrepareService((TY_Byte)request->Command, request->BytesOfData, request->DataLen,
+            request->BytesOfUniqueID, BatchServiceCompleted, this);
+    }
+
+    if (h_service == INVALID_SRV_HANDLE)
+    {
+        // No free service, try again when one is released
+        return INVALID_SRV_HANDLE;
+    }
+
+    batch->NextRequest++;
+    GetServicePtr(h_service)->SetOwner(EN_Owner::PROTOCOL);
+    GetServicePtr(h_service)->SetStatus(CService::EN_Status::BUSY);
+    return h_service;
+}
+
+void CChannel::BatchServiceCompleted(SRV_Handle service_, void* context_)
+{
+    // Note: Called by the kernel only
+    CChannel*            channel = (CChannel*)context_;
+    ST_Batch*            batch = &channel->m_batches[channel->m_active_batch];
+    TY_BatchRequest*     request = &batch->Requests[batch->NumCompleted];
+    WRD_Handle           h_batch;
+    TY_CompletionHandler handler;
+    void*                context;
+
+    channel->GetServicePtr(service_)->GetConfirmation(&request->Confirmation);
+    channel->FreeService(service_);
+    batch->NumCompleted++;
+    if (batch->NumCompleted < batch->NumRequests)
+    {
+        return;
+    }
+
+    // The whole batch is done, take the handler before passing
+    // the batch back, it may be released at any time then
+    handler = batch->Handler;
+    context = batch->Context;
+    h_batch = batch->Handle;
+    channel->m_active_batch = INVALID_WRD_HANDLE;
+    channel->m_num_pending_batches--;
+    batch->IsCompleted.store(EN_Bool::TRUE8, std::memory_order_release);
+    channel->m_service_completed.Set();
+    if (handler != NULL)
+    {
+        handler(h_batch, context);
+    }
 }
 
 /* Get Configuration */
@@ -341,7 +1250,12 @@ EN_CommType CChannel::GetCommType(void)
 
 TY_Word CChannel::GetHartIpStatus()
 {
-    return CHMipMacPort::GetStatus();
+    return IpMacPort.GetStatus();
+}
+
+void CChannel::GetLoopbackConfig(TY_LoopbackConfig* config_)
+{
+    *config_ = m_loop_config;
 }
 
 /* Set Configuration */
@@ -398,11 +1312,52 @@ void CChannel::FireServiceEvent(TY_Byte event_, SRV_Handle handle_, TY_DWord dat
 {
     if (IsValidService(handle_) == EN_Bool::TRUE8)
     {
-        CService* srv = GetServicePtr(handle_);
+        CService*            srv = GetServicePtr(handle_);
+        void*                context;
+        TY_CompletionHandler handler = srv->GetCompletionHandler(&context);
 
         srv->SetLastEvent(event_);
-        // Pass back service to user
-        GetServicePtr(handle_)->SetOwner(EN_Owner::USER);
+        if ((event_ == CServiceEvent::CONFIRMATION) &&
+            (srv->GetMode() == CService::EN_Mode::NORMAL) &&
+            (srv->GetCompletionCode() != EN_SRV_Result::DEADLINE_MISSED) &&
+            (srv->GetCompletionCode() != EN_SRV_Result::DEVICE_OFFLINE))
+        {
+            RecordLatency(srv);
+        }
+
+        // Pass back service to user, from now on the
+        // service may be released at any time
+        srv->SetOwner(EN_Owner::USER);
+        m_service_completed.Set();
+        if (handler != NULL)
+        {
+            handler(handle_, context);
+        }
+    }
+}
+
+void CChannel::RecordLatency(CService* service_)
+{
+    // Note: Called by the kernel only
+    TY_DWord phases[CLatencyStats::CPhase::NUM_PHASES];
+    TY_Byte  address[5];
+    TY_Byte  addr_mode;
+    TY_Word  command;
+
+    service_->GetPhaseTimes(phases);
+    service_->GetLatencyKey(&addr_mode, address, &command);
+    Latency.Record(addr_mode, address, command,
+        (service_->GetCompletionCode() == EN_SRV_Result::SUCCESSFUL) ? EN_Bool::FALSE8 : EN_Bool::TRUE8,
+        service_->GetNumRetries(), phases);
+    // Only a missing response counts against the device. A garbled
+    // response, a service which was aborted by closing the channel
+    // and the like don't tell anything about it.
+    if ((service_->GetCompletionCode() == EN_SRV_Result::SUCCESSFUL) ||
+        (service_->GetCompletionCode() == EN_SRV_Result::NO_DEV_RESP))
+    {
+        Health.Record(addr_mode, address,
+            (service_->GetCompletionCode() == EN_SRV_Result::NO_DEV_RESP) ? EN_Bool::TRUE8 : EN_Bool::FALSE8,
+            service_->GetNumRetries(), phases[CLatencyStats::CPhase::TURNAROUND], COSAL::CTimer::GetTime());
     }
 }
 
@@ -450,8 +1405,19 @@ void CChannel::SetHartIpUseAddress(EN_Bool hart_ip_use_address_)
     HartIpUseAddress = hart_ip_use_address_;
 }
 
+EN_Bool CChannel::SetLoopbackConfig(TY_LoopbackConfig* config_)
+{
+    if ((config_->NumDevices == 0) || (config_->NumDevices > MAX_NUM_LOOP_DEVICES))
+    {
+        return EN_Bool::FALSE8;
+    }
+
+    // Takes effect with the next Open()
+    m_loop_config = *config_;
+    return EN_Bool::TRUE8;
+}
+
 void CChannel::BurstIndicate(CFrame* frame_)
 {
-    // ToDo
-    // mpcl_CyclicService->AddCyclicData(pcl_Frame);
+    Bursts.Store(frame_);
 }
@@ -14,32 +14,84 @@
  * Copyright 2006-2025 Walter Borst, Cuxhaven, Germany
  */
 
+// Once
+#ifndef __hartchannel_h__
+#define __hartchannel_h__
+
 #include "OSAL.h"
 #include "WbHartUser.h"
+#include "HartFrame.h"
+#include "HartService.h"
+#include "HartServiceQueue.h"
+#include "HartFramePool.h"
+#include "HartPreparedRequest.h"
+#include "Monitor.h"
+#include "HMuartLayer2.h"
+#include "HMipLayer2.h"
+#include "HMloopMacPort.h"
+#include "HartLatency.h"
+#include "HartBurstCache.h"
+#include "HartDeviceHealth.h"
 
-class CService;
 class CChannel
 {
-    // Since only one channel is initially supported in this
-    // version of the implementation, the channel class is
-    // purely static.
+    // Each channel owns the complete protocol stack of one Hart
+    // loop (layer 2 state machines, mac port and monitor). Any
+    // number of channels may be served by the kernel at a time.
 public:
-
-
-    static EN_Bool                   Open(TY_Word port_number_, EN_CommType type_);
-    static void                     Close();
-    static EN_Bool                 IsOpen();
-    static void                      Init();
+                          CChannel();
+                         ~CChannel();
+    EN_Bool                   Open(TY_Word port_number_, EN_CommType type_);
+    void                     Close();
+    EN_Bool                 IsOpen();
+    void                      Init();
     // Service handling
-    static SRV_Handle       GetNewService();
-    static CService*        GetServicePtr(SRV_Handle handle_);
-    static void            ReleaseService(SRV_Handle handle_);
-    static EN_Bool         IsValidService(SRV_Handle handle_);
-    static EN_Bool     IsServiceCompleted(SRV_Handle handle_);
-    static void           SetServiceOwner(SRV_Handle handle_, EN_Owner owner_);
-    static EN_Owner       GetServiceOwner(SRV_Handle handle_);
-    static void               FreeService(SRV_Handle handle_);
-    static SRV_Handle GetRequestedService();
+    // The pool is allocated by Open() with the configured number
+    // of services, a change takes effect with the next Open()
+    EN_Bool         SetNumServices(TY_Word num_services_);
+    TY_Word         GetNumServices();
+    SRV_Handle       GetNewService();
+    CService*        GetServicePtr(SRV_Handle handle_);
+    void            ReleaseService(SRV_Handle handle_);
+    EN_Bool         IsValidService(SRV_Handle handle_);
+    EN_Bool     IsServiceCompleted(SRV_Handle handle_);
+    // FALSE8: The service could not be passed to the kernel, it is
+    // completed with RESOURCE_ERROR and owned by the user again
+    EN_Bool        SetServiceOwner(SRV_Handle handle_, EN_Owner owner_);
+    EN_Owner       GetServiceOwner(SRV_Handle handle_);
+    void               FreeService(SRV_Handle handle_);
+    SRV_Handle      PrepareService(TY_Byte command_, TY_Byte* data_ref_, TY_Byte data_len_,
+                        TY_Byte* bytes_of_unique_id_, TY_CompletionHandler handler_, void* context_);
+    SRV_Handle GetRequestedService();
+    void              RetryService(SRV_Handle handle_);
+    // Completion
+    EN_Bool         WaitForService(SRV_Handle handle_, TY_DWord timeout_ms_);
+    PTR_Handle     GetCompletionHandle();
+    // Batch handling
+    WRD_Handle         LaunchBatch(TY_BatchRequest* requests_, TY_Word num_requests_,
+                        TY_CompletionHandler handler_, void* context_);
+    EN_Bool       IsBatchCompleted(WRD_Handle batch_);
+    EN_Bool           WaitForBatch(WRD_Handle batch_, TY_DWord timeout_ms_);
+    void              ReleaseBatch(WRD_Handle batch_);
+    // Prepared requests
+    WRD_Handle      PrepareRequest(TY_Word command_, TY_Byte* data_ref_, TY_Byte data_len_,
+                        TY_Byte* bytes_of_unique_id_);
+    EN_Bool     UpdatePreparedData(WRD_Handle prepared_, TY_Byte offset_, TY_Byte* data_ref_, TY_Byte len_);
+    SRV_Handle      LaunchPrepared(WRD_Handle prepared_, TY_CompletionHandler handler_, void* context_);
+    void           ReleasePrepared(WRD_Handle prepared_);
+    // Operation (kernel)
+    void                    Execute(TY_Word time_ms_);
+    void                     WakeUp();
+    // A channel which is closed or deleted by one of its own
+    // handlers is only marked. Execute() completes it as soon
+    // as the protocol stack is left.
+    EN_Bool             IsExecuting();
+    void                DeleteLater();
+    // Held by the channel table and by the interface calls which
+    // use the channel. The last unpin deletes the channel, it is
+    // taken from the table then.
+    void                        Pin();
+    void                      Unpin();
 
 public:
     class CProtocol
@@ -50,66 +102,170 @@ public:
         static const TY_Byte    SLAVE = 2;
     };
 private:
-    static EN_Bool        m_is_open;
-    static EN_CommType    m_comm_type;
-    static TY_Word        m_port_number;
-    static TY_Byte        m_protocol;
-    static COSAL::CTask   m_CTask_cyclic_50ms;
-    static TY_Word        m_num_active_services;
-    static CService       m_CService_pool[MAX_NUM_SERVICES];
-    static TY_DWord       m_baudrate;
-    static TY_Byte        m_num_preambles;
-    static TY_Byte        m_num_retries;
-    static EN_Bool        m_retry_if_busy;
-    static EN_Master      m_master_type;
-    static TY_Byte        m_addressing_mode;
-    static EN_Bool        m_hart_enabled;
-    static TY_Byte        m_hart_version;
-    static EN_Master      m_local_master;
-    static TY_Word        m_next_srv_search_idx;
+    EN_Bool        m_is_open;
+    EN_Bool        m_close_pending;
+    EN_Bool        m_delete_pending;
+    std::atomic<TY_Word> m_num_pins;
+    // Channel executed by the calling thread, if any
+    static thread_local CChannel* s_executing;
+    EN_CommType    m_comm_type;
+    TY_Word        m_port_number;
+    TY_Byte        m_protocol;
+    COSAL::CTask   m_CTask_cyclic_50ms;
+    // A service handle carries the index of the service in the
+    // pool (low bits) and a generation (high bits), which is
+    // advanced on every allocation. So a handle which is used
+    // after the service was released is rejected.
+    static const TY_Word SRV_INDEX_BITS = 10;
+    static const TY_Word SRV_INDEX_MASK = (1 << SRV_INDEX_BITS) - 1;
+    // Same for the handles of batches and prepared requests
+    static const TY_Word WRD_INDEX_BITS = 6;
+    static const TY_Word WRD_INDEX_MASK = (1 << WRD_INDEX_BITS) - 1;
+    // Each protocol handler holds up to five frames (work, junk,
+    // request, response and burst), each service one response
+    static const TY_Word NUM_PROTOCOL_FRAMES = 10;
+    CService*      m_CService_pool;
+    TY_Word        m_pool_size;
+    TY_Word        m_num_services;
+    // Indices of the pool which are not in use
+    CServiceQueue  m_free_services;
+    // Handles passed to the kernel, taken over into the ready list
+    CServiceQueue  m_requested_services;
+    SRV_Handle     m_retry_service;
+    // Requests waiting for the bus, owned by the kernel. Served by
+    // priority class, within a class the earliest deadline first,
+    // then in order of arrival.
+    typedef struct st_Ready
+    {
+        SRV_Handle           Handle;
+        EN_Priority          Priority;
+        EN_Bool              HasDeadline;
+        TY_DWord             Deadline;
+        TY_DWord             Sequence;
+    } ST_Ready;
+    ST_Ready*      m_ready;
+    TY_Word        m_ready_size;
+    TY_Word        m_num_ready;
+    TY_DWord       m_ready_sequence;
+    // Set whenever a service is passed back to the user
+    COSAL::CSignal m_service_completed;
+    // Batches, the requests are dispatched by the kernel
+    // one after the other as soon as layer 2 is ready
+    typedef struct st_Batch
+    {
+        TY_BatchRequest*     Requests;
+        TY_Word              NumRequests;
+        TY_Word              NextRequest;
+        TY_Word              NumCompleted;
+        TY_CompletionHandler Handler;
+        void*                Context;
+        WRD_Handle           Handle;
+        EN_Bool              IsUsed;
+        std::atomic<EN_Bool> IsCompleted;
+    } ST_Batch;
+    ST_Batch       m_batches[MAX_NUM_BATCHES];
+    CServiceQueue  m_free_batches;
+    CServiceQueue  m_requested_batches;
+    WRD_Handle     m_active_batch;
+    std::atomic<TY_Word> m_num_pending_batches;
+    // Requests which are encoded once and launched repeatedly,
+    // they are used by the application only
+    CPreparedRequest m_prepared[MAX_NUM_PREPARED_REQUESTS];
+    WRD_Handle     m_prepared_handles[MAX_NUM_PREPARED_REQUESTS];
+    CServiceQueue  m_free_prepared;
+
+    EN_Bool          CreateServicePool();
+    void            DestroyServicePool();
+    void              ResetServicePool();
+    void                  AbortBatches();
+    static WRD_Handle     GetNextHandle(WRD_Handle handle_, WRD_Handle idx_);
+    WRD_Handle          GetBatchIndex(WRD_Handle batch_);
+    WRD_Handle       GetPreparedIndex(WRD_Handle prepared_);
+    void               RecordLatency(CService* service_);
+    SRV_Handle         GetBatchService();
+    void                  AddReady(SRV_Handle handle_);
+    SRV_Handle       GetReadyService();
+    EN_Bool            AdmitService(SRV_Handle handle_);
+    void               RemoveReady(TY_Word idx_);
+    static EN_Bool        IsBefore(ST_Ready* ready_, ST_Ready* other_);
+    static void  BatchServiceCompleted(SRV_Handle service_, void* context_);
+    TY_DWord       m_baudrate;
+    TY_Byte        m_num_preambles;
+    TY_Byte        m_num_retries;
+    EN_Bool        m_retry_if_busy;
+    EN_Master      m_master_type;
+    TY_Byte        m_addressing_mode;
+    EN_Bool        m_hart_enabled;
+    TY_Byte        m_hart_version;
+    EN_Master      m_local_master;
+    TY_LoopbackConfig m_loop_config;
 public:
+    // Protocol stack
+    CHMuartMacPort  UartMacPort;
+    CHMuartProtocol UartProtocol;
+    CHMuartL2SM     UartL2SM;
+    CHMuartL2RxSM   UartL2RxSM;
+    CHMuartL2TxSM   UartL2TxSM;
+    CHMipMacPort    IpMacPort;
+    CHMipProtocol   IpProtocol;
+    CHMipL2SM       IpL2SM;
+    CHMipL2RxSM     IpL2RxSM;
+    CHMipL2TxSM     IpL2TxSM;
+    // Loopback, the uart state machines talk to a virtual wire
+    CHMloopMacPort  LoopMacPort;
+    CMonitor        Monitor;
+    // Received frames, passed on without a copy
+    CFramePool      Frames;
+    // Latency of the completed services
+    CLatencyStats   Latency;
+    // Latest burst responses of the devices
+    CBurstCache     Bursts;
+    // Response times and errors of the devices, adapts the retries
+    CDeviceHealth   Health;
     // HartIp globals
-    static TY_Byte        HartIpHostName[MAX_STRING_LEN];
-    static TY_Byte        HartIpAddress[MAX_STRING_LEN];
-    static TY_Byte        HartIpPort[MAX_STRING_LEN];
-    static EN_Bool        HartIpUseAddress;
-    static EN_Bool        HartIpEnabled;
-    static EN_Bool        HartIpSendKeepAlive;
+    TY_Byte        HartIpHostName[MAX_STRING_LEN];
+    TY_Byte        HartIpAddress[MAX_STRING_LEN];
+    TY_Byte        HartIpPort[MAX_STRING_LEN];
+    EN_Bool        HartIpUseAddress;
+    EN_Bool        HartIpEnabled;
+    EN_Bool        HartIpSendKeepAlive;
     /* Get Configuration */
-    static TY_DWord            GetBaudrate(void);
-    static TY_Byte         GetNumPreambles(void);
-    static TY_Byte           GetNumRetries(void);
-    static EN_Bool          GetRetryIfBusy(void);
-    static EN_Master         GetMasterType(void);
-    static TY_Byte       GetAddressingMode(void);
-    static EN_Bool          GetHartEnabled(void);
-    static TY_Byte          GetHartVersion(void);
-    static EN_Bool         IsPrimaryMaster(void);
-    static void        FetchHartIpHostName(TY_Byte* hart_ip_host_name_);
-    static void         FetchHartIpAddress(TY_Byte* hart_ip_address_);
-    static void         FetchHartIpPort(TY_Byte* hart_ip_address_);
-    static TY_Word           GetHartIpPort(void);
-    static EN_Bool     GetHartIpUseAddress(void);
-    static EN_CommType         GetCommType(void);
-    static TY_Word         GetHartIpStatus(void);
+    TY_DWord            GetBaudrate(void);
+    TY_Byte         GetNumPreambles(void);
+    TY_Byte           GetNumRetries(void);
+    EN_Bool          GetRetryIfBusy(void);
+    EN_Master         GetMasterType(void);
+    TY_Byte       GetAddressingMode(void);
+    EN_Bool          GetHartEnabled(void);
+    TY_Byte          GetHartVersion(void);
+    EN_Bool         IsPrimaryMaster(void);
+    void        FetchHartIpHostName(TY_Byte* hart_ip_host_name_);
+    void         FetchHartIpAddress(TY_Byte* hart_ip_address_);
+    void         FetchHartIpPort(TY_Byte* hart_ip_address_);
+    TY_Word           GetHartIpPort(void);
+    EN_Bool     GetHartIpUseAddress(void);
+    EN_CommType         GetCommType(void);
+    TY_Word         GetHartIpStatus(void);
+    void        GetLoopbackConfig(TY_LoopbackConfig* config_);
 
     /* Set Configuration */
-    static void                SetBaudrate(TY_DWord baudrate_);
-    static void            SetNumPreambles(TY_Byte num_preambles_);
-    static void              SetNumRetries(TY_Byte num_retries_);
-    static void             SetRetryIfBusy(EN_Bool retry_if_busy_);
-    static void              SetMasterType(EN_Master master_type_);
-    static void          SetAddressingMode(TY_Byte addressing_mode_);
-    static void             SetHartEnabled(EN_Bool enabled_);
-    static void             SetHartVersion(TY_Byte hart_version_);
-    static void           FireServiceEvent(TY_Byte event_, SRV_Handle handle_, TY_DWord data_);
-    static void          SetHartIpHostName(TY_Byte* hart_ip_host_name_);
-    static void           SetHartIpAddress(TY_Byte* hart_ip_address_);
-    static void              SetHartIpPort(TY_Byte* hart_ip_port_);
-    static void        SetHartIpUseAddress(EN_Bool hart_ip_use_address_);
+    void                SetBaudrate(TY_DWord baudrate_);
+    void            SetNumPreambles(TY_Byte num_preambles_);
+    void              SetNumRetries(TY_Byte num_retries_);
+    void             SetRetryIfBusy(EN_Bool retry_if_busy_);
+    void              SetMasterType(EN_Master master_type_);
+    void          SetAddressingMode(TY_Byte addressing_mode_);
+    void             SetHartEnabled(EN_Bool enabled_);
+    void             SetHartVersion(TY_Byte hart_version_);
+    void           FireServiceEvent(TY_Byte event_, SRV_Handle handle_, TY_DWord data_);
+    void          SetHartIpHostName(TY_Byte* hart_ip_host_name_);
+    void           SetHartIpAddress(TY_Byte* hart_ip_address_);
+    void              SetHartIpPort(TY_Byte* hart_ip_port_);
+    void        SetHartIpUseAddress(EN_Bool hart_ip_use_address_);
+    EN_Bool     SetLoopbackConfig(TY_LoopbackConfig* config_);
 
     /* Cyclic Data Handling */
-    static void              BurstIndicate(CFrame* frame_);
+    void              BurstIndicate(CFrame* frame_);
 
     class CServiceEvent
     {
@@ -120,3 +276,5 @@ public:
         static const TY_Word          REQUEST = 3;
     };
 };
+
+#endif // __hartchannel_h__
@@ -0,0 +1,305 @@
+/*
+ *          File: HartDeviceHealth.cpp (CDeviceHealth)
+ *                The health is recorded and checked by the kernel
+ *                thread and queried by the application, both under
+ *                the lock of the table.
+ *
+ *        Author: Walter Borst
+ *
+ *        E-Mail: info@borst-automation.de
+ *          Home: https://www.borst-automation.de
+ *
+ * No Warranties: https://www.borst-automation.com/legal/warranty-disclaimer
+ *
+ * Copyright 2006-2025 Walter Borst, Cuxhaven, Germany
+ */
+
+#include "HartDeviceHealth.h"
+#include "HartConsts.h"
+#include "HartLatency.h"
+
+// Methods
+CDeviceHealth::CDeviceHealth()
+{
+    m_num_entries = 0;
+    m_config.IsAdaptive = EN_Bool::TRUE8;
+    m_config.OfflineFailures = OFFLINE_FAILURES;
+    m_config.MinBackoff = MIN_BACKOFF;
+    m_config.MaxBackoff = MAX_BACKOFF;
+}
+
+void CDeviceHealth::Reset()
+{
+    m_lock.Lock();
+    m_num_entries = 0;
+    m_lock.Unlock();
+}
+
+EN_Bool CDeviceHealth::SetConfig(TY_HealthConfig* config_)
+{
+    if ((config_->OfflineFailures == 0) || (config_->MinBackoff == 0) ||
+        (config_->MaxBackoff < config_->MinBackoff))
+    {
+        return EN_Bool::FALSE8;
+    }
+
+    m_lock.Lock();
+    m_config = *config_;
+    for (TY_Word e = 0; e < m_num_entries; e++)
+    {
+        ST_Entry* entry = &m_entries[e];
+
+        if (m_config.IsAdaptive == EN_Bool::FALSE8)
+        {
+            // The devices which are offline are served again
+            entry->IsOffline = EN_Bool::FALSE8;
+        }
+        else if (entry->Backoff > m_config.MaxBackoff)
+        {
+            entry->Backoff = m_config.MaxBackoff;
+        }
+    }
+
+    m_lock.Unlock();
+    return EN_Bool::TRUE8;
+}
+
+void CDeviceHealth::GetConfig(TY_HealthConfig* config_)
+{
+    m_lock.Lock();
+    *config_ = m_config;
+    m_lock.Unlock();
+}
+
+void CDeviceHealth::Record(TY_Byte addr_mode_, TY_Byte* address_, EN_Bool failed_,
+    TY_Byte num_retries_, TY_DWord turnaround_ms_, TY_DWord now_)
+{
+    ST_Entry* entry;
+    TY_Word   num_failed_attempts = num_retries_;
+
+    m_lock.Lock();
+    entry = FindEntry(addr_mode_, address_);
+    if (entry == NULL)
+    {
+        if (m_num_entries >= MAX_NUM_HEALTH_ENTRIES)
+        {
+            // Devices which find no entry are not adapted
+            m_lock.Unlock();
+            return;
+        }
+
+        entry = &m_entries[m_num_entries++];
+        COSAL::CMem::Set((TY_Byte*)entry, 0, sizeof(ST_Entry));
+        entry->AddrMode = addr_mode_;
+        COSAL::CMem::Copy(entry->Address, address_, 5);
+    }
+
+    entry->NumServices++;
+    if (failed_ == EN_Bool::TRUE8)
+    {
+        entry->NumFailed++;
+        num_failed_attempts++;
+    }
+
+    // Each attempt moves the rate by 1/2^ERROR_RATE_SHIFT
+    // of the distance to one (failed) or zero
+    for (TY_Word e = 0; e < num_failed_attempts; e++)
+    {
+        entry->ErrorRate = (TY_Word)(entry->ErrorRate + ((ERROR_RATE_ONE - entry->ErrorRate) >> ERROR_RATE_SHIFT));
+    }
+
+    if (failed_ == EN_Bool::FALSE8)
+    {
+        entry->ErrorRate = (TY_Word)(entry->ErrorRate - (entry->ErrorRate >> ERROR_RATE_SHIFT));
+        if (turnaround_ms_ != CLatencyStats::NOT_REACHED)
+        {
+            if (entry->Turnaround == 0)
+            {
+                entry->Turnaround = turnaround_ms_;
+            }
+            else
+            {
+                entry->Turnaround = (TY_DWord)((TY_Int32)entry->Turnaround +
+                    (((TY_Int32)turnaround_ms_ - (TY_Int32)entry->Turnaround) >> TURNAROUND_SHIFT));
+            }
+        }
+
+        entry->NumFailedInRow = 0;
+        entry->IsOffline = EN_Bool::FALSE8;
+        entry->Backoff = 0;
+        m_lock.Unlock();
+        return;
+    }
+
+    if (entry->NumFailedInRow < 0xff)
+    {
+        entry->NumFailedInRow++;
+    }
+
+    if (m_config.IsAdaptive == EN_Bool::FALSE8)
+    {
+        // Recorded only, no device is taken offline
+        m_lock.Unlock();
+        return;
+    }
+
+    if (entry->IsOffline == EN_Bool::TRUE8)
+    {
+        // The probe failed as well
+        entry->Backoff = ((2 * entry->Backoff) < m_config.MaxBackoff) ? (2 * entry->Backoff) : m_config.MaxBackoff;
+        entry->NextProbe = now_ + entry->Backoff;
+    }
+    else if (entry->NumFailedInRow >= m_config.OfflineFailures)
+    {
+        entry->IsOffline = EN_Bool::TRUE8;
+        entry->Backoff = m_config.MinBackoff;
+        entry->NextProbe = now_ + entry->Backoff;
+    }
+
+    m_lock.Unlock();
+}
+
+EN_Bool CDeviceHealth::Admit(TY_Byte addr_mode_, TY_Byte* address_, TY_Word command_,
+    TY_Byte* num_retries_, TY_DWord now_)
+{
+    ST_Entry* entry;
+    TY_Byte   max_retries;
+
+    m_lock.Lock();
+    entry = FindEntry(addr_mode_, address_);
+    if ((entry == NULL) || (m_config.IsAdaptive == EN_Bool::FALSE8))
+    {
+        m_lock.Unlock();
+        return EN_Bool::TRUE8;
+    }
+
+    if (entry->IsOffline == EN_Bool::TRUE8)
+    {
+        // Command 0 finds a device which is back, it is always
+        // sent. Otherwise one probe per backoff time.
+        if ((command_ != 0) && ((TY_Int32)(now_ - entry->NextProbe) < 0))
+        {
+            entry->NumSkipped++;
+            m_lock.Unlock();
+            return EN_Bool::FALSE8;
+        }
+
+        entry->NextProbe = now_ + entry->Backoff;
+    }
+
+    max_retries = GetMaxRetries(entry);
+    if (*num_retries_ > max_retries)
+    {
+        *num_retries_ = max_retries;
+    }
+
+    m_lock.Unlock();
+    return EN_Bool::TRUE8;
+}
+
+EN_Bool CDeviceHealth::Query(TY_Byte* bytes_of_unique_id_, TY_DeviceHealth* health_)
+{
+    ST_Entry* entry;
+
+    m_lock.Lock();
+    entry = FindEntry(CHart::CAddrMode::UNIQUE, bytes_of_unique_id_);
+    if (entry == NULL)
+    {
+        m_lock.Unlock();
+        COSAL::CMem::Set((TY_Byte*)health_, 0, sizeof(TY_DeviceHealth));
+        health_->PollAddress = 0xff;
+        COSAL::CMem::Copy(health_->BytesOfUniqueID, bytes_of_unique_id_, 5);
+        health_->MaxRetries = NO_LIMIT;
+        return EN_Bool::FALSE8;
+    }
+
+    FillHealth(entry, health_, COSAL::CTimer::GetTime());
+    m_lock.Unlock();
+    return EN_Bool::TRUE8;
+}
+
+TY_Word CDeviceHealth::GetNumEntries()
+{
+    return m_num_entries;
+}
+
+EN_Bool CDeviceHealth::FetchEntry(TY_Word index_, TY_DeviceHealth* health_)
+{
+    m_lock.Lock();
+    if (index_ >= m_num_entries)
+    {
+        m_lock.Unlock();
+        return EN_Bool::FALSE8;
+    }
+
+    FillHealth(&m_entries[index_], health_, COSAL::CTimer::GetTime());
+    m_lock.Unlock();
+    return EN_Bool::TRUE8;
+}
+
+// Helpers
+CDeviceHealth::ST_Entry* CDeviceHealth::FindEntry(TY_Byte addr_mode_, TY_Byte* address_)
+{
+    for (TY_Word e = 0; e < m_num_entries; e++)
+    {
+        ST_Entry* entry = &m_entries[e];
+
+        if ((entry->AddrMode == addr_mode_) &&
+            (COSAL::CMem::IsEqual(entry->Address, address_, 5) == EN_Bool::TRUE8))
+        {
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+TY_Byte CDeviceHealth::GetMaxRetries(ST_Entry* entry_)
+{
+    // Retries pay off as long as most attempts succeed. A device
+    // which failed the last service or most of the last attempts
+    // gets one retry, an offline device only the probe.
+    if (m_config.IsAdaptive == EN_Bool::FALSE8)
+    {
+        return NO_LIMIT;
+    }
+
+    if (entry_->IsOffline == EN_Bool::TRUE8)
+    {
+        return 0;
+    }
+
+    if ((entry_->NumFailedInRow > 0) || (entry_->ErrorRate > ERROR_RATE_HIGH))
+    {
+        return 1;
+    }
+
+    return NO_LIMIT;
+}
+
+void CDeviceHealth::FillHealth(ST_Entry* entry_, TY_DeviceHealth* health_, TY_DWord now_)
+{
+    if (entry_->AddrMode == CHart::CAddrMode::UNIQUE)
+    {
+        health_->PollAddress = 0xff;
+        COSAL::CMem::Copy(health_->BytesOfUniqueID, entry_->Address, 5);
+    }
+    else
+    {
+        health_->PollAddress = entry_->Address[0];
+        COSAL::CMem::Set(health_->BytesOfUniqueID, 0, 5);
+    }
+
+    health_->NumServices = entry_->NumServices;
+    health_->NumFailed = entry_->NumFailed;
+    health_->NumSkipped = entry_->NumSkipped;
+    health_->ErrorRate = (TY_Word)(((TY_DWord)entry_->ErrorRate * 1000 + ERROR_RATE_ONE / 2) / ERROR_RATE_ONE);
+    health_->Turnaround = entry_->Turnaround;
+    health_->MaxRetries = GetMaxRetries(entry_);
+    health_->IsOffline = entry_->IsOffline;
+    health_->NextProbe = 0;
+    if ((entry_->IsOffline == EN_Bool::TRUE8) && ((TY_Int32)(entry_->NextProbe - now_) > 0))
+    {
+        health_->NextProbe = entry_->NextProbe - now_;
+    }
+}
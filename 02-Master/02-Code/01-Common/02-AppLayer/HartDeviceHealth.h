@@ -0,0 +1,94 @@
+/*
+ *          File: HartDeviceHealth.h (CDeviceHealth)
+ *                Response times and error rates of the devices of a
+ *                channel. The kernel records each completed service
+ *                and asks before a request is sent: A device which
+ *                fails gets fewer retries, a device which is offline
+ *                gets a probe now and then instead of every request.
+ *                The adaption is configured per channel or turned off.
+ *
+ *        Author: Walter Borst
+ *
+ *        E-Mail: info@borst-automation.de
+ *          Home: https://www.borst-automation.de
+ *
+ * No Warranties: https://www.borst-automation.com/legal/warranty-disclaimer
+ *
+ * Copyright 2006-2025 Walter Borst, Cuxhaven, Germany
+ */
+
+// Once
+#ifndef __hartdevicehealth_h__
+#define __hartdevicehealth_h__
+
+#include "OSAL.h"
+#include "WbHartUser.h"
+#include "WbHartM_Structures.h"
+
+class CDeviceHealth
+{
+public:
+    // Retries of a request which are not limited
+    static const TY_Byte NO_LIMIT = 0xff;
+
+                          CDeviceHealth();
+    void                      Reset();
+    // Applied at once, FALSE8: Invalid configuration
+    EN_Bool               SetConfig(TY_HealthConfig* config_);
+    void                  GetConfig(TY_HealthConfig* config_);
+    // Called by the kernel when a service is completed, failed_:
+    // No response after all attempts
+    void                     Record(TY_Byte addr_mode_, TY_Byte* address_, EN_Bool failed_,
+                               TY_Byte num_retries_, TY_DWord turnaround_ms_, TY_DWord now_);
+    // Called by the kernel before a request is sent. FALSE8: The device
+    // is offline, don't send. Otherwise the retries are limited.
+    EN_Bool                   Admit(TY_Byte addr_mode_, TY_Byte* address_, TY_Word command_,
+                               TY_Byte* num_retries_, TY_DWord now_);
+    EN_Bool                   Query(TY_Byte* bytes_of_unique_id_, TY_DeviceHealth* health_);
+    TY_Word           GetNumEntries();
+    EN_Bool              FetchEntry(TY_Word index_, TY_DeviceHealth* health_);
+
+private:
+    // Error rates are fractions of ERROR_RATE_ONE, smoothed by
+    // 1/2^ERROR_RATE_SHIFT of each attempt
+    static const TY_Word   ERROR_RATE_ONE = 0x8000;
+    static const TY_Byte ERROR_RATE_SHIFT = 3;
+    // Above this rate a request gets one retry only
+    static const TY_Word  ERROR_RATE_HIGH = 0x6000;
+    // Turnarounds are smoothed by 1/2^TURNAROUND_SHIFT
+    static const TY_Byte TURNAROUND_SHIFT = 2;
+    // Defaults of the configuration: Failed services in a row until
+    // a device is offline and the time between the probes of an
+    // offline device, doubled with each probe which failed
+    static const TY_Byte  OFFLINE_FAILURES = 3;
+    static const TY_DWord      MIN_BACKOFF = 1000;
+    static const TY_DWord      MAX_BACKOFF = 60000;
+
+    typedef struct st_Entry
+    {
+        TY_Byte      AddrMode;
+        // Unique ID or the polling address in the first byte
+        TY_Byte      Address[5];
+        TY_DWord     NumServices;
+        TY_DWord     NumFailed;
+        TY_DWord     NumSkipped;
+        TY_Word      ErrorRate;
+        TY_DWord     Turnaround;
+        TY_Byte      NumFailedInRow;
+        EN_Bool      IsOffline;
+        TY_DWord     Backoff;
+        TY_DWord     NextProbe;
+    } ST_Entry;
+
+    ST_Entry*             FindEntry(TY_Byte addr_mode_, TY_Byte* address_);
+    TY_Byte           GetMaxRetries(ST_Entry* entry_);
+    void                 FillHealth(ST_Entry* entry_, TY_DeviceHealth* health_, TY_DWord now_);
+
+    ST_Entry       m_entries[MAX_NUM_HEALTH_ENTRIES];
+    TY_Word        m_num_entries;
+    TY_HealthConfig m_config;
+    // Recording by the kernel, queries by the application
+    COSAL::CLock   m_lock;
+};
+
+#endif // __hartdevicehealth_h__
@@ -0,0 +1,130 @@
+/*
+ *          File: HartFramePool.cpp (CFramePool)
+ *                A pool of reference counted frames. The frames are taken
+ *                and released without a lock, the kernel and the
+ *                application may do so at the same time.
+ *
+ *        Author: Walter Borst
+ *
+ *        E-Mail: info@borst-automation.de
+ *          Home: https://www.borst-automation.de
+ *
+ * No Warranties: https://www.borst-automation.com/legal/warranty-disclaimer
+ *
+ * Copyright 2006-2025 Walter Borst, Cuxhaven, Germany
+ */
+
+#include <new>
+#include "HartFramePool.h"
+
+// Methods
+CFramePool::CFramePool()
+{
+    m_entries = NULL;
+    m_num_frames = 0;
+}
+
+CFramePool::~CFramePool()
+{
+    Destroy();
+}
+
+EN_Bool CFramePool::Create(TY_Word num_frames_)
+{
+    // Note: Not thread safe, only for initialization
+    Destroy();
+    m_entries = new (std::nothrow) ST_Entry[num_frames_];
+    if (m_entries == NULL)
+    {
+        return EN_Bool::FALSE8;
+    }
+
+    if (m_free_frames.Create(num_frames_) == EN_Bool::FALSE8)
+    {
+        Destroy();
+        return EN_Bool::FALSE8;
+    }
+
+    m_num_frames = num_frames_;
+    Reset();
+    return EN_Bool::TRUE8;
+}
+
+void CFramePool::Reset()
+{
+    // Note: Not thread safe, only for initialization
+    m_free_frames.Clear();
+    for (TY_Word e = 0; e < m_num_frames; e++)
+    {
+        m_entries[e].RefCount.store(0, std::memory_order_relaxed);
+        m_free_frames.Push(e);
+    }
+}
+
+void CFramePool::Destroy()
+{
+    if (m_entries != NULL)
+    {
+        delete[] m_entries;
+        m_entries = NULL;
+    }
+
+    m_num_frames = 0;
+    m_free_frames.Destroy();
+}
+
+CFrame* CFramePool::Acquire()
+{
+    TY_Word idx = m_free_frames.Pop();
+
+    if (idx == INVALID_SRV_HANDLE)
+    {
+        return NULL;
+    }
+
+    m_entries[idx].RefCount.store(1, std::memory_order_relaxed);
+    m_entries[idx].Frame.Init();
+    return &m_entries[idx].Frame;
+}
+
+void CFramePool::AddRef(CFrame* frame_)
+{
+    ST_Entry* entry = GetEntry(frame_);
+
+    if (entry != NULL)
+    {
+        entry->RefCount.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void CFramePool::Release(CFrame* frame_)
+{
+    ST_Entry* entry = GetEntry(frame_);
+
+    if (entry != NULL)
+    {
+        // The last holder passes the frame back to the pool
+        if (entry->RefCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            m_free_frames.Push((TY_Word)(entry - m_entries));
+        }
+    }
+}
+
+CFramePool::ST_Entry* CFramePool::GetEntry(CFrame* frame_)
+{
+    TY_Word idx;
+
+    if ((frame_ == NULL) || (m_entries == NULL))
+    {
+        return NULL;
+    }
+
+    idx = (TY_Word)(((TY_Byte*)frame_ - (TY_Byte*)&m_entries[0].Frame) / sizeof(ST_Entry));
+    if ((idx >= m_num_frames) || (&m_entries[idx].Frame != frame_))
+    {
+        return NULL;
+    }
+
+    return &m_entries[idx];
+}
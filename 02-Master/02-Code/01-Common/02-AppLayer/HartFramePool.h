@@ -0,0 +1,59 @@
+/*
+ *          File: HartFramePool.h (CFramePool)
+ *                The received frames of a channel are taken from this pool.
+ *                A frame is filled once by the parser and then handed on
+ *                by its pointer, to the layer 2 state machine, to the
+ *                service and finally to the application. Each holder owns
+ *                a reference, the frame returns to the pool when the last
+ *                one is released.
+ *
+ *        Author: Walter Borst
+ *
+ *        E-Mail: info@borst-automation.de
+ *          Home: https://www.borst-automation.de
+ *
+ * No Warranties: https://www.borst-automation.com/legal/warranty-disclaimer
+ *
+ * Copyright 2006-2025 Walter Borst, Cuxhaven, Germany
+ */
+
+// Once
+#ifndef __hartframepool_h__
+#define __hartframepool_h__
+
+#include <atomic>
+#include "OSAL.h"
+#include "WbHartUser.h"
+#include "HartFrame.h"
+#include "HartServiceQueue.h"
+
+class CFramePool
+{
+public:
+                           CFramePool();
+                          ~CFramePool();
+    EN_Bool                    Create(TY_Word num_frames_);
+    void                      Destroy();
+    // All frames are free again, the references are dropped
+    void                        Reset();
+    // Returns an initialized frame with one reference
+    CFrame*                   Acquire();
+    void                       AddRef(CFrame* frame_);
+    void                      Release(CFrame* frame_);
+
+private:
+    typedef struct st_Entry
+    {
+        CFrame                Frame;
+        std::atomic<TY_Word>  RefCount;
+    } ST_Entry;
+
+    ST_Entry*              GetEntry(CFrame* frame_);
+
+    ST_Entry*                     m_entries;
+    TY_Word                    m_num_frames;
+    // Indices of the frames which are not in use
+    CServiceQueue             m_free_frames;
+};
+
+#endif // __hartframepool_h__
@@ -0,0 +1,371 @@
+/*
+ *          File: HartLatency.cpp (CLatencyStats)
+ *                The statistics are recorded by the kernel thread and
+ *                queried by the application, both under the lock of the
+ *                statistics. Recording a transaction takes a few bucket
+ *                increments, the percentiles are computed by the query.
+ *
+ *        Author: Walter Borst
+ *
+ *        E-Mail: info@borst-automation.de
+ *          Home: https://www.borst-automation.de
+ *
+ * No Warranties: https://www.borst-automation.com/legal/warranty-disclaimer
+ *
+ * Copyright 2006-2025 Walter Borst, Cuxhaven, Germany
+ */
+
+#include "HartLatency.h"
+#include "HartConsts.h"
+
+// Methods
+CLatencyStats::CLatencyStats()
+{
+    m_num_entries = 0;
+    ClearEntry(&m_others);
+}
+
+void CLatencyStats::Reset()
+{
+    m_lock.Lock();
+    m_num_entries = 0;
+    ClearEntry(&m_others);
+    m_lock.Unlock();
+}
+
+void CLatencyStats::Record(TY_Byte addr_mode_, TY_Byte* address_, TY_Word command_,
+    EN_Bool failed_, TY_Byte num_retries_, TY_DWord* phase_ms_)
+{
+    ST_Entry* entry;
+
+    m_lock.Lock();
+    entry = FindEntry(addr_mode_, address_, command_);
+    if (entry == NULL)
+    {
+        if (m_num_entries < MAX_NUM_LATENCY_ENTRIES)
+        {
+            entry = &m_entries[m_num_entries++];
+            ClearEntry(entry);
+            entry->AddrMode = addr_mode_;
+            COSAL::CMem::Copy(entry->Address, address_, 5);
+            entry->Command = command_;
+        }
+        else
+        {
+            entry = &m_others;
+        }
+    }
+
+    entry->NumTransactions++;
+    if (failed_ == EN_Bool::TRUE8)
+    {
+        entry->NumFailed++;
+    }
+
+    if (num_retries_ >= NUM_LATENCY_RETRY_COUNTS)
+    {
+        num_retries_ = NUM_LATENCY_RETRY_COUNTS - 1;
+    }
+
+    entry->NumByRetries[num_retries_]++;
+    for (TY_Byte e = 0; e < CPhase::NUM_PHASES; e++)
+    {
+        if (phase_ms_[e] != NOT_REACHED)
+        {
+            entry->Phases[e].Add(phase_ms_[e]);
+        }
+    }
+
+    m_lock.Unlock();
+}
+
+EN_Bool CLatencyStats::Query(TY_Byte* bytes_of_unique_id_, TY_Word command_, TY_LatencyStats* stats_)
+{
+    EN_Bool found = EN_Bool::FALSE8;
+
+    m_lock.Lock();
+    ClearEntry(&m_sum);
+    for (TY_Word e = 0; e < m_num_entries; e++)
+    {
+        ST_Entry* entry = &m_entries[e];
+
+        if ((command_ != ALL_COMMANDS) && (entry->Command != command_))
+        {
+            continue;
+        }
+
+        if (bytes_of_unique_id_ != NULL)
+        {
+            if ((entry->AddrMode != CHart::CAddrMode::UNIQUE) ||
+                (COSAL::CMem::IsEqual(entry->Address, bytes_of_unique_id_, 5) == EN_Bool::FALSE8))
+            {
+                continue;
+            }
+        }
+
+        MergeEntry(&m_sum, entry);
+        found = EN_Bool::TRUE8;
+    }
+
+    if ((bytes_of_unique_id_ == NULL) && (command_ == ALL_COMMANDS))
+    {
+        MergeEntry(&m_sum, &m_others);
+        if (m_others.NumTransactions > 0)
+        {
+            found = EN_Bool::TRUE8;
+        }
+    }
+
+    FillStats(&m_sum, stats_);
+    m_lock.Unlock();
+
+    stats_->PollAddress = 0xff;
+    stats_->Command = command_;
+    if (bytes_of_unique_id_ != NULL)
+    {
+        COSAL::CMem::Copy(stats_->BytesOfUniqueID, bytes_of_unique_id_, 5);
+    }
+    else
+    {
+        COSAL::CMem::Set(stats_->BytesOfUniqueID, 0, 5);
+    }
+
+    return found;
+}
+
+TY_Word CLatencyStats::GetNumEntries()
+{
+    return m_num_entries;
+}
+
+EN_Bool CLatencyStats::FetchEntry(TY_Word index_, TY_LatencyStats* stats_)
+{
+    ST_Entry* entry;
+
+    m_lock.Lock();
+    if (index_ >= m_num_entries)
+    {
+        m_lock.Unlock();
+        return EN_Bool::FALSE8;
+    }
+
+    entry = &m_entries[index_];
+    FillStats(entry, stats_);
+    stats_->Command = entry->Command;
+    if (entry->AddrMode == CHart::CAddrMode::UNIQUE)
+    {
+        stats_->PollAddress = 0xff;
+        COSAL::CMem::Copy(stats_->BytesOfUniqueID, entry->Address, 5);
+    }
+    else
+    {
+        stats_->PollAddress = entry->Address[0];
+        COSAL::CMem::Set(stats_->BytesOfUniqueID, 0, 5);
+    }
+
+    m_lock.Unlock();
+    return EN_Bool::TRUE8;
+}
+
+// Helpers
+void CLatencyStats::ClearEntry(ST_Entry* entry_)
+{
+    entry_->AddrMode = CHart::CAddrMode::UNIQUE;
+    COSAL::CMem::Set(entry_->Address, 0, 5);
+    entry_->Command = ALL_COMMANDS;
+    entry_->NumTransactions = 0;
+    entry_->NumFailed = 0;
+    for (TY_Byte e = 0; e < NUM_LATENCY_RETRY_COUNTS; e++)
+    {
+        entry_->NumByRetries[e] = 0;
+    }
+
+    for (TY_Byte e = 0; e < CPhase::NUM_PHASES; e++)
+    {
+        entry_->Phases[e].Clear();
+    }
+}
+
+void CLatencyStats::MergeEntry(ST_Entry* sum_, ST_Entry* entry_)
+{
+    sum_->NumTransactions += entry_->NumTransactions;
+    sum_->NumFailed += entry_->NumFailed;
+    for (TY_Byte e = 0; e < NUM_LATENCY_RETRY_COUNTS; e++)
+    {
+        sum_->NumByRetries[e] += entry_->NumByRetries[e];
+    }
+
+    for (TY_Byte e = 0; e < CPhase::NUM_PHASES; e++)
+    {
+        sum_->Phases[e].Merge(&entry_->Phases[e]);
+    }
+}
+
+void CLatencyStats::FillStats(ST_Entry* entry_, TY_LatencyStats* stats_)
+{
+    stats_->NumTransactions = entry_->NumTransactions;
+    stats_->NumFailed = entry_->NumFailed;
+    for (TY_Byte e = 0; e < NUM_LATENCY_RETRY_COUNTS; e++)
+    {
+        stats_->NumByRetries[e] = entry_->NumByRetries[e];
+    }
+
+    entry_->Phases[CPhase::QUEUE_WAIT].GetLatency(&stats_->QueueWait);
+    entry_->Phases[CPhase::BUS_WAIT].GetLatency(&stats_->BusWait);
+    entry_->Phases[CPhase::TX_TIME].GetLatency(&stats_->TxTime);
+    entry_->Phases[CPhase::TURNAROUND].GetLatency(&stats_->Turnaround);
+    entry_->Phases[CPhase::TOTAL].GetLatency(&stats_->Total);
+}
+
+CLatencyStats::ST_Entry* CLatencyStats::FindEntry(TY_Byte addr_mode_, TY_Byte* address_, TY_Word command_)
+{
+    for (TY_Word e = 0; e < m_num_entries; e++)
+    {
+        ST_Entry* entry = &m_entries[e];
+
+        if ((entry->Command == command_) && (entry->AddrMode == addr_mode_) &&
+            (COSAL::CMem::IsEqual(entry->Address, address_, 5) == EN_Bool::TRUE8))
+        {
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+// CHistogram
+void CLatencyStats::CHistogram::Clear()
+{
+    for (TY_Word e = 0; e < NUM_BUCKETS; e++)
+    {
+        m_counts[e] = 0;
+    }
+
+    m_count = 0;
+    m_min = 0;
+    m_max = 0;
+    m_sum = 0;
+}
+
+void CLatencyStats::CHistogram::Add(TY_DWord value_)
+{
+    m_counts[GetBucket(value_)]++;
+    if ((m_count == 0) || (value_ < m_min))
+    {
+        m_min = value_;
+    }
+
+    if (value_ > m_max)
+    {
+        m_max = value_;
+    }
+
+    m_count++;
+    m_sum += value_;
+}
+
+void CLatencyStats::CHistogram::Merge(CHistogram* other_)
+{
+    if (other_->m_count == 0)
+    {
+        return;
+    }
+
+    for (TY_Word e = 0; e < NUM_BUCKETS; e++)
+    {
+        m_counts[e] += other_->m_counts[e];
+    }
+
+    if ((m_count == 0) || (other_->m_min < m_min))
+    {
+        m_min = other_->m_min;
+    }
+
+    if (other_->m_max > m_max)
+    {
+        m_max = other_->m_max;
+    }
+
+    m_count += other_->m_count;
+    m_sum += other_->m_sum;
+}
+
+void CLatencyStats::CHistogram::GetLatency(TY_Latency* latency_)
+{
+    latency_->Count = m_count;
+    latency_->Min = m_min;
+    latency_->Max = m_max;
+    latency_->Mean = (m_count > 0) ? (TY_DWord)(m_sum / m_count) : 0;
+    latency_->P50 = GetPercentile(500);
+    latency_->P90 = GetPercentile(900);
+    latency_->P99 = GetPercentile(990);
+}
+
+TY_Word CLatencyStats::CHistogram::GetBucket(TY_DWord value_)
+{
+    TY_Byte shift = 0;
+
+    if (value_ >= ((TY_DWord)1 << MAX_VALUE_BITS))
+    {
+        value_ = ((TY_DWord)1 << MAX_VALUE_BITS) - 1;
+    }
+
+    if (value_ < (2 * SUB_BUCKETS))
+    {
+        return (TY_Word)value_;
+    }
+
+    while ((value_ >> shift) >= (2 * SUB_BUCKETS))
+    {
+        shift++;
+    }
+
+    // The top bits select the sub bucket within the power of two
+    return (TY_Word)((shift + 1) * SUB_BUCKETS + ((value_ >> shift) - SUB_BUCKETS));
+}
+
+TY_DWord CLatencyStats::CHistogram::GetUpperValue(TY_Word bucket_)
+{
+    TY_Byte  shift;
+    TY_DWord top;
+
+    if (bucket_ < (2 * SUB_BUCKETS))
+    {
+        return bucket_;
+    }
+
+    shift = (TY_Byte)(bucket_ / SUB_BUCKETS - 1);
+    top = SUB_BUCKETS + (bucket_ % SUB_BUCKETS);
+    return ((top + 1) << shift) - 1;
+}
+
+TY_DWord CLatencyStats::CHistogram::GetPercentile(TY_Word per_mille_)
+{
+    TY_UInt64 rank;
+    TY_DWord  sum = 0;
+
+    if (m_count == 0)
+    {
+        return 0;
+    }
+
+    // Number of values at or below the percentile
+    rank = ((TY_UInt64)m_count * per_mille_ + 999) / 1000;
+    if (rank == 0)
+    {
+        rank = 1;
+    }
+
+    for (TY_Word e = 0; e < NUM_BUCKETS; e++)
+    {
+        sum += m_counts[e];
+        if (sum >= rank)
+        {
+            TY_DWord value = GetUpperValue(e);
+
+            return (value < m_max) ? value : m_max;
+        }
+    }
+
+    return m_max;
+}
@@ -0,0 +1,112 @@
+/*
+ *          File: HartLatency.h (CLatencyStats)
+ *                Latency statistics of the transactions of a channel.
+ *                When a service is completed the kernel records the
+ *                durations of its phases (queue wait, bus wait, tx time,
+ *                device turnaround and total) in histograms per device
+ *                and command. The application queries them at any time.
+ *
+ *        Author: Walter Borst
+ *
+ *        E-Mail: info@borst-automation.de
+ *          Home: https://www.borst-automation.de
+ *
+ * No Warranties: https://www.borst-automation.com/legal/warranty-disclaimer
+ *
+ * Copyright 2006-2025 Walter Borst, Cuxhaven, Germany
+ */
+
+// Once
+#ifndef __hartlatency_h__
+#define __hartlatency_h__
+
+#include "OSAL.h"
+#include "WbHartUser.h"
+#include "WbHartM_Structures.h"
+
+class CLatencyStats
+{
+public:
+    class CPhase
+    {
+    public:
+        static const TY_Byte QUEUE_WAIT = 0;
+        static const TY_Byte   BUS_WAIT = 1;
+        static const TY_Byte    TX_TIME = 2;
+        static const TY_Byte TURNAROUND = 3;
+        static const TY_Byte      TOTAL = 4;
+        static const TY_Byte NUM_PHASES = 5;
+    };
+
+    // Duration of a phase which was not reached
+    static const TY_DWord NOT_REACHED = 0xffffffff;
+    static const TY_Word ALL_COMMANDS = 0xffff;
+
+                          CLatencyStats();
+    void                      Reset();
+    // Called by the kernel when a service is completed
+    void                     Record(TY_Byte addr_mode_, TY_Byte* address_, TY_Word command_,
+                               EN_Bool failed_, TY_Byte num_retries_, TY_DWord* phase_ms_);
+    // Sum of all entries of the device (NULL: any device)
+    // and the command (ALL_COMMANDS: any command)
+    EN_Bool                   Query(TY_Byte* bytes_of_unique_id_, TY_Word command_, TY_LatencyStats* stats_);
+    TY_Word           GetNumEntries();
+    EN_Bool              FetchEntry(TY_Word index_, TY_LatencyStats* stats_);
+
+private:
+    class CHistogram
+    {
+    public:
+        void                  Clear();
+        void                    Add(TY_DWord value_);
+        void                  Merge(CHistogram* other_);
+        void             GetLatency(TY_Latency* latency_);
+
+    private:
+        // Values below 2 * SUB_BUCKETS are counted exactly, above
+        // each power of two is split into SUB_BUCKETS buckets
+        static const TY_Byte SUB_BUCKET_BITS = 3;
+        static const TY_Byte     SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+        // Larger values (about 17 minutes) are counted as the largest one
+        static const TY_Byte  MAX_VALUE_BITS = 20;
+        static const TY_Word     NUM_BUCKETS = (MAX_VALUE_BITS - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+        static TY_Word        GetBucket(TY_DWord value_);
+        static TY_DWord   GetUpperValue(TY_Word bucket_);
+        TY_DWord          GetPercentile(TY_Word per_mille_);
+
+        TY_DWord   m_counts[NUM_BUCKETS];
+        TY_DWord   m_count;
+        TY_DWord   m_min;
+        TY_DWord   m_max;
+        TY_UInt64  m_sum;
+    };
+
+    typedef struct st_Entry
+    {
+        TY_Byte      AddrMode;
+        // Unique ID or the polling address in the first byte
+        TY_Byte      Address[5];
+        TY_Word      Command;
+        TY_DWord     NumTransactions;
+        TY_DWord     NumFailed;
+        TY_DWord     NumByRetries[NUM_LATENCY_RETRY_COUNTS];
+        CHistogram   Phases[CPhase::NUM_PHASES];
+    } ST_Entry;
+
+    static void          ClearEntry(ST_Entry* entry_);
+    static void          MergeEntry(ST_Entry* sum_, ST_Entry* entry_);
+    static void           FillStats(ST_Entry* entry_, TY_LatencyStats* stats_);
+    ST_Entry*             FindEntry(TY_Byte addr_mode_, TY_Byte* address_, TY_Word command_);
+
+    ST_Entry       m_entries[MAX_NUM_LATENCY_ENTRIES];
+    TY_Word        m_num_entries;
+    // Transactions which found no free entry
+    ST_Entry       m_others;
+    // Sum of a query, kept here as it is too large for the stack
+    ST_Entry       m_sum;
+    // Recording by the kernel, queries by the application
+    COSAL::CLock   m_lock;
+};
+
+#endif // __hartlatency_h__
@@ -0,0 +1,599 @@
+/*
+ *          File: HartReplay.cpp (CReplay)
+ *                Each frame of the capture is decoded in one go by
+ *                CFrame::TryParse, the capture already tells where a
+ *                frame starts and ends. A request is pending until its
+ *                response, the next request or a broken frame arrives.
+ *                pcapng holds no end time of a frame, the turnaround
+ *                is then taken from the start of the request.
+ *
+ *        Author: Walter Borst
+ *
+ *        E-Mail: info@borst-automation.de
+ *          Home: https://www.borst-automation.de
+ *
+ * No Warranties: https://www.borst-automation.com/legal/warranty-disclaimer
+ *
+ * Copyright 2006-2025 Walter Borst, Cuxhaven, Germany
+ */
+
+#include "HartReplay.h"
+#include "HartConsts.h"
+#include "HartCoding.h"
+
+// Methods
+CReplay::CReplay()
+{
+    COSAL::CMem::Set(m_no_errors, COSAL::CRcvErr::ERR_None, sizeof(m_no_errors));
+    Clear();
+}
+
+EN_Bool CReplay::Run(const TY_Char* file_name_)
+{
+    COSAL::CFileMap file_map;
+
+    if (file_map.Open(file_name_) == EN_Bool::FALSE8)
+    {
+        Clear();
+        return EN_Bool::FALSE8;
+    }
+
+    return Run(file_map.GetData(), file_map.GetSize());
+}
+
+EN_Bool CReplay::Run(const TY_Byte* data_, TY_UInt64 size_)
+{
+    EN_Bool result = EN_Bool::FALSE8;
+
+    Clear();
+    if ((size_ >= 12) && (GetDWord(data_) == CPcapng::SECTION_HEADER))
+    {
+        result = ReplayPcapng(data_, size_);
+    }
+    else if ((size_ > 0) && ((size_ % sizeof(TY_MonFrame)) == 0))
+    {
+        result = ReplayMonitor(data_, size_);
+    }
+
+    // A request at the end of the capture is left without response
+    ResolvePending();
+    return result;
+}
+
+TY_Word CReplay::GetNumEntries()
+{
+    return m_num_entries;
+}
+
+EN_Bool CReplay::FetchEntry(TY_Word index_, TY_ReplayStats* stats_)
+{
+    if (index_ >= m_num_entries)
+    {
+        return EN_Bool::FALSE8;
+    }
+
+    FillStats(&m_entries[index_], stats_);
+    return EN_Bool::TRUE8;
+}
+
+void CReplay::GetTotal(TY_ReplayStats* stats_)
+{
+    ST_Entry sum;
+
+    ClearEntry(&sum);
+    for (TY_Word e = 0; e < m_num_entries; e++)
+    {
+        MergeEntry(&sum, &m_entries[e]);
+    }
+
+    MergeEntry(&sum, &m_others);
+    FillStats(&sum, stats_);
+    stats_->PollAddress = 0xff;
+    COSAL::CMem::Set(stats_->BytesOfUniqueID, 0, 5);
+    stats_->Command = ALL_COMMANDS;
+}
+
+TY_DWord CReplay::GetNumFrames()
+{
+    return m_num_frames;
+}
+
+TY_DWord CReplay::GetNumJunkFrames()
+{
+    return m_num_junk_frames;
+}
+
+// Helpers
+void CReplay::Clear()
+{
+    m_num_entries = 0;
+    COSAL::CMem::Set((TY_Byte*)m_index, 0, sizeof(m_index));
+    ClearEntry(&m_others);
+    mp_pending = NULL;
+    m_pending_end = 0;
+    m_num_frames = 0;
+    m_num_junk_frames = 0;
+    m_swap = EN_Bool::FALSE8;
+    m_num_interfaces = 0;
+}
+
+EN_Bool CReplay::ReplayPcapng(const TY_Byte* data_, TY_UInt64 size_)
+{
+    TY_UInt64 pos = 0;
+
+    while ((pos + 12) <= size_)
+    {
+        const TY_Byte* block = &data_[pos];
+        TY_DWord       type;
+        TY_DWord       len;
+
+        if (GetDWord(block) == CPcapng::SECTION_HEADER)
+        {
+            // The byte order applies up to the next section
+            TY_DWord magic;
+
+            COSAL::CMem::Copy((TY_Byte*)&magic, &block[8], 4);
+            if (magic == CPcapng::BYTE_ORDER_MAGIC)
+            {
+                m_swap = EN_Bool::FALSE8;
+            }
+            else if (magic == 0x4d3c2b1a)
+            {
+                m_swap = EN_Bool::TRUE8;
+            }
+            else
+            {
+                return EN_Bool::FALSE8;
+            }
+
+            m_num_interfaces = 0;
+        }
+
+        type = GetDWord(block);
+        len = GetDWord(&block[4]);
+        if ((len < 12) || ((len & 3) != 0) || (len > (size_ - pos)))
+        {
+            // Broken or truncated
+            return EN_Bool::FALSE8;
+        }
+
+        switch (type)
+        {
+        case CPcapng::INTERFACE:
+            if ((len >= 20) && (m_num_interfaces < CPcapng::MAX_INTERFACES))
+            {
+                ST_Interface* interface_desc = &m_interfaces[m_num_interfaces++];
+                TY_DWord      opt = 16;
+
+                interface_desc->LinkType = GetWord(&block[8]);
+                interface_desc->Exponent = 6;
+                interface_desc->IsPowerOf2 = EN_Bool::FALSE8;
+                while ((opt + 4) <= (len - 4))
+                {
+                    TY_Word code = GetWord(&block[opt]);
+                    TY_Word opt_len = GetWord(&block[opt + 2]);
+
+                    if ((code == 0) || ((opt + 4 + opt_len) > (len - 4)))
+                    {
+                        break;
+                    }
+
+                    if ((code == CPcapng::IF_TSRESOL) && (opt_len >= 1))
+                    {
+                        interface_desc->Exponent = block[opt + 4] & 0x7f;
+                        interface_desc->IsPowerOf2 = ((block[opt + 4] & 0x80) != 0) ? EN_Bool::TRUE8 : EN_Bool::FALSE8;
+                    }
+
+                    opt += 4 + ((opt_len + 3) & ~3u);
+                }
+            }
+            break;
+        case CPcapng::ENHANCED_PACKET:
+            if (len >= 32)
+            {
+                TY_DWord  if_id = GetDWord(&block[8]);
+                TY_DWord  cap_len = GetDWord(&block[20]);
+                TY_DWord  opt = 28 + ((cap_len + 3) & ~3u);
+                TY_DWord  flags = 0;
+                TY_UInt64 time;
+
+                if ((cap_len > (len - 32)) || (if_id >= m_num_interfaces) ||
+                    (m_interfaces[if_id].LinkType < CPcapng::LINK_TYPE_USER0) ||
+                    (m_interfaces[if_id].LinkType > (CPcapng::LINK_TYPE_USER0 + 15)))
+                {
+                    break;
+                }
+
+                while ((opt + 4) <= (len - 4))
+                {
+                    TY_Word code = GetWord(&block[opt]);
+                    TY_Word opt_len = GetWord(&block[opt + 2]);
+
+                    if ((code == 0) || ((opt + 4 + opt_len) > (len - 4)))
+                    {
+                        break;
+                    }
+
+                    if ((code == CPcapng::EPB_FLAGS) && (opt_len == 4))
+                    {
+                        flags = GetDWord(&block[opt + 4]);
+                    }
+
+                    opt += 4 + ((opt_len + 3) & ~3u);
+                }
+
+                time = ((TY_UInt64)GetDWord(&block[12]) << 32) | GetDWord(&block[16]);
+                time = ToMilliseconds(time, &m_interfaces[if_id]);
+                // Bits 24..31 are the link layer errors, e.g. the gap time out
+                HandleFrame(time, time, ((flags & 0xff000000) != 0) ? EN_Bool::TRUE8 : EN_Bool::FALSE8,
+                    &block[28], (TY_Word)((cap_len < 0xffff) ? cap_len : 0xffff));
+            }
+            break;
+        case CPcapng::SIMPLE_PACKET:
+            if ((len >= 16) && (m_num_interfaces > 0) &&
+                (m_interfaces[0].LinkType >= CPcapng::LINK_TYPE_USER0) &&
+                (m_interfaces[0].LinkType <= (CPcapng::LINK_TYPE_USER0 + 15)))
+            {
+                TY_DWord cap_len = GetDWord(&block[8]);
+
+                if (cap_len > (len - 16))
+                {
+                    cap_len = len - 16;
+                }
+
+                // Without a timestamp
+                HandleFrame(0, 0, EN_Bool::FALSE8, &block[12], (TY_Word)((cap_len < 0xffff) ? cap_len : 0xffff));
+            }
+            break;
+        default:
+            break;
+        }
+
+        pos += len;
+    }
+
+    return (pos == size_) ? EN_Bool::TRUE8 : EN_Bool::FALSE8;
+}
+
+EN_Bool CReplay::ReplayMonitor(const TY_Byte* data_, TY_UInt64 size_)
+{
+    // The monitor times are 32 bit milliseconds, they are
+    // extended to 64 bit so a wrap does not disturb the order
+    TY_UInt64 time = 0;
+    TY_DWord  last_start = 0;
+    EN_Bool   is_first = EN_Bool::TRUE8;
+
+    for (TY_UInt64 pos = 0; pos < size_; pos += sizeof(TY_MonFrame))
+    {
+        const TY_MonFrame* frame = (const TY_MonFrame*)&data_[pos];
+        TY_Word            len = frame->Len;
+
+        if (frame->IsReceiveReady != EN_Bool::TRUE8)
+        {
+            // An empty slot
+            continue;
+        }
+
+        if (is_first == EN_Bool::TRUE8)
+        {
+            time = frame->StartTime;
+            is_first = EN_Bool::FALSE8;
+        }
+        else
+        {
+            time += (TY_UInt64)(long long)(TY_Int32)(frame->StartTime - last_start);
+        }
+
+        last_start = frame->StartTime;
+        if (len > MON_MAX_FRAME_DATA_SIZE)
+        {
+            len = MON_MAX_FRAME_DATA_SIZE;
+        }
+
+        HandleFrame(time, time + (TY_UInt64)(long long)(TY_Int32)(frame->EndTime - frame->StartTime),
+            ((frame->Detail & CMonitor::CDetail::GAP_TO) != 0) ? EN_Bool::TRUE8 : EN_Bool::FALSE8,
+            frame->BytesOfData, len);
+    }
+
+    return EN_Bool::TRUE8;
+}
+
+void CReplay::HandleFrame(TY_UInt64 start_time_, TY_UInt64 end_time_, EN_Bool is_gap_,
+    const TY_Byte* data_, TY_Word len_)
+{
+    TY_Word   bytes_parsed;
+    ST_Key    key;
+    ST_Entry* entry;
+
+    m_num_frames++;
+    m_frame.Init();
+    if ((len_ > HART_IP_HDR_SIZE) && ((((TY_Word)data_[0] << 8) | data_[1]) == HART_IP_MAGIC))
+    {
+        // Hart-IP: The header of the monitor and the PDU without preambles
+        data_ += HART_IP_HDR_SIZE;
+        len_ -= HART_IP_HDR_SIZE;
+        m_frame.NoPreamb = EN_Bool::TRUE8;
+    }
+    else if ((len_ > 0) && (data_[0] != 0xff))
+    {
+        m_frame.NoPreamb = EN_Bool::TRUE8;
+    }
+
+    if (len_ > MON_MAX_FRAME_DATA_SIZE)
+    {
+        len_ = MON_MAX_FRAME_DATA_SIZE;
+    }
+
+    if ((is_gap_ == EN_Bool::TRUE8) || (len_ == 0) ||
+        (m_frame.TryParse(&bytes_parsed, (TY_Byte*)data_, m_no_errors, len_, EN_Bool::FALSE8) == EN_Bool::FALSE8) ||
+        (m_frame.Type == CFrame::EN_Type::JUNK))
+    {
+        m_num_junk_frames++;
+        // Most likely the response was broken
+        ResolvePending();
+        return;
+    }
+
+    GetKey(&key);
+    switch (m_frame.Type)
+    {
+    case CFrame::EN_Type::REQUEST:
+        ResolvePending();
+        entry = GetEntry(&key);
+        TouchEntry(entry, start_time_);
+        entry->NumRequests++;
+        mp_pending = entry;
+        m_pending_key = key;
+        m_pending_end = end_time_;
+        break;
+    case CFrame::EN_Type::RESPONSE:
+        if ((mp_pending != NULL) && (m_frame.Command == 31) && (m_frame.PayloadSize < 2) &&
+            (m_pending_key.AddrMode == key.AddrMode) &&
+            (COSAL::CMem::IsEqual(m_pending_key.Address, key.Address, 5) == EN_Bool::TRUE8))
+        {
+            // An error response to an extended command lacks the 16 bit number
+            key.Command = m_pending_key.Command;
+        }
+
+        entry = GetEntry(&key);
+        TouchEntry(entry, start_time_);
+        entry->NumResponses++;
+        if ((m_frame.GetRspCode1() & 0x80) != 0)
+        {
+            entry->NumCommErrors++;
+        }
+        else if (m_frame.GetRspCode1() != 0)
+        {
+            entry->NumResponseCodes++;
+        }
+
+        if ((mp_pending != NULL) && (COSAL::CMem::IsEqual((TY_Byte*)&m_pending_key, (TY_Byte*)&key, sizeof(ST_Key)) == EN_Bool::TRUE8))
+        {
+            TY_DWord turnaround = (start_time_ > m_pending_end) ? (TY_DWord)(start_time_ - m_pending_end) : 0;
+
+            if ((entry->NumTurnarounds == 0) || (turnaround < entry->MinTurnaround))
+            {
+                entry->MinTurnaround = turnaround;
+            }
+
+            if (turnaround > entry->MaxTurnaround)
+            {
+                entry->MaxTurnaround = turnaround;
+            }
+
+            entry->NumTurnarounds++;
+            entry->SumTurnaround += turnaround;
+            mp_pending = NULL;
+        }
+        break;
+    case CFrame::EN_Type::BURST:
+        entry = GetEntry(&key);
+        TouchEntry(entry, start_time_);
+        entry->NumBursts++;
+        break;
+    default:
+        break;
+    }
+}
+
+void CReplay::GetKey(ST_Key* key_)
+{
+    COSAL::CMem::Set((TY_Byte*)key_, 0, sizeof(ST_Key));
+    key_->AddrMode = m_frame.AddrMode;
+    if (m_frame.AddrMode == CHart::CAddrMode::UNIQUE)
+    {
+        m_frame.GetUniqueID(key_->Address);
+    }
+    else
+    {
+        key_->Address[0] = m_frame.GetShortAddr();
+    }
+
+    key_->Command = m_frame.Command;
+    // Extended commands are filed under their 16 bit number
+    if ((m_frame.Command == 31) && (m_frame.PayloadSize >= 2))
+    {
+        key_->Command = CCoding::PickWord(0, m_frame.PayloadData, EN_Endian::MSB_First);
+    }
+}
+
+CReplay::ST_Entry* CReplay::GetEntry(ST_Key* key_)
+{
+    // FNV-1a over the key, the slots are probed linearly
+    TY_DWord hash = 2166136261u;
+    TY_Word  slot;
+
+    for (TY_Byte e = 0; e < sizeof(ST_Key); e++)
+    {
+        hash = (hash ^ ((TY_Byte*)key_)[e]) * 16777619u;
+    }
+
+    slot = (TY_Word)(hash & (INDEX_SIZE - 1));
+    while (m_index[slot] != 0)
+    {
+        ST_Entry* entry = &m_entries[m_index[slot] - 1];
+
+        if (COSAL::CMem::IsEqual((TY_Byte*)&entry->Key, (TY_Byte*)key_, sizeof(ST_Key)) == EN_Bool::TRUE8)
+        {
+            return entry;
+        }
+
+        slot = (TY_Word)((slot + 1) & (INDEX_SIZE - 1));
+    }
+
+    if (m_num_entries >= MAX_NUM_REPLAY_ENTRIES)
+    {
+        return &m_others;
+    }
+
+    m_index[slot] = (TY_Word)(m_num_entries + 1);
+    ClearEntry(&m_entries[m_num_entries]);
+    m_entries[m_num_entries].Key = *key_;
+    return &m_entries[m_num_entries++];
+}
+
+void CReplay::TouchEntry(ST_Entry* entry_, TY_UInt64 time_)
+{
+    if ((entry_->NumRequests == 0) && (entry_->NumResponses == 0) && (entry_->NumBursts == 0))
+    {
+        entry_->FirstTime = time_;
+    }
+
+    entry_->LastTime = time_;
+}
+
+void CReplay::ResolvePending()
+{
+    if (mp_pending != NULL)
+    {
+        mp_pending->NumNoResponses++;
+        mp_pending = NULL;
+    }
+}
+
+void CReplay::ClearEntry(ST_Entry* entry_)
+{
+    COSAL::CMem::Set((TY_Byte*)entry_, 0, sizeof(ST_Entry));
+    entry_->Key.AddrMode = CHart::CAddrMode::UNIQUE;
+    entry_->Key.Command = ALL_COMMANDS;
+}
+
+void CReplay::MergeEntry(ST_Entry* sum_, ST_Entry* entry_)
+{
+    if ((entry_->NumRequests == 0) && (entry_->NumResponses == 0) && (entry_->NumBursts == 0))
+    {
+        return;
+    }
+
+    if (((sum_->NumRequests == 0) && (sum_->NumResponses == 0) && (sum_->NumBursts == 0)) ||
+        (entry_->FirstTime < sum_->FirstTime))
+    {
+        sum_->FirstTime = entry_->FirstTime;
+    }
+
+    if (entry_->LastTime > sum_->LastTime)
+    {
+        sum_->LastTime = entry_->LastTime;
+    }
+
+    if ((entry_->NumTurnarounds > 0) &&
+        ((sum_->NumTurnarounds == 0) || (entry_->MinTurnaround < sum_->MinTurnaround)))
+    {
+        sum_->MinTurnaround = entry_->MinTurnaround;
+    }
+
+    if (entry_->MaxTurnaround > sum_->MaxTurnaround)
+    {
+        sum_->MaxTurnaround = entry_->MaxTurnaround;
+    }
+
+    sum_->NumRequests += entry_->NumRequests;
+    sum_->NumResponses += entry_->NumResponses;
+    sum_->NumNoResponses += entry_->NumNoResponses;
+    sum_->NumCommErrors += entry_->NumCommErrors;
+    sum_->NumResponseCodes += entry_->NumResponseCodes;
+    sum_->NumBursts += entry_->NumBursts;
+    sum_->NumTurnarounds += entry_->NumTurnarounds;
+    sum_->SumTurnaround += entry_->SumTurnaround;
+}
+
+void CReplay::FillStats(ST_Entry* entry_, TY_ReplayStats* stats_)
+{
+    if (entry_->Key.AddrMode == CHart::CAddrMode::UNIQUE)
+    {
+        stats_->PollAddress = 0xff;
+        COSAL::CMem::Copy(stats_->BytesOfUniqueID, entry_->Key.Address, 5);
+    }
+    else
+    {
+        stats_->PollAddress = entry_->Key.Address[0];
+        COSAL::CMem::Set(stats_->BytesOfUniqueID, 0, 5);
+    }
+
+    stats_->Command = entry_->Key.Command;
+    stats_->NumRequests = entry_->NumRequests;
+    stats_->NumResponses = entry_->NumResponses;
+    stats_->NumNoResponses = entry_->NumNoResponses;
+    stats_->NumCommErrors = entry_->NumCommErrors;
+    stats_->NumResponseCodes = entry_->NumResponseCodes;
+    stats_->NumBursts = entry_->NumBursts;
+    stats_->MinTurnaround = entry_->MinTurnaround;
+    stats_->MaxTurnaround = entry_->MaxTurnaround;
+    stats_->MeanTurnaround = (entry_->NumTurnarounds > 0) ? (TY_DWord)(entry_->SumTurnaround / entry_->NumTurnarounds) : 0;
+    stats_->FirstTime = entry_->FirstTime;
+    stats_->LastTime = entry_->LastTime;
+}
+
+TY_UInt64 CReplay::ToMilliseconds(TY_UInt64 time_, ST_Interface* interface_)
+{
+    TY_Byte exponent = interface_->Exponent;
+
+    if (interface_->IsPowerOf2 == EN_Bool::TRUE8)
+    {
+        if (exponent >= 64)
+        {
+            return 0;
+        }
+
+        // Split, so the multiplication does not overflow
+        return ((time_ >> exponent) * 1000) + (((time_ & (((TY_UInt64)1 << exponent) - 1)) * 1000) >> exponent);
+    }
+
+    for (; exponent > 3; exponent--)
+    {
+        time_ /= 10;
+    }
+
+    for (; exponent < 3; exponent++)
+    {
+        time_ *= 10;
+    }
+
+    return time_;
+}
+
+TY_Word CReplay::GetWord(const TY_Byte* data_)
+{
+    TY_Word value;
+
+    COSAL::CMem::Copy((TY_Byte*)&value, data_, 2);
+    if (m_swap == EN_Bool::TRUE8)
+    {
+        value = (TY_Word)((value >> 8) | (value << 8));
+    }
+
+    return value;
+}
+
+TY_DWord CReplay::GetDWord(const TY_Byte* data_)
+{
+    TY_DWord value;
+
+    COSAL::CMem::Copy((TY_Byte*)&value, data_, 4);
+    if (m_swap == EN_Bool::TRUE8)
+    {
+        value = (value >> 24) | ((value >> 8) & 0x0000ff00) | ((value << 8) & 0x00ff0000) | (value << 24);
+    }
+
+    return value;
+}
@@ -0,0 +1,139 @@
+/*
+ *          File: HartReplay.h (CReplay)
+ *                Offline analysis of a capture. The file is mapped into
+ *                memory and its frames are decoded by the parser of the
+ *                frames as fast as the CPU allows. Requests are matched
+ *                with their responses, the result is a table of the
+ *                transactions per device and command.
+ *                Formats: pcapng (as written by CMonitorCapture) and
+ *                plain arrays of TY_MonFrame records.
+ *
+ *        Author: Walter Borst
+ *
+ *        E-Mail: info@borst-automation.de
+ *          Home: https://www.borst-automation.de
+ *
+ * No Warranties: https://www.borst-automation.com/legal/warranty-disclaimer
+ *
+ * Copyright 2006-2025 Walter Borst, Cuxhaven, Germany
+ */
+
+// Once
+#ifndef __hartreplay_h__
+#define __hartreplay_h__
+
+#include "OSAL.h"
+#include "WbHartUser.h"
+#include "WbHartM_Structures.h"
+#include "HartFrame.h"
+#include "Monitor.h"
+
+class CReplay
+{
+public:
+    static const TY_Word ALL_COMMANDS = 0xffff;
+
+                           CReplay();
+    // The tables are cleared by each run. FALSE8: The file could not
+    // be read or it is broken, the tables hold what was read before.
+    EN_Bool                    Run(const TY_Char* file_name_);
+    EN_Bool                    Run(const TY_Byte* data_, TY_UInt64 size_);
+    TY_Word          GetNumEntries();
+    EN_Bool             FetchEntry(TY_Word index_, TY_ReplayStats* stats_);
+    // Sum of all entries, including the devices which found no entry
+    void                  GetTotal(TY_ReplayStats* stats_);
+    TY_DWord          GetNumFrames();
+    TY_DWord      GetNumJunkFrames();
+
+private:
+    class CPcapng
+    {
+    public:
+        static const TY_DWord   SECTION_HEADER = 0x0a0d0d0a;
+        static const TY_DWord        INTERFACE = 0x00000001;
+        static const TY_DWord    SIMPLE_PACKET = 0x00000003;
+        static const TY_DWord  ENHANCED_PACKET = 0x00000006;
+        static const TY_DWord BYTE_ORDER_MAGIC = 0x1a2b3c4d;
+        static const TY_Word        IF_TSRESOL = 9;
+        static const TY_Word         EPB_FLAGS = 2;
+        static const TY_Word   LINK_TYPE_USER0 = 147;
+        static const TY_Byte    MAX_INTERFACES = 8;
+    };
+
+    // Magic number of a Hart-IP frame recorded by the monitor
+    static const TY_Word    HART_IP_MAGIC = 0xe0a3;
+    static const TY_Byte HART_IP_HDR_SIZE = 5;
+    // Size of the index of the entries, a power of two
+    static const TY_Word       INDEX_SIZE = 4 * MAX_NUM_REPLAY_ENTRIES;
+
+    typedef struct st_Key
+    {
+        TY_Byte      AddrMode;
+        // Unique ID or the polling address in the first byte
+        TY_Byte      Address[5];
+        TY_Word      Command;
+    } ST_Key;
+
+    typedef struct st_Entry
+    {
+        ST_Key       Key;
+        TY_DWord     NumRequests;
+        TY_DWord     NumResponses;
+        TY_DWord     NumNoResponses;
+        TY_DWord     NumCommErrors;
+        TY_DWord     NumResponseCodes;
+        TY_DWord     NumBursts;
+        // Responses matched with their request
+        TY_DWord     NumTurnarounds;
+        TY_DWord     MinTurnaround;
+        TY_DWord     MaxTurnaround;
+        TY_UInt64    SumTurnaround;
+        TY_UInt64    FirstTime;
+        TY_UInt64    LastTime;
+    } ST_Entry;
+
+    typedef struct st_Interface
+    {
+        TY_Word      LinkType;
+        // Timestamp units per second are 10^Exponent (or 2^Exponent)
+        TY_Byte      Exponent;
+        EN_Bool      IsPowerOf2;
+    } ST_Interface;
+
+    void                     Clear();
+    EN_Bool            ReplayPcapng(const TY_Byte* data_, TY_UInt64 size_);
+    EN_Bool           ReplayMonitor(const TY_Byte* data_, TY_UInt64 size_);
+    void              HandleFrame(TY_UInt64 start_time_, TY_UInt64 end_time_, EN_Bool is_gap_,
+                                   const TY_Byte* data_, TY_Word len_);
+    void                  GetKey(ST_Key* key_);
+    ST_Entry*           GetEntry(ST_Key* key_);
+    void               TouchEntry(ST_Entry* entry_, TY_UInt64 time_);
+    void            ResolvePending();
+    static void        ClearEntry(ST_Entry* entry_);
+    static void        MergeEntry(ST_Entry* sum_, ST_Entry* entry_);
+    static void         FillStats(ST_Entry* entry_, TY_ReplayStats* stats_);
+    static TY_UInt64       ToMilliseconds(TY_UInt64 time_, ST_Interface* interface_);
+    TY_Word             GetWord(const TY_Byte* data_);
+    TY_DWord           GetDWord(const TY_Byte* data_);
+
+    CFrame         m_frame;
+    TY_Byte        m_no_errors[MON_MAX_FRAME_DATA_SIZE];
+    ST_Entry       m_entries[MAX_NUM_REPLAY_ENTRIES];
+    TY_Word        m_num_entries;
+    // Entry + 1 of a key, 0: free
+    TY_Word        m_index[INDEX_SIZE];
+    // Transactions which found no free entry
+    ST_Entry       m_others;
+    // The last request waiting for its response
+    ST_Entry*      mp_pending;
+    ST_Key         m_pending_key;
+    TY_UInt64      m_pending_end;
+    TY_DWord       m_num_frames;
+    TY_DWord       m_num_junk_frames;
+    // Byte order of the pcapng section differs from the host
+    EN_Bool        m_swap;
+    ST_Interface   m_interfaces[CPcapng::MAX_INTERFACES];
+    TY_Byte        m_num_interfaces;
+};
+
+#endif // __hartreplay_h__
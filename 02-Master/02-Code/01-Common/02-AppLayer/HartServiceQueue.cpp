@@ -0,0 +1,168 @@
+/*
+ *          File: HartServiceQueue.cpp (CServiceQueue)
+ *                A bounded queue of service handles which works without
+ *                a lock. Each cell carries a sequence number, so a thread
+ *                only has to win the position counter to own a cell.
+ *
+ *        Author: Walter Borst
+ *
+ *        E-Mail: info@borst-automation.de
+ *          Home: https://www.borst-automation.de
+ *
+ * No Warranties: https://www.borst-automation.com/legal/warranty-disclaimer
+ *
+ * Copyright 2006-2025 Walter Borst, Cuxhaven, Germany
+ */
+
+#include <new>
+#include "HartServiceQueue.h"
+
+// Methods
+CServiceQueue::CServiceQueue()
+{
+    m_cells = NULL;
+    m_size = 0;
+    m_wr_pos.store(0, std::memory_order_relaxed);
+    m_rd_pos.store(0, std::memory_order_relaxed);
+}
+
+CServiceQueue::~CServiceQueue()
+{
+    Destroy();
+}
+
+EN_Bool CServiceQueue::Create(TY_DWord min_size_)
+{
+    // Note: Not thread safe, only for initialization
+    TY_DWord size = 2;
+
+    while (size < min_size_)
+    {
+        size <<= 1;
+    }
+
+    if (size != m_size)
+    {
+        Destroy();
+        m_cells = new (std::nothrow) ST_Cell[size];
+        if (m_cells == NULL)
+        {
+            return EN_Bool::FALSE8;
+        }
+
+        m_size = size;
+    }
+
+    Clear();
+    return EN_Bool::TRUE8;
+}
+
+void CServiceQueue::Destroy()
+{
+    if (m_cells != NULL)
+    {
+        delete[] m_cells;
+        m_cells = NULL;
+    }
+
+    m_size = 0;
+}
+
+void CServiceQueue::Clear()
+{
+    // Note: Not thread safe, only for initialization
+    for (TY_DWord e = 0; e < m_size; e++)
+    {
+        m_cells[e].Sequence.store(e, std::memory_order_relaxed);
+        m_cells[e].Handle = INVALID_SRV_HANDLE;
+    }
+
+    m_wr_pos.store(0, std::memory_order_relaxed);
+    m_rd_pos.store(0, std::memory_order_relaxed);
+}
+
+EN_Bool CServiceQueue::Push(SRV_Handle handle_)
+{
+    ST_Cell* cell = NULL;
+    TY_DWord pos = m_wr_pos.load(std::memory_order_relaxed);
+    TY_DWord seq;
+    int      diff;
+
+    if (m_cells == NULL)
+    {
+        return EN_Bool::FALSE8;
+    }
+
+    for (;;)
+    {
+        cell = &m_cells[pos & (m_size - 1)];
+        seq = cell->Sequence.load(std::memory_order_acquire);
+        diff = (int)(seq - pos);
+        if (diff == 0)
+        {
+            // The cell is free, try to claim it
+            if (m_wr_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed) == true)
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            // Queue is full
+            return EN_Bool::FALSE8;
+        }
+        else
+        {
+            // Another writer was faster
+            pos = m_wr_pos.load(std::memory_order_relaxed);
+        }
+    }
+
+    cell->Handle = handle_;
+    cell->Sequence.store(pos + 1, std::memory_order_release);
+    return EN_Bool::TRUE8;
+}
+
+SRV_Handle CServiceQueue::Pop()
+{
+    ST_Cell*   cell = NULL;
+    TY_DWord   pos = m_rd_pos.load(std::memory_order_relaxed);
+    TY_DWord   seq;
+    int        diff;
+    SRV_Handle handle;
+
+    if (m_cells == NULL)
+    {
+        return INVALID_SRV_HANDLE;
+    }
+
+    for (;;)
+    {
+        cell = &m_cells[pos & (m_size - 1)];
+        seq = cell->Sequence.load(std::memory_order_acquire);
+        diff = (int)(seq - (pos + 1));
+        if (diff == 0)
+        {
+            // The cell is filled, try to claim it
+            if (m_rd_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed) == true)
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            // Queue is empty
+            return INVALID_SRV_HANDLE;
+        }
+        else
+        {
+            // Another reader was faster
+            pos = m_rd_pos.load(std::memory_order_relaxed);
+        }
+    }
+
+    handle = cell->Handle;
+    // Release the cell for the writer of the next round
+    cell->Sequence.store(pos + m_size, std::memory_order_release);
+    return handle;
+}
@@ -0,0 +1,55 @@
+/*
+ *          File: HartServiceQueue.h (CServiceQueue)
+ *                A bounded queue of service handles which works without
+ *                a lock. Any number of threads may push and pop at the
+ *                same time. The channel uses one queue for the free
+ *                services and one to pass the requested services to the
+ *                kernel. The cells are allocated once by Create().
+ *
+ *        Author: Walter Borst
+ *
+ *        E-Mail: info@borst-automation.de
+ *          Home: https://www.borst-automation.de
+ *
+ * No Warranties: https://www.borst-automation.com/legal/warranty-disclaimer
+ *
+ * Copyright 2006-2025 Walter Borst, Cuxhaven, Germany
+ */
+
+// Once
+#ifndef __hartservicequeue_h__
+#define __hartservicequeue_h__
+
+#include <atomic>
+#include "OSAL.h"
+#include "WbHartUser.h"
+
+class CServiceQueue
+{
+public:
+                        CServiceQueue();
+                       ~CServiceQueue();
+    // The size is rounded up to the next power of 2
+    EN_Bool                   Create(TY_DWord min_size_);
+    void                     Destroy();
+    void                       Clear();
+    EN_Bool                     Push(SRV_Handle handle_);
+    SRV_Handle                   Pop();
+
+private:
+    typedef struct st_Cell
+    {
+        // The sequence tells whether the cell may be
+        // written (== pos) or read (== pos + 1)
+        std::atomic<TY_DWord> Sequence;
+        SRV_Handle              Handle;
+    } ST_Cell;
+
+    ST_Cell*                       m_cells;
+    TY_DWord                        m_size;
+    // Keep the writers and the readers on different cache lines
+    alignas(64) std::atomic<TY_DWord> m_wr_pos;
+    alignas(64) std::atomic<TY_DWord> m_rd_pos;
+};
+
+#endif // __hartservicequeue_h__
@@ -0,0 +1,145 @@
+/*
+ *          File: HartPreparedRequest.cpp (CPreparedRequest)
+ *                A request which is sent again and again (e.g. cyclic
+ *                polling of a device) is encoded only once. A service
+ *                launched from it just copies the octets. Changes of
+ *                the payload, the number of preambles or the master
+ *                address are patched into the encoded frame.
+ *
+ *        Author: Walter Borst
+ *
+ *        E-Mail: info@borst-automation.de
+ *          Home: https://www.borst-automation.de
+ *
+ * No Warranties: https://www.borst-automation.com/legal/warranty-disclaimer
+ *
+ * Copyright 2006-2025 Walter Borst, Cuxhaven, Germany
+ */
+
+#include "HartPreparedRequest.h"
+#include "HartConsts.h"
+#include "HartCoding.h"
+
+// Methods
+CPreparedRequest::CPreparedRequest()
+{
+    COSAL::CMem::Set(m_bytes, 0xff, MAX_PREAMBLES);
+    Init();
+}
+
+void CPreparedRequest::Init()
+{
+    m_len = 0;
+    m_command = 0;
+    m_data_pos = 0;
+    m_data_len = 0;
+    m_primary_master = EN_Bool::FALSE8;
+    m_is_used = EN_Bool::FALSE8;
+}
+
+EN_Bool CPreparedRequest::Prepare(TY_Word command_, TY_Byte* data_ref_, TY_Byte data_len_,
+    TY_Byte* bytes_of_unique_id_, TY_Byte addr_mode_)
+{
+    CFrame      frame;
+    ST_TxBuffer tx_buffer;
+    TY_Byte     data_bytes[MAX_PAYLOAD_SIZE];
+    TY_Byte     ext_len = 0;
+    TY_Byte     addr_len = 1;
+
+    if (command_ > 255)
+    {
+        // Extended commands are sent by command 31
+        ext_len = 2;
+    }
+
+    if ((data_len_ + ext_len) > MAX_PAYLOAD_SIZE)
+    {
+        return EN_Bool::FALSE8;
+    }
+
+    if (ext_len > 0)
+    {
+        CCoding::PutWord(command_, 0, data_bytes, EN_Endian::MSB_First);
+    }
+
+    if (data_len_ > 0)
+    {
+        COSAL::CMem::Copy(&data_bytes[ext_len], data_ref_, data_len_);
+    }
+
+    // Encoded as by a service, but without preambles
+    // and as secondary master
+    frame.AttachTxBuffer(&tx_buffer);
+    frame.Init();
+    frame.Command = (ext_len > 0) ? 31 : (TY_Byte)command_;
+    frame.AddrMode = addr_mode_;
+    frame.NumPreambles = 0;
+    frame.SetUniqueAddr(bytes_of_unique_id_);
+    frame.SetData(data_bytes, (TY_Word)(data_len_ + ext_len));
+    frame.SetLocalMaster(EN_Bool::FALSE8);
+    frame.Encode();
+
+    if (addr_mode_ != CHart::CAddrMode::POLLING)
+    {
+        addr_len = CHart::CSize::NUM_ADDR_BYTES;
+    }
+
+    COSAL::CMem::Copy(&m_bytes[MAX_PREAMBLES], tx_buffer.Bytes, tx_buffer.Len);
+    m_len = tx_buffer.Len;
+    m_command = frame.Command;
+    // Delimiter, address, command and byte count
+    m_data_pos = (TY_Byte)(MAX_PREAMBLES + 1 + addr_len + 2 + ext_len);
+    m_data_len = data_len_;
+    m_primary_master = EN_Bool::FALSE8;
+    m_is_used = EN_Bool::TRUE8;
+    return EN_Bool::TRUE8;
+}
+
+EN_Bool CPreparedRequest::UpdateData(TY_Byte offset_, TY_Byte* data_ref_, TY_Byte len_)
+{
+    TY_Byte* data = &m_bytes[m_data_pos + offset_];
+    TY_Byte* chk = &m_bytes[MAX_PREAMBLES + m_len - 1];
+
+    if ((offset_ + len_) > m_data_len)
+    {
+        return EN_Bool::FALSE8;
+    }
+
+    // The checksum is corrected by the bytes which are replaced
+    *chk ^= CCoding::CheckSum(data, len_) ^ CCoding::CheckSum(data_ref_, len_);
+    COSAL::CMem::Copy(data, data_ref_, len_);
+    return EN_Bool::TRUE8;
+}
+
+void CPreparedRequest::CopyTo(ST_TxBuffer* tx_buffer_, TY_Byte num_preambles_,
+    EN_Bool primary_master_)
+{
+    TY_Byte start;
+
+    if (primary_master_ != m_primary_master)
+    {
+        // Toggle the master flag of the address and the checksum
+        m_bytes[MAX_PREAMBLES + 1] ^= 0x80;
+        m_bytes[MAX_PREAMBLES + m_len - 1] ^= 0x80;
+        m_primary_master = primary_master_;
+    }
+
+    if (num_preambles_ > MAX_PREAMBLES)
+    {
+        num_preambles_ = MAX_PREAMBLES;
+    }
+
+    start = (TY_Byte)(MAX_PREAMBLES - num_preambles_);
+    tx_buffer_->Len = (TY_Word)(m_len + num_preambles_);
+    COSAL::CMem::Copy(tx_buffer_->Bytes, &m_bytes[start], tx_buffer_->Len);
+}
+
+TY_Byte CPreparedRequest::GetCommand()
+{
+    return m_command;
+}
+
+EN_Bool CPreparedRequest::IsUsed()
+{
+    return m_is_used;
+}
@@ -0,0 +1,55 @@
+/*
+ *          File: HartPreparedRequest.h (CPreparedRequest)
+ *                A request which is sent again and again (e.g. cyclic
+ *                polling of a device) is encoded only once. A service
+ *                launched from it just copies the octets. Changes of
+ *                the payload, the number of preambles or the master
+ *                address are patched into the encoded frame.
+ *
+ *        Author: Walter Borst
+ *
+ *        E-Mail: info@borst-automation.de
+ *          Home: https://www.borst-automation.de
+ *
+ * No Warranties: https://www.borst-automation.com/legal/warranty-disclaimer
+ *
+ * Copyright 2006-2025 Walter Borst, Cuxhaven, Germany
+ */
+
+// Once
+#ifndef __hartpreparedrequest_h__
+#define __hartpreparedrequest_h__
+
+#include "OSAL.h"
+#include "WbHartUser.h"
+#include "HartFrame.h"
+
+class CPreparedRequest
+{
+public:
+                          CPreparedRequest();
+    void                      Init();
+    EN_Bool                Prepare(TY_Word command_, TY_Byte* data_ref_, TY_Byte data_len_,
+                               TY_Byte* bytes_of_unique_id_, TY_Byte addr_mode_);
+    EN_Bool             UpdateData(TY_Byte offset_, TY_Byte* data_ref_, TY_Byte len_);
+    // Copies the frame with the given preambles and master flag
+    void                    CopyTo(ST_TxBuffer* tx_buffer_, TY_Byte num_preambles_,
+                               EN_Bool primary_master_);
+    TY_Byte             GetCommand();
+    EN_Bool                 IsUsed();
+
+private:
+    // The frame is stored behind the maximum number of
+    // preambles, fewer preambles just start later
+    static const TY_Byte MAX_PREAMBLES = 23;
+
+    TY_Byte       m_bytes[MAX_PREAMBLES + MAX_TXRX_SIZE];
+    TY_Word       m_len;        // From the delimiter up to the checksum
+    TY_Byte       m_command;    // 8 bit command (31 for extended ones)
+    TY_Byte       m_data_pos;   // First byte of the user data
+    TY_Byte       m_data_len;
+    EN_Bool       m_primary_master;
+    EN_Bool       m_is_used;
+};
+
+#endif // __hartpreparedrequest_h__
@@ -22,59 +22,120 @@
 #include "HartService.h"
 #include "HartChannel.h"
 #include "HartCoding.h"
+#include "HartPreparedRequest.h"
+#include "HartLatency.h"
+#include "HartConsts.h"
+
+// Used as long as no frame was received
+CFrame CService::NoResponse;
+
+// Time stamps of the latency phases which are set
+static const TY_Byte STAMP_BUSY = 0x01;
+static const TY_Byte STAMP_FIRST_TX = 0x02;
+static const TY_Byte STAMP_TX_START = 0x04;
+static const TY_Byte STAMP_TX_END = 0x08;
+static const TY_Byte STAMP_RSP_START = 0x10;
+
+static TY_DWord GetElapsed(TY_DWord from_, TY_DWord to_)
+{
+    // The receiver dates a response back to its first octet,
+    // which may be a tick before the end of the request
+    return ((TY_Int32)(to_ - from_) > 0) ? (to_ - from_) : 0;
+}
 
  /* Initialization and Termination */
-void CService::Init()
+CService::CService()
 {
+    mo_channel = NULL;
+    m_handle.store(INVALID_SRV_HANDLE, std::memory_order_relaxed);
+    m_is_active.store(EN_Bool::FALSE8, std::memory_order_relaxed);
+    m_owner.store(EN_Owner::USER, std::memory_order_relaxed);
+    m_last_event = 0;
+    m_completion_handler = NULL;
+    m_completion_context = NULL;
+    mp_response = NULL;
+    m_request.AttachTxBuffer(&m_tx_buffer);
+}
+
+void CService::Init(CChannel* channel_)
+{
+    mo_channel = channel_;
     Clear();
-    m_is_active = EN_Bool::TRUE8;
-    m_owner = EN_Owner::USER;
+    m_owner.store(EN_Owner::USER, std::memory_order_relaxed);
+    m_is_active.store(EN_Bool::TRUE8, std::memory_order_release);
 }
 
-void CService::Release()
+EN_Bool CService::Release()
 {
-    m_is_active = EN_Bool::FALSE8;
+    // Only the first of concurrent calls succeeds
+    if (m_is_active.exchange(EN_Bool::FALSE8, std::memory_order_acq_rel) == EN_Bool::FALSE8)
+    {
+        return EN_Bool::FALSE8;
+    }
+
+    ReleaseResponse();
+    return EN_Bool::TRUE8;
 }
 
 EN_Bool CService::IsActive()
 {
-    return m_is_active;
+    return m_is_active.load(std::memory_order_acquire);
 }
 
 void CService::Clear()
 {
     m_request.Init();
-    m_response.Init();
+    ReleaseResponse();
     Status = EN_Status::IDLE;
     m_sub_status = EN_SubStat::IDLE;
     m_type = EN_Type::SEND_RECEIVE;
     m_mode = EN_Mode::NORMAL;
     m_duration = 0;
+    m_stamps = 0;
+    m_num_attempts = 0;
     m_retry_count = 0;
     m_req_cmd = 0;
+    m_priority = EN_Priority::CYCLIC;
+    m_deadline_ms = 0;
+    m_completion_handler = NULL;
+    m_completion_context = NULL;
 }
 
 /* Handling of properties */
 SRV_Handle CService::GetHandle()
 {
-    return m_handle;
+    return m_handle.load(std::memory_order_relaxed);
 }
 
 void CService::SetHandle(SRV_Handle service_)
 {
-    m_handle = service_;
+    m_handle.store(service_, std::memory_order_relaxed);
 }
 
 void CService::Launch()
 {
-    m_request.SetLocalMaster(CChannel::IsPrimaryMaster());
-    m_response.SetLocalMaster(CChannel::IsPrimaryMaster());
+    m_request.SetLocalMaster(mo_channel->IsPrimaryMaster());
     if (GetMode() == EN_Mode::SEND_BURST)
     {
         m_request.SetBurstFrame(EN_Bool::TRUE8);
     }
 
     m_request.Encode();
+    m_launch_time = COSAL::CTimer::GetTime();
+    m_stamps = 0;
+    m_num_attempts = 0;
+    Status = EN_Status::REQUESTED;
+}
+
+void CService::LaunchPrepared(CPreparedRequest* prepared_)
+{
+    // The request was encoded before, it is only copied
+    m_req_cmd = prepared_->GetCommand();
+    m_request.Command = m_req_cmd;
+    prepared_->CopyTo(&m_tx_buffer, m_request.NumPreambles, mo_channel->IsPrimaryMaster());
+    m_launch_time = COSAL::CTimer::GetTime();
+    m_stamps = 0;
+    m_num_attempts = 0;
     Status = EN_Status::REQUESTED;
 }
 
@@ -88,6 +149,18 @@ TY_Byte CService::GetLastEvent()
     return m_last_event;
 }
 
+void CService::SetCompletionHandler(TY_CompletionHandler handler_, void* context_)
+{
+    m_completion_handler = handler_;
+    m_completion_context = context_;
+}
+
+TY_CompletionHandler CService::GetCompletionHandler(void** context_)
+{
+    *context_ = m_completion_context;
+    return m_completion_handler;
+}
+
 CService::EN_Status CService::GetStatus()
 {
     return Status;
@@ -99,6 +172,12 @@ void CService::SetStatus(EN_Status status_)
     if (status_ == EN_Status::BUSY)
     {
         m_start_time = COSAL::CTimer::GetTime();
+        if ((m_stamps & STAMP_BUSY) == 0)
+        {
+            // Taken by layer 2 for the first time
+            m_busy_time = m_start_time;
+            m_stamps |= STAMP_BUSY;
+        }
     }
 
     if (status_ == EN_Status::WAITING)
@@ -149,12 +228,13 @@ void CService::SetCompletionCode(EN_SRV_Result code_)
 
 EN_Owner CService::GetOwner()
 {
-    return m_owner;
+    return m_owner.load(std::memory_order_acquire);
 }
 
 void CService::SetOwner(EN_Owner owner_)
 {
-    m_owner = owner_;
+    // Publishes all data of the service to the new owner
+    m_owner.store(owner_, std::memory_order_release);
 }
 
 TY_Byte* CService::GetTxData(TY_Word* len_)
@@ -218,6 +298,11 @@ void CService::SetNumRetries(TY_Byte num_retries_)
     m_num_retries = num_retries_;
 }
 
+TY_Byte CService::GetMaxRetries()
+{
+    return m_num_retries;
+}
+
 void CService::SetNumPreambles(TY_Byte num_preambles_)
 {
     m_request.NumPreambles = num_preambles_;
@@ -238,11 +323,58 @@ void CService::SetShortAddr(TY_Byte short_addr_)
     m_request.SetPollAddr(short_addr_);
 }
 
+void CService::SetPriority(EN_Priority priority_)
+{
+    m_priority = priority_;
+}
+
+EN_Priority CService::GetPriority()
+{
+    return m_priority;
+}
+
+void CService::SetDeadline(TY_DWord deadline_ms_)
+{
+    m_deadline_ms = deadline_ms_;
+}
+
+EN_Bool CService::GetDeadline(TY_DWord* time_)
+{
+    if (m_deadline_ms == 0)
+    {
+        return EN_Bool::FALSE8;
+    }
+
+    *time_ = m_launch_time + m_deadline_ms;
+    return EN_Bool::TRUE8;
+}
+
 /* Setup up request */
 void CService::SetResponse(CFrame* frame_)
 {
-    m_response.Init();
-    m_response = *frame_;
+    // The frame is shared with the receiver, not copied
+    ReleaseResponse();
+    mo_channel->Frames.AddRef(frame_);
+    mp_response = frame_;
+}
+
+CFrame* CService::Response()
+{
+    if (mp_response != NULL)
+    {
+        return mp_response;
+    }
+
+    return &NoResponse;
+}
+
+void CService::ReleaseResponse()
+{
+    if (mp_response != NULL)
+    {
+        mo_channel->Frames.Release(mp_response);
+        mp_response = NULL;
+    }
 }
 
 EN_Bool CService::IsInProgress()
@@ -279,6 +411,8 @@ EN_Bool CService::Failed()
     case EN_SRV_Result::NO_DEV_RESP:
     case EN_SRV_Result::COMM_ERR:
     case EN_SRV_Result::RESOURCE_ERROR:
+    case EN_SRV_Result::DEADLINE_MISSED:
+    case EN_SRV_Result::DEVICE_OFFLINE:
         return EN_Bool::TRUE8;
     default:
         break;
@@ -286,19 +420,33 @@ EN_Bool CService::Failed()
     return EN_Bool::FALSE8;
 }
 
+EN_SRV_Result CService::GetFailedResult()
+{
+    // A failed service which was dropped by the kernel or was
+    // short of resources tells why, all others did not get a
+    // valid response
+    if ((m_completion_code == EN_SRV_Result::DEADLINE_MISSED) ||
+        (m_completion_code == EN_SRV_Result::DEVICE_OFFLINE) ||
+        (m_completion_code == EN_SRV_Result::RESOURCE_ERROR))
+    {
+        return m_completion_code;
+    }
+    return EN_SRV_Result::NO_DEV_RESP;
+}
+
 TY_Byte CService::GetRespLen()
 {
-    return m_response.GetDataSize();
+    return Response()->GetDataSize();
 }
 
 TY_Byte CService::GetRespCode1()
 {
-    return m_response.GetRspCode1();
+    return Response()->GetRspCode1();
 }
 
 TY_Byte CService::GetRespCode2()
 {
-    return m_response.GetRspCode2();
+    return Response()->GetRspCode2();
 }
 
 TY_Byte CService::GetRespDataByte(TY_Byte idx_)
@@ -306,10 +454,10 @@ TY_Byte CService::GetRespDataByte(TY_Byte idx_)
     TY_Byte* data;
     TY_Byte  len;
 
-    data = m_response.GetDataBuffer();
+    data = Response()->GetDataBuffer();
     if (data != NULL)
     {
-        len = m_response.GetDataSize();
+        len = Response()->GetDataSize();
         if (len > idx_)
         {
             return data[idx_];
@@ -321,12 +469,12 @@ TY_Byte CService::GetRespDataByte(TY_Byte idx_)
 
 EN_Bool CService::GetDeviceInBurstMode()
 {
-    return m_response.IsBurstModeDevice();
+    return Response()->IsBurstModeDevice();
 }
 
 TY_Byte CService::GetUsedRetries()
 {
-    return 0;
+    return GetNumRetries();
 }
 
 TY_Word CService::GetDuration()
@@ -338,10 +486,10 @@ TY_Byte CService::GetRespData(TY_Byte* data_bytes_)
 {
     TY_Byte len;
 
-    len = m_response.GetDataSize();
+    len = Response()->GetDataSize();
     if (len > 0)
     {
-        TY_Byte* data = m_response.GetDataBuffer();
+        TY_Byte* data = Response()->GetDataBuffer();
         if (data != 0)
         {
             COSAL::CMem::Copy(data_bytes_, data, len);
@@ -354,5 +502,211 @@ TY_Byte CService::GetRespData(TY_Byte* data_bytes_)
 
 TY_Byte CService::GetRespCmd()
 {
-    return m_response.Command;
+    return Response()->Command;
+}
+
+void CService::GetConfirmation(TY_Confirmation* conf_data_)
+{
+    if (Failed() == EN_Bool::TRUE8)
+    {
+        conf_data_->SrvResultCode = GetFailedResult();
+        conf_data_->UsedRetries = GetUsedRetries();
+        conf_data_->DataLen = 0;
+        return;
+    }
+
+    conf_data_->SrvResultCode = EN_SRV_Result::SUCCESSFUL;
+    conf_data_->RespCode1 = GetRespCode1();
+    conf_data_->RespCode2 = GetRespCode2();
+    conf_data_->Cmd = GetRespCmd();
+    conf_data_->DeviceInBurstMode = GetDeviceInBurstMode();
+    conf_data_->UsedRetries = GetUsedRetries();
+    conf_data_->SrvDuration = GetDuration();
+    conf_data_->DataLen = GetRespData(conf_data_->BytesOfData);
+    if (GetRespCmd() == 31)
+    {
+        // Handle extended command
+        if (conf_data_->RespCode1 != 64)
+        {
+            if (conf_data_->DataLen < 2)
+            {
+                // Extended command format error
+                conf_data_->SrvResultCode = EN_SRV_Result::TOO_FEW_DATA_BYTES;
+                conf_data_->ExtCommand = 0xffff;
+            }
+            else
+            {
+                TY_Byte u8_DataLen = (TY_Byte)(conf_data_->DataLen - 2);
+
+                // Extended command: correct data and data length
+                conf_data_->ExtCommand = CCoding::PickWord(0, conf_data_->BytesOfData, EN_Endian::MSB_First);
+                if (u8_DataLen > 0)
+                {
+                    // Pull the data two octets foreward
+                    COSAL::CMem::Copy(conf_data_->BytesOfData, &conf_data_->BytesOfData[2], u8_DataLen);
+                }
+
+                conf_data_->DataLen = u8_DataLen;
+            }
+        }
+    }
+}
+
+void CService::GetConfirmationView(TY_ConfirmationView* view_)
+{
+    view_->Data = NULL;
+    view_->DataLen = 0;
+    if (Failed() == EN_Bool::TRUE8)
+    {
+        view_->SrvResultCode = GetFailedResult();
+        view_->UsedRetries = GetUsedRetries();
+        return;
+    }
+
+    view_->SrvResultCode = EN_SRV_Result::SUCCESSFUL;
+    view_->RespCode1 = GetRespCode1();
+    view_->RespCode2 = GetRespCode2();
+    view_->Cmd = GetRespCmd();
+    view_->ExtCommand = view_->Cmd;
+    view_->DeviceInBurstMode = GetDeviceInBurstMode();
+    view_->UsedRetries = GetUsedRetries();
+    view_->SrvDuration = GetDuration();
+    view_->DataLen = GetRespLen();
+    if (view_->DataLen > 0)
+    {
+        view_->Data = Response()->GetDataBuffer();
+    }
+
+    if ((view_->Cmd == 31) && (view_->RespCode1 != 64))
+    {
+        // Handle extended command
+        if (view_->DataLen < 2)
+        {
+            // Extended command format error
+            view_->SrvResultCode = EN_SRV_Result::TOO_FEW_DATA_BYTES;
+            view_->ExtCommand = 0xffff;
+        }
+        else
+        {
+            // Skip the command number instead of moving the data
+            view_->ExtCommand = CCoding::PickWord(0, (TY_Byte*)view_->Data, EN_Endian::MSB_First);
+            view_->DataLen = (TY_Byte)(view_->DataLen - 2);
+            if (view_->DataLen > 0)
+            {
+                view_->Data = &view_->Data[2];
+            }
+            else
+            {
+                view_->Data = NULL;
+            }
+        }
+    }
+}
+
+/* Latency */
+void CService::MarkTxStart()
+{
+    m_tx_start_time = COSAL::CTimer::GetTime();
+    if ((m_stamps & STAMP_FIRST_TX) == 0)
+    {
+        m_first_tx_time = m_tx_start_time;
+    }
+
+    // Only the phases of the last attempt are recorded
+    m_stamps = (TY_Byte)((m_stamps | STAMP_FIRST_TX | STAMP_TX_START) & ~(STAMP_TX_END | STAMP_RSP_START));
+    m_num_attempts++;
+}
+
+void CService::MarkTxEnd()
+{
+    m_tx_end_time = COSAL::CTimer::GetTime();
+    m_stamps |= STAMP_TX_END;
+}
+
+void CService::MarkRspStart(TY_DWord time_)
+{
+    m_rsp_start_time = time_;
+    m_stamps |= STAMP_RSP_START;
+}
+
+void CService::GetPhaseTimes(TY_DWord* phase_ms_)
+{
+    for (TY_Byte e = 0; e < CLatencyStats::CPhase::NUM_PHASES; e++)
+    {
+        phase_ms_[e] = CLatencyStats::NOT_REACHED;
+    }
+
+    if ((m_stamps & STAMP_BUSY) != 0)
+    {
+        phase_ms_[CLatencyStats::CPhase::QUEUE_WAIT] = GetElapsed(m_launch_time, m_busy_time);
+        if ((m_stamps & STAMP_FIRST_TX) != 0)
+        {
+            phase_ms_[CLatencyStats::CPhase::BUS_WAIT] = GetElapsed(m_busy_time, m_first_tx_time);
+        }
+    }
+
+    if ((m_stamps & STAMP_TX_END) != 0)
+    {
+        phase_ms_[CLatencyStats::CPhase::TX_TIME] = GetElapsed(m_tx_start_time, m_tx_end_time);
+        if ((m_stamps & STAMP_RSP_START) != 0)
+        {
+            phase_ms_[CLatencyStats::CPhase::TURNAROUND] = GetElapsed(m_tx_end_time, m_rsp_start_time);
+        }
+    }
+
+    phase_ms_[CLatencyStats::CPhase::TOTAL] = GetElapsed(m_launch_time, COSAL::CTimer::GetTime());
+}
+
+TY_Byte CService::GetNumRetries()
+{
+    // Retries on a busy device as well as on a missing response
+    return (m_num_attempts > 0) ? (TY_Byte)(m_num_attempts - 1) : 0;
+}
+
+void CService::GetLatencyKey(TY_Byte* addr_mode_, TY_Byte* address_, TY_Word* command_)
+{
+    // The key is taken from the encoded request, which
+    // is the only copy for a prepared request
+    TY_Word  pos = 0;
+    TY_Byte  delimiter;
+    TY_Byte* bytes = m_tx_buffer.Bytes;
+
+    COSAL::CMem::Set(address_, 0, 5);
+    *addr_mode_ = CHart::CAddrMode::POLLING;
+    *command_ = m_req_cmd;
+    while ((pos < m_tx_buffer.Len) && (bytes[pos] == 0xff))
+    {
+        pos++;
+    }
+
+    if ((pos + 2) >= m_tx_buffer.Len)
+    {
+        return;
+    }
+
+    delimiter = bytes[pos++];
+    if ((delimiter & CHart::CFlags::UNIQUE_ADDR) != 0)
+    {
+        *addr_mode_ = CHart::CAddrMode::UNIQUE;
+        if ((pos + 5) > m_tx_buffer.Len)
+        {
+            return;
+        }
+
+        COSAL::CMem::Copy(address_, &bytes[pos], 5);
+        pos += 5;
+    }
+    else
+    {
+        address_[0] = bytes[pos++];
+    }
+
+    // Without the master and burst flags
+    address_[0] &= CHart::CMask::HIGH_ADDR;
+    pos = (TY_Word)(pos + ((delimiter & CHart::CMask::NUM_EXP_BYTES) >> 5));
+    // Extended commands are filed under their 16 bit number
+    if ((m_req_cmd == 31) && ((pos + 4) <= m_tx_buffer.Len) && (bytes[pos + 1] >= 2))
+    {
+        *command_ = CCoding::PickWord(0, &bytes[pos + 2], EN_Endian::MSB_First);
+    }
 }
@@ -20,7 +20,12 @@
 #ifndef __hartservice_h__
 #define __hartservice_h__
 
-class CFrame;
+#include <atomic>
+#include "WbHartM_Structures.h"
+#include "HartFrame.h"
+
+class CChannel;
+class CPreparedRequest;
 class CService
 {
 public:
@@ -56,8 +61,9 @@ public:
     };
 
     /* Construction/Destruction */
-    void                       Init();
-    void                    Release();
+                           CService();
+    void                       Init(CChannel* channel_);
+    EN_Bool                 Release();
     EN_Bool                IsActive();
     void                      Clear();
     /* Operation */
@@ -77,13 +83,17 @@ public:
     void          SetCompletionCode(EN_SRV_Result code_);
     EN_SRV_Result GetCompletionCode();
     void                     Launch();
+    void             LaunchPrepared(CPreparedRequest* prepared_);
     void               SetLastEvent(TY_Byte event_);
     TY_Byte            GetLastEvent();
+    void       SetCompletionHandler(TY_CompletionHandler handler_, void* context_);
+    TY_CompletionHandler GetCompletionHandler(void** context_);
     // Set Request Data
     void                 SetCommand(TY_Byte command_);
     void                SetAddrMode(TY_Byte addr_mode_);
     void             SetRetryIfBusy(EN_Bool retry_if_busy_);
     void              SetNumRetries(TY_Byte num_retries_);
+    TY_Byte           GetMaxRetries();
     void            SetNumPreambles(TY_Byte num_preambles_);
     void                    SetData(TY_Byte* data_, TY_Byte len_);
     void                SetUniqueID(TY_Byte* bytes_of_unique_id_);
@@ -91,6 +101,12 @@ public:
     void                SetShortTag(TY_Byte* short_tag_);
     void                 SetLongTag(TY_Byte* long_tag_);
     void               SetInvMaster(EN_Bool inv_master_);
+    // Scheduling by the kernel, the deadline counts from the launch
+    void                SetPriority(EN_Priority priority_);
+    EN_Priority         GetPriority();
+    void                SetDeadline(TY_DWord deadline_ms_);
+    // FALSE8: No deadline
+    EN_Bool             GetDeadline(TY_DWord* time_);
     // Get Response Data
     TY_Byte              Command();
     void                SetResponse(CFrame* frame_);
@@ -99,6 +115,8 @@ public:
     EN_Bool            IsInProgress();
     EN_Bool             RetryIfBusy();
     EN_Bool                  Failed();
+    // Completion code of a failed service
+    EN_SRV_Result   GetFailedResult();
     void            ClearRetryCount();
     void              IncRetryCount();
     TY_Byte              GetRespLen();
@@ -110,27 +128,60 @@ public:
     TY_Word             GetDuration();
     TY_Byte             GetRespData(TY_Byte* pu8_Data);
     TY_Byte              GetRespCmd();
+    void            GetConfirmation(TY_Confirmation* conf_data_);
+    void        GetConfirmationView(TY_ConfirmationView* view_);
+    // Latency, the phases are marked by layer 2
+    void                MarkTxStart();
+    void                  MarkTxEnd();
+    void              MarkRspStart(TY_DWord time_);
+    void             GetPhaseTimes(TY_DWord* phase_ms_);
+    TY_Byte            GetNumRetries();
+    void             GetLatencyKey(TY_Byte* addr_mode_, TY_Byte* address_, TY_Word* command_);
 protected:
 private:
+    CFrame*                Response();
+    void            ReleaseResponse();
+
     /* Data */
+    CChannel*      mo_channel;
     EN_Status      Status;
     EN_SubStat     m_sub_status;
     EN_Type        m_type;
     EN_Mode        m_mode;
-    SRV_Handle     m_handle;
     TY_DWord       m_app_key;
     EN_Bool        m_retry_if_busy;
     TY_Byte        m_num_retries;
     EN_SRV_Result  m_completion_code;
     TY_DWord       m_start_time;
     TY_DWord       m_duration;
+    // Time stamps of the phases, m_stamps tells which are set
+    TY_DWord       m_launch_time;
+    TY_DWord       m_busy_time;
+    TY_DWord       m_first_tx_time;
+    TY_DWord       m_tx_start_time;
+    TY_DWord       m_tx_end_time;
+    TY_DWord       m_rsp_start_time;
+    TY_Byte        m_stamps;
+    TY_Byte        m_num_attempts;
     TY_Byte        m_retry_count;
     TY_Byte        m_req_cmd;
+    EN_Priority    m_priority;
+    // 0: No deadline
+    TY_DWord       m_deadline_ms;
     CFrame         m_request;
-    CFrame         m_response;
-    EN_Bool        m_is_active;
-    EN_Owner       m_owner;
+    // Received frame, taken from the frame pool of the channel
+    CFrame*        mp_response;
+    static CFrame  NoResponse;
+    // Only the request is encoded
+    ST_TxBuffer    m_tx_buffer;
+    // Shared by the application and the kernel
+    std::atomic<EN_Bool>  m_is_active;
+    // Index and generation, checked against stale handles
+    std::atomic<SRV_Handle> m_handle;
+    std::atomic<EN_Owner> m_owner;
     TY_Byte        m_last_event;
+    TY_CompletionHandler m_completion_handler;
+    void*          m_completion_context;
 };
 
 #endif // __hartservice_h__
\ No newline at end of file
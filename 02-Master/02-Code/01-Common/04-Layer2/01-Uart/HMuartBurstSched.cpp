@@ -0,0 +1,196 @@
+/*
+ *          File: HMuartBurstSched.cpp (CHMuartBurstSched)
+ *                Scheduling of the requests of the master around the
+ *                burst frames on a Hart loop.
+ *
+ *        Author: Walter Borst
+ *
+ *        E-Mail: info@borst-automation.de
+ *          Home: https://www.borst-automation.de
+ *
+ * No Warranties: https://www.borst-automation.com/legal/warranty-disclaimer
+ *
+ * Copyright 2006-2025 Walter Borst, Cuxhaven, Germany
+ */
+
+#include "HMuartBurstSched.h"
+#include "HartConsts.h"
+
+// Construction
+CHMuartBurstSched::CHMuartBurstSched()
+{
+    Init();
+}
+
+// Methods
+void CHMuartBurstSched::Init()
+{
+    COSAL::CMem::Set((TY_Byte*)m_devices, 0, sizeof(m_devices));
+    m_trans_time = 0;
+    m_deferred = EN_Bool::FALSE8;
+}
+
+void CHMuartBurstSched::Learn(CFrame* frame_)
+{
+    ST_Device* device;
+    TY_Byte    address[5] = { 0 };
+    TY_DWord   start = frame_->GetStartTime();
+    TY_DWord   sample;
+
+    if (frame_->AddrMode == CHart::CAddrMode::UNIQUE)
+    {
+        frame_->GetUniqueID(address);
+    }
+    else
+    {
+        address[0] = frame_->GetShortAddr();
+    }
+
+    device = FindDevice(frame_->AddrMode, address, start);
+    if (device->IsUsed == EN_Bool::FALSE8)
+    {
+        device->IsUsed = EN_Bool::TRUE8;
+        device->AddrMode = frame_->AddrMode;
+        COSAL::CMem::Copy(device->Address, address, 5);
+        device->Period = 0;
+        device->NumMisfits = 0;
+    }
+    else
+    {
+        sample = start - device->LastStart;
+        if ((device->Period == 0) || (device->NumMisfits >= 2))
+        {
+            device->Period = sample;
+            device->NumMisfits = 0;
+        }
+        else
+        {
+            // Bursts missed or delayed by a transaction count as
+            // the nearest multiple of the period
+            TY_DWord num_periods = (sample + device->Period / 2) / device->Period;
+            TY_DWord expected = num_periods * device->Period;
+            TY_DWord deviation = (sample > expected) ? (sample - expected) : (expected - sample);
+
+            if ((num_periods > 0) && (deviation <= device->Period / 4))
+            {
+                sample /= num_periods;
+                device->Period = (TY_DWord)((TY_Int32)device->Period +
+                    (((TY_Int32)sample - (TY_Int32)device->Period) >> PERIOD_SHIFT));
+                device->NumMisfits = 0;
+            }
+            else
+            {
+                device->NumMisfits++;
+            }
+        }
+    }
+
+    device->LastStart = start;
+    device->Duration = frame_->GetEndTime() - start;
+}
+
+void CHMuartBurstSched::LearnTransaction(TY_DWord duration_)
+{
+    if (m_trans_time == 0)
+    {
+        m_trans_time = duration_;
+    }
+    else
+    {
+        m_trans_time = (TY_DWord)((TY_Int32)m_trans_time +
+            (((TY_Int32)duration_ - (TY_Int32)m_trans_time) >> TRANS_SHIFT));
+    }
+}
+
+TY_DWord CHMuartBurstSched::GetWaitTime(TY_DWord now_, TY_Word tx_len_, TY_DWord baudrate_)
+{
+    TY_DWord trans_time = m_trans_time;
+    TY_DWord wait_time = 0;
+
+    if (trans_time == 0)
+    {
+        // Nothing learned yet, a response as long as the request
+        trans_time = COSAL::CTimer::GetTxDuration((TY_Word)(2 * tx_len_), baudrate_);
+    }
+
+    for (TY_Word e = 0; e < MAX_NUM_BURST_DEVICES; e++)
+    {
+        ST_Device* device = &m_devices[e];
+
+        if ((device->IsUsed == EN_Bool::FALSE8) || (device->Period == 0))
+        {
+            continue;
+        }
+
+        TY_DWord next = device->LastStart + device->Period;
+        TY_Int32 to_end = (TY_Int32)(next + device->Duration - now_);
+        TY_Int32 to_start = (TY_Int32)(next - now_) - (TY_Int32)(GUARD + device->Period / 16);
+
+        // Overdue bursts are not waited for, the device stopped
+        // bursting or it was pushed back by another transaction
+        if (to_end <= 0)
+        {
+            continue;
+        }
+
+        if ((to_start < (TY_Int32)trans_time) && ((TY_DWord)to_end > wait_time))
+        {
+            wait_time = (TY_DWord)to_end;
+        }
+    }
+
+    return wait_time;
+}
+
+TY_DWord CHMuartBurstSched::DeferRequest(TY_DWord now_, TY_Word tx_len_, TY_DWord baudrate_)
+{
+    TY_DWord wait_time;
+
+    if (m_deferred == EN_Bool::TRUE8)
+    {
+        return 0;
+    }
+
+    wait_time = GetWaitTime(now_, tx_len_, baudrate_);
+    if (wait_time > 0)
+    {
+        m_deferred = EN_Bool::TRUE8;
+    }
+
+    return wait_time;
+}
+
+void CHMuartBurstSched::ReleaseRequest()
+{
+    m_deferred = EN_Bool::FALSE8;
+}
+
+CHMuartBurstSched::ST_Device* CHMuartBurstSched::FindDevice(TY_Byte addr_mode_, TY_Byte* address_, TY_DWord time_)
+{
+    ST_Device* oldest = &m_devices[0];
+
+    for (TY_Word e = 0; e < MAX_NUM_BURST_DEVICES; e++)
+    {
+        ST_Device* device = &m_devices[e];
+
+        if (device->IsUsed == EN_Bool::FALSE8)
+        {
+            return device;
+        }
+
+        if ((device->AddrMode == addr_mode_) &&
+            (COSAL::CMem::IsEqual(device->Address, address_, 5) == EN_Bool::TRUE8))
+        {
+            return device;
+        }
+
+        if ((time_ - device->LastStart) > (time_ - oldest->LastStart))
+        {
+            oldest = device;
+        }
+    }
+
+    // The device which was silent for the longest time is replaced
+    oldest->IsUsed = EN_Bool::FALSE8;
+    return oldest;
+}
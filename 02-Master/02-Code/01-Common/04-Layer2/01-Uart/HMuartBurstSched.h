@@ -0,0 +1,82 @@
+/*
+ *          File: HMuartBurstSched.h (CHMuartBurstSched)
+ *                Scheduling of the requests of the master around the
+ *                burst frames on a Hart loop. The period and the length
+ *                of the bursts are learned per device from the frames
+ *                on the bus. A request which would still be on the bus
+ *                (or waiting for its response) when the next burst is
+ *                due is held back until that burst is over, but for one
+ *                burst at most.
+ *
+ *        Author: Walter Borst
+ *
+ *        E-Mail: info@borst-automation.de
+ *          Home: https://www.borst-automation.de
+ *
+ * No Warranties: https://www.borst-automation.com/legal/warranty-disclaimer
+ *
+ * Copyright 2006-2025 Walter Borst, Cuxhaven, Germany
+ */
+
+// Once
+#ifndef __hmuartburstsched_h__
+#define __hmuartburstsched_h__
+
+#include "OSAL.h"
+#include "WbHartUser.h"
+#include "HartFrame.h"
+
+class CHMuartBurstSched
+{
+public:
+                           CHMuartBurstSched();
+    void                      Init();
+    // A burst frame seen on the bus
+    void                     Learn(CFrame* frame_);
+    // A transaction of the master, from the start of the request
+    // to the end of the response
+    void          LearnTransaction(TY_DWord duration_);
+    // Time until the end of the next burst if a transaction started
+    // now would collide with it, 0: The gap is large enough
+    TY_DWord           GetWaitTime(TY_DWord now_, TY_Word tx_len_, TY_DWord baudrate_);
+    // The wait time of the request which is about to be sent, 0 if
+    // it waited for a burst already. It is sent after that burst
+    // or if the burst did not come.
+    TY_DWord          DeferRequest(TY_DWord now_, TY_Word tx_len_, TY_DWord baudrate_);
+    // The request is sent or dropped, the next one may wait again
+    void            ReleaseRequest();
+
+private:
+    // Periods are smoothed by 1/2^PERIOD_SHIFT of the new sample
+    static const TY_Byte    PERIOD_SHIFT = 2;
+    // Transaction times are smoothed the same way
+    static const TY_Byte     TRANS_SHIFT = 2;
+    // Safety margin in front of a burst in milliseconds
+    static const TY_DWord          GUARD = 5;
+
+    typedef struct st_Device
+    {
+        EN_Bool      IsUsed;
+        TY_Byte      AddrMode;
+        // Unique ID or the polling address in the first byte
+        TY_Byte      Address[5];
+        TY_DWord     LastStart;
+        // Length of the last burst frame
+        TY_DWord     Duration;
+        // 0: Only one burst seen yet
+        TY_DWord     Period;
+        // Consecutive periods which did not fit, the period is
+        // learned again after two of them
+        TY_Byte      NumMisfits;
+    } ST_Device;
+
+    ST_Device*         FindDevice(TY_Byte addr_mode_, TY_Byte* address_, TY_DWord time_);
+
+    ST_Device      m_devices[MAX_NUM_BURST_DEVICES];
+    // Smoothed time of a transaction, 0: None seen yet
+    TY_DWord       m_trans_time;
+    // The request waited for a burst already
+    EN_Bool        m_deferred;
+};
+
+#endif // __hmuartburstsched_h__
@@ -25,16 +25,21 @@
 
 // CHMuartL2SM
 
-// Data 
-CHMuartL2SM::EN_Status           CHMuartL2SM::Status = EN_Status::IDLE;
-CHMuartL2SM::EN_StatusInWATCHING CHMuartL2SM::m_status_in_WATCHING = EN_StatusInWATCHING::IDLE;
-CHMuartL2SM::EN_StatusInIDLE     CHMuartL2SM::m_status_in_IDLE = EN_StatusInIDLE::IDLE;
-CHMuartL2SM::EN_StatusInUSING    CHMuartL2SM::m_status_in_USING = EN_StatusInUSING::NOT_SET;
-EN_Bool                          CHMuartL2SM::m_hart_enabled = EN_Bool::FALSE8;
-EN_Bool                          CHMuartL2SM::m_burst_mode = EN_Bool::FALSE8;
-EN_Bool                          CHMuartL2SM::m_msg_pending = EN_Bool::FALSE8;
-CService*                        CHMuartL2SM::m_active_CService;
-COSAL::CTimer                    CHMuartL2SM::m_timer;
+// Construction
+CHMuartL2SM::CHMuartL2SM(CChannel* channel_)
+{
+    mo_channel = channel_;
+    Status = EN_Status::IDLE;
+    m_status_in_WATCHING = EN_StatusInWATCHING::IDLE;
+    m_status_in_IDLE = EN_StatusInIDLE::IDLE;
+    m_status_in_USING = EN_StatusInUSING::NOT_SET;
+    m_hart_enabled = EN_Bool::FALSE8;
+    m_burst_mode = EN_Bool::FALSE8;
+    m_msg_pending = EN_Bool::FALSE8;
+    m_active_CService = NULL;
+    m_timer.InitNoneStatic();
+    m_tx_start_time = 0;
+}
 
 //Methods
 void CHMuartL2SM::Init()
@@ -46,9 +51,12 @@ void CHMuartL2SM::Init()
     m_hart_enabled = EN_Bool::FALSE8;
     m_burst_mode = EN_Bool::FALSE8;
     m_msg_pending = EN_Bool::FALSE8;
+    // Services of the last open were dropped with the pool
+    m_active_CService = NULL;
     m_timer.InitNoneStatic();
-    CHMuartL2RxSM::Init();
-    CHMuartL2TxSM::Init();
+    m_burst_sched.Init();
+    mo_channel->UartL2RxSM.Init();
+    mo_channel->UartL2TxSM.Init();
 }
 
 // Operation
@@ -103,11 +111,11 @@ void CHMuartL2SM::SetActiveServiceFailed()
     {
         m_active_CService->SetCompletionCode(EN_SRV_Result::RESOURCE_ERROR);
         m_active_CService->SetStatus(CService::EN_Status::WAITING);
-        CChannel::FireServiceEvent(CChannel::CServiceEvent::CONFIRMATION,
+        mo_channel->FireServiceEvent(CChannel::CServiceEvent::CONFIRMATION,
             m_active_CService->GetHandle(),
             0
         );
-        m_active_CService = NULL;
+        DropActiveService();
     }
 }
 
@@ -121,13 +129,18 @@ void CHMuartL2SM::Disable()
     m_hart_enabled = EN_Bool::FALSE8;
 }
 
+void CHMuartL2SM::ExpireTimer()
+{
+    m_timer.Expire();
+}
+
 // State handling
 CHMuartL2SM::EN_Status CHMuartL2SM::HandleStatus_IDLE(EN_Event event_, CFrame* frame_, CHMuartProtocol::EN_ToDo* to_do_)
 {
     switch (m_status_in_IDLE)
     {
     case EN_StatusInIDLE::IDLE:
-        if (CChannel::GetHartEnabled() == EN_Bool::TRUE8)
+        if (mo_channel->GetHartEnabled() == EN_Bool::TRUE8)
         {
             SetRT1();
             return Enter_WATCHING(to_do_);
@@ -141,11 +154,11 @@ CHMuartL2SM::EN_Status CHMuartL2SM::HandleStatus_IDLE(EN_Event event_, CFrame* f
                 m_active_CService->SetSubStatus(CService::EN_SubStat::IDLE);
                 m_active_CService->SetCompletionCode(EN_SRV_Result::NO_DEV_RESP);
                 m_active_CService->SetStatus(CService::EN_Status::WAITING);
-                CChannel::FireServiceEvent(CChannel::CServiceEvent::CONFIRMATION,
+                mo_channel->FireServiceEvent(CChannel::CServiceEvent::CONFIRMATION,
                     m_active_CService->GetHandle(),
                     0
                 );
-                m_active_CService = NULL;
+                DropActiveService();
                 *to_do_ = CHMuartProtocol::EN_ToDo::RECEIVE_DISABLE;
                 m_status_in_IDLE = EN_StatusInIDLE::IDLE;
             }
@@ -254,7 +267,7 @@ CHMuartL2SM::EN_Status CHMuartL2SM::HandleStatus_WATCHING(EN_Event event_, CFram
                 if (IsMsgPending() == EN_Bool::TRUE8)
                 {
                     m_timer.Stop();
-                    CHMuartL2RxSM::Reset();
+                    mo_channel->UartL2RxSM.Reset();
                     return StartTransmit_EnterUSING(to_do_);
                 }
                 else
@@ -307,6 +320,11 @@ CHMuartL2SM::EN_Status CHMuartL2SM::HandleStatus_ENABLED(CHMuartL2SM::EN_Event e
 
     if (IsMsgPending() == EN_Bool::TRUE8)
     {
+        if (DeferForBurst() == EN_Bool::TRUE8)
+        {
+            // Watch the burst, the token may be passed by it
+            return Enter_WATCHING(to_do_);
+        }
         m_timer.Stop();
         return StartTransmit_EnterUSING(to_do_);
     }
@@ -336,6 +354,7 @@ CHMuartL2SM::EN_Status CHMuartL2SM::HandleStatus_USING(CHMuartL2SM::EN_Event eve
     case EN_StatusInUSING::SENDING:
         if (event_ == EN_Event::TX_DONE)
         {
+            m_active_CService->MarkTxEnd();
             if (m_active_CService->GetMode() == CService::EN_Mode::SEND_BURST)
             {
                 TRANSMITcnfDone();
@@ -387,6 +406,7 @@ CHMuartL2SM::EN_Status CHMuartL2SM::HandleStatus_USING(CHMuartL2SM::EN_Event eve
             // Response received
         case EN_Event::RX_COMPLETED_RSP:
             m_timer.Stop();
+            m_active_CService->MarkRspStart(frame_->GetStartTime());
             if (IsBURST() == EN_Bool::TRUE8)
             {
                 SetRT1();
@@ -492,7 +512,7 @@ EN_Bool CHMuartL2SM::SetRT1diff()
 
 void CHMuartL2SM::SetRT2()
 {
-    switch (CChannel::GetBaudrate())
+    switch (mo_channel->GetBaudrate())
     {
     case COSAL::CBitRates::CBR_Win::BR_1200:
         m_timer.Start(CUsedTimeOuts::RT2_1200);
@@ -504,10 +524,10 @@ void CHMuartL2SM::SetRT2()
         m_timer.Start(CUsedTimeOuts::RT2_4800);
         break;
     default:
-        m_timer.Start(CUsedTimeOuts::SHORT_RT2 + COSAL::CTimer::GetDelay(6, CChannel::GetBaudrate()));
+        m_timer.Start(CUsedTimeOuts::SHORT_RT2 + COSAL::CTimer::GetDelay(6, mo_channel->GetBaudrate()));
         break;
     }
-    if (CChannel::GetBaudrate() == 1200)
+    if (mo_channel->GetBaudrate() == 1200)
     {
     }
     else
@@ -517,7 +537,7 @@ void CHMuartL2SM::SetRT2()
 
 void CHMuartL2SM::SetHOLD()
 {
-    switch (CChannel::GetBaudrate())
+    switch (mo_channel->GetBaudrate())
     {
     case COSAL::CBitRates::CBR_Win::BR_1200:
         m_timer.Start(CUsedTimeOuts::HOLD_1200);
@@ -536,10 +556,10 @@ void CHMuartL2SM::SetHOLD()
 
 TY_DWord CHMuartL2SM::GetRT1()
 {
-    if (CChannel::IsPrimaryMaster() == EN_Bool::TRUE8)
+    if (mo_channel->IsPrimaryMaster() == EN_Bool::TRUE8)
     {
         // Primary master
-        switch (CChannel::GetBaudrate())
+        switch (mo_channel->GetBaudrate())
         {
         case COSAL::CBitRates::CBR_Win::BR_1200:
             return CUsedTimeOuts::PRIM_RT1_1200;
@@ -551,14 +571,14 @@ TY_DWord CHMuartL2SM::GetRT1()
             return CUsedTimeOuts::PRIM_RT1_4800;
             break;
         default:
-            return CUsedTimeOuts::SHORT_PRIM_RT1 + COSAL::CTimer::GetDelay(5, CChannel::GetBaudrate());
+            return CUsedTimeOuts::SHORT_PRIM_RT1 + COSAL::CTimer::GetDelay(5, mo_channel->GetBaudrate());
             break;
         }
     }
     else
     {
         // Secondary master
-        switch (CChannel::GetBaudrate())
+        switch (mo_channel->GetBaudrate())
         {
         case COSAL::CBitRates::CBR_Win::BR_1200:
             return CUsedTimeOuts::SCND_RT1_1200;
@@ -570,7 +590,7 @@ TY_DWord CHMuartL2SM::GetRT1()
             return CUsedTimeOuts::SCND_RT1_4800;
             break;
         default:
-            return CUsedTimeOuts::SHORT_SCND_RT1 + COSAL::CTimer::GetDelay(11, CChannel::GetBaudrate());
+            return CUsedTimeOuts::SHORT_SCND_RT1 + COSAL::CTimer::GetDelay(11, mo_channel->GetBaudrate());
             break;
         }
     }
@@ -578,7 +598,7 @@ TY_DWord CHMuartL2SM::GetRT1()
 
 TY_DWord CHMuartL2SM::GetRT1prim()
 {
-    switch (CChannel::GetBaudrate())
+    switch (mo_channel->GetBaudrate())
     {
     case COSAL::CBitRates::CBR_Win::BR_1200:
         return CUsedTimeOuts::PRIM_RT1_1200;
@@ -590,7 +610,7 @@ TY_DWord CHMuartL2SM::GetRT1prim()
         return CUsedTimeOuts::PRIM_RT1_4800;
         break;
     default:
-        return CUsedTimeOuts::SHORT_PRIM_RT1 + COSAL::CTimer::GetDelay(5, CChannel::GetBaudrate());
+        return CUsedTimeOuts::SHORT_PRIM_RT1 + COSAL::CTimer::GetDelay(5, mo_channel->GetBaudrate());
         break;
     }
 }
@@ -636,7 +656,7 @@ EN_Bool CHMuartL2SM::CheckForPendingMsg()
     {
         if (m_active_CService == NULL)
         {
-            m_active_CService = CChannel::GetServicePtr(CChannel::GetRequestedService());
+            m_active_CService = mo_channel->GetServicePtr(mo_channel->GetRequestedService());
             if (m_active_CService != NULL)
             {
                 m_active_CService->ClearRetryCount();
@@ -668,6 +688,9 @@ CHMuartL2SM::EN_Status CHMuartL2SM::Enter_ENABLED(CHMuartProtocol::EN_ToDo* to_d
 CHMuartL2SM::EN_Status CHMuartL2SM::StartTransmit_EnterUSING(CHMuartProtocol::EN_ToDo* to_do_)
 {
     m_active_CService->SetSubStatus(CService::EN_SubStat::IDLE);
+    m_active_CService->MarkTxStart();
+    m_burst_sched.ReleaseRequest();
+    m_tx_start_time = COSAL::CTimer::GetTime();
     *to_do_ = CHMuartProtocol::EN_ToDo::START_TRANSMIT;
     m_status_in_USING = EN_StatusInUSING::SENDING;
     return EN_Status::USING;
@@ -691,7 +714,8 @@ void CHMuartL2SM::TRANSMITcnfRetry()
     m_active_CService->SetSubStatus(CService::EN_SubStat::IDLE);
     m_active_CService->SetCompletionCode(EN_SRV_Result::IN_PROGRESS);
     m_active_CService->SetStatus(CService::EN_Status::REQUESTED);
-    m_active_CService = NULL;
+    mo_channel->RetryService(m_active_CService->GetHandle());
+    DropActiveService();
     SetMsgPending(EN_Bool::FALSE8);
 }
 
@@ -700,11 +724,11 @@ void CHMuartL2SM::TRANSMITcnfFail()
     m_active_CService->SetSubStatus(CService::EN_SubStat::IDLE);
     m_active_CService->SetCompletionCode(EN_SRV_Result::NO_DEV_RESP);
     m_active_CService->SetStatus(CService::EN_Status::WAITING);
-    CChannel::FireServiceEvent(CChannel::CServiceEvent::CONFIRMATION,
+    mo_channel->FireServiceEvent(CChannel::CServiceEvent::CONFIRMATION,
         m_active_CService->GetHandle(),
         0
     );
-    m_active_CService = NULL;
+    DropActiveService();
     SetMsgPending(EN_Bool::FALSE8);
 }
 
@@ -714,17 +738,19 @@ void CHMuartL2SM::TRANSMITcnfSuccess(CFrame* frame_)
     m_active_CService->SetCompletionCode(EN_SRV_Result::SUCCESSFUL);
     m_active_CService->SetStatus(CService::EN_Status::WAITING);
     m_active_CService->SetResponse(frame_);
-    CChannel::FireServiceEvent(CChannel::CServiceEvent::CONFIRMATION,
+    m_burst_sched.LearnTransaction(frame_->GetEndTime() - m_tx_start_time);
+    mo_channel->FireServiceEvent(CChannel::CServiceEvent::CONFIRMATION,
         m_active_CService->GetHandle(),
         0
     );
-    m_active_CService = NULL;
+    DropActiveService();
     SetMsgPending(EN_Bool::FALSE8);
 }
 
 void CHMuartL2SM::TRANSMITindBurst(CFrame* frame_)
 {
-    CChannel::BurstIndicate(frame_);
+    m_burst_sched.Learn(frame_);
+    mo_channel->BurstIndicate(frame_);
 }
 
 void CHMuartL2SM::TRANSMITcnfDone()
@@ -732,11 +758,11 @@ void CHMuartL2SM::TRANSMITcnfDone()
     m_active_CService->SetSubStatus(CService::EN_SubStat::IDLE);
     m_active_CService->SetCompletionCode(EN_SRV_Result::OBSOLETE);
     m_active_CService->SetStatus(CService::EN_Status::WAITING);
-    CChannel::FireServiceEvent(CChannel::CServiceEvent::CONFIRMATION,
+    mo_channel->FireServiceEvent(CChannel::CServiceEvent::CONFIRMATION,
         m_active_CService->GetHandle(),
         0
     );
-    m_active_CService = NULL;
+    DropActiveService();
     SetMsgPending(EN_Bool::FALSE8);
 }
 
@@ -780,16 +806,49 @@ CHMuartL2SM::EN_Status CHMuartL2SM::HandleSrvFailed(CHMuartProtocol::EN_ToDo* to
     }
 }
 
+EN_Bool CHMuartL2SM::DeferForBurst()
+{
+    TY_Word  len = 0;
+    TY_DWord wait_time;
+
+    if ((m_active_CService->GetMode() == CService::EN_Mode::SEND_BURST) ||
+        (m_active_CService->GetTxData(&len) == NULL))
+    {
+        return EN_Bool::FALSE8;
+    }
+
+    wait_time = m_burst_sched.DeferRequest(COSAL::CTimer::GetTime(), len, mo_channel->GetBaudrate());
+    if (wait_time == 0)
+    {
+        return EN_Bool::FALSE8;
+    }
+
+    m_timer.Start(wait_time);
+    return EN_Bool::TRUE8;
+}
+
+void CHMuartL2SM::DropActiveService()
+{
+    // The service is confirmed or put back, the next one
+    // may wait for a burst again
+    m_active_CService = NULL;
+    m_burst_sched.ReleaseRequest();
+}
+
 // CRxSM
 
-// Data
-CHMuartL2RxSM::EN_Status CHMuartL2RxSM::Status;
-ST_RcvByte       CHMuartL2RxSM::m_pend_rcv_bytes[MAX_TXRX_SIZE];
-TY_Word          CHMuartL2RxSM::m_num_pend_bytes;
-COSAL::CTimer    CHMuartL2RxSM::m_timer;
-TY_Word          CHMuartL2RxSM::m_next_char_gap;
-TY_DWord         CHMuartL2RxSM::m_last_rcv_event_time;
-TY_Byte          CHMuartL2RxSM::m_expected_rcv_size;
+// Construction
+CHMuartL2RxSM::CHMuartL2RxSM(CChannel* channel_)
+{
+    mo_channel = channel_;
+    Status = EN_Status::IDLE;
+    m_num_pend_bytes = 0;
+    m_timer.InitNoneStatic();
+    m_next_char_gap = 0;
+    m_last_rcv_event_time = 0;
+    m_expected_rcv_size = 14;
+    m_debug = 0;
+}
 
 // = Methods =
 
@@ -806,8 +865,8 @@ void CHMuartL2RxSM::Init()
 
 // Operation
 
-CHMuartProtocol::EN_ToDo CHMuartL2RxSM::EventHandler(CHMuartProtocol::EN_Event event_, CFrame* frame_, ST_RcvByte* rcv_bytes_, TY_Word len_,
-    CFrame* junk_frame_, CFrame* request_frame_, CFrame* response_frame_, CFrame* burst_frame_)
+CHMuartProtocol::EN_ToDo CHMuartL2RxSM::EventHandler(CHMuartProtocol::EN_Event event_, CFrame** frame_, ST_RcvByte* rcv_bytes_, TY_Word len_,
+    CFrame** junk_frame_, CFrame** request_frame_, CFrame** response_frame_, CFrame** burst_frame_)
 {
     ST_RcvByte    au8_LocRcvBytes[MAX_TXRX_SIZE];
     TY_Word               u16_LocLen = 0;
@@ -847,7 +906,7 @@ CHMuartProtocol::EN_ToDo CHMuartL2RxSM::EventHandler(CHMuartProtocol::EN_Event e
         if (len_ > 0)
         {
             // Check for gap detection
-            if ((rcv_bytes_[0].Time - au8_LocRcvBytes[u16_LocLen - 1].Time) > (TY_DWord)(3 * COSAL::CTimer::GetByteTime(CChannel::GetBaudrate())))
+            if ((rcv_bytes_[0].Time - au8_LocRcvBytes[u16_LocLen - 1].Time) > (TY_DWord)(3 * COSAL::CTimer::GetByteTime(mo_channel->GetBaudrate())))
             {
                 // Gap detected, handle pending bytes first
                 u16_RemainingBytes = 1;
@@ -927,38 +986,45 @@ TY_Byte CHMuartL2RxSM::GetBlockSize()
 
 // Helpers
 
-TY_Word CHMuartL2RxSM::HandleData(EN_Bool bGapDetected, CHMuartProtocol::EN_Event event_, CFrame* frame_, ST_RcvByte* rcv_bytes_, TY_Word len_,
-    CFrame* junk_frame_, CFrame* request_frame_, CFrame* response_frame_, CFrame* burst_frame_)
+TY_Word CHMuartL2RxSM::HandleData(EN_Bool bGapDetected, CHMuartProtocol::EN_Event event_, CFrame** work_frame_, ST_RcvByte* rcv_bytes_, TY_Word len_,
+    CFrame** junk_frame_, CFrame** request_frame_, CFrame** response_frame_, CFrame** burst_frame_)
 {
+    CFrame* frame = *work_frame_;
     TY_Word bytes_parsed = 0;
     TY_Byte         au8_Data[MAX_TXRX_SIZE];
     TY_Byte        au8_Error[MAX_TXRX_SIZE];
 
+    if (frame == NULL)
+    {
+        // No frame left in the pool, the data is dropped
+        return 0;
+    }
+
     COSAL::ExtractRcvBytes(au8_Data, rcv_bytes_, len_);
     COSAL::ExtractRcvErrors(au8_Error, rcv_bytes_, len_);
 
     if (bGapDetected == EN_Bool::TRUE8)
     {
-        if (frame_->GetTotalLen(len_) == 1)
+        if (frame->GetTotalLen(len_) == 1)
         {
-            frame_->Init();
+            frame->Init();
             Status = EN_Status::IDLE;
         }
 
         if (len_ == 0)
         {
-            if (frame_->GetRcvByteCount() == 0)
+            if (frame->GetRcvByteCount() == 0)
             {
                 return 0;
             }
         }
     }
 
-    if (frame_->GetRcvByteCount() == 0)
+    if (frame->GetRcvByteCount() == 0)
     {
         if (len_ > 0)
         {
-            frame_->SetStartTime(rcv_bytes_[0].Time - COSAL::CTimer::GetByteTime(CChannel::GetBaudrate()));
+            frame->SetStartTime(rcv_bytes_[0].Time - COSAL::CTimer::GetByteTime(mo_channel->GetBaudrate()));
         }
     }
 
@@ -966,25 +1032,25 @@ TY_Word CHMuartL2RxSM::HandleData(EN_Bool bGapDetected, CHMuartProtocol::EN_Even
     {
         if (len_ > 0)
         {
-            CMonitor::StartReceive(rcv_bytes_[0].Time - COSAL::CTimer::GetByteTime(CChannel::GetBaudrate()));
+            mo_channel->Monitor.StartReceive(rcv_bytes_[0].Time - COSAL::CTimer::GetByteTime(mo_channel->GetBaudrate()));
         }
 
         Status = EN_Status::RECEIVING;
-        frame_->Init();
+        frame->Init();
     }
 
     if (len_ > 0)
     {
-        CMonitor::StoreData(au8_Data, len_);
+        mo_channel->Monitor.StoreData(au8_Data, len_);
     }
 
     // store the end time just for the case
     if (len_ > 0)
     {
-        frame_->SetEndTime(rcv_bytes_[len_ - 1].Time);
+        frame->SetEndTime(rcv_bytes_[len_ - 1].Time);
         m_last_rcv_event_time = rcv_bytes_[len_ - 1].Time;
     }
-    if (frame_->TryParse(&bytes_parsed, au8_Data, au8_Error, len_, bGapDetected) == EN_Bool::TRUE8)
+    if (frame->TryParse(&bytes_parsed, au8_Data, au8_Error, len_, bGapDetected) == EN_Bool::TRUE8)
     {
         // Frame done, sharp gap time out required
         if (bGapDetected == EN_Bool::FALSE8)
@@ -996,47 +1062,43 @@ TY_Word CHMuartL2RxSM::HandleData(EN_Bool bGapDetected, CHMuartProtocol::EN_Even
         // set the end of the frame
         if ((len_ > 0) && (bytes_parsed > 0))
         {
-            frame_->SetEndTime(rcv_bytes_[bytes_parsed - 1].Time);
+            frame->SetEndTime(rcv_bytes_[bytes_parsed - 1].Time);
         }
 
         if (len_ > bytes_parsed)
         {
             TY_Word pending = len_ - bytes_parsed;
-            CMonitor::RemoveData(pending);
+            mo_channel->Monitor.RemoveData(pending);
         }
 
-        switch (frame_->Type)
+        switch (frame->Type)
         {
         case CFrame::EN_Type::JUNK:
-            if (CMonitor::GetDataLen() > 0)
+            if (mo_channel->Monitor.GetDataLen() > 0)
             {
-                CMonitor::EndRcvGapTO(COSAL::CTimer::GetTime() - 1);
+                mo_channel->Monitor.EndRcvGapTO(COSAL::CTimer::GetTime() - 1);
             }
             else
             {
-                CMonitor::AbortReceive();
+                mo_channel->Monitor.AbortReceive();
             }
 
-            *junk_frame_ = *frame_;
-            junk_frame_->SetActive();
+            PassFrame(work_frame_, junk_frame_);
             Status = EN_Status::IDLE;
             break;
         case CFrame::EN_Type::REQUEST:
-            CMonitor::EndRcvValidFrame(COSAL::CTimer::GetTime());
-            *request_frame_ = *frame_;
-            request_frame_->SetActive();
+            mo_channel->Monitor.EndRcvValidFrame(COSAL::CTimer::GetTime());
+            PassFrame(work_frame_, request_frame_);
             Status = EN_Status::IDLE;
             break;
         case CFrame::EN_Type::RESPONSE:
-            CMonitor::EndRcvValidFrame(COSAL::CTimer::GetTime());
-            *response_frame_ = *frame_;
-            response_frame_->SetActive();
+            mo_channel->Monitor.EndRcvValidFrame(COSAL::CTimer::GetTime());
+            PassFrame(work_frame_, response_frame_);
             Status = EN_Status::IDLE;
             break;
         case CFrame::EN_Type::BURST:
-            CMonitor::EndRcvValidFrame(COSAL::CTimer::GetTime());
-            *burst_frame_ = *frame_;
-            burst_frame_->SetActive();
+            mo_channel->Monitor.EndRcvValidFrame(COSAL::CTimer::GetTime());
+            PassFrame(work_frame_, burst_frame_);
             Status = EN_Status::IDLE;
             break;
         }
@@ -1046,19 +1108,19 @@ TY_Word CHMuartL2RxSM::HandleData(EN_Bool bGapDetected, CHMuartProtocol::EN_Even
         if (bGapDetected == EN_Bool::TRUE8)
         {
             m_next_char_gap = 0;
-            if (CMonitor::GetDataLen() > 0)
+            if (mo_channel->Monitor.GetDataLen() > 0)
             {
-                CMonitor::EndRcvGapTO(m_last_rcv_event_time);
+                mo_channel->Monitor.EndRcvGapTO(m_last_rcv_event_time);
             }
             else
             {
-                CMonitor::AbortReceive();
+                mo_channel->Monitor.AbortReceive();
             }
             Status = EN_Status::IDLE;
         }
         else
         {
-            if (((frame_->GetStatus() == CFrame::CFrame::EN_Status::PARSE_PREAMBLE) &&
+            if (((frame->GetStatus() == CFrame::CFrame::EN_Status::PARSE_PREAMBLE) &&
                 (len_ == 1)
                 ) ||
                 (Status == EN_Status::WAIT_SIELENCE)
@@ -1086,6 +1148,21 @@ TY_Word CHMuartL2RxSM::HandleData(EN_Bool bGapDetected, CHMuartProtocol::EN_Even
     return (TY_Word)(len_ - bytes_parsed);
 }
 
+void CHMuartL2RxSM::PassFrame(CFrame** work_frame_, CFrame** slot_)
+{
+    // The parsed frame is passed on by its pointer and the
+    // parser continues with a fresh frame of the pool
+    if (*slot_ != NULL)
+    {
+        // Replaced before it was handled
+        mo_channel->Frames.Release(*slot_);
+    }
+
+    *slot_ = *work_frame_;
+    (*slot_)->SetActive();
+    *work_frame_ = mo_channel->Frames.Acquire();
+}
+
 void CHMuartL2RxSM::SavePendingBytes(ST_RcvByte* rcv_bytes_, TY_Word len_)
 {
     m_num_pend_bytes = len_;
@@ -1114,7 +1191,7 @@ void CHMuartL2RxSM::SetGapTimer(TY_Word u16_NumCharacters)
 {
     if (u16_NumCharacters > 0)
     {
-        TY_DWord u32_Gap = (TY_DWord)((u16_NumCharacters + 1) * COSAL::CTimer::GetByteTime(CChannel::GetBaudrate()));
+        TY_DWord u32_Gap = (TY_DWord)((u16_NumCharacters + 1) * COSAL::CTimer::GetByteTime(mo_channel->GetBaudrate()));
 
         if (u32_Gap < 50)
         {
@@ -1125,7 +1202,7 @@ void CHMuartL2RxSM::SetGapTimer(TY_Word u16_NumCharacters)
     }
     else
     {
-        TY_DWord u32_Gap = (TY_DWord)(3 * COSAL::CTimer::GetByteTime(CChannel::GetBaudrate()));
+        TY_DWord u32_Gap = (TY_DWord)(3 * COSAL::CTimer::GetByteTime(mo_channel->GetBaudrate()));
 
         m_timer.Start(u32_Gap);
     }
@@ -1133,10 +1210,14 @@ void CHMuartL2RxSM::SetGapTimer(TY_Word u16_NumCharacters)
 
 // CTxSM
 
-// Data
-CHMuartL2TxSM::EN_Status CHMuartL2TxSM::Status = EN_Status::IDLE;
-TY_Word                  CHMuartL2TxSM::m_len = 0;
-COSAL::CTimer            CHMuartL2TxSM::m_timer;
+// Construction
+CHMuartL2TxSM::CHMuartL2TxSM(CChannel* channel_)
+{
+    mo_channel = channel_;
+    Status = EN_Status::IDLE;
+    m_len = 0;
+    m_timer.InitNoneStatic();
+}
 
 // Methods 
 
@@ -1155,7 +1236,7 @@ CHMuartProtocol::EN_ToDo CHMuartL2TxSM::EventHandler()
     switch (Status)
     {
     case EN_Status::START_TX:
-        m_timer.Start(COSAL::CTimer::GetTxDuration(m_len, CChannel::GetBaudrate()));
+        m_timer.Start(COSAL::CTimer::GetTxDuration(m_len, mo_channel->GetBaudrate()));
         Status = EN_Status::WAIT_TX_END;
         return CHMuartProtocol::EN_ToDo::SEND_REQUEST;
         break;
@@ -1185,3 +1266,8 @@ void CHMuartL2TxSM::SetTxLen(TY_Word len_)
     m_len = len_;
 }
 
+void CHMuartL2TxSM::ExpireTimer()
+{
+    m_timer.Expire();
+}
+
@@ -25,6 +25,9 @@
 #include "HartFrame.h"
 #include "HartService.h"
 #include "HMuartProtocol.h"
+#include "HMuartBurstSched.h"
+
+class CChannel;
 
 class CHMuartL2SM
 {
@@ -71,46 +74,52 @@ public:
         RECEIVING = 2
     };
 
+    // Construction
+    CHMuartL2SM(CChannel* channel_);
     // Initialization
-    static void                          Init();
+    void                          Init();
     // Operation
-    static CHMuartProtocol::EN_ToDo  EventHandler(EN_Event event_, CFrame* frame_);
-    static TY_Byte*                 GetTxData(TY_Word* pu16_Len);
-    static void        SetActiveServiceFailed();
-    static void                        Enable();
-    static void                       Disable();
+    CHMuartProtocol::EN_ToDo  EventHandler(EN_Event event_, CFrame* frame_);
+    TY_Byte*                 GetTxData(TY_Word* pu16_Len);
+    void        SetActiveServiceFailed();
+    void                        Enable();
+    void                       Disable();
+    // The running time out is over at once (simulated bus)
+    void                   ExpireTimer();
     // State handling
-    static EN_Status        HandleStatus_IDLE(EN_Event event_, CFrame* frame_, CHMuartProtocol::EN_ToDo* to_do_);
-    static EN_Status    HandleStatus_WATCHING(EN_Event event_, CFrame* frame_, CHMuartProtocol::EN_ToDo* to_do_);
-    static EN_Status     HandleStatus_ENABLED(EN_Event event_, CFrame* frame_, CHMuartProtocol::EN_ToDo* to_do_);
-    static EN_Status       HandleStatus_USING(EN_Event event_, CFrame* frame_, CHMuartProtocol::EN_ToDo* to_do_);
+    EN_Status        HandleStatus_IDLE(EN_Event event_, CFrame* frame_, CHMuartProtocol::EN_ToDo* to_do_);
+    EN_Status    HandleStatus_WATCHING(EN_Event event_, CFrame* frame_, CHMuartProtocol::EN_ToDo* to_do_);
+    EN_Status     HandleStatus_ENABLED(EN_Event event_, CFrame* frame_, CHMuartProtocol::EN_ToDo* to_do_);
+    EN_Status       HandleStatus_USING(EN_Event event_, CFrame* frame_, CHMuartProtocol::EN_ToDo* to_do_);
     // Helpers
-    static void                        SetRT1();
-    static EN_Bool                 SetRT1diff();
-    static void                     SetTwoRT1();
-    static void                    SetRT1prim();
-    static void                 SetTwoRT1prim();
-    static void                        SetRT2();
-    static void                       SetHOLD();
-    static TY_DWord                    GetRT1();
-    static TY_DWord                GetRT1prim();
-    static EN_Bool                    IsBURST();
-    static void                      SetBURST(EN_Bool value);
-    static void                 SetMsgPending(EN_Bool value);
-    static EN_Bool               IsMsgPending();
-    static void                   UpdateBurst(CFrame* frame_);
-    static EN_Bool         CheckForPendingMsg();
-    static EN_Status           Enter_WATCHING(CHMuartProtocol::EN_ToDo* to_do_);
-    static EN_Status            Enter_ENABLED(CHMuartProtocol::EN_ToDo* to_do_);
-    static EN_Status               StartTransmit_EnterUSING(CHMuartProtocol::EN_ToDo* to_do_);
-    static EN_Status            XmtMsg_ENABLE(CHMuartProtocol::EN_ToDo* to_do_);
-    static EN_Status             XmtMsg_WATCH(CHMuartProtocol::EN_ToDo* to_do_);
-    static void               TRANSMITcnfFail();
-    static void              TRANSMITcnfRetry();
-    static void            TRANSMITcnfSuccess(CFrame* frame_);
-    static void              TRANSMITindBurst(CFrame* frame_);
-    static void               TRANSMITcnfDone();
-    static EN_Status          HandleSrvFailed(CHMuartProtocol::EN_ToDo* to_do_);
+    void                        SetRT1();
+    EN_Bool                 SetRT1diff();
+    void                     SetTwoRT1();
+    void                    SetRT1prim();
+    void                 SetTwoRT1prim();
+    void                        SetRT2();
+    void                       SetHOLD();
+    TY_DWord                    GetRT1();
+    TY_DWord                GetRT1prim();
+    EN_Bool                    IsBURST();
+    void                      SetBURST(EN_Bool value);
+    void                 SetMsgPending(EN_Bool value);
+    EN_Bool               IsMsgPending();
+    void                   UpdateBurst(CFrame* frame_);
+    EN_Bool         CheckForPendingMsg();
+    EN_Status           Enter_WATCHING(CHMuartProtocol::EN_ToDo* to_do_);
+    EN_Status            Enter_ENABLED(CHMuartProtocol::EN_ToDo* to_do_);
+    EN_Status               StartTransmit_EnterUSING(CHMuartProtocol::EN_ToDo* to_do_);
+    EN_Status            XmtMsg_ENABLE(CHMuartProtocol::EN_ToDo* to_do_);
+    EN_Status             XmtMsg_WATCH(CHMuartProtocol::EN_ToDo* to_do_);
+    void               TRANSMITcnfFail();
+    void              TRANSMITcnfRetry();
+    void            TRANSMITcnfSuccess(CFrame* frame_);
+    void              TRANSMITindBurst(CFrame* frame_);
+    void               TRANSMITcnfDone();
+    EN_Status          HandleSrvFailed(CHMuartProtocol::EN_ToDo* to_do_);
+    EN_Bool           DeferForBurst();
+    void          DropActiveService();
 
     /* Nested classes */
     class CUsedTimeOuts
@@ -144,15 +153,18 @@ public:
         static const TY_DWord          SHORT_HOLD = 3;
     };
 private:
-    static EN_Status           Status;
-    static EN_StatusInWATCHING m_status_in_WATCHING;
-    static EN_StatusInIDLE     m_status_in_IDLE;
-    static EN_StatusInUSING    m_status_in_USING;
-    static EN_Bool             m_hart_enabled;
-    static EN_Bool             m_burst_mode;
-    static EN_Bool             m_msg_pending;
-    static CService*           m_active_CService;
-    static COSAL::CTimer       m_timer;
+    CChannel*           mo_channel;
+    EN_Status           Status;
+    EN_StatusInWATCHING m_status_in_WATCHING;
+    EN_StatusInIDLE     m_status_in_IDLE;
+    EN_StatusInUSING    m_status_in_USING;
+    EN_Bool             m_hart_enabled;
+    EN_Bool             m_burst_mode;
+    EN_Bool             m_msg_pending;
+    CService*           m_active_CService;
+    COSAL::CTimer       m_timer;
+    CHMuartBurstSched   m_burst_sched;
+    TY_DWord            m_tx_start_time;
 };
 
 class CHMuartL2RxSM
@@ -166,30 +178,34 @@ public:
         WAIT_SIELENCE = 2
     };
 
+    // Construction
+    CHMuartL2RxSM(CChannel* channel_);
     // Initialization
-    static void                 Init();
+    void                 Init();
      // Operation
-    static CHMuartProtocol::EN_ToDo      EventHandler(CHMuartProtocol::EN_Event event_, CFrame* frame_, ST_RcvByte* rcv_bytes_, TY_Word len_,
-                                                  CFrame* junk_, CFrame* request_, CFrame* response_, CFrame* burst_);
-    static void                Reset();
-    static TY_Byte      GetBlockSize();
+    CHMuartProtocol::EN_ToDo      EventHandler(CHMuartProtocol::EN_Event event_, CFrame** frame_, ST_RcvByte* rcv_bytes_, TY_Word len_,
+                                                  CFrame** junk_, CFrame** request_, CFrame** response_, CFrame** burst_);
+    void                Reset();
+    TY_Byte      GetBlockSize();
 
 private:
-    static EN_Status       Status;
-    static ST_RcvByte      m_pend_rcv_bytes[MAX_TXRX_SIZE];
-    static TY_Word         m_num_pend_bytes;
-    static COSAL::CTimer   m_timer;
-    static TY_Word         m_next_char_gap;
-    static TY_DWord        m_last_rcv_event_time;
-    static TY_Byte         m_expected_rcv_size;
-    static TY_DWord        m_debug;
+    CChannel*       mo_channel;
+    EN_Status       Status;
+    ST_RcvByte      m_pend_rcv_bytes[MAX_TXRX_SIZE];
+    TY_Word         m_num_pend_bytes;
+    COSAL::CTimer   m_timer;
+    TY_Word         m_next_char_gap;
+    TY_DWord        m_last_rcv_event_time;
+    TY_Byte         m_expected_rcv_size;
+    TY_DWord        m_debug;
 
     // Helpers
-    static TY_Word        HandleData(EN_Bool bGapDetected, CHMuartProtocol::EN_Event event_, CFrame* frame_, ST_RcvByte* pst_RcvBytes, TY_Word u16_Len,
-                                     CFrame* junk_, CFrame* request_, CFrame* response_, CFrame* burst_);
-    static void     SavePendingBytes(ST_RcvByte* rcv_bytes_, TY_Word len_);
-    static TY_Word   GetPendingBytes(ST_RcvByte* rcv_bytes_);
-    static void          SetGapTimer(TY_Word num_characters_);
+    TY_Word        HandleData(EN_Bool bGapDetected, CHMuartProtocol::EN_Event event_, CFrame** work_frame_, ST_RcvByte* pst_RcvBytes, TY_Word u16_Len,
+                                     CFrame** junk_, CFrame** request_, CFrame** response_, CFrame** burst_);
+    void             PassFrame(CFrame** work_frame_, CFrame** slot_);
+    void     SavePendingBytes(ST_RcvByte* rcv_bytes_, TY_Word len_);
+    TY_Word   GetPendingBytes(ST_RcvByte* rcv_bytes_);
+    void          SetGapTimer(TY_Word num_characters_);
 };
 
 class CHMuartL2TxSM
@@ -203,18 +219,23 @@ public:
         WAIT_TX_END = 2
     };
 
+    // Construction
+    CHMuartL2TxSM(CChannel* channel_);
     // Initialization
-    static void                         Init();
+    void                         Init();
     /* Operation */
-    static CHMuartProtocol::EN_ToDo EventHandler();
-    static EN_Status               GetStatus();
-    static void                    SetStatus(EN_Status status_);
-    static void                     SetTxLen(TY_Word len_);
+    CHMuartProtocol::EN_ToDo EventHandler();
+    EN_Status               GetStatus();
+    void                    SetStatus(EN_Status status_);
+    void                     SetTxLen(TY_Word len_);
+    // The transmission is over at once (simulated bus)
+    void                 ExpireTimer();
 
 private:
-    static EN_Status     Status;
-    static TY_Word       m_len;
-    static COSAL::CTimer m_timer;
+    CChannel*     mo_channel;
+    EN_Status     Status;
+    TY_Word       m_len;
+    COSAL::CTimer m_timer;
 };
 
 #endif // __hmuartlayer2_h__
\ No newline at end of file
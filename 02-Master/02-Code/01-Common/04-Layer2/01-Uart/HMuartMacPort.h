@@ -24,6 +24,8 @@
 #include "OSAL.h"
 #include "WbHartUser.h"
 
+class CChannel;
+
 class CHMuartMacPort
 {
 public:
@@ -45,15 +47,23 @@ public:
         RECEIVE_DISABLE = 5
     };
 
-    static EN_Bool   Open(TY_Word port_, TY_DWord baudrate_, EN_CommType type_);
-    static void     Close();
-    static void   Execute(TY_Word time_ms_);
-    static void      Init();
+             CHMuartMacPort(CChannel* channel_);
+            ~CHMuartMacPort();
+    EN_Bool   Open(TY_Word port_, TY_DWord baudrate_, EN_CommType type_);
+    void     Close();
+    void   Execute(TY_Word time_ms_);
+    void      Init();
+    // Let the kernel serve this port right away
+    void    WakeUp();
 
 private:
-    static ST_RcvByte m_loc_rcv_buf[MAX_TXRX_SIZE];
+    CChannel*  mo_channel;
+    // Handles of the platform (kernel and port)
+    PTR_Handle mo_kernel;
+    PTR_Handle mo_port;
+    ST_RcvByte m_loc_rcv_buf[MAX_TXRX_SIZE];
 
 public:
-    static EN_Status  Status;
+    EN_Status  Status;
 };
 #endif // __hmuartmacport_h__
\ No newline at end of file
@@ -19,18 +19,39 @@
 #include "HMuartMacPort.h"
 #include "HMuartLayer2.h"
 #include "Monitor.h"
+#include "HartChannel.h"
 
 /* CHMUartProtocol */
-CHMuartProtocol::EN_Status CHMuartProtocol::Status;
-CFrame    CHMuartProtocol::m_work_frame;
-CFrame    CHMuartProtocol::m_junk_frame;
-CFrame    CHMuartProtocol::m_request_frame;
-CFrame    CHMuartProtocol::m_response_frame;
-CFrame    CHMuartProtocol::m_burst_frame;
-TY_Byte*  CHMuartProtocol::mpu8_TxData;
-TY_Len    CHMuartProtocol::mu16_TxLen;
 
 // Methods
+CHMuartProtocol::CHMuartProtocol(CChannel* channel_)
+{
+    mo_channel = channel_;
+    Status = EN_Status::IDLE;
+    mpu8_TxData = NULL;
+    mu16_TxLen = 0;
+    mp_work_frame = NULL;
+    mp_junk_frame = NULL;
+    mp_request_frame = NULL;
+    mp_response_frame = NULL;
+    mp_burst_frame = NULL;
+}
+
+void CHMuartProtocol::ReleaseFrames()
+{
+    // Note: Called while the channel is closed
+    mo_channel->Frames.Release(mp_work_frame);
+    mo_channel->Frames.Release(mp_junk_frame);
+    mo_channel->Frames.Release(mp_request_frame);
+    mo_channel->Frames.Release(mp_response_frame);
+    mo_channel->Frames.Release(mp_burst_frame);
+    mp_work_frame = NULL;
+    mp_junk_frame = NULL;
+    mp_request_frame = NULL;
+    mp_response_frame = NULL;
+    mp_burst_frame = NULL;
+}
+
 CHMuartMacPort::EN_ToDo CHMuartProtocol::EventHandler(EN_Event event_, ST_RcvByte* rx_bytes_, TY_Word len_)
 {
     TY_DWord time = COSAL::CTimer::GetTime();
@@ -46,58 +67,71 @@ CHMuartMacPort::EN_ToDo CHMuartProtocol::EventHandler(EN_Event event_, ST_RcvByt
     switch (Status)
     {
     case EN_Status::IDLE:
-        to_do = CHMuartL2SM::EventHandler(CHMuartL2SM::EN_Event::NONE, NULL);
+        to_do = mo_channel->UartL2SM.EventHandler(CHMuartL2SM::EN_Event::NONE, NULL);
         break;
     case EN_Status::RECEIVING:
+        if (mp_work_frame == NULL)
+        {
+            mp_work_frame = mo_channel->Frames.Acquire();
+        }
+
         if (event_ == EN_Event::NEW_RCV_DATA)
         {
-            to_do = CHMuartL2RxSM::EventHandler(event_, &m_work_frame, rx_bytes_, len_, &m_junk_frame, &m_request_frame, &m_response_frame, &m_burst_frame);
-            if (m_work_frame.NumPreambles > 1)
+            // Note: The receiver passes on a completed
+            // frame and continues with a fresh one
+            CFrame* frame = mp_work_frame;
+
+            to_do = mo_channel->UartL2RxSM.EventHandler(event_, &mp_work_frame, rx_bytes_, len_, &mp_junk_frame, &mp_request_frame, &mp_response_frame, &mp_burst_frame);
+            if ((frame != NULL) && (frame->NumPreambles > 1))
             {
-                to_do = CHMuartL2SM::EventHandler(CHMuartL2SM::EN_Event::RX_DATA_DETECTED, &m_work_frame);
+                to_do = mo_channel->UartL2SM.EventHandler(CHMuartL2SM::EN_Event::RX_DATA_DETECTED, frame);
             }
         }
         else
         {
-            to_do = CHMuartL2RxSM::EventHandler(event_, &m_work_frame, NULL, 0, &m_junk_frame, &m_request_frame, &m_response_frame, &m_burst_frame);
+            to_do = mo_channel->UartL2RxSM.EventHandler(event_, &mp_work_frame, NULL, 0, &mp_junk_frame, &mp_request_frame, &mp_response_frame, &mp_burst_frame);
         }
 
-        if (m_request_frame.IsActive() == EN_Bool::TRUE8)
+        if (mp_request_frame != NULL)
         {
-            to_do = CHMuartL2SM::EventHandler(CHMuartL2SM::EN_Event::RX_COMPLETED_REQ, &m_request_frame);
-            m_request_frame.Uninit();
+            to_do = mo_channel->UartL2SM.EventHandler(CHMuartL2SM::EN_Event::RX_COMPLETED_REQ, mp_request_frame);
+            mo_channel->Frames.Release(mp_request_frame);
+            mp_request_frame = NULL;
         }
 
-        if (m_response_frame.IsActive() == EN_Bool::TRUE8)
+        if (mp_response_frame != NULL)
         {
-            to_do = CHMuartL2SM::EventHandler(CHMuartL2SM::EN_Event::RX_COMPLETED_RSP, &m_response_frame);
-            m_response_frame.Uninit();
+            to_do = mo_channel->UartL2SM.EventHandler(CHMuartL2SM::EN_Event::RX_COMPLETED_RSP, mp_response_frame);
+            mo_channel->Frames.Release(mp_response_frame);
+            mp_response_frame = NULL;
         }
 
-        if (m_burst_frame.IsActive() == EN_Bool::TRUE8)
+        if (mp_burst_frame != NULL)
         {
-            to_do = CHMuartL2SM::EventHandler(CHMuartL2SM::EN_Event::RX_COMPLETED_BST, &m_burst_frame);
-            m_burst_frame.Uninit();
+            to_do = mo_channel->UartL2SM.EventHandler(CHMuartL2SM::EN_Event::RX_COMPLETED_BST, mp_burst_frame);
+            mo_channel->Frames.Release(mp_burst_frame);
+            mp_burst_frame = NULL;
         }
 
-        if (m_junk_frame.IsActive() == EN_Bool::TRUE8)
+        if (mp_junk_frame != NULL)
         {
-            to_do = CHMuartL2SM::EventHandler(CHMuartL2SM::EN_Event::RX_COMPLETED_ERR, &m_junk_frame);
-            m_junk_frame.Uninit();
+            to_do = mo_channel->UartL2SM.EventHandler(CHMuartL2SM::EN_Event::RX_COMPLETED_ERR, mp_junk_frame);
+            mo_channel->Frames.Release(mp_junk_frame);
+            mp_junk_frame = NULL;
         }
 
         if (to_do == EN_ToDo::START_TRANSMIT)
         {
-            CHMuartL2RxSM::Reset();
+            mo_channel->UartL2RxSM.Reset();
         }
         else
         {
-            to_do = CHMuartL2SM::EventHandler(CHMuartL2SM::EN_Event::NONE, NULL);
+            to_do = mo_channel->UartL2SM.EventHandler(CHMuartL2SM::EN_Event::NONE, NULL);
         }
         break;
 
     case EN_Status::TRANSMITTING:
-        to_do = CHMuartL2TxSM::EventHandler();
+        to_do = mo_channel->UartL2TxSM.EventHandler();
         break;
     }
 
@@ -125,17 +159,17 @@ CHMuartMacPort::EN_ToDo CHMuartProtocol::EventHandler(EN_Event event_, ST_RcvByt
             break;
         case EN_ToDo::START_TRANSMIT:
             to_do = EN_ToDo::NOTHING;
-            mpu8_TxData = CHMuartL2SM::GetTxData(&mu16_TxLen);
+            mpu8_TxData = mo_channel->UartL2SM.GetTxData(&mu16_TxLen);
             if ((mpu8_TxData != 0) && (mu16_TxLen > 0))
             {
-                CHMuartL2TxSM::SetTxLen(mu16_TxLen);
-                CHMuartL2TxSM::SetStatus(CHMuartL2TxSM::EN_Status::START_TX);
+                mo_channel->UartL2TxSM.SetTxLen(mu16_TxLen);
+                mo_channel->UartL2TxSM.SetStatus(CHMuartL2TxSM::EN_Status::START_TX);
                 Status = EN_Status::TRANSMITTING;
                 parent_to_do = CHMuartMacPort::EN_ToDo::CARRIER_ON;
             }
             else
             {
-                CHMuartL2SM::SetActiveServiceFailed();
+                mo_channel->UartL2SM.SetActiveServiceFailed();
                 Status = EN_Status::RECEIVING;
                 parent_to_do = CHMuartMacPort::EN_ToDo::CARRIER_OFF;
                 to_do = EN_ToDo::NOTHING;
@@ -146,13 +180,13 @@ CHMuartMacPort::EN_ToDo CHMuartProtocol::EventHandler(EN_Event event_, ST_RcvByt
             parent_to_do = CHMuartMacPort::EN_ToDo::SEND_REQUEST;
             if (mu16_TxLen > 0)
             {
-                CMonitor::StartTransmit(COSAL::CTimer::GetTime() + 1);
-                CMonitor::StoreData(mpu8_TxData, mu16_TxLen);
+                mo_channel->Monitor.StartTransmit(COSAL::CTimer::GetTime() + 1);
+                mo_channel->Monitor.StoreData(mpu8_TxData, mu16_TxLen);
             }
             break;
         case EN_ToDo::END_TRANSMIT:
-            CMonitor::EndTransmit(COSAL::CTimer::GetTime() - 1);
-            to_do = CHMuartL2SM::EventHandler(CHMuartL2SM::EN_Event::TX_DONE, NULL);
+            mo_channel->Monitor.EndTransmit(COSAL::CTimer::GetTime() - 1);
+            to_do = mo_channel->UartL2SM.EventHandler(CHMuartL2SM::EN_Event::TX_DONE, NULL);
             if (to_do == EN_ToDo::RECEIVE_ENABLE)
             {
                 parent_to_do = CHMuartMacPort::EN_ToDo::RECEIVE_ENABLE;
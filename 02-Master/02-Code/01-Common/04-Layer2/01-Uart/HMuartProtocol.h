@@ -24,6 +24,8 @@
 #include "HartFrame.h"
 #include "HMuartMacPort.h"
 
+class CChannel;
+
 class CHMuartProtocol
 {
 public:
@@ -50,16 +52,20 @@ public:
         END_TRANSMIT = 6
     };
 
-    static CHMuartMacPort::EN_ToDo EventHandler(CHMuartProtocol::EN_Event event_, ST_RcvByte* rx_bytes_, TY_Word len_);
+    CHMuartProtocol(CChannel* channel_);
+    void ReleaseFrames();
+    CHMuartMacPort::EN_ToDo EventHandler(CHMuartProtocol::EN_Event event_, ST_RcvByte* rx_bytes_, TY_Word len_);
 
 private:
-    static EN_Status Status;
-    static CFrame    m_work_frame;
-    static CFrame    m_junk_frame;
-    static CFrame    m_request_frame;
-    static CFrame    m_response_frame;
-    static CFrame    m_burst_frame;
-    static TY_Byte*  mpu8_TxData;
-    static TY_Len    mu16_TxLen;
+    CChannel* mo_channel;
+    EN_Status Status;
+    // Taken from the frame pool of the channel
+    CFrame*   mp_work_frame;
+    CFrame*   mp_junk_frame;
+    CFrame*   mp_request_frame;
+    CFrame*   mp_response_frame;
+    CFrame*   mp_burst_frame;
+    TY_Byte*  mpu8_TxData;
+    TY_Len    mu16_TxLen;
 };
 #endif // __hmuartprotocol_h__
\ No newline at end of file
@@ -26,16 +26,20 @@
 
 // CHartIpSM
 
-// Data 
-CHMipL2SM::EN_Status           CHMipL2SM::Status = EN_Status::IDLE;
-CHMipL2SM::EN_StatusInWATCHING CHMipL2SM::m_status_in_WATCHING = EN_StatusInWATCHING::IDLE;
-CHMipL2SM::EN_StatusInIDLE     CHMipL2SM::m_status_in_IDLE = EN_StatusInIDLE::IDLE;
-CHMipL2SM::EN_StatusInUSING    CHMipL2SM::m_status_in_USING = EN_StatusInUSING::NOT_SET;
-EN_Bool                        CHMipL2SM::m_hart_enabled = EN_Bool::FALSE8;
-EN_Bool                        CHMipL2SM::m_burst_mode = EN_Bool::FALSE8;
-EN_Bool                        CHMipL2SM::m_msg_pending = EN_Bool::FALSE8;
-CService*                      CHMipL2SM::m_active_CService;
-COSAL::CTimer                  CHMipL2SM::m_timer;
+// Construction
+CHMipL2SM::CHMipL2SM(CChannel* channel_)
+{
+    mo_channel = channel_;
+    Status = EN_Status::IDLE;
+    m_status_in_WATCHING = EN_StatusInWATCHING::IDLE;
+    m_status_in_IDLE = EN_StatusInIDLE::IDLE;
+    m_status_in_USING = EN_StatusInUSING::NOT_SET;
+    m_hart_enabled = EN_Bool::FALSE8;
+    m_burst_mode = EN_Bool::FALSE8;
+    m_msg_pending = EN_Bool::FALSE8;
+    m_active_CService = NULL;
+    m_timer.InitNoneStatic();
+}
 
 // = Methods =
  
@@ -50,9 +54,11 @@ void CHMipL2SM::Init()
     m_hart_enabled = EN_Bool::FALSE8;
     m_burst_mode = EN_Bool::FALSE8;
     m_msg_pending = EN_Bool::FALSE8;
+    // Services of the last open were dropped with the pool
+    m_active_CService = NULL;
     m_timer.InitNoneStatic();
-    CHMipL2RxSM::Init();
-    CHMipL2TxSM::Init();
+    mo_channel->IpL2RxSM.Init();
+    mo_channel->IpL2TxSM.Init();
 }
 
 // Operation
@@ -108,7 +114,7 @@ void CHMipL2SM::SetActiveServiceFailed()
     {
         m_active_CService->SetCompletionCode(EN_SRV_Result::RESOURCE_ERROR);
         m_active_CService->SetStatus(CService::EN_Status::WAITING);
-        CChannel::FireServiceEvent(CChannel::CServiceEvent::CONFIRMATION,
+        mo_channel->FireServiceEvent(CChannel::CServiceEvent::CONFIRMATION,
             m_active_CService->GetHandle(),
             0
         );
@@ -133,7 +139,7 @@ CHMipL2SM::EN_Status CHMipL2SM::HandleStatus_IDLE(EN_Event event_, CFrame* frame
     switch (m_status_in_IDLE)
     {
     case EN_StatusInIDLE::IDLE:
-        if (CChannel::GetHartEnabled() == EN_Bool::TRUE8)
+        if (mo_channel->GetHartEnabled() == EN_Bool::TRUE8)
         {
             SetRT1();
             return Enter_WATCHING(to_do_);
@@ -147,7 +153,7 @@ CHMipL2SM::EN_Status CHMipL2SM::HandleStatus_IDLE(EN_Event event_, CFrame* frame
                 m_active_CService->SetSubStatus(CService::EN_SubStat::IDLE);
                 m_active_CService->SetCompletionCode(EN_SRV_Result::NO_DEV_RESP);
                 m_active_CService->SetStatus(CService::EN_Status::WAITING);
-                CChannel::FireServiceEvent(CChannel::CServiceEvent::CONFIRMATION,
+                mo_channel->FireServiceEvent(CChannel::CServiceEvent::CONFIRMATION,
                     m_active_CService->GetHandle(),
                     0
                 );
@@ -261,7 +267,7 @@ CHMipL2SM::EN_Status CHMipL2SM::HandleStatus_WATCHING(EN_Event event_, CFrame* f
                 if (IsMsgPending() == EN_Bool::TRUE8)
                 {
                     m_timer.Stop();
-                    CHMipL2RxSM::Reset();
+                    mo_channel->IpL2RxSM.Reset();
                     return StartTransmit_EnterUSING(to_do_);
                 }
                 else
@@ -348,6 +354,7 @@ CHMipL2SM::EN_Status CHMipL2SM::HandleStatus_USING(CHMipL2SM::EN_Event event_, C
     case EN_StatusInUSING::SENDING:
         if (event_ == EN_Event::TX_DONE)
         {
+            m_active_CService->MarkTxEnd();
             if (m_active_CService->GetMode() == CService::EN_Mode::SEND_BURST)
             {
                 TRANSMITcnfDone();
@@ -399,6 +406,7 @@ CHMipL2SM::EN_Status CHMipL2SM::HandleStatus_USING(CHMipL2SM::EN_Event event_, C
             // Response received
         case EN_Event::RX_COMPLETED_RSP:
             m_timer.Stop();
+            m_active_CService->MarkRspStart(frame_->GetStartTime());
             if (IsBURST() == EN_Bool::TRUE8)
             {
                 SetRT1();
@@ -504,7 +512,7 @@ EN_Bool CHMipL2SM::SetRT1diff()
 
 void CHMipL2SM::SetRT2()
 {
-    switch (CChannel::GetBaudrate())
+    switch (mo_channel->GetBaudrate())
     {
     case COSAL::CBitRates::CBR_Win::BR_1200:
         m_timer.Start(CUsedTimeOuts::RT2_1200);
@@ -516,10 +524,10 @@ void CHMipL2SM::SetRT2()
         m_timer.Start(CUsedTimeOuts::RT2_4800);
         break;
     default:
-        m_timer.Start(CUsedTimeOuts::SHORT_RT2 + COSAL::CTimer::GetDelay(6, CChannel::GetBaudrate()));
+        m_timer.Start(CUsedTimeOuts::SHORT_RT2 + COSAL::CTimer::GetDelay(6, mo_channel->GetBaudrate()));
         break;
     }
-    if (CChannel::GetBaudrate() == 1200)
+    if (mo_channel->GetBaudrate() == 1200)
     {
     }
     else
@@ -529,7 +537,7 @@ void CHMipL2SM::SetRT2()
 
 void CHMipL2SM::SetHOLD()
 {
-    switch (CChannel::GetBaudrate())
+    switch (mo_channel->GetBaudrate())
     {
     case COSAL::CBitRates::CBR_Win::BR_1200:
         m_timer.Start(CUsedTimeOuts::HOLD_1200);
@@ -548,10 +556,10 @@ void CHMipL2SM::SetHOLD()
 
 TY_DWord CHMipL2SM::GetRT1()
 {
-    if (CChannel::IsPrimaryMaster() == EN_Bool::TRUE8)
+    if (mo_channel->IsPrimaryMaster() == EN_Bool::TRUE8)
     {
         // Primary master
-        switch (CChannel::GetBaudrate())
+        switch (mo_channel->GetBaudrate())
         {
         case COSAL::CBitRates::CBR_Win::BR_1200:
             return CUsedTimeOuts::PRIM_RT1_1200;
@@ -563,14 +571,14 @@ TY_DWord CHMipL2SM::GetRT1()
             return CUsedTimeOuts::PRIM_RT1_4800;
             break;
         default:
-            return CUsedTimeOuts::SHORT_PRIM_RT1 + COSAL::CTimer::GetDelay(5, CChannel::GetBaudrate());
+            return CUsedTimeOuts::SHORT_PRIM_RT1 + COSAL::CTimer::GetDelay(5, mo_channel->GetBaudrate());
             break;
         }
     }
     else
     {
         // Secondary master
-        switch (CChannel::GetBaudrate())
+        switch (mo_channel->GetBaudrate())
         {
         case COSAL::CBitRates::CBR_Win::BR_1200:
             return CUsedTimeOuts::SCND_RT1_1200;
@@ -582,7 +590,7 @@ TY_DWord CHMipL2SM::GetRT1()
             return CUsedTimeOuts::SCND_RT1_4800;
             break;
         default:
-            return CUsedTimeOuts::SHORT_SCND_RT1 + COSAL::CTimer::GetDelay(11, CChannel::GetBaudrate());
+            return CUsedTimeOuts::SHORT_SCND_RT1 + COSAL::CTimer::GetDelay(11, mo_channel->GetBaudrate());
             break;
         }
     }
@@ -590,7 +598,7 @@ TY_DWord CHMipL2SM::GetRT1()
 
 TY_DWord CHMipL2SM::GetRT1prim()
 {
-    switch (CChannel::GetBaudrate())
+    switch (mo_channel->GetBaudrate())
     {
     case COSAL::CBitRates::CBR_Win::BR_1200:
         return CUsedTimeOuts::PRIM_RT1_1200;
@@ -602,7 +610,7 @@ TY_DWord CHMipL2SM::GetRT1prim()
         return CUsedTimeOuts::PRIM_RT1_4800;
         break;
     default:
-        return CUsedTimeOuts::SHORT_PRIM_RT1 + COSAL::CTimer::GetDelay(5, CChannel::GetBaudrate());
+        return CUsedTimeOuts::SHORT_PRIM_RT1 + COSAL::CTimer::GetDelay(5, mo_channel->GetBaudrate());
         break;
     }
 }
@@ -648,7 +656,7 @@ EN_Bool CHMipL2SM::CheckForPendingMsg()
     {
         if (m_active_CService == NULL)
         {
-            m_active_CService = CChannel::GetServicePtr(CChannel::GetRequestedService());
+            m_active_CService = mo_channel->GetServicePtr(mo_channel->GetRequestedService());
             if (m_active_CService != NULL)
             {
                 m_active_CService->ClearRetryCount();
@@ -680,6 +688,7 @@ CHMipL2SM::EN_Status CHMipL2SM::Enter_ENABLED(CHMipProtocol::EN_ToDo* to_do_)
 CHMipL2SM::EN_Status CHMipL2SM::StartTransmit_EnterUSING(CHMipProtocol::EN_ToDo* to_do_)
 {
     m_active_CService->SetSubStatus(CService::EN_SubStat::IDLE);
+    m_active_CService->MarkTxStart();
     *to_do_ = CHMipProtocol::EN_ToDo::START_TRANSMIT;
     m_status_in_USING = EN_StatusInUSING::SENDING;
     return EN_Status::USING;
@@ -703,6 +712,7 @@ void CHMipL2SM::TRANSMITcnfRetry()
     m_active_CService->SetSubStatus(CService::EN_SubStat::IDLE);
     m_active_CService->SetCompletionCode(EN_SRV_Result::IN_PROGRESS);
     m_active_CService->SetStatus(CService::EN_Status::REQUESTED);
+    mo_channel->RetryService(m_active_CService->GetHandle());
     m_active_CService = NULL;
     SetMsgPending(EN_Bool::FALSE8);
 }
@@ -712,7 +722,7 @@ void CHMipL2SM::TRANSMITcnfFail()
     m_active_CService->SetSubStatus(CService::EN_SubStat::IDLE);
     m_active_CService->SetCompletionCode(EN_SRV_Result::NO_DEV_RESP);
     m_active_CService->SetStatus(CService::EN_Status::WAITING);
-    CChannel::FireServiceEvent(CChannel::CServiceEvent::CONFIRMATION,
+    mo_channel->FireServiceEvent(CChannel::CServiceEvent::CONFIRMATION,
         m_active_CService->GetHandle(),
         0
     );
@@ -726,7 +736,7 @@ void CHMipL2SM::TRANSMITcnfSuccess(CFrame* frame_)
     m_active_CService->SetCompletionCode(EN_SRV_Result::SUCCESSFUL);
     m_active_CService->SetStatus(CService::EN_Status::WAITING);
     m_active_CService->SetResponse(frame_);
-    CChannel::FireServiceEvent(CChannel::CServiceEvent::CONFIRMATION,
+    mo_channel->FireServiceEvent(CChannel::CServiceEvent::CONFIRMATION,
         m_active_CService->GetHandle(),
         0
     );
@@ -736,7 +746,7 @@ void CHMipL2SM::TRANSMITcnfSuccess(CFrame* frame_)
 
 void CHMipL2SM::SignalBurstIndication(CFrame* frame_)
 {
-    CChannel::BurstIndicate(frame_);
+    mo_channel->BurstIndicate(frame_);
 }
 
 void CHMipL2SM::TRANSMITcnfDone()
@@ -744,7 +754,7 @@ void CHMipL2SM::TRANSMITcnfDone()
     m_active_CService->SetSubStatus(CService::EN_SubStat::IDLE);
     m_active_CService->SetCompletionCode(EN_SRV_Result::OBSOLETE);
     m_active_CService->SetStatus(CService::EN_Status::WAITING);
-    CChannel::FireServiceEvent(CChannel::CServiceEvent::CONFIRMATION,
+    mo_channel->FireServiceEvent(CChannel::CServiceEvent::CONFIRMATION,
         m_active_CService->GetHandle(),
         0
     );
@@ -794,14 +804,18 @@ CHMipL2SM::EN_Status CHMipL2SM::HandleSrvFailed(CHMipProtocol::EN_ToDo* to_do_)
 
 // CRxIpSM
 
-// Data
-CHMipL2RxSM::EN_Status CHMipL2RxSM::Status;
-TY_Byte            CHMipL2RxSM::m_pend_rcv_bytes[MAX_TXRX_SIZE];
-TY_Word            CHMipL2RxSM::m_num_pend_bytes;
-COSAL::CTimer      CHMipL2RxSM::m_timer;
-TY_Word            CHMipL2RxSM::m_next_char_gap;
-TY_DWord           CHMipL2RxSM::m_last_rcv_event_time;
-TY_Byte            CHMipL2RxSM::m_expected_rcv_size;
+// Construction
+CHMipL2RxSM::CHMipL2RxSM(CChannel* channel_)
+{
+    mo_channel = channel_;
+    Status = EN_Status::IDLE;
+    m_num_pend_bytes = 0;
+    m_timer.InitNoneStatic();
+    m_next_char_gap = 0;
+    m_last_rcv_event_time = 0;
+    m_expected_rcv_size = 14;
+    m_debug = 0;
+}
 
 // = Methods =
 
@@ -818,8 +832,8 @@ void CHMipL2RxSM::Init()
 
 // Operation
 
-CHMipProtocol::EN_ToDo CHMipL2RxSM::EventHandler(CHMipProtocol::EN_Event event_, CFrame* frame_, TY_Byte* rcv_bytes_, TY_Word len_,
-    CFrame* junk_frame_, CFrame* request_frame_, CFrame* response_frame_, CFrame* burst_frame_)
+CHMipProtocol::EN_ToDo CHMipL2RxSM::EventHandler(CHMipProtocol::EN_Event event_, CFrame** frame_, TY_Byte* rcv_bytes_, TY_Word len_,
+    CFrame** junk_frame_, CFrame** request_frame_, CFrame** response_frame_, CFrame** burst_frame_)
 {
     TY_Byte          au8_LocRcvBytes[MAX_TXRX_SIZE];
     TY_Word               u16_LocLen = 0;
@@ -857,25 +871,32 @@ TY_Byte CHMipL2RxSM::GetBlockSize()
 
 // Helpers
 
-TY_Word CHMipL2RxSM::HandleData(CHMipProtocol::EN_Event event_, CFrame* frame_, TY_Byte* rcv_bytes_, TY_Word new_data_len_,
-    CFrame* junk_frame_, CFrame* request_frame_, CFrame* response_frame_, CFrame* burst_frame_)
+TY_Word CHMipL2RxSM::HandleData(CHMipProtocol::EN_Event event_, CFrame** work_frame_, TY_Byte* rcv_bytes_, TY_Word new_data_len_,
+    CFrame** junk_frame_, CFrame** request_frame_, CFrame** response_frame_, CFrame** burst_frame_)
 {
+    CFrame* frame = *work_frame_;
     TY_Word         bytes_parsed = 0;
     TY_Byte             new_data[MAX_TXRX_SIZE];
     TY_Byte              new_err[MAX_TXRX_SIZE];
 
+    if (frame == NULL)
+    {
+        // No frame left in the pool, the data is dropped
+        return 0;
+    }
+
     COSAL::CMem::Copy(new_data, rcv_bytes_, new_data_len_);
     COSAL::CMem::Set(new_err, 0, MAX_TXRX_SIZE);
 
     if (Status == EN_Status::IDLE)
     {
         Status = EN_Status::RECEIVING;
-        frame_->Init();
+        frame->Init();
 
         if (new_data_len_ > 0)
         {
-            CMonitor::StartReceive(COSAL::CTimer::GetTime());
-            frame_->SetStartTime(COSAL::CTimer::GetTime());
+            mo_channel->Monitor.StartReceive(COSAL::CTimer::GetTime());
+            frame->SetStartTime(COSAL::CTimer::GetTime());
         }
     }
 
@@ -883,12 +904,12 @@ TY_Word CHMipL2RxSM::HandleData(CHMipProtocol::EN_Event event_, CFrame* frame_,
     // store the end time just for the case
     if (new_data_len_ > 0)
     {
-        frame_->SetEndTime(COSAL::CTimer::GetTime() + 1);
+        frame->SetEndTime(COSAL::CTimer::GetTime() + 1);
         m_last_rcv_event_time = COSAL::CTimer::GetTime() + 1;
     }
 
-    frame_->NoPreamb = EN_Bool::TRUE8;
-    if (frame_->TryParse(&bytes_parsed, new_data, new_err, new_data_len_, EN_Bool::FALSE8) == EN_Bool::TRUE8)
+    frame->NoPreamb = EN_Bool::TRUE8;
+    if (frame->TryParse(&bytes_parsed, new_data, new_err, new_data_len_, EN_Bool::FALSE8) == EN_Bool::TRUE8)
     {
         TY_Byte mon_data[MAX_TXRX_SIZE];
         TY_Byte mon_data_len = 0;
@@ -898,55 +919,51 @@ TY_Word CHMipL2RxSM::HandleData(CHMipProtocol::EN_Event event_, CFrame* frame_,
         // set the end of the frame anew
         if ((new_data_len_ > 0) && (bytes_parsed > 0))
         {
-            frame_->SetEndTime(COSAL::CTimer::GetTime());
+            frame->SetEndTime(COSAL::CTimer::GetTime());
         }
 
         if (new_data_len_ > bytes_parsed)
         {
             TY_Word pending = new_data_len_ - bytes_parsed;
-            CMonitor::RemoveData(pending);
+            mo_channel->Monitor.RemoveData(pending);
         }
 
-        switch (frame_->Type)
+        switch (frame->Type)
         {
         case CFrame::EN_Type::JUNK:
-            CHMipMacPort::GetIpFrameForMonitor(mon_data, &mon_data_len, new_data, (TY_Byte)new_data_len_, (TY_Byte)CHMipMacPort::EN_Msg_Type::RECEIVED);
-            CMonitor::StoreData(mon_data, mon_data_len);
-            if (CMonitor::GetDataLen() > 0)
+            mo_channel->IpMacPort.GetIpFrameForMonitor(mon_data, &mon_data_len, new_data, (TY_Byte)new_data_len_, (TY_Byte)CHMipMacPort::EN_Msg_Type::RECEIVED);
+            mo_channel->Monitor.StoreData(mon_data, mon_data_len);
+            if (mo_channel->Monitor.GetDataLen() > 0)
             {
-                CMonitor::EndRcvGapTO(COSAL::CTimer::GetTime());
+                mo_channel->Monitor.EndRcvGapTO(COSAL::CTimer::GetTime());
             }
             else
             {
-                CMonitor::AbortReceive();
+                mo_channel->Monitor.AbortReceive();
             }
 
-            *junk_frame_ = *frame_;
-            junk_frame_->SetActive();
+            PassFrame(work_frame_, junk_frame_);
             Status = EN_Status::IDLE;
             break;
         case CFrame::EN_Type::REQUEST:
-            CHMipMacPort::GetIpFrameForMonitor(mon_data, &mon_data_len, new_data, (TY_Byte)new_data_len_, (TY_Byte)CHMipMacPort::EN_Msg_Type::REQUEST);
-            CMonitor::StoreData(mon_data, mon_data_len);
-            CMonitor::EndRcvValidFrame(COSAL::CTimer::GetTime());
-            *request_frame_ = *frame_;
-            request_frame_->SetActive();
+            mo_channel->IpMacPort.GetIpFrameForMonitor(mon_data, &mon_data_len, new_data, (TY_Byte)new_data_len_, (TY_Byte)CHMipMacPort::EN_Msg_Type::REQUEST);
+            mo_channel->Monitor.StoreData(mon_data, mon_data_len);
+            mo_channel->Monitor.EndRcvValidFrame(COSAL::CTimer::GetTime());
+            PassFrame(work_frame_, request_frame_);
             Status = EN_Status::IDLE;
             break;
         case CFrame::EN_Type::RESPONSE:
-            CHMipMacPort::GetIpFrameForMonitor(mon_data, &mon_data_len, new_data, (TY_Byte)new_data_len_, (TY_Byte)CHMipMacPort::EN_Msg_Type::RESPONSE);
-            CMonitor::StoreData(mon_data, mon_data_len);
-            CMonitor::EndRcvValidFrame(COSAL::CTimer::GetTime());
-            *response_frame_ = *frame_;
-            response_frame_->SetActive();
+            mo_channel->IpMacPort.GetIpFrameForMonitor(mon_data, &mon_data_len, new_data, (TY_Byte)new_data_len_, (TY_Byte)CHMipMacPort::EN_Msg_Type::RESPONSE);
+            mo_channel->Monitor.StoreData(mon_data, mon_data_len);
+            mo_channel->Monitor.EndRcvValidFrame(COSAL::CTimer::GetTime());
+            PassFrame(work_frame_, response_frame_);
             Status = EN_Status::IDLE;
             break;
         case CFrame::EN_Type::BURST:
-            CHMipMacPort::GetIpFrameForMonitor(mon_data, &mon_data_len, new_data, (TY_Byte)new_data_len_, (TY_Byte)CHMipMacPort::EN_Msg_Type::BURST);
-            CMonitor::StoreData(mon_data, mon_data_len);
-            CMonitor::EndRcvValidFrame(COSAL::CTimer::GetTime());
-            *burst_frame_ = *frame_;
-            burst_frame_->SetActive();
+            mo_channel->IpMacPort.GetIpFrameForMonitor(mon_data, &mon_data_len, new_data, (TY_Byte)new_data_len_, (TY_Byte)CHMipMacPort::EN_Msg_Type::BURST);
+            mo_channel->Monitor.StoreData(mon_data, mon_data_len);
+            mo_channel->Monitor.EndRcvValidFrame(COSAL::CTimer::GetTime());
+            PassFrame(work_frame_, burst_frame_);
             Status = EN_Status::IDLE;
             break;
         }
@@ -965,11 +982,26 @@ TY_Word CHMipL2RxSM::HandleData(CHMipProtocol::EN_Event event_, CFrame* frame_,
     return (TY_Word)(new_data_len_ - bytes_parsed);
 }
 
+void CHMipL2RxSM::PassFrame(CFrame** work_frame_, CFrame** slot_)
+{
+    // The parsed frame is passed on by its pointer and the
+    // parser continues with a fresh frame of the pool
+    if (*slot_ != NULL)
+    {
+        // Replaced before it was handled
+        mo_channel->Frames.Release(*slot_);
+    }
+
+    *slot_ = *work_frame_;
+    (*slot_)->SetActive();
+    *work_frame_ = mo_channel->Frames.Acquire();
+}
+
 void CHMipL2RxSM::SetGapTimer(TY_Word u16_NumCharacters)
 {
     if (u16_NumCharacters > 0)
     {
-        TY_DWord u32_Gap = (TY_DWord)((u16_NumCharacters + 1) * COSAL::CTimer::GetByteTime(CChannel::GetBaudrate()));
+        TY_DWord u32_Gap = (TY_DWord)((u16_NumCharacters + 1) * COSAL::CTimer::GetByteTime(mo_channel->GetBaudrate()));
 
         if (u32_Gap < 50)
         {
@@ -980,7 +1012,7 @@ void CHMipL2RxSM::SetGapTimer(TY_Word u16_NumCharacters)
     }
     else
     {
-        TY_DWord u32_Gap = (TY_DWord)(3 * COSAL::CTimer::GetByteTime(CChannel::GetBaudrate()));
+        TY_DWord u32_Gap = (TY_DWord)(3 * COSAL::CTimer::GetByteTime(mo_channel->GetBaudrate()));
 
         m_timer.Start(u32_Gap);
     }
@@ -988,10 +1020,14 @@ void CHMipL2RxSM::SetGapTimer(TY_Word u16_NumCharacters)
 
 // CTxIpSM
 
-// Data
-CHMipL2TxSM::EN_Status CHMipL2TxSM::Status = EN_Status::IDLE;
-TY_Word          CHMipL2TxSM::m_len = 0;
-COSAL::CTimer    CHMipL2TxSM::m_timer;
+// Construction
+CHMipL2TxSM::CHMipL2TxSM(CChannel* channel_)
+{
+    mo_channel = channel_;
+    Status = EN_Status::IDLE;
+    m_len = 0;
+    m_timer.InitNoneStatic();
+}
 
 // Methods 
 
@@ -26,6 +26,8 @@
 #include "HartService.h"
 #include "HMipProtocol.h"
 
+class CChannel;
+
 class CHMipL2SM
 {
 public:
@@ -71,46 +73,48 @@ public:
         RECEIVING = 2
     };
 
+    // Construction
+    CHMipL2SM(CChannel* channel_);
     // Initialization
-    static void                          Init();
+    void                          Init();
     // Operation
-    static CHMipProtocol::EN_ToDo  EventHandler(EN_Event event_, CFrame* frame_);
-    static TY_Byte*                 GetTxData(TY_Word* pu16_Len);
-    static void        SetActiveServiceFailed();
-    static void                        Enable();
-    static void                       Disable();
+    CHMipProtocol::EN_ToDo  EventHandler(EN_Event event_, CFrame* frame_);
+    TY_Byte*                 GetTxData(TY_Word* pu16_Len);
+    void        SetActiveServiceFailed();
+    void                        Enable();
+    void                       Disable();
     // State handling
-    static EN_Status        HandleStatus_IDLE(EN_Event event_, CFrame* frame_, CHMipProtocol::EN_ToDo* to_do_);
-    static EN_Status    HandleStatus_WATCHING(EN_Event event_, CFrame* frame_, CHMipProtocol::EN_ToDo* to_do_);
-    static EN_Status     HandleStatus_ENABLED(EN_Event event_, CFrame* frame_, CHMipProtocol::EN_ToDo* to_do_);
-    static EN_Status       HandleStatus_USING(EN_Event event_, CFrame* frame_, CHMipProtocol::EN_ToDo* to_do_);
+    EN_Status        HandleStatus_IDLE(EN_Event event_, CFrame* frame_, CHMipProtocol::EN_ToDo* to_do_);
+    EN_Status    HandleStatus_WATCHING(EN_Event event_, CFrame* frame_, CHMipProtocol::EN_ToDo* to_do_);
+    EN_Status     HandleStatus_ENABLED(EN_Event event_, CFrame* frame_, CHMipProtocol::EN_ToDo* to_do_);
+    EN_Status       HandleStatus_USING(EN_Event event_, CFrame* frame_, CHMipProtocol::EN_ToDo* to_do_);
     // Helpers
-    static void                        SetRT1();
-    static EN_Bool                 SetRT1diff();
-    static void                     SetTwoRT1();
-    static void                    SetRT1prim();
-    static void                 SetTwoRT1prim();
-    static void                        SetRT2();
-    static void                       SetHOLD();
-    static TY_DWord                    GetRT1();
-    static TY_DWord                GetRT1prim();
-    static EN_Bool                    IsBURST();
-    static void                      SetBURST(EN_Bool value);
-    static void                 SetMsgPending(EN_Bool value);
-    static EN_Bool               IsMsgPending();
-    static void                   UpdateBurstMode(CFrame* frame_);
-    static EN_Bool         CheckForPendingMsg();
-    static EN_Status           Enter_WATCHING(CHMipProtocol::EN_ToDo* to_do_);
-    static EN_Status            Enter_ENABLED(CHMipProtocol::EN_ToDo* to_do_);
-    static EN_Status               StartTransmit_EnterUSING(CHMipProtocol::EN_ToDo* to_do_);
-    static EN_Status            XmtMsg_ENABLE(CHMipProtocol::EN_ToDo* to_do_);
-    static EN_Status             XmtMsg_WATCH(CHMipProtocol::EN_ToDo* to_do_);
-    static void               TRANSMITcnfFail();
-    static void              TRANSMITcnfRetry();
-    static void            TRANSMITcnfSuccess(CFrame* frame_);
-    static void              SignalBurstIndication(CFrame* frame_);
-    static void               TRANSMITcnfDone();
-    static EN_Status          HandleSrvFailed(CHMipProtocol::EN_ToDo* to_do_);
+    void                        SetRT1();
+    EN_Bool                 SetRT1diff();
+    void                     SetTwoRT1();
+    void                    SetRT1prim();
+    void                 SetTwoRT1prim();
+    void                        SetRT2();
+    void                       SetHOLD();
+    TY_DWord                    GetRT1();
+    TY_DWord                GetRT1prim();
+    EN_Bool                    IsBURST();
+    void                      SetBURST(EN_Bool value);
+    void                 SetMsgPending(EN_Bool value);
+    EN_Bool               IsMsgPending();
+    void                   UpdateBurstMode(CFrame* frame_);
+    EN_Bool         CheckForPendingMsg();
+    EN_Status           Enter_WATCHING(CHMipProtocol::EN_ToDo* to_do_);
+    EN_Status            Enter_ENABLED(CHMipProtocol::EN_ToDo* to_do_);
+    EN_Status               StartTransmit_EnterUSING(CHMipProtocol::EN_ToDo* to_do_);
+    EN_Status            XmtMsg_ENABLE(CHMipProtocol::EN_ToDo* to_do_);
+    EN_Status             XmtMsg_WATCH(CHMipProtocol::EN_ToDo* to_do_);
+    void               TRANSMITcnfFail();
+    void              TRANSMITcnfRetry();
+    void            TRANSMITcnfSuccess(CFrame* frame_);
+    void              SignalBurstIndication(CFrame* frame_);
+    void               TRANSMITcnfDone();
+    EN_Status          HandleSrvFailed(CHMipProtocol::EN_ToDo* to_do_);
 
     /* Nested classes */
     class CUsedTimeOuts
@@ -144,15 +148,16 @@ public:
         static const TY_DWord          SHORT_HOLD = 3;
     };
 private:
-    static EN_Status           Status;
-    static EN_StatusInWATCHING m_status_in_WATCHING;
-    static EN_StatusInIDLE     m_status_in_IDLE;
-    static EN_StatusInUSING    m_status_in_USING;
-    static EN_Bool             m_hart_enabled;
-    static EN_Bool             m_burst_mode;
-    static EN_Bool             m_msg_pending;
-    static CService*           m_active_CService;
-    static COSAL::CTimer       m_timer;
+    CChannel*           mo_channel;
+    EN_Status           Status;
+    EN_StatusInWATCHING m_status_in_WATCHING;
+    EN_StatusInIDLE     m_status_in_IDLE;
+    EN_StatusInUSING    m_status_in_USING;
+    EN_Bool             m_hart_enabled;
+    EN_Bool             m_burst_mode;
+    EN_Bool             m_msg_pending;
+    CService*           m_active_CService;
+    COSAL::CTimer       m_timer;
 };
 
 class CHMipL2RxSM
@@ -166,30 +171,34 @@ public:
         WAIT_SIELENCE = 2
     };
 
+    // Construction
+    CHMipL2RxSM(CChannel* channel_);
     // Initialization
-    static void                 Init();
+    void                 Init();
      // Operation
-    static CHMipProtocol::EN_ToDo      EventHandler(CHMipProtocol::EN_Event event_, CFrame* frame_, TY_Byte* rcv_bytes_, TY_Word len_,
-                                                  CFrame* junk_, CFrame* request_, CFrame* response_, CFrame* burst_);
-    static void                Reset();
-    static TY_Byte      GetBlockSize();
+    CHMipProtocol::EN_ToDo      EventHandler(CHMipProtocol::EN_Event event_, CFrame** frame_, TY_Byte* rcv_bytes_, TY_Word len_,
+                                                  CFrame** junk_, CFrame** request_, CFrame** response_, CFrame** burst_);
+    void                Reset();
+    TY_Byte      GetBlockSize();
 
 private:
-    static EN_Status       Status;
-    static TY_Byte         m_pend_rcv_bytes[MAX_TXRX_SIZE];
-    static TY_Word         m_num_pend_bytes;
-    static COSAL::CTimer   m_timer;
-    static TY_Word         m_next_char_gap;
-    static TY_DWord        m_last_rcv_event_time;
-    static TY_Byte         m_expected_rcv_size;
-    static TY_DWord        m_debug;
+    CChannel*       mo_channel;
+    EN_Status       Status;
+    TY_Byte         m_pend_rcv_bytes[MAX_TXRX_SIZE];
+    TY_Word         m_num_pend_bytes;
+    COSAL::CTimer   m_timer;
+    TY_Word         m_next_char_gap;
+    TY_DWord        m_last_rcv_event_time;
+    TY_Byte         m_expected_rcv_size;
+    TY_DWord        m_debug;
 
     // Helpers
-    static TY_Word        HandleData(CHMipProtocol::EN_Event event_, CFrame* frame_, TY_Byte* pst_RcvBytes, TY_Word u16_Len,
-                                     CFrame* junk_, CFrame* request_, CFrame* response_, CFrame* burst_);
-    static void     SavePendingBytes(TY_Byte* rcv_bytes_, TY_Word len_);
-    static TY_Word   GetPendingBytes(TY_Byte* rcv_bytes_);
-    static void          SetGapTimer(TY_Word num_characters_);
+    TY_Word        HandleData(CHMipProtocol::EN_Event event_, CFrame** work_frame_, TY_Byte* pst_RcvBytes, TY_Word u16_Len,
+                                     CFrame** junk_, CFrame** request_, CFrame** response_, CFrame** burst_);
+    void             PassFrame(CFrame** work_frame_, CFrame** slot_);
+    void     SavePendingBytes(TY_Byte* rcv_bytes_, TY_Word len_);
+    TY_Word   GetPendingBytes(TY_Byte* rcv_bytes_);
+    void          SetGapTimer(TY_Word num_characters_);
 };
 
 class CHMipL2TxSM
@@ -203,18 +212,21 @@ public:
         WAIT_TX_END = 2
     };
 
+    // Construction
+    CHMipL2TxSM(CChannel* channel_);
     // Initialization
-    static void                         Init();
+    void                         Init();
     /* Operation */
-    static CHMipProtocol::EN_ToDo EventHandler();
-    static EN_Status               GetStatus();
-    static void                    SetStatus(EN_Status status_);
-    static void                     SetTxLen(TY_Word len_);
+    CHMipProtocol::EN_ToDo EventHandler();
+    EN_Status               GetStatus();
+    void                    SetStatus(EN_Status status_);
+    void                     SetTxLen(TY_Word len_);
 
 private:
-    static EN_Status     Status;
-    static TY_Word       m_len;
-    static COSAL::CTimer m_timer;
+    CChannel*     mo_channel;
+    EN_Status     Status;
+    TY_Word       m_len;
+    COSAL::CTimer m_timer;
 };
 
 #endif // __hmiplayer2_h__
\ No newline at end of file
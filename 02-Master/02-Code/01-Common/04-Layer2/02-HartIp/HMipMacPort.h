@@ -47,6 +47,8 @@
 
 #define MAX_VER 1
 
+class CChannel;
+
 class CHMipMacPort
 {
 public:
@@ -125,73 +127,81 @@ public:
         KEEP_ALIVE = 10
     };
 
-    static void                 Execute(TY_Word time_ms_);
-    static EN_Bool                 Open(TY_Byte* host_name_, TY_Byte* port_, EN_CommType type_);
-    static void                   Close();
-    static void                    Init();
-    static TY_Word            GetStatus();
-    static TY_Word       GetMagicNumber();
-    static TY_Word    GetSequenceNumber(TY_Byte msg_type_);
-    static void       SetSequenceNumber(TY_Byte msg_type_);
-    static void    GetIpFrameForMonitor(TY_Byte* dst_, TY_Byte* dst_len_, TY_Byte* src_, TY_Byte src_len, TY_Byte msg_type_);
-    static TY_Word       GetPayloadData(TY_Byte* data_);
+                          CHMipMacPort(CChannel* channel_);
+                         ~CHMipMacPort();
+    void                 Execute(TY_Word time_ms_);
+    EN_Bool                 Open(TY_Byte* host_name_, TY_Byte* port_, EN_CommType type_);
+    void                   Close();
+    void                    Init();
+    TY_Word            GetStatus();
+    TY_Word       GetMagicNumber();
+    TY_Word    GetSequenceNumber(TY_Byte msg_type_);
+    void       SetSequenceNumber(TY_Byte msg_type_);
+    void    GetIpFrameForMonitor(TY_Byte* dst_, TY_Byte* dst_len_, TY_Byte* src_, TY_Byte src_len, TY_Byte msg_type_);
+    TY_Word       GetPayloadData(TY_Byte* data_);
+    // Let the kernel serve this port right away
+    void                  WakeUp();
 
 private:
     // Data
-    static TY_Byte        m_rcv_buf[MAX_IP_TXRX_SIZE];
-    static int            m_rcv_len;
-    static TY_Byte        m_tx_buf[MAX_IP_TXRX_SIZE];
-    static int            m_tx_len;
-    static TY_Byte        m_hart_ip_data[MAX_IP_TXRX_SIZE];
-    static TY_Word        m_hart_ip_len;
-    static EN_LastError   m_last_error;
-    static TY_Byte        m_rx_err;
-    static EN_HartIP_Info m_last_hart_ip_info;
-    static EN_ToDo        m_to_do;
-    static EN_Bool        m_close_request;
-    static TY_Byte        m_hart_rx_data[MAX_TXRX_SIZE];
-    static TY_Byte        m_hart_rx_len;
-    static TY_Byte        m_hart_ip_version;
-    static TY_Byte        m_hart_ip_message_type;
-    static TY_Byte        m_hart_ip_message_id;
-    static TY_Byte        m_hart_ip_comm_status;
-    static TY_Word        m_hart_ip_request_seq_number;
-    static TY_Word        m_hart_ip_response_seq_number;
-    static TY_Word        m_hart_ip_burst_seq_number;
-    static TY_Word        m_hart_ip_nak_seq_number;
-    static TY_Word        m_hart_ip_received_seq_number;
-    static TY_Word        m_hart_ip_byte_count;
-    static TY_Word        m_magic_number;
-    static TY_DWord       m_ms_counter;
-    static TY_Byte        m_initiate_req_data[5];
+    CChannel*      mo_channel;
+    // Handles of the platform (kernel and socket)
+    PTR_Handle     mo_kernel;
+    PTR_Handle     mo_port;
+    TY_Byte        m_rcv_buf[MAX_IP_TXRX_SIZE];
+    int            m_rcv_len;
+    TY_Byte        m_tx_buf[MAX_IP_TXRX_SIZE];
+    int            m_tx_len;
+    TY_Byte        m_hart_ip_data[MAX_IP_TXRX_SIZE];
+    TY_Word        m_hart_ip_len;
+    EN_LastError   m_last_error;
+    TY_Byte        m_rx_err;
+    EN_HartIP_Info m_last_hart_ip_info;
+    EN_ToDo        m_to_do;
+    EN_Bool        m_close_request;
+    TY_Byte        m_hart_rx_data[MAX_TXRX_SIZE];
+    TY_Byte        m_hart_rx_len;
+    TY_Byte        m_hart_ip_version;
+    TY_Byte        m_hart_ip_message_type;
+    TY_Byte        m_hart_ip_message_id;
+    TY_Byte        m_hart_ip_comm_status;
+    TY_Word        m_hart_ip_request_seq_number;
+    TY_Word        m_hart_ip_response_seq_number;
+    TY_Word        m_hart_ip_burst_seq_number;
+    TY_Word        m_hart_ip_nak_seq_number;
+    TY_Word        m_hart_ip_received_seq_number;
+    TY_Word        m_hart_ip_byte_count;
+    TY_Word        m_magic_number;
+    TY_DWord       m_ms_counter;
+    TY_Byte        m_initiate_req_data[5];
     // Methods
-    static EN_Bool        InitializeSocketHandler();
-    static EN_Bool                ConnectToServer();
-    static EN_Status          SendInitiateRequest();
-    static void            AcceptInitiateResponse();
-    static void            EncodeKeepAliveRequest();
-    static EN_Status         SendKeepAliveRequest();
-    static void           AcceptKeepAliveResponse();
-    static EN_Status           SendCommandRequest();
-    static void             AcceptCommandResponse();
-    static void             RejectCommandResponse();
-    static void                   AcceptHartBurst();
-    static EN_Status             SendCloseRequest();
-    static void               AcceptCloseResponse();
-    static EN_Bool        HandleConnectionClosing();
+    EN_Bool        InitializeSocketHandler();
+    EN_Bool                ConnectToServer();
+    EN_Status          SendInitiateRequest();
+    void            AcceptInitiateResponse();
+    void            EncodeKeepAliveRequest();
+    EN_Status         SendKeepAliveRequest();
+    void           AcceptKeepAliveResponse();
+    EN_Status           SendCommandRequest();
+    void             AcceptCommandResponse();
+    void             RejectCommandResponse();
+    void                   AcceptHartBurst();
+    EN_Status             SendCloseRequest();
+    void               AcceptCloseResponse();
+    EN_Bool        HandleConnectionClosing();
     // Receive from the network
-    static EN_HartIP_Info   ReceiveNetworkMessage();
+    EN_HartIP_Info   ReceiveNetworkMessage();
     // Signal to the Hart protocol
-    static EN_ToDo         SignalHartPDUreceiving();
-    static EN_ToDo              SignalHartSilence();
-    static void                  SignalHartTxDone();
-    static void                SignalNetworkError();
+    EN_ToDo         SignalHartPDUreceiving();
+    EN_ToDo              SignalHartSilence();
+    void                  SignalHartTxDone();
+    void                SignalNetworkError();
     // Helper functions
-    static EN_Status          TerminateConnection(EN_LastError last_err_);
-    static void                      SaveNextToDo(EN_ToDo to_do_);
-    static EN_ToDo                  FetchNextToDo();
+    EN_Status          TerminateConnection(EN_LastError last_err_);
+    void                      SaveNextToDo(EN_ToDo to_do_);
+    EN_ToDo                  FetchNextToDo();
 
 public:
-    static EN_Status Status;
+    EN_Status Status;
 };
 #endif // __hmipmacport_h__
\ No newline at end of file
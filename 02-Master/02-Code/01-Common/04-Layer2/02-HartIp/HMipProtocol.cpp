@@ -19,18 +19,39 @@
 #include "HMipMacPort.h"
 #include "HMipLayer2.h"
 #include "Monitor.h"
+#include "HartChannel.h"
 
 /* CHIPM_Protocolocol */
-CHMipProtocol::EN_Status CHMipProtocol::Status;
-CFrame    CHMipProtocol::m_work_frame;
-CFrame    CHMipProtocol::m_junk_frame;
-CFrame    CHMipProtocol::m_request_frame;
-CFrame    CHMipProtocol::m_response_frame;
-CFrame    CHMipProtocol::m_burst_frame;
-TY_Byte*  CHMipProtocol::mpu8_TxData;
-TY_Len    CHMipProtocol::mu16_TxLen;
 
 // Methods
+CHMipProtocol::CHMipProtocol(CChannel* channel_)
+{
+    mo_channel = channel_;
+    Status = EN_Status::IDLE;
+    mpu8_TxData = NULL;
+    mu16_TxLen = 0;
+    mp_work_frame = NULL;
+    mp_junk_frame = NULL;
+    mp_request_frame = NULL;
+    mp_response_frame = NULL;
+    mp_burst_frame = NULL;
+}
+
+void CHMipProtocol::ReleaseFrames()
+{
+    // Note: Called while the channel is closed
+    mo_channel->Frames.Release(mp_work_frame);
+    mo_channel->Frames.Release(mp_junk_frame);
+    mo_channel->Frames.Release(mp_request_frame);
+    mo_channel->Frames.Release(mp_response_frame);
+    mo_channel->Frames.Release(mp_burst_frame);
+    mp_work_frame = NULL;
+    mp_junk_frame = NULL;
+    mp_request_frame = NULL;
+    mp_response_frame = NULL;
+    mp_burst_frame = NULL;
+}
+
 CHMipMacPort::EN_ToDo CHMipProtocol::EventHandler(EN_Event event_, TY_Byte* rx_bytes_, TY_Word len_)
 {
     TY_DWord time = COSAL::CTimer::GetTime();
@@ -41,54 +62,63 @@ CHMipMacPort::EN_ToDo CHMipProtocol::EventHandler(EN_Event event_, TY_Byte* rx_b
     switch (Status)
     {
     case EN_Status::IDLE:
-        to_do = CHMipL2SM::EventHandler(CHMipL2SM::EN_Event::NONE, NULL);
+        to_do = mo_channel->IpL2SM.EventHandler(CHMipL2SM::EN_Event::NONE, NULL);
         break;
     case EN_Status::RECEIVING:
+        if (mp_work_frame == NULL)
+        {
+            mp_work_frame = mo_channel->Frames.Acquire();
+        }
+
         if (event_ == EN_Event::HART_IP_DATA_RECEIVED)
         {
-            to_do = CHMipL2RxSM::EventHandler(event_, &m_work_frame, rx_bytes_, len_, &m_junk_frame, &m_request_frame, &m_response_frame, &m_burst_frame);
+            to_do = mo_channel->IpL2RxSM.EventHandler(event_, &mp_work_frame, rx_bytes_, len_, &mp_junk_frame, &mp_request_frame, &mp_response_frame, &mp_burst_frame);
         }
         else if (event_ == EN_Event::REQUEST_REJECTED)
         {
-            to_do = CHMipL2SM::EventHandler(CHMipL2SM::EN_Event::RX_COMPLETED_ERR, &m_response_frame);
-            m_response_frame.Uninit();
+            // No frame was received
+            to_do = mo_channel->IpL2SM.EventHandler(CHMipL2SM::EN_Event::RX_COMPLETED_ERR, NULL);
         }
         else
         {
-            to_do = CHMipL2RxSM::EventHandler(event_, &m_work_frame, NULL, 0, &m_junk_frame, &m_request_frame, &m_response_frame, &m_burst_frame);
+            to_do = mo_channel->IpL2RxSM.EventHandler(event_, &mp_work_frame, NULL, 0, &mp_junk_frame, &mp_request_frame, &mp_response_frame, &mp_burst_frame);
         }
 
-        if (m_request_frame.IsActive() == EN_Bool::TRUE8)
+        if (mp_request_frame != NULL)
         {
-            to_do = CHMipL2SM::EventHandler(CHMipL2SM::EN_Event::RX_COMPLETED_REQ, &m_request_frame);
-            m_request_frame.Uninit();
+            to_do = mo_channel->IpL2SM.EventHandler(CHMipL2SM::EN_Event::RX_COMPLETED_REQ, mp_request_frame);
+            mo_channel->Frames.Release(mp_request_frame);
+            mp_request_frame = NULL;
         }
 
-        if (m_response_frame.IsActive() == EN_Bool::TRUE8)
+        if (mp_response_frame != NULL)
         {
-            to_do = CHMipL2SM::EventHandler(CHMipL2SM::EN_Event::RX_COMPLETED_RSP, &m_response_frame);
-            m_response_frame.Uninit();
+            to_do = mo_channel->IpL2SM.EventHandler(CHMipL2SM::EN_Event::RX_COMPLETED_RSP, mp_response_frame);
+            mo_channel->Frames.Release(mp_response_frame);
+            mp_response_frame = NULL;
         }
 
-        if (m_burst_frame.IsActive() == EN_Bool::TRUE8)
+        if (mp_burst_frame != NULL)
         {
-            to_do = CHMipL2SM::EventHandler(CHMipL2SM::EN_Event::RX_COMPLETED_BST, &m_burst_frame);
-            m_burst_frame.Uninit();
+            to_do = mo_channel->IpL2SM.EventHandler(CHMipL2SM::EN_Event::RX_COMPLETED_BST, mp_burst_frame);
+            mo_channel->Frames.Release(mp_burst_frame);
+            mp_burst_frame = NULL;
         }
 
-        if (m_junk_frame.IsActive() == EN_Bool::TRUE8)
+        if (mp_junk_frame != NULL)
         {
-            to_do = CHMipL2SM::EventHandler(CHMipL2SM::EN_Event::RX_COMPLETED_ERR, &m_junk_frame);
-            m_junk_frame.Uninit();
+            to_do = mo_channel->IpL2SM.EventHandler(CHMipL2SM::EN_Event::RX_COMPLETED_ERR, mp_junk_frame);
+            mo_channel->Frames.Release(mp_junk_frame);
+            mp_junk_frame = NULL;
         }
 
         if (to_do == EN_ToDo::START_TRANSMIT)
         {
-            CHMipL2RxSM::Reset();
+            mo_channel->IpL2RxSM.Reset();
         }
         else
         {
-            to_do = CHMipL2SM::EventHandler(CHMipL2SM::EN_Event::NONE, NULL);
+            to_do = mo_channel->IpL2SM.EventHandler(CHMipL2SM::EN_Event::NONE, NULL);
         }
 
 
@@ -97,7 +127,7 @@ CHMipMacPort::EN_ToDo CHMipProtocol::EventHandler(EN_Event event_, TY_Byte* rx_b
     case EN_Status::TRANSMITTING:
         // Call the state machine of the 
         // Hart ip protocol
-        to_do = CHMipL2TxSM::EventHandler();
+        to_do = mo_channel->IpL2TxSM.EventHandler();
         break;
     }
 
@@ -125,16 +155,16 @@ CHMipMacPort::EN_ToDo CHMipProtocol::EventHandler(EN_Event event_, TY_Byte* rx_b
             break;
         case EN_ToDo::START_TRANSMIT:
             to_do = EN_ToDo::NOTHING;
-            mpu8_TxData = CHMipL2SM::GetTxData(&mu16_TxLen);
+            mpu8_TxData = mo_channel->IpL2SM.GetTxData(&mu16_TxLen);
             if ((mpu8_TxData != 0) && (mu16_TxLen > 0))
             {
-                CHMipL2TxSM::SetTxLen(mu16_TxLen);
-                CHMipL2TxSM::SetStatus(CHMipL2TxSM::EN_Status::START_TX);
+                mo_channel->IpL2TxSM.SetTxLen(mu16_TxLen);
+                mo_channel->IpL2TxSM.SetStatus(CHMipL2TxSM::EN_Status::START_TX);
                 Status = EN_Status::TRANSMITTING;
             }
             else
             {
-                CHMipL2SM::SetActiveServiceFailed();
+                mo_channel->IpL2SM.SetActiveServiceFailed();
                 Status = EN_Status::RECEIVING;
                 to_do = EN_ToDo::NOTHING;
             }
@@ -147,14 +177,14 @@ CHMipMacPort::EN_ToDo CHMipProtocol::EventHandler(EN_Event event_, TY_Byte* rx_b
                 TY_Byte tx_data[MAX_TXRX_SIZE];
                 TY_Byte tx_len = 0;
 
-                CMonitor::StartTransmit(COSAL::CTimer::GetTime() + 1);
-                CHMipMacPort::GetIpFrameForMonitor(tx_data, &tx_len, mpu8_TxData, (TY_Byte)mu16_TxLen, (TY_Byte)CHMipMacPort::EN_Msg_Type::REQUEST);
-                CMonitor::StoreData(tx_data, tx_len);
+                mo_channel->Monitor.StartTransmit(COSAL::CTimer::GetTime() + 1);
+                mo_channel->IpMacPort.GetIpFrameForMonitor(tx_data, &tx_len, mpu8_TxData, (TY_Byte)mu16_TxLen, (TY_Byte)CHMipMacPort::EN_Msg_Type::REQUEST);
+                mo_channel->Monitor.StoreData(tx_data, tx_len);
             }
             break;
         case EN_ToDo::END_TRANSMIT:
-            CMonitor::EndTransmit(COSAL::CTimer::GetTime() - 1);
-            to_do = CHMipL2SM::EventHandler(CHMipL2SM::EN_Event::TX_DONE, NULL);
+            mo_channel->Monitor.EndTransmit(COSAL::CTimer::GetTime() - 1);
+            to_do = mo_channel->IpL2SM.EventHandler(CHMipL2SM::EN_Event::TX_DONE, NULL);
             if (to_do == EN_ToDo::RECEIVE_ENABLE)
             {
                 parent_to_do = CHMipMacPort::EN_ToDo::RECEIVE_ENABLE;
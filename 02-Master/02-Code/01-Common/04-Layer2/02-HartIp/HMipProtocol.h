@@ -24,6 +24,8 @@
 #include "HartFrame.h"
 #include "HMipMacPort.h"
 
+class CChannel;
+
 class CHMipProtocol
 {
 public:
@@ -54,18 +56,22 @@ public:
         END_TRANSMIT = 6
     };
 
-    static CHMipMacPort::EN_ToDo              EventHandler(CHMipProtocol::EN_Event event_, TY_Byte* rx_bytes_, TY_Word len_);
-    static TY_Byte*                              GetTxData(TY_Word* tx_len_);
-    static EN_ToDo               HandleHartIpPayloadPacket(TY_Byte* rx_tx_bytes_, TY_Word rx_tx_len_);
+                                        CHMipProtocol(CChannel* channel_);
+    void                              ReleaseFrames();
+    CHMipMacPort::EN_ToDo              EventHandler(CHMipProtocol::EN_Event event_, TY_Byte* rx_bytes_, TY_Word len_);
+    TY_Byte*                              GetTxData(TY_Word* tx_len_);
+    EN_ToDo               HandleHartIpPayloadPacket(TY_Byte* rx_tx_bytes_, TY_Word rx_tx_len_);
 
 private:
-    static EN_Status Status;
-    static CFrame    m_work_frame;
-    static CFrame    m_junk_frame;
-    static CFrame    m_request_frame;
-    static CFrame    m_response_frame;
-    static CFrame    m_burst_frame;
-    static TY_Byte*  mpu8_TxData;
-    static TY_Len    mu16_TxLen;
+    CChannel* mo_channel;
+    EN_Status Status;
+    // Taken from the frame pool of the channel
+    CFrame*   mp_work_frame;
+    CFrame*   mp_junk_frame;
+    CFrame*   mp_request_frame;
+    CFrame*   mp_response_frame;
+    CFrame*   mp_burst_frame;
+    TY_Byte*  mpu8_TxData;
+    TY_Len    mu16_TxLen;
 };
 #endif // __hmipprotocol_h__
\ No newline at end of file
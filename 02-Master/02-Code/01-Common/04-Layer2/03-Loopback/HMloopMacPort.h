@@ -0,0 +1,69 @@
+/*
+ *          File: HMloopMacPort.h (CHMloopMacPort)
+ *                The MAC port of a loopback channel. It takes the place
+ *                of the uart MAC port, the layer 2 state machines of the
+ *                uart are used as they are. The octets are exchanged with
+ *                the virtual wire instead of a com port. As for the
+ *                other ports, only the header is generic, the file
+ *                HMloopMacPort.cpp can be found in the specific branch.
+ *
+ *        Author: Walter Borst
+ *
+ *        E-Mail: info@borst-automation.de
+ *          Home: https://www.borst-automation.de
+ *
+ * No Warranties: https://www.borst-automation.com/legal/warranty-disclaimer
+ *
+ * Copyright 2006-2025 Walter Borst, Cuxhaven, Germany
+ */
+
+// Once
+#ifndef __hmloopmacport_h__
+#define __hmloopmacport_h__
+
+#include "OSAL.h"
+#include "WbHartUser.h"
+#include "WbHartM_Structures.h"
+#include "HMuartMacPort.h"
+#include "HMloopWire.h"
+
+class CChannel;
+
+class CHMloopMacPort
+{
+public:
+             CHMloopMacPort(CChannel* channel_);
+            ~CHMloopMacPort();
+    EN_Bool   Open(TY_LoopbackConfig* config_, TY_DWord baudrate_);
+    void     Close();
+    void   Execute(TY_Word time_ms_);
+    void      Init();
+    // Let the kernel serve this port right away
+    void    WakeUp();
+    // Calls at full speed which left a request to a later
+    // cycle of the kernel, 0 if every request was served at once
+    TY_DWord GetNumTickWaits();
+
+private:
+    // Passes of the state machines in one call at full speed
+    static const TY_Byte MAX_PASSES = 32;
+
+    // TRUE8: Something is going on
+    EN_Bool      Step();
+    // TRUE8: A timer of layer 2 held a request back, it is expired
+    EN_Bool ExpireTimers();
+
+    CChannel*   mo_channel;
+    // Handle of the platform (kernel)
+    PTR_Handle  mo_kernel;
+    CHMloopWire m_wire;
+    EN_Bool     m_carrier_on;
+    // Wakes up the kernel when the next octet arrives
+    COSAL::CTimer m_arrival_timer;
+    ST_RcvByte  m_loc_rcv_buf[MAX_TXRX_SIZE];
+    TY_DWord    m_num_tick_waits;
+
+public:
+    CHMuartMacPort::EN_Status Status;
+};
+#endif // __hmloopmacport_h__
@@ -0,0 +1,563 @@
+/*
+ *          File: HMloopWire.cpp (CHMloopWire)
+ *                The virtual wire of a loopback channel. The requests
+ *                of the master are answered by simulated devices, which
+ *                implement a few universal commands and may burst one
+ *                of them. Each octet gets the
+ *                time it would arrive on a real Hart loop, so the layer 2
+ *                state machines of the uart run unchanged. The wire is
+ *                driven by the kernel thread of the channel only.
+ *
+ *        Author: Walter Borst
+ *
+ *        E-Mail: info@borst-automation.de
+ *          Home: https://www.borst-automation.de
+ *
+ * No Warranties: https://www.borst-automation.com/legal/warranty-disclaimer
+ *
+ * Copyright 2006-2025 Walter Borst, Cuxhaven, Germany
+ */
+
+#include "OSAL.h"
+#include "WbHartUser.h"
+#include "HartConsts.h"
+#include "HartCoding.h"
+#include "HMloopWire.h"
+
+// Identity of the simulated devices, the device id
+// is taken from the polling address
+static const TY_Word LOOP_EXP_DEVICE_TYPE = 0x26A0;
+static const TY_Word LOOP_MANUFACTURER_ID = 0x00FA;
+static const TY_Byte LOOP_NUM_PREAMBLES = 5;
+
+// Device variables, in the order PV, SV, TV, QV, percent and current
+typedef struct st_LoopDevVar
+{
+    TY_Byte     Class;
+    TY_Byte     Units;
+    TY_Float    Value;
+} ST_LoopDevVar;
+
+static const ST_LoopDevVar loop_dev_vars[6] =
+{
+    { (TY_Byte)EN_DevVarClass::TEMPERATURE, 32, 21.5f },
+    { (TY_Byte)EN_DevVarClass::PRESSURE,     7, 1.013f },
+    { (TY_Byte)EN_DevVarClass::VOLUMEFLOW,  19, 50.0f },
+    { (TY_Byte)EN_DevVarClass::TEMPERATURE, 32, 12.5f },
+    { (TY_Byte)EN_DevVarClass::NONE,        57, 25.0f },
+    { (TY_Byte)EN_DevVarClass::CURRENT,     39, 8.0f }
+};
+
+static TY_Byte GetDevVarIdx(TY_Byte code_)
+{
+    // Returns 0xff for a code which is not supported
+    switch ((EN_DevVarCode)code_)
+    {
+    case EN_DevVarCode::PV1_0:
+    case EN_DevVarCode::PV1:
+        return 0;
+    case EN_DevVarCode::PV2_1:
+    case EN_DevVarCode::PV2:
+        return 1;
+    case EN_DevVarCode::PV3_2:
+    case EN_DevVarCode::PV3:
+        return 2;
+    case EN_DevVarCode::PV4_3:
+    case EN_DevVarCode::PV4:
+        return 3;
+    case EN_DevVarCode::PERCENT:
+        return 4;
+    case EN_DevVarCode::CURRENT:
+        return 5;
+    default:
+        return 0xff;
+    }
+}
+
+// Methods
+CHMloopWire::CHMloopWire()
+{
+    m_num_devices = 1;
+    m_model_baudrate = EN_Bool::TRUE8;
+    m_turnaround_time = 2;
+    m_baudrate = 1200;
+    m_num_preambles = LOOP_NUM_PREAMBLES;
+    m_burst_period = 0;
+    m_burst_command = 1;
+    m_line_len = 0;
+    m_line_idx = 0;
+    m_line_start = 0;
+    m_quiet_time = 0;
+    for (TY_Byte e = 0; e < MAX_NUM_LOOP_DEVICES; e++)
+    {
+        m_devices[e].Init(e);
+        m_next_burst[e] = 0;
+        m_burst_primary[e] = EN_Bool::TRUE8;
+    }
+}
+
+void CHMloopWire::Open(TY_LoopbackConfig* config_, TY_DWord baudrate_)
+{
+    m_num_devices = config_->NumDevices;
+    if (m_num_devices == 0)
+    {
+        m_num_devices = 1;
+    }
+
+    if (m_num_devices > MAX_NUM_LOOP_DEVICES)
+    {
+        m_num_devices = MAX_NUM_LOOP_DEVICES;
+    }
+
+    m_model_baudrate = config_->ModelBaudRate;
+    m_turnaround_time = config_->TurnaroundTime;
+    m_baudrate = (baudrate_ != 0) ? baudrate_ : 1200;
+    m_burst_period = config_->BurstPeriod;
+    m_burst_command = config_->BurstCommand;
+    for (TY_Byte e = 0; e < m_num_devices; e++)
+    {
+        m_devices[e].Init(e);
+        // The first burst message follows one period after opening
+        m_next_burst[e] = COSAL::CTimer::GetTime() + m_burst_period;
+        m_burst_primary[e] = EN_Bool::TRUE8;
+    }
+
+    Clear();
+}
+
+void CHMloopWire::Clear()
+{
+    m_line_len = 0;
+    m_line_idx = 0;
+    m_quiet_time = COSAL::CTimer::GetTime();
+    m_request.Init();
+}
+
+void CHMloopWire::Transmit(TY_Byte* data_, TY_Word len_, TY_DWord time_)
+{
+    TY_Byte errors[MAX_TXRX_SIZE];
+    TY_Word       parsed = 0;
+
+    // A new request cuts off a response which is still on the wire
+    m_line_len = 0;
+    m_line_idx = 0;
+    if ((len_ == 0) || (len_ > MAX_TXRX_SIZE))
+    {
+        return;
+    }
+
+    // A burst message doesn't start before the request is over
+    m_quiet_time = time_ + GetTxTime((TY_Word)(len_ - 1));
+
+    COSAL::CMem::Set(errors, COSAL::CRcvErr::ERR_None, len_);
+    m_request.Init();
+    m_request.TryParse(&parsed, data_, errors, len_, EN_Bool::FALSE8);
+    if ((m_request.GetStatus() != CFrame::EN_Status::FRAME_COMPLETED) ||
+        (m_request.Type != CFrame::EN_Type::REQUEST))
+    {
+        // Nothing a device would answer to
+        return;
+    }
+
+    for (TY_Byte e = 0; e < m_num_devices; e++)
+    {
+        if (m_devices[e].IsAddressed(&m_request) == EN_Bool::TRUE8)
+        {
+            EncodeResponse(&m_request, &m_devices[e]);
+            // The device starts after the last octet of the request
+            m_line_start = m_quiet_time + m_turnaround_time;
+            m_quiet_time = m_line_start + GetTxTime((TY_Word)(m_line_len - 1));
+            break;
+        }
+    }
+}
+
+TY_Len CHMloopWire::Receive(TY_Word max_len_, ST_RcvByte* rcv_bytes_, TY_DWord time_)
+{
+    TY_Len length = 0;
+
+    if (m_line_idx >= m_line_len)
+    {
+        StartBurst(time_);
+    }
+
+    while ((m_line_idx < m_line_len) && (length < max_len_))
+    {
+        TY_DWord arrival = m_line_start + GetTxTime(m_line_idx);
+
+        if ((TY_Int32)(arrival - time_) > 0)
+        {
+            // Still on its way
+            break;
+        }
+
+        rcv_bytes_[length].Data = m_line[m_line_idx];
+        rcv_bytes_[length].Error = COSAL::CRcvErr::ERR_None;
+        rcv_bytes_[length].Time = arrival;
+        m_line_idx++;
+        length++;
+    }
+
+    return length;
+}
+
+EN_Bool CHMloopWire::GetNextArrival(TY_DWord* time_)
+{
+    TY_Byte device;
+
+    if (m_line_idx < m_line_len)
+    {
+        *time_ = m_line_start + GetTxTime(m_line_idx);
+        return EN_Bool::TRUE8;
+    }
+
+    device = GetNextBurst();
+    if (device == 0xff)
+    {
+        return EN_Bool::FALSE8;
+    }
+
+    // The first octet of the next burst message
+    *time_ = GetBurstStart(device) + GetTxTime(0);
+    return EN_Bool::TRUE8;
+}
+
+EN_Bool CHMloopWire::IsFullSpeed()
+{
+    if (m_model_baudrate == EN_Bool::FALSE8)
+    {
+        return EN_Bool::TRUE8;
+    }
+
+    return EN_Bool::FALSE8;
+}
+
+TY_DWord CHMloopWire::GetTxTime(TY_Word idx_)
+{
+    if (m_model_baudrate == EN_Bool::FALSE8)
+    {
+        return 0;
+    }
+
+    // 11 bits per character, the product keeps the fractions
+    return (TY_DWord)(((TY_UInt64)(idx_ + 1) * 11000ULL) / m_baudrate);
+}
+
+void CHMloopWire::EncodeResponse(CFrame* request_, CDevice* device_)
+{
+    TY_Byte  data[MAX_PAYLOAD_SIZE];
+    TY_Byte  address[CHart::CSize::NUM_ADDR_BYTES];
+    TY_Byte  resp_code = CHart::CRespCode::SUCCESS;
+    TY_Byte  data_len = device_->Execute(request_->Command, request_->GetDataBuffer(),
+                            request_->GetDataSize(), data, &resp_code);
+    TY_Byte  delimiter = CHart::CDelimiter::ACK;
+    TY_Byte  addr_len = 1;
+
+    // The address is the one of the request
+    if (request_->AddrMode == CHart::CAddrMode::UNIQUE)
+    {
+        delimiter |= CHart::CFlags::UNIQUE_ADDR;
+        device_->GetUniqueID(address);
+        addr_len = CHart::CSize::NUM_ADDR_BYTES;
+    }
+    else
+    {
+        address[0] = request_->GetShortAddr();
+    }
+
+    address[0] &= CHart::CMask::HIGH_ADDR;
+    if (request_->GetRemoteMaster() == EN_Bool::TRUE8)
+    {
+        address[0] |= CHart::CFlags::PRIM_MASTER;
+    }
+
+    if (m_burst_period != 0)
+    {
+        address[0] |= CHart::CFlags::BURST_MODE;
+    }
+
+    EncodeFrame(delimiter, address, addr_len, request_->Command, resp_code,
+        device_->GetDeviceStatus(), data, data_len);
+}
+
+void CHMloopWire::StartBurst(TY_DWord time_)
+{
+    static const TY_Byte dynamic_vars[4] = { 0, 1, 2, 3 };
+
+    TY_Byte  data[MAX_PAYLOAD_SIZE];
+    TY_Byte  address[CHart::CSize::NUM_ADDR_BYTES];
+    TY_Byte  resp_code = CHart::CRespCode::SUCCESS;
+    TY_Byte  data_len;
+    TY_DWord start;
+    TY_Byte  device = GetNextBurst();
+
+    if (device == 0xff)
+    {
+        return;
+    }
+
+    start = GetBurstStart(device);
+    if ((TY_Int32)(start - time_) > 0)
+    {
+        // Not yet
+        return;
+    }
+
+    // Command 9 reads the dynamic variables
+    data_len = m_devices[device].Execute(m_burst_command, (TY_Byte*)dynamic_vars,
+        sizeof(dynamic_vars), data, &resp_code);
+    m_devices[device].GetUniqueID(address);
+    address[0] &= CHart::CMask::HIGH_ADDR;
+    address[0] |= CHart::CFlags::BURST_MODE;
+    if (m_burst_primary[device] == EN_Bool::TRUE8)
+    {
+        address[0] |= CHart::CFlags::PRIM_MASTER;
+    }
+
+    EncodeFrame(CHart::CDelimiter::BACK | CHart::CFlags::UNIQUE_ADDR, address, CHart::CSize::NUM_ADDR_BYTES,
+        m_burst_command, resp_code, m_devices[device].GetDeviceStatus(), data, data_len);
+    m_line_start = start;
+    m_quiet_time = m_line_start + GetTxTime((TY_Word)(m_line_len - 1));
+
+    // The token is passed to the masters in turn. A device
+    // which fell behind doesn't catch up with its bursts.
+    m_burst_primary[device] = (m_burst_primary[device] == EN_Bool::TRUE8) ? EN_Bool::FALSE8 : EN_Bool::TRUE8;
+    m_next_burst[device] += m_burst_period;
+    if ((TY_Int32)(m_next_burst[device] - start) <= 0)
+    {
+        m_next_burst[device] = start + m_burst_period;
+    }
+}
+
+TY_Byte CHMloopWire::GetNextBurst()
+{
+    TY_Byte device = 0xff;
+
+    if (m_burst_period == 0)
+    {
+        return 0xff;
+    }
+
+    for (TY_Byte e = 0; e < m_num_devices; e++)
+    {
+        if ((device == 0xff) || ((TY_Int32)(m_next_burst[e] - m_next_burst[device]) < 0))
+        {
+            device = e;
+        }
+    }
+
+    return device;
+}
+
+TY_DWord CHMloopWire::GetBurstStart(TY_Byte device_)
+{
+    TY_DWord quiet = m_quiet_time + m_turnaround_time;
+
+    // A burst message waits until the wire is quiet
+    if ((TY_Int32)(m_next_burst[device_] - quiet) < 0)
+    {
+        return quiet;
+    }
+
+    return m_next_burst[device_];
+}
+
+void CHMloopWire::EncodeFrame(TY_Byte delimiter_, TY_Byte* address_, TY_Byte addr_len_, TY_Byte command_,
+    TY_Byte resp_code_, TY_Byte status_, TY_Byte* data_, TY_Byte data_len_)
+{
+    TY_Word pos = 0;
+    TY_Word start_chk_pos;
+
+    for (TY_Byte e = 0; e < m_num_preambles; e++)
+    {
+        m_line[pos++] = 0xff;
+    }
+
+    start_chk_pos = pos;
+    m_line[pos++] = delimiter_;
+    COSAL::CMem::Copy(&m_line[pos], address_, addr_len_);
+    pos += addr_len_;
+    m_line[pos++] = command_;
+    m_line[pos++] = (TY_Byte)(data_len_ + 2);
+    m_line[pos++] = resp_code_;
+    m_line[pos++] = status_;
+    COSAL::CMem::Copy(&m_line[pos], data_, data_len_);
+    pos += data_len_;
+    m_line[pos] = CCoding::CheckSum(&m_line[start_chk_pos], (TY_Word)(pos - start_chk_pos));
+    pos++;
+    m_line_len = pos;
+    m_line_idx = 0;
+}
+
+// Simulated device
+void CHMloopWire::CDevice::Init(TY_Byte poll_addr_)
+{
+    m_poll_addr = poll_addr_;
+    m_unique_id[0] = (TY_Byte)((LOOP_EXP_DEVICE_TYPE >> 8) & CHart::CMask::HIGH_ADDR);
+    m_unique_id[1] = (TY_Byte)(LOOP_EXP_DEVICE_TYPE & 0xff);
+    m_unique_id[2] = 0;
+    m_unique_id[3] = 0;
+    m_unique_id[4] = (TY_Byte)(poll_addr_ + 1);
+    m_cfg_change_counter = 0;
+    m_device_status = 0;
+}
+
+EN_Bool CHMloopWire::CDevice::IsAddressed(CFrame* request_)
+{
+    TY_Byte unique_id[5];
+
+    if (request_->AddrMode == CHart::CAddrMode::POLLING)
+    {
+        return (request_->GetShortAddr() == m_poll_addr) ? EN_Bool::TRUE8 : EN_Bool::FALSE8;
+    }
+
+    request_->GetUniqueID(unique_id);
+    unique_id[0] &= CHart::CMask::HIGH_ADDR;
+    return COSAL::CMem::IsEqual(unique_id, m_unique_id, CHart::CSize::NUM_ADDR_BYTES);
+}
+
+void CHMloopWire::CDevice::GetUniqueID(TY_Byte* bytes_of_unique_id_)
+{
+    COSAL::CMem::Copy(bytes_of_unique_id_, m_unique_id, CHart::CSize::NUM_ADDR_BYTES);
+}
+
+TY_Byte CHMloopWire::CDevice::GetDeviceStatus()
+{
+    return m_device_status;
+}
+
+TY_Byte CHMloopWire::CDevice::Execute(TY_Byte command_, TY_Byte* req_data_, TY_Byte req_len_,
+    TY_Byte* data_, TY_Byte* resp_code_)
+{
+    *resp_code_ = CHart::CRespCode::SUCCESS;
+
+    switch (command_)
+    {
+    case 0:
+        return ReadUniqueID(data_);
+    case 1:
+        // Read primary variable
+        data_[0] = loop_dev_vars[0].Units;
+        CCoding::PutFloat(GetValue(0), 1, data_, EN_Endian::MSB_First);
+        return 5;
+    case 2:
+        // Read loop current and percent of range
+        CCoding::PutFloat(GetValue(5), 0, data_, EN_Endian::MSB_First);
+        CCoding::PutFloat(GetValue(4), 4, data_, EN_Endian::MSB_First);
+        return 8;
+    case 3:
+        // Read dynamic variables and loop current
+        CCoding::PutFloat(GetValue(5), 0, data_, EN_Endian::MSB_First);
+        for (TY_Byte e = 0; e < 4; e++)
+        {
+            data_[4 + 5 * e] = loop_dev_vars[e].Units;
+            CCoding::PutFloat(GetValue(e), (TY_Byte)(5 + 5 * e), data_, EN_Endian::MSB_First);
+        }
+        return 24;
+    case 9:
+        return ReadDevVars(req_data_, req_len_, data_, resp_code_);
+    case 38:
+        // Reset configuration changed flag
+        m_device_status &= (TY_Byte)~CHart::CDevStatus::CFG_CHANGED;
+        CCoding::PutWord(m_cfg_change_counter, 0, data_, EN_Endian::MSB_First);
+        return 2;
+    case 48:
+        // Read additional device status, all clear
+        COSAL::CMem::Set(data_, 0, 9);
+        return 9;
+    default:
+        *resp_code_ = CHart::CRespCode::CMD_NOT_IMP;
+        if ((command_ == CHart::CFlags::EXT_CMD_FLAG) && (req_len_ >= 2))
+        {
+            // Extended commands echo the command number
+            COSAL::CMem::Copy(data_, req_data_, 2);
+            return 2;
+        }
+        return 0;
+    }
+}
+
+TY_Byte CHMloopWire::CDevice::ReadUniqueID(TY_Byte* data_)
+{
+    data_[0] = 254;
+    CCoding::PutWord(LOOP_EXP_DEVICE_TYPE, 1, data_, EN_Endian::MSB_First);
+    data_[3] = LOOP_NUM_PREAMBLES;
+    data_[4] = 7;
+    data_[5] = 1;
+    data_[6] = 1;
+    data_[7] = 0x08;
+    data_[8] = 0;
+    data_[9] = m_unique_id[2];
+    data_[10] = m_unique_id[3];
+    data_[11] = m_unique_id[4];
+    data_[12] = LOOP_NUM_PREAMBLES;
+    data_[13] = (TY_Byte)EN_DevVarCode::PV4_3;
+    CCoding::PutWord(m_cfg_change_counter, 14, data_, EN_Endian::MSB_First);
+    data_[16] = 0;
+    CCoding::PutWord(LOOP_MANUFACTURER_ID, 17, data_, EN_Endian::MSB_First);
+    CCoding::PutWord(LOOP_MANUFACTURER_ID, 19, data_, EN_Endian::MSB_First);
+    data_[21] = 1;
+    return 22;
+}
+
+TY_Byte CHMloopWire::CDevice::ReadDevVars(TY_Byte* slots_, TY_Byte num_slots_, TY_Byte* data_, TY_Byte* resp_code_)
+{
+    // Extended status, the slots (8 octets each) and the time stamp.
+    // The number of slots is limited by the size of the payload.
+    const TY_Byte max_slots = (TY_Byte)((MAX_PAYLOAD_SIZE - 5) / 8);
+    TY_Byte       num_slots = num_slots_;
+    TY_Byte       len = 1;
+
+    if (num_slots == 0)
+    {
+        *resp_code_ = CHart::CRespCode::TOO_FEW_DATA;
+        return 0;
+    }
+
+    if (num_slots > max_slots)
+    {
+        num_slots = max_slots;
+    }
+
+    data_[0] = 0;
+    for (TY_Byte e = 0; e < num_slots; e++)
+    {
+        InsertDevVar(slots_[e], &data_[len]);
+        len += 8;
+    }
+
+    CCoding::PutDWord(COSAL::CTimer::GetTime() * 32, len, data_, EN_Endian::MSB_First);
+    return (TY_Byte)(len + 4);
+}
+
+void CHMloopWire::CDevice::InsertDevVar(TY_Byte code_, TY_Byte* buffer_)
+{
+    TY_Byte idx = GetDevVarIdx(code_);
+
+    buffer_[0] = code_;
+    if (idx == 0xff)
+    {
+        // Not used: No class, no units and NaN
+        buffer_[1] = (TY_Byte)EN_DevVarClass::NONE;
+        buffer_[2] = (TY_Byte)EN_DevVarCode::NOT_USED;
+        CCoding::PutDWord(0x7fa00000, 3, buffer_, EN_Endian::MSB_First);
+        buffer_[7] = 0x30;
+        return;
+    }
+
+    buffer_[1] = loop_dev_vars[idx].Class;
+    buffer_[2] = loop_dev_vars[idx].Units;
+    CCoding::PutFloat(GetValue(idx), 3, buffer_, EN_Endian::MSB_First);
+    buffer_[7] = 0xc0;
+}
+
+TY_Float CHMloopWire::CDevice::GetValue(TY_Byte idx_)
+{
+    // The devices are told apart by the primary variable
+    if (idx_ == 0)
+    {
+        return loop_dev_vars[0].Value + (TY_Float)m_poll_addr;
+    }
+
+    return loop_dev_vars[idx_].Value;
+}
@@ -0,0 +1,104 @@
+/*
+ *          File: HMloopWire.h (CHMloopWire)
+ *                The virtual wire of a loopback channel. The requests
+ *                of the master are answered by simulated devices, which
+ *                implement a few universal commands and may burst one
+ *                of them. Each octet gets the
+ *                time it would arrive on a real Hart loop, so the layer 2
+ *                state machines of the uart run unchanged. The wire is
+ *                driven by the kernel thread of the channel only.
+ *
+ *        Author: Walter Borst
+ *
+ *        E-Mail: info@borst-automation.de
+ *          Home: https://www.borst-automation.de
+ *
+ * No Warranties: https://www.borst-automation.com/legal/warranty-disclaimer
+ *
+ * Copyright 2006-2025 Walter Borst, Cuxhaven, Germany
+ */
+
+// Once
+#ifndef __hmloopwire_h__
+#define __hmloopwire_h__
+
+#include "OSAL.h"
+#include "WbHartUser.h"
+#include "WbHartM_Structures.h"
+#include "HartFrame.h"
+
+class CHMloopWire
+{
+public:
+                           CHMloopWire();
+    void                      Open(TY_LoopbackConfig* config_, TY_DWord baudrate_);
+    void                     Clear();
+    // A request of the master, the addressed device responds
+    void                  Transmit(TY_Byte* data_, TY_Word len_, TY_DWord time_);
+    // The octets which have arrived at the master until time_
+    TY_Len                 Receive(TY_Word max_len_, ST_RcvByte* rcv_bytes_, TY_DWord time_);
+    // Arrival of the next octet, FALSE8 if the wire is quiet
+    EN_Bool         GetNextArrival(TY_DWord* time_);
+    // TRUE8: The baud rate is not modeled, frames take no time
+    EN_Bool            IsFullSpeed();
+
+private:
+    class CDevice
+    {
+    public:
+        void                  Init(TY_Byte poll_addr_);
+        EN_Bool        IsAddressed(CFrame* request_);
+        // Returns the length of the response data
+        TY_Byte            Execute(TY_Byte command_, TY_Byte* req_data_, TY_Byte req_len_,
+                               TY_Byte* data_, TY_Byte* resp_code_);
+        void           GetUniqueID(TY_Byte* bytes_of_unique_id_);
+        TY_Byte    GetDeviceStatus();
+    private:
+        TY_Byte    ReadUniqueID(TY_Byte* data_);
+        TY_Byte     ReadDevVars(TY_Byte* slots_, TY_Byte num_slots_, TY_Byte* data_, TY_Byte* resp_code_);
+        void       InsertDevVar(TY_Byte code_, TY_Byte* buffer_);
+        TY_Float       GetValue(TY_Byte idx_);
+
+        TY_Byte    m_poll_addr;
+        TY_Byte    m_unique_id[5];
+        TY_Word    m_cfg_change_counter;
+        TY_Byte    m_device_status;
+    };
+
+    // Time from the start of a transmission until the end of octet idx_
+    TY_DWord    GetTxTime(TY_Word idx_);
+    void     EncodeResponse(CFrame* request_, CDevice* device_);
+    // The burst message of the device which is due next, if the time has come
+    void        StartBurst(TY_DWord time_);
+    // Encodes a response (ACK) or a burst message (BACK) on the line
+    void        EncodeFrame(TY_Byte delimiter_, TY_Byte* address_, TY_Byte addr_len_, TY_Byte command_,
+                    TY_Byte resp_code_, TY_Byte status_, TY_Byte* data_, TY_Byte data_len_);
+    // The device which bursts next, 0xff if none is in burst mode
+    TY_Byte    GetNextBurst();
+    // Start of the next burst message of the device
+    TY_DWord  GetBurstStart(TY_Byte device_);
+
+    CDevice      m_devices[MAX_NUM_LOOP_DEVICES];
+    TY_Byte      m_num_devices;
+    EN_Bool      m_model_baudrate;
+    TY_Byte      m_turnaround_time;
+    TY_DWord     m_baudrate;
+    TY_Byte      m_num_preambles;
+    TY_Word      m_burst_period;
+    TY_Byte      m_burst_command;
+    // Time of the next burst message of each device
+    TY_DWord     m_next_burst[MAX_NUM_LOOP_DEVICES];
+    // The master which gets the token with the burst message
+    EN_Bool      m_burst_primary[MAX_NUM_LOOP_DEVICES];
+    // The request is parsed by the devices
+    CFrame       m_request;
+    // The response on its way to the master
+    TY_Byte      m_line[MAX_TXRX_SIZE];
+    TY_Word      m_line_len;
+    TY_Word      m_line_idx;
+    TY_DWord     m_line_start;
+    // End of the last frame on the wire
+    TY_DWord     m_quiet_time;
+};
+
+#endif // __hmloopwire_h__
@@ -17,6 +17,7 @@
 
 #include "HartFrame.h"
 #include "HartConsts.h"
+#include "HartCoding.h"
 
 // Operation
 void CFrame::Encode()
@@ -29,7 +30,15 @@ void CFrame::Encode()
     TY_Word                  e;
     TY_Byte                chk = 0;
     TY_Word       payload_len = 0;
+    TY_Byte*         tx_bytes = NULL;
 
+    if (m_tx_buffer == NULL)
+    {
+        // Nothing to encode into
+        return;
+    }
+
+    tx_bytes = m_tx_buffer->Bytes;
     if (NumPreambles > 23)
     {
         NumPreambles = 23;
@@ -38,27 +47,27 @@ void CFrame::Encode()
     /* Insert preambles */
     for (e = 0; e < NumPreambles; e++)
     {
-        m_req_primitive[actual_pos++] = 0xff;
+        tx_bytes[actual_pos++] = 0xff;
     }
 
     /* Insert Delimiter */
     start_chk_pos = actual_pos;
     if (GetBurstFrame() == EN_Bool::TRUE8)
     {
-        m_req_primitive[actual_pos] = CHart::CDelimiter::BACK;
+        tx_bytes[actual_pos] = CHart::CDelimiter::BACK;
     }
     else
     {
-        m_req_primitive[actual_pos] = CHart::CDelimiter::STX;
+        tx_bytes[actual_pos] = CHart::CDelimiter::STX;
     }
 
     if (AddrMode != CHart::CAddrMode::POLLING)
     {
         /* Using unique address */
         // Insert addressing flag into delimiter
-        m_req_primitive[actual_pos++] |= (TY_Byte)(CHart::CAddrMode::UNIQUE << 7);
+        tx_bytes[actual_pos++] |= (TY_Byte)(CHart::CAddrMode::UNIQUE << 7);
         // Copy uinque ID to the address field
-        GetUniqueID(&m_req_primitive[actual_pos]);
+        GetUniqueID(&tx_bytes[actual_pos]);
         next_pos = actual_pos + 5;
     }
     else
@@ -67,42 +76,39 @@ void CFrame::Encode()
         // Leave delimiter as is
         actual_pos++;
         // Insert poll adress
-        m_req_primitive[actual_pos] = GetShortAddr();
+        tx_bytes[actual_pos] = GetShortAddr();
         next_pos = actual_pos + 1;
     }
 
     /* Modify first adress byte */
     // Mask out address flags
-    m_req_primitive[actual_pos] &= 0x3f;
+    tx_bytes[actual_pos] &= 0x3f;
     if (GetLocalMaster() == EN_Bool::TRUE8)
     {
         // Insert primary master flag
-        m_req_primitive[actual_pos] |= 0x80;
+        tx_bytes[actual_pos] |= 0x80;
     }
     if (GetBurstFrame() == EN_Bool::TRUE8)
     {
         // Set burst mode flag if burst frame is simulated
-        m_req_primitive[actual_pos] |= 0x40;
+        tx_bytes[actual_pos] |= 0x40;
     }
     // Continue to next position
     actual_pos = next_pos;
     /* Note: Expansion bytes are skipped in this version.
              They may be added later if required. */
              /* Append command */
-    m_req_primitive[actual_pos++] = Command;
+    tx_bytes[actual_pos++] = Command;
     /* Append byte count and data */
-    GetData(&m_req_primitive[actual_pos + 1], &payload_len);
-    m_req_primitive[actual_pos] = (TY_Byte)payload_len;
+    GetData(&tx_bytes[actual_pos + 1], &payload_len);
+    tx_bytes[actual_pos] = (TY_Byte)payload_len;
     // Move to next position
     actual_pos = (TY_Byte)(actual_pos + payload_len + 1);
     /* Insert Checksum */
-    for (e = start_chk_pos; e < actual_pos; e++)
-    {
-        chk ^= m_req_primitive[e];
-    }
+    chk = CCoding::CheckSum(&tx_bytes[start_chk_pos], (TY_Word)(actual_pos - start_chk_pos));
 
-    m_req_primitive[actual_pos++] = chk;
-    m_req_prim_len = actual_pos;
+    tx_bytes[actual_pos++] = chk;
+    m_tx_buffer->Len = actual_pos;
 }
 
 // Getting frame data
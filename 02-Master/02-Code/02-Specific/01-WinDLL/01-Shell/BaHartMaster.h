@@ -168,7 +168,19 @@ HARTDLL_API void    WINAPI BAHAMA_TerminateMonitor();
 HARTDLL_API void    WINAPI BAHAMA_StartMonitor();
 HARTDLL_API void    WINAPI BAHAMA_StopMonitor();
 HARTDLL_API EN_Bool WINAPI BAHAMA_GetMonitorData(TY_MonFrame* mon_frame);
+HARTDLL_API TY_Word WINAPI BAHAMA_GetMonitorFrames(TY_MonFrame* mon_frames, TY_Word max_frames);
+HARTDLL_API TY_DWord WINAPI BAHAMA_GetMonitorDropped(void);
 HARTDLL_API EN_Bit  WINAPI BAHAMA_GetMonitorStatus(void);
 HARTDLL_API TY_Word WINAPI BAHAMA_GetMonitorAddData(TY_Byte* data_);
+// Streaming of the monitor frames to pcapng files, ServeCapture is
+// called cyclically by the application instead of GetMonitorData
+HARTDLL_API EN_Bool WINAPI BAHAMA_StartCapture(const TY_Char* file_name, TY_DWord max_file_size, TY_DWord max_file_time);
+HARTDLL_API TY_DWord WINAPI BAHAMA_ServeCapture(void);
+HARTDLL_API void    WINAPI BAHAMA_StopCapture(void);
+// Offline analysis of a pcapng capture or a file of TY_MonFrame records
+HARTDLL_API EN_Bool WINAPI BAHAMA_ReplayCapture(const TY_Char* file_name);
+HARTDLL_API TY_Word WINAPI BAHAMA_GetReplayNumEntries(void);
+HARTDLL_API EN_Bool WINAPI BAHAMA_FetchReplayEntry(TY_Word index, TY_ReplayStats* stats);
+HARTDLL_API void    WINAPI BAHAMA_GetReplayTotal(TY_ReplayStats* stats);
 
 #endif // __bahartmaster76_h__
\ No newline at end of file
@@ -19,13 +19,23 @@
 #include "WinSystem.h"
 #include "HMuartProtocol.h"
 #include "HMuartLayer2.h"
+#include "HartChannel.h"
+#include "HartMasterIface.h"
 
-// Data
+// Methods
 
-CHMuartMacPort::EN_Status CHMuartMacPort::Status = CHMuartMacPort::EN_Status::IDLE;
-ST_RcvByte            CHMuartMacPort::m_loc_rcv_buf[MAX_TXRX_SIZE];
+CHMuartMacPort::CHMuartMacPort(CChannel* channel_)
+{
+    mo_channel = channel_;
+    mo_kernel = NULL;
+    mo_port = NULL;
+    Status = EN_Status::IDLE;
+}
 
-// Methods
+CHMuartMacPort::~CHMuartMacPort()
+{
+
+}
 
 void CHMuartMacPort::Execute(TY_Word time_ms_)
 {
@@ -39,21 +49,21 @@ void CHMuartMacPort::Execute(TY_Word time_ms_)
     switch (Status)
     {
     case EN_Status::IDLE:
-        to_do = CHMuartProtocol::EventHandler(CHMuartProtocol::EN_Event::NONE, NULL, 0);
+        to_do = mo_channel->UartProtocol.EventHandler(CHMuartProtocol::EN_Event::NONE, NULL, 0);
         break;
     case EN_Status::RECEIVING:
         len = CWinSys::CUart::Rx(MAX_TXRX_SIZE, m_loc_rcv_buf);
         if (len > 0)
         {
-            to_do = CHMuartProtocol::EventHandler(CHMuartProtocol::EN_Event::NEW_RCV_DATA, m_loc_rcv_buf, len);
+            to_do = mo_channel->UartProtocol.EventHandler(CHMuartProtocol::EN_Event::NEW_RCV_DATA, m_loc_rcv_buf, len);
         }
         else
         {
-            to_do = CHMuartProtocol::EventHandler(CHMuartProtocol::EN_Event::NONE, NULL, 0);
+            to_do = mo_channel->UartProtocol.EventHandler(CHMuartProtocol::EN_Event::NONE, NULL, 0);
         }
         break;
     case EN_Status::TRANSMITTING:
-        to_do = CHMuartProtocol::EventHandler(CHMuartProtocol::EN_Event::NONE, NULL, 0);
+        to_do = mo_channel->UartProtocol.EventHandler(CHMuartProtocol::EN_Event::NONE, NULL, 0);
         break;
     }
 
@@ -80,7 +90,7 @@ void CHMuartMacPort::Execute(TY_Word time_ms_)
     case EN_ToDo::SEND_REQUEST:
         {
         TY_Word tx_len;
-        TY_Byte* tx_data = CHMuartL2SM::GetTxData(&tx_len);
+        TY_Byte* tx_data = mo_channel->UartL2SM.GetTxData(&tx_len);
         CWinSys::CUart::Tx(tx_data, tx_len);
         }
     break;
@@ -109,6 +119,12 @@ EN_Bool CHMuartMacPort::Open(TY_Word port_, TY_DWord baudrate_, EN_CommType type
         return EN_Bool::FALSE8;
     }
 
+    if (mo_channel != CHartMaster::GetChannel(CHartMaster::DEFAULT_CHANNEL))
+    {
+        // The Windows kernel serves the default channel only
+        return EN_Bool::FALSE8;
+    }
+
     if (CWinSys::CUart::Open((TY_Byte)port_, baudrate_) == EN_Bool::TRUE8)
     {
         // Start the thread for the cyclic handler
@@ -127,6 +143,10 @@ void CHMuartMacPort::Close()
 
 void CHMuartMacPort::Init()
 {
-    CHMuartL2SM::Init();
+    mo_channel->UartL2SM.Init();
 }
 
+void CHMuartMacPort::WakeUp()
+{
+    // Nothing to do, the cyclic task polls every ms
+}
@@ -32,37 +32,7 @@
 #include "WbHartM_Structures.h"
 #include "Monitor.h"
 #include "HartChannel.h"
-
-// Data
-CHMipMacPort::EN_Status      CHMipMacPort::Status = CHMipMacPort::EN_Status::IDLE;
-TY_Byte                      CHMipMacPort::m_rcv_buf[MAX_IP_TXRX_SIZE];
-int                          CHMipMacPort::m_rcv_len = 0;
-TY_Byte                      CHMipMacPort::m_tx_buf[MAX_IP_TXRX_SIZE];
-int                          CHMipMacPort::m_tx_len = 0;
-TY_Byte                      CHMipMacPort::m_hart_ip_data[MAX_IP_TXRX_SIZE];
-TY_Word                      CHMipMacPort::m_hart_ip_len;
-CHMipMacPort::EN_LastError   CHMipMacPort::m_last_error = CHMipMacPort::EN_LastError::NONE;
-TY_Byte                      CHMipMacPort::m_rx_err = 0;
-CHMipMacPort::EN_HartIP_Info CHMipMacPort::m_last_hart_ip_info;
-CHMipMacPort::EN_ToDo        CHMipMacPort::m_to_do;
-EN_Bool                      CHMipMacPort::m_close_request = EN_Bool::FALSE8;
-TY_Byte                      CHMipMacPort::m_hart_rx_data[MAX_TXRX_SIZE];
-TY_Byte                      CHMipMacPort::m_hart_rx_len = 0;
-TY_Byte                      CHMipMacPort::m_hart_ip_version = 0;
-TY_Byte                      CHMipMacPort::m_hart_ip_message_type = 0;
-TY_Byte                      CHMipMacPort::m_hart_ip_message_id = 0;
-TY_Byte                      CHMipMacPort::m_hart_ip_comm_status = 0;
-TY_Word                      CHMipMacPort::m_hart_ip_request_seq_number;
-TY_Word                      CHMipMacPort::m_hart_ip_response_seq_number;
-TY_Word                      CHMipMacPort::m_hart_ip_burst_seq_number;
-TY_Word                      CHMipMacPort::m_hart_ip_nak_seq_number;
-TY_Word                      CHMipMacPort::m_hart_ip_received_seq_number;
-TY_Word                      CHMipMacPort::m_hart_ip_byte_count = 0;
-TY_Word                      CHMipMacPort::m_magic_number = 0xe0a3;
-TY_DWord                     CHMipMacPort::m_ms_counter = 0;
-                                                                    //   1, 60000
-TY_Byte                      CHMipMacPort::m_initiate_req_data[5] = { 0x01, 0x00, 0x09, 0x27, 0xc7 };
-
+#include "HartMasterIface.h"
 
 // WinSockets
 // Data
@@ -84,13 +54,57 @@ static int     s_keep_alive_req_header_len = 8;
 static TY_Byte                s_req_header[] = { MAX_VER, MSGTY_REQ, MSGID_PDU, 0x00, 0x00, 0x00, 0x00,  8 };
 static int                s_req_header_len = 8;
 
+CHMipMacPort::CHMipMacPort(CChannel* channel_)
+{
+    mo_channel = channel_;
+    mo_kernel = NULL;
+    mo_port = NULL;
+    Status = EN_Status::IDLE;
+    m_rcv_len = 0;
+    m_tx_len = 0;
+    m_hart_ip_len = 0;
+    m_last_error = EN_LastError::NONE;
+    m_rx_err = 0;
+    m_last_hart_ip_info = EN_HartIP_Info::NO_TRAFFIC;
+    m_to_do = EN_ToDo::NOTHING;
+    m_close_request = EN_Bool::FALSE8;
+    m_hart_rx_len = 0;
+    m_hart_ip_version = 0;
+    m_hart_ip_message_type = 0;
+    m_hart_ip_message_id = 0;
+    m_hart_ip_comm_status = 0;
+    m_hart_ip_request_seq_number = 0;
+    m_hart_ip_response_seq_number = 0;
+    m_hart_ip_burst_seq_number = 0;
+    m_hart_ip_nak_seq_number = 0;
+    m_hart_ip_received_seq_number = 0;
+    m_hart_ip_byte_count = 0;
+    m_magic_number = 0xe0a3;
+    m_ms_counter = 0;
+    //   1, 60000
+    m_initiate_req_data[0] = 0x01;
+    m_initiate_req_data[1] = 0x00;
+    m_initiate_req_data[2] = 0x09;
+    m_initiate_req_data[3] = 0x27;
+    m_initiate_req_data[4] = 0xc7;
+}
+CHMipMacPort::~CHMipMacPort()
+{
+
+}
 // Public Methods
 void CHMipMacPort::Init()
 {
-    CHMipL2SM::Init();
+    mo_channel->IpL2SM.Init();
 }
 EN_Bool CHMipMacPort::Open(TY_Byte* host_name_, TY_Byte* port_, EN_CommType type_)
 {
+    if (mo_channel != CHartMaster::GetChannel(CHartMaster::DEFAULT_CHANNEL))
+    {
+        // The Windows kernel serves the default channel only
+        return EN_Bool::FALSE8;
+    }
+
     // Start the thread for the cyclic handler
     Status = EN_Status::INITIALIZING;
     m_last_error = EN_LastError::NONE;
@@ -141,7 +155,7 @@ void CHMipMacPort::Execute(TY_Word time_ms_)
         // Do nothing
         break;
     case EN_Status::INITIALIZING:
-        CHMipL2SM::Init();
+        mo_channel->IpL2SM.Init();
         if (InitializeSocketHandler() == EN_Bool::TRUE8)
         {
             Status = EN_Status::WAIT_CONNECT;
@@ -184,7 +198,7 @@ void CHMipMacPort::Execute(TY_Word time_ms_)
             else if (m_ms_counter >= 5000)
             {
                 m_ms_counter = 0;
-                if (CChannel::HartIpSendKeepAlive == EN_Bool::TRUE8)
+                if (mo_channel->HartIpSendKeepAlive == EN_Bool::TRUE8)
                 {
                     Status = SendKeepAliveRequest();
                 }
@@ -322,6 +336,10 @@ TY_Word CHMipMacPort::GetPayloadData(TY_Byte* data_)
     COSAL::CMem::Copy(data_, m_hart_ip_data, m_hart_ip_len);
     return m_hart_ip_len;
 }
+void CHMipMacPort::WakeUp()
+{
+    // Nothing to do, the cyclic task polls every ms
+}
 // Private Methods
 EN_Bool CHMipMacPort::InitializeSocketHandler()
 {
@@ -346,13 +364,13 @@ EN_Bool CHMipMacPort::InitializeSocketHandler()
         so_addrinfo.ai_protocol = IPPROTO_TCP;
 
         // Resolve the server address and port
-        if (CChannel::HartIpUseAddress == EN_Bool::TRUE8)
+        if (mo_channel->HartIpUseAddress == EN_Bool::TRUE8)
         {
-            result = getaddrinfo((const char*)CChannel::HartIpAddress, (const char*)CChannel::HartIpPort, &so_addrinfo, &so_result);
+            result = getaddrinfo((const char*)mo_channel->HartIpAddress, (const char*)mo_channel->HartIpPort, &so_addrinfo, &so_result);
         }
         else
         {
-            result = getaddrinfo((const char*)CChannel::HartIpHostName, (const char*)CChannel::HartIpPort, &so_addrinfo, &so_result);
+            result = getaddrinfo((const char*)mo_channel->HartIpHostName, (const char*)mo_channel->HartIpPort, &so_addrinfo, &so_result);
         }
 
         if (result != 0)
@@ -483,7 +501,7 @@ CHMipMacPort::EN_Status CHMipMacPort::SendCommandRequest()
     TY_Word payload_len = 0;
 
 
-    TY_Byte* tx_data = CHMipL2SM::GetTxData(&tx_len);
+    TY_Byte* tx_data = mo_channel->IpL2SM.GetTxData(&tx_len);
     // Find delimiter
     for (TY_Word i = 0; i < tx_len; i++)
     {
@@ -508,7 +526,7 @@ CHMipMacPort::EN_Status CHMipMacPort::SendCommandRequest()
     payload_len = payload_len + 8;
     m_tx_buf[6] = (TY_Byte)(payload_len >> 8);
     m_tx_buf[7] = (TY_Byte)(payload_len);
-    CMonitor::SetAdditionalData(m_tx_buf, m_tx_len);
+    mo_channel->Monitor.SetAdditionalData(m_tx_buf, m_tx_len);
     // Send the paket
     result = send(so_server_socket, (const char*)m_tx_buf, m_tx_len, 0);
     SignalHartTxDone();
@@ -533,7 +551,7 @@ void CHMipMacPort::AcceptCommandResponse()
     m_hart_rx_len = (TY_Byte)(m_rcv_len - HART_IP_HEADER_LEN);
     COSAL::CMem::Copy(m_hart_rx_data, &m_rcv_buf[HART_IP_HEADER_LEN], m_hart_rx_len);
     // Call the protocol state machine
-    CHMipMacPort::EN_ToDo todo = CHMipProtocol::EventHandler(CHMipProtocol::EN_Event::HART_IP_DATA_RECEIVED, m_hart_rx_data, m_hart_rx_len);
+    CHMipMacPort::EN_ToDo todo = mo_channel->IpProtocol.EventHandler(CHMipProtocol::EN_Event::HART_IP_DATA_RECEIVED, m_hart_rx_data, m_hart_rx_len);
 }
 void CHMipMacPort::RejectCommandResponse()
 {
@@ -549,7 +567,7 @@ void CHMipMacPort::RejectCommandResponse()
     m_hart_rx_len = (TY_Byte)(m_rcv_len - HART_IP_HEADER_LEN);
     COSAL::CMem::Copy(m_hart_rx_data, &m_rcv_buf[HART_IP_HEADER_LEN], m_hart_rx_len);
     // Call the protocol state machine
-    CHMipMacPort::EN_ToDo todo = CHMipProtocol::EventHandler(CHMipProtocol::EN_Event::REQUEST_REJECTED, m_hart_rx_data, m_hart_rx_len);
+    CHMipMacPort::EN_ToDo todo = mo_channel->IpProtocol.EventHandler(CHMipProtocol::EN_Event::REQUEST_REJECTED, m_hart_rx_data, m_hart_rx_len);
 }
 void CHMipMacPort::AcceptHartBurst()
 {
@@ -572,7 +590,7 @@ void CHMipMacPort::AcceptHartBurst()
     m_hart_rx_len = (TY_Byte)(m_rcv_len - HART_IP_HEADER_LEN);
     COSAL::CMem::Copy(m_hart_rx_data, &m_rcv_buf[HART_IP_HEADER_LEN], m_hart_rx_len);
     // Call the protocol state machine
-    CHMipMacPort::EN_ToDo todo = CHMipProtocol::EventHandler(CHMipProtocol::EN_Event::HART_IP_DATA_RECEIVED, m_hart_rx_data, m_hart_rx_len);
+    CHMipMacPort::EN_ToDo todo = mo_channel->IpProtocol.EventHandler(CHMipProtocol::EN_Event::HART_IP_DATA_RECEIVED, m_hart_rx_data, m_hart_rx_len);
 
     return;
 }
@@ -717,22 +735,22 @@ CHMipMacPort::EN_ToDo CHMipMacPort::SignalHartPDUreceiving()
 {
     AcceptCommandResponse();
     // Call the protocol state machine
-    CHMipMacPort::EN_ToDo todo = CHMipProtocol::EventHandler(CHMipProtocol::EN_Event::HART_IP_DATA_RECEIVED, m_hart_rx_data, m_hart_rx_len);
+    CHMipMacPort::EN_ToDo todo = mo_channel->IpProtocol.EventHandler(CHMipProtocol::EN_Event::HART_IP_DATA_RECEIVED, m_hart_rx_data, m_hart_rx_len);
     return todo;
 }
 CHMipMacPort::EN_ToDo CHMipMacPort::SignalHartSilence()
 {
-    CHMipMacPort::EN_ToDo todo = CHMipProtocol::EventHandler(CHMipProtocol::EN_Event::SILENCE_DETECTED, m_hart_rx_data, m_hart_rx_len);
+    CHMipMacPort::EN_ToDo todo = mo_channel->IpProtocol.EventHandler(CHMipProtocol::EN_Event::SILENCE_DETECTED, m_hart_rx_data, m_hart_rx_len);
 
     return todo;
 }
 void CHMipMacPort::SignalHartTxDone()
 {
-    CHMipProtocol::EventHandler(CHMipProtocol::EN_Event::HART_IP_TX_DONE, NULL, NULL);
+    mo_channel->IpProtocol.EventHandler(CHMipProtocol::EN_Event::HART_IP_TX_DONE, NULL, NULL);
 }
 void CHMipMacPort::SignalNetworkError()
 {
-    CHMipProtocol::EventHandler(CHMipProtocol::EN_Event::NETWORK_ERROR, NULL, NULL);
+    mo_channel->IpProtocol.EventHandler(CHMipProtocol::EN_Event::NETWORK_ERROR, NULL, NULL);
 }
 CHMipMacPort::EN_Status CHMipMacPort::TerminateConnection(EN_LastError last_err_)
 {
@@ -0,0 +1,193 @@
+/*
+ *          File: HMloopMacPort.cpp (CHMloopMacPort)
+ *                The Execute method is called directly by the fast cyclic
+ *                handler, just like the one of the uart. Instead of a com
+ *                port the octets are exchanged with the virtual wire.
+ *
+ *        Author: Walter Borst
+ *
+ *        E-Mail: info@borst-automation.de
+ *          Home: https://www.borst-automation.de
+ *
+ * No Warranties: https://www.borst-automation.com/legal/warranty-disclaimer
+ *
+ * Copyright 2006-2025 Walter Borst, Cuxhaven, Germany
+ */
+
+#include "HMloopMacPort.h"
+#include "WinSystem.h"
+#include "HMuartProtocol.h"
+#include "HMuartLayer2.h"
+#include "HartChannel.h"
+#include "HartMasterIface.h"
+
+// Methods
+
+CHMloopMacPort::CHMloopMacPort(CChannel* channel_)
+{
+    mo_channel = channel_;
+    mo_kernel = NULL;
+    m_carrier_on = EN_Bool::FALSE8;
+    m_num_tick_waits = 0;
+    m_arrival_timer.InitNoneStatic();
+    Status = CHMuartMacPort::EN_Status::IDLE;
+}
+
+CHMloopMacPort::~CHMloopMacPort()
+{
+
+}
+
+void CHMloopMacPort::Execute(TY_Word time_ms_)
+{
+    // Note: This procedure is called every ms as long as the channel is open
+
+    EN_Bool is_active;
+
+    COSAL::CTimer::UpdateTime(time_ms_);
+
+    is_active = Step();
+    if (m_wire.IsFullSpeed() == EN_Bool::TRUE8)
+    {
+        // Nothing to wait for on the wire, the state machines are
+        // continued at once and the timers which hold a request
+        // back expire right away, until the request is done
+        for (TY_Byte e = 1; e < MAX_PASSES; e++)
+        {
+            if ((is_active == EN_Bool::FALSE8) && (ExpireTimers() == EN_Bool::FALSE8))
+            {
+                break;
+            }
+            is_active = Step();
+        }
+
+        if (mo_channel->UartL2SM.IsMsgPending() == EN_Bool::TRUE8)
+        {
+            m_num_tick_waits++;
+        }
+    }
+}
+
+EN_Bool CHMloopMacPort::Step()
+{
+    CHMuartMacPort::EN_ToDo to_do = CHMuartMacPort::EN_ToDo::NOTHING;
+    TY_Len                   len = 0;
+
+    switch (Status)
+    {
+    case CHMuartMacPort::EN_Status::IDLE:
+        to_do = mo_channel->UartProtocol.EventHandler(CHMuartProtocol::EN_Event::NONE, NULL, 0);
+        break;
+    case CHMuartMacPort::EN_Status::RECEIVING:
+        len = m_wire.Receive(MAX_TXRX_SIZE, m_loc_rcv_buf, COSAL::CTimer::GetTime());
+        if (len > 0)
+        {
+            to_do = mo_channel->UartProtocol.EventHandler(CHMuartProtocol::EN_Event::NEW_RCV_DATA, m_loc_rcv_buf, len);
+        }
+        else
+        {
+            to_do = mo_channel->UartProtocol.EventHandler(CHMuartProtocol::EN_Event::NONE, NULL, 0);
+        }
+        break;
+    case CHMuartMacPort::EN_Status::TRANSMITTING:
+        to_do = mo_channel->UartProtocol.EventHandler(CHMuartProtocol::EN_Event::NONE, NULL, 0);
+        break;
+    }
+
+    switch (to_do)
+    {
+    case CHMuartMacPort::EN_ToDo::NOTHING:
+        break;
+    case CHMuartMacPort::EN_ToDo::CARRIER_ON:
+        if (m_carrier_on == EN_Bool::FALSE8)
+        {
+            m_carrier_on = EN_Bool::TRUE8;
+            Status = CHMuartMacPort::EN_Status::TRANSMITTING;
+        }
+        break;
+    case CHMuartMacPort::EN_ToDo::CARRIER_OFF:
+        m_carrier_on = EN_Bool::FALSE8;
+        Status = CHMuartMacPort::EN_Status::IDLE;
+        break;
+    case CHMuartMacPort::EN_ToDo::SEND_REQUEST:
+        {
+        TY_Word tx_len;
+        TY_Byte* tx_data = mo_channel->UartL2SM.GetTxData(&tx_len);
+        m_wire.Transmit(tx_data, tx_len, COSAL::CTimer::GetTime());
+        }
+    break;
+    case CHMuartMacPort::EN_ToDo::RECEIVE_ENABLE:
+        if (Status != CHMuartMacPort::EN_Status::RECEIVING)
+        {
+            m_carrier_on = EN_Bool::FALSE8;
+            Status = CHMuartMacPort::EN_Status::RECEIVING;
+        }
+        break;
+    case CHMuartMacPort::EN_ToDo::RECEIVE_DISABLE:
+        Status = CHMuartMacPort::EN_Status::IDLE;
+        break;
+    }
+
+    if ((len > 0) || (to_do != CHMuartMacPort::EN_ToDo::NOTHING))
+    {
+        return EN_Bool::TRUE8;
+    }
+
+    return EN_Bool::FALSE8;
+}
+
+EN_Bool CHMloopMacPort::ExpireTimers()
+{
+    if (mo_channel->UartL2TxSM.GetStatus() == CHMuartL2TxSM::EN_Status::WAIT_TX_END)
+    {
+        mo_channel->UartL2TxSM.ExpireTimer();
+        return EN_Bool::TRUE8;
+    }
+
+    if (mo_channel->UartL2SM.IsMsgPending() == EN_Bool::TRUE8)
+    {
+        // Bus times (RT1, RT2, HOLD) or the time out of a response
+        // which is not on the wire, i.e. will never come
+        mo_channel->UartL2SM.ExpireTimer();
+        return EN_Bool::TRUE8;
+    }
+
+    return EN_Bool::FALSE8;
+}
+
+EN_Bool CHMloopMacPort::Open(TY_LoopbackConfig* config_, TY_DWord baudrate_)
+{
+    if (mo_channel != CHartMaster::GetChannel(CHartMaster::DEFAULT_CHANNEL))
+    {
+        // The Windows kernel serves the default channel only
+        return EN_Bool::FALSE8;
+    }
+
+    m_wire.Open(config_, baudrate_);
+    m_carrier_on = EN_Bool::FALSE8;
+    Status = CHMuartMacPort::EN_Status::IDLE;
+    // Start the thread for the cyclic handler
+    CWinSys::CyclicTaskStart();
+    return EN_Bool::TRUE8;
+}
+
+void CHMloopMacPort::Close()
+{
+    CWinSys::CyclicTaskTerminate();
+    m_wire.Clear();
+}
+
+void CHMloopMacPort::Init()
+{
+    mo_channel->UartL2SM.Init();
+}
+
+void CHMloopMacPort::WakeUp()
+{
+    // Nothing to do, the cyclic task polls every ms
+}
+
+TY_DWord CHMloopMacPort::GetNumTickWaits()
+{
+    return m_num_tick_waits;
+}
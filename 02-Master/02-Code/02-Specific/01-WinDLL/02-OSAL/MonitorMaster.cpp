@@ -26,40 +26,91 @@
 #include <minwindef.h>
 #include "BaHartMaster.h"
 #include "Monitor.h"
+#include "MonitorCapture.h"
+#include "HartReplay.h"
+
+// Capture of the monitor frames to pcapng files
+static CMonitorCapture capture;
+// Offline analysis of a capture
+static CReplay replay;
 
 // Windows specific part
 HARTDLL_API void WINAPI BAHAMA_InitMonitor()
 {
-    CMonitor::Init();
+    CHartMaster::GetChannel(CHartMaster::DEFAULT_CHANNEL)->Monitor.Init();
 }
 
 HARTDLL_API void WINAPI BAHAMA_TerminateMonitor()
 {
-    CMonitor::Terminate();
+    CHartMaster::GetChannel(CHartMaster::DEFAULT_CHANNEL)->Monitor.Terminate();
 }
 
 HARTDLL_API void WINAPI BAHAMA_StartMonitor()
 {
-    CMonitor::Start();
+    CHartMaster::GetChannel(CHartMaster::DEFAULT_CHANNEL)->Monitor.Start();
 }
 
 HARTDLL_API void WINAPI BAHAMA_StopMonitor()
 {
-    CMonitor::Stop();
+    CHartMaster::GetChannel(CHartMaster::DEFAULT_CHANNEL)->Monitor.Stop();
 }
 
 HARTDLL_API EN_Bool WINAPI BAHAMA_GetMonitorData(TY_MonFrame* mon_frame_)
 {
-    return CMonitor::GetData(mon_frame_);
+    return CHartMaster::GetChannel(CHartMaster::DEFAULT_CHANNEL)->Monitor.GetData(mon_frame_);
+}
+
+HARTDLL_API TY_Word WINAPI BAHAMA_GetMonitorFrames(TY_MonFrame* mon_frames_, TY_Word max_frames_)
+{
+    return CHartMaster::GetChannel(CHartMaster::DEFAULT_CHANNEL)->Monitor.GetData(mon_frames_, max_frames_);
+}
+
+HARTDLL_API TY_DWord WINAPI BAHAMA_GetMonitorDropped(void)
+{
+    return CHartMaster::GetChannel(CHartMaster::DEFAULT_CHANNEL)->Monitor.GetNumDropped();
 }
 
 HARTDLL_API EN_Bit WINAPI BAHAMA_GetMonitorStatus(void)
 {
-    return CMonitor::GetStatus();
+    return CHartMaster::GetChannel(CHartMaster::DEFAULT_CHANNEL)->Monitor.GetStatus();
 }
 
 HARTDLL_API TY_Word WINAPI BAHAMA_GetMonitorAddData(TY_Byte* data_)
 {
-    return CMonitor::GetPayloadData(data_);
+    return CHartMaster::GetChannel(CHartMaster::DEFAULT_CHANNEL)->Monitor.GetPayloadData(data_);
 }
 
+HARTDLL_API EN_Bool WINAPI BAHAMA_StartCapture(const TY_Char* file_name_, TY_DWord max_file_size_, TY_DWord max_file_time_)
+{
+    return capture.Open(file_name_, max_file_size_, max_file_time_);
+}
+
+HARTDLL_API TY_DWord WINAPI BAHAMA_ServeCapture(void)
+{
+    return capture.Serve(&CHartMaster::GetChannel(CHartMaster::DEFAULT_CHANNEL)->Monitor);
+}
+
+HARTDLL_API void WINAPI BAHAMA_StopCapture(void)
+{
+    capture.Close();
+}
+
+HARTDLL_API EN_Bool WINAPI BAHAMA_ReplayCapture(const TY_Char* file_name_)
+{
+    return replay.Run(file_name_);
+}
+
+HARTDLL_API TY_Word WINAPI BAHAMA_GetReplayNumEntries(void)
+{
+    return replay.GetNumEntries();
+}
+
+HARTDLL_API EN_Bool WINAPI BAHAMA_FetchReplayEntry(TY_Word index_, TY_ReplayStats* stats_)
+{
+    return replay.FetchEntry(index_, stats_);
+}
+
+HARTDLL_API void WINAPI BAHAMA_GetReplayTotal(TY_ReplayStats* stats_)
+{
+    replay.GetTotal(stats_);
+}
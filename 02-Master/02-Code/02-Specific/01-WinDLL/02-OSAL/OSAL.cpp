@@ -29,6 +29,21 @@ typedef struct st_ComPortData
     EN_Bool          carr_on;
 } ST_ComPortData;
 
+typedef struct st_SignalData
+{
+    CRITICAL_SECTION      Lock;
+    CONDITION_VARIABLE    Cond;
+    TY_DWord              Count;
+    HANDLE                Event;
+} ST_SignalData;
+
+typedef struct st_FileMapData
+{
+    HANDLE                Mapping;
+    TY_Byte*              Data;
+    TY_UInt64             Size;
+} ST_FileMapData;
+
 COSAL::CLock m_lock;
 
 COSAL::CLock::CLock()
@@ -66,6 +81,213 @@ void COSAL::CLock::Unlock()
     }
 }
 
+COSAL::CSignal::CSignal()
+{
+    ST_SignalData* data = (ST_SignalData*)malloc(sizeof(ST_SignalData));
+
+    m_signal_data = data;
+    if (data != NULL)
+    {
+        InitializeCriticalSection(&data->Lock);
+        InitializeConditionVariable(&data->Cond);
+        data->Count = 0;
+        // Auto reset, a successful wait consumes the signal
+        data->Event = CreateEvent(NULL, FALSE, FALSE, NULL);
+    }
+}
+
+COSAL::CSignal::~CSignal()
+{
+    ST_SignalData* data = (ST_SignalData*)m_signal_data;
+
+    if (data != NULL)
+    {
+        if (data->Event != NULL)
+        {
+            CloseHandle(data->Event);
+        }
+
+        DeleteCriticalSection(&data->Lock);
+        free(data);
+    }
+}
+
+void COSAL::CSignal::Set()
+{
+    ST_SignalData* data = (ST_SignalData*)m_signal_data;
+
+    if (data == NULL)
+    {
+        return;
+    }
+
+    EnterCriticalSection(&data->Lock);
+    data->Count++;
+    WakeAllConditionVariable(&data->Cond);
+    LeaveCriticalSection(&data->Lock);
+    if (data->Event != NULL)
+    {
+        SetEvent(data->Event);
+    }
+}
+
+TY_DWord COSAL::CSignal::GetCount()
+{
+    ST_SignalData* data = (ST_SignalData*)m_signal_data;
+    TY_DWord       count;
+
+    if (data == NULL)
+    {
+        return 0;
+    }
+
+    EnterCriticalSection(&data->Lock);
+    count = data->Count;
+    LeaveCriticalSection(&data->Lock);
+    return count;
+}
+
+EN_Bool COSAL::CSignal::Wait(TY_DWord count_, TY_DWord timeout_ms_)
+{
+    ST_SignalData* data = (ST_SignalData*)m_signal_data;
+    ULONGLONG      deadline = GetTickCount64() + timeout_ms_;
+    ULONGLONG      now;
+    EN_Bool        result = EN_Bool::TRUE8;
+
+    if (data == NULL)
+    {
+        return EN_Bool::FALSE8;
+    }
+
+    EnterCriticalSection(&data->Lock);
+    while (data->Count == count_)
+    {
+        now = GetTickCount64();
+        if (now >= deadline)
+        {
+            result = EN_Bool::FALSE8;
+            break;
+        }
+
+        SleepConditionVariableCS(&data->Cond, &data->Lock, (DWORD)(deadline - now));
+    }
+    LeaveCriticalSection(&data->Lock);
+    return result;
+}
+
+PTR_Handle COSAL::CSignal::GetWaitHandle()
+{
+    ST_SignalData* data = (ST_SignalData*)m_signal_data;
+
+    if (data == NULL)
+    {
+        return NULL;
+    }
+
+    return (PTR_Handle)data->Event;
+}
+
+COSAL::CFileMap::CFileMap()
+{
+    ST_FileMapData* data = (ST_FileMapData*)malloc(sizeof(ST_FileMapData));
+
+    m_map_data = data;
+    if (data != NULL)
+    {
+        data->Mapping = NULL;
+        data->Data = NULL;
+        data->Size = 0;
+    }
+}
+
+COSAL::CFileMap::~CFileMap()
+{
+    Close();
+    free(m_map_data);
+}
+
+EN_Bool COSAL::CFileMap::Open(const TY_Char* file_name_)
+{
+    ST_FileMapData* data = (ST_FileMapData*)m_map_data;
+    LARGE_INTEGER   size;
+    HANDLE          file;
+
+    if (data == NULL)
+    {
+        return EN_Bool::FALSE8;
+    }
+
+    Close();
+    file = CreateFileA(file_name_, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return EN_Bool::FALSE8;
+    }
+
+    if ((GetFileSizeEx(file, &size) == FALSE) || (size.QuadPart <= 0))
+    {
+        CloseHandle(file);
+        return EN_Bool::FALSE8;
+    }
+
+    // The mapping holds a reference to the file
+    data->Mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file);
+    if (data->Mapping == NULL)
+    {
+        return EN_Bool::FALSE8;
+    }
+
+    data->Data = (TY_Byte*)MapViewOfFile(data->Mapping, FILE_MAP_READ, 0, 0, 0);
+    if (data->Data == NULL)
+    {
+        CloseHandle(data->Mapping);
+        data->Mapping = NULL;
+        return EN_Bool::FALSE8;
+    }
+
+    data->Size = (TY_UInt64)size.QuadPart;
+    return EN_Bool::TRUE8;
+}
+
+void COSAL::CFileMap::Close()
+{
+    ST_FileMapData* data = (ST_FileMapData*)m_map_data;
+
+    if (data == NULL)
+    {
+        return;
+    }
+
+    if (data->Data != NULL)
+    {
+        UnmapViewOfFile(data->Data);
+        data->Data = NULL;
+        data->Size = 0;
+    }
+
+    if (data->Mapping != NULL)
+    {
+        CloseHandle(data->Mapping);
+        data->Mapping = NULL;
+    }
+}
+
+const TY_Byte* COSAL::CFileMap::GetData()
+{
+    ST_FileMapData* data = (ST_FileMapData*)m_map_data;
+
+    return (data != NULL) ? data->Data : NULL;
+}
+
+TY_UInt64 COSAL::CFileMap::GetSize()
+{
+    ST_FileMapData* data = (ST_FileMapData*)m_map_data;
+
+    return (data != NULL) ? data->Size : 0;
+}
+
 void COSAL::Init(void)
 {
 
@@ -81,16 +303,41 @@ void COSAL::Wait(TY_DWord time_)
     Sleep(time_);
 }
 
+// Depth of the lock held by the calling thread
+static thread_local TY_Word s_lock_depth = 0;
+
 void COSAL::Lock()
 {
     m_lock.Lock();
+    s_lock_depth++;
 }
 
 void COSAL::Unlock()
 {
+    s_lock_depth--;
     m_lock.Unlock();
 }
 
+TY_Word COSAL::ReleaseLock()
+{
+    TY_Word depth = s_lock_depth;
+
+    for (TY_Word e = 0; e < depth; e++)
+    {
+        Unlock();
+    }
+
+    return depth;
+}
+
+void COSAL::RestoreLock(TY_Word depth_)
+{
+    for (TY_Word e = 0; e < depth_; e++)
+    {
+        Lock();
+    }
+}
+
 inline bool COSAL::IsInvalidIntHandle(WRD_Handle handle_)
 {
     if (handle_ == INVALID_WRD_HANDLE)
@@ -199,6 +446,13 @@ void COSAL::CTimer::Stop()
     m_active = EN_Bool::FALSE8;
 }
 
+void COSAL::CTimer::Expire()
+{
+    m_locked = EN_Bool::TRUE8;
+    m_start_time = COSAL::CTimer::GetTime() - m_time_limit - 1;
+    m_locked = EN_Bool::FALSE8;
+}
+
 EN_Bool COSAL::CTimer::IsExpired()
 {
     TY_DWord current_time = COSAL::CTimer::GetTime();
@@ -520,14 +520,7 @@ void CHartMaster::FastCyclicHandler(TY_Word time_ms_)
 #endif // DEBUG_TIMING
 
     // Call the Hart master protocol handler
-    if (CChannel::GetCommType() == EN_CommType::HART_IP)
-    {
-        CHMipMacPort::Execute(time_ms_);
-    }
-    else
-    {
-        CHMuartMacPort::Execute(time_ms_);
-    }
+    CHartMaster::GetChannel(CHartMaster::DEFAULT_CHANNEL)->Execute(time_ms_);
     /// Test
     //if (time_ms_ > 3)
     //{
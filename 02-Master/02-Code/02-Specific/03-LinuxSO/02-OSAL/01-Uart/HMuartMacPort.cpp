@@ -0,0 +1,171 @@
+/*
+ *          File: HMuartMacPort.cpp (CHMuartMacPort)
+ *                The Execute method is called directly by the fast cyclic
+ *                handler. This basically drives all status machines in
+ *                the Hart implementation. Here too, the method is divided
+ *                into an Event handler and a ToDo handler.
+ *
+ *        Author: Walter Borst
+ *
+ *        E-Mail: info@borst-automation.de
+ *          Home: https://www.borst-automation.de
+ *
+ * No Warranties: https://www.borst-automation.com/legal/warranty-disclaimer
+ *
+ * Copyright 2006-2025 Walter Borst, Cuxhaven, Germany
+ */
+
+#include "HMuartMacPort.h"
+#include "LinuxSystem.h"
+#include "HMuartProtocol.h"
+#include "HMuartLayer2.h"
+#include "HartChannel.h"
+
+// Methods
+
+CHMuartMacPort::CHMuartMacPort(CChannel* channel_)
+{
+    mo_channel = channel_;
+    mo_kernel = NULL;
+    mo_port = NULL;
+    Status = EN_Status::IDLE;
+}
+
+CHMuartMacPort::~CHMuartMacPort()
+{
+    Close();
+}
+
+void CHMuartMacPort::Execute(TY_Word time_ms_)
+{
+    // Note: This procedure is called whenever the kernel thread
+    // wakes up, i.e. on received data, on requests of the
+    // application and when the next timer expires
+
+    CHMuartMacPort::EN_ToDo to_do = CHMuartMacPort::EN_ToDo::NOTHING;
+    TY_Len                 len = 0;
+
+    switch (Status)
+    {
+    case EN_Status::IDLE:
+        to_do = mo_channel->UartProtocol.EventHandler(CHMuartProtocol::EN_Event::NONE, NULL, 0);
+        break;
+    case EN_Status::RECEIVING:
+        len = CLinuxSys::CUart::Rx(mo_port, MAX_TXRX_SIZE, m_loc_rcv_buf);
+        if (len > 0)
+        {
+            to_do = mo_channel->UartProtocol.EventHandler(CHMuartProtocol::EN_Event::NEW_RCV_DATA, m_loc_rcv_buf, len);
+        }
+        else
+        {
+            to_do = mo_channel->UartProtocol.EventHandler(CHMuartProtocol::EN_Event::NONE, NULL, 0);
+        }
+        break;
+    case EN_Status::TRANSMITTING:
+        to_do = mo_channel->UartProtocol.EventHandler(CHMuartProtocol::EN_Event::NONE, NULL, 0);
+        break;
+    }
+
+    if ((len > 0) || (to_do != EN_ToDo::NOTHING))
+    {
+        // Something is going on, the state machines
+        // are continued in the next cycle
+        CLinuxSys::RequestCycle();
+    }
+
+    switch (to_do)
+    {
+    case EN_ToDo::NOTHING:
+        break;
+    case EN_ToDo::CARRIER_ON:
+        if (CLinuxSys::CUart::IsCarrierOn(mo_port) == EN_Bool::FALSE8)
+        {
+            CLinuxSys::CUart::SetCarrierOn(mo_port);
+            Status = EN_Status::TRANSMITTING;
+            COSAL::Wait(1);
+        }
+        break;
+    case EN_ToDo::CARRIER_OFF:
+        if (CLinuxSys::CUart::IsCarrierOn(mo_port) == EN_Bool::TRUE8)
+        {
+            CLinuxSys::CUart::SetCarrierOff(mo_port);
+        }
+
+        Status = EN_Status::IDLE;
+        break;
+    case EN_ToDo::SEND_REQUEST:
+        {
+        TY_Word tx_len;
+        TY_Byte* tx_data = mo_channel->UartL2SM.GetTxData(&tx_len);
+        CLinuxSys::CUart::Tx(mo_port, tx_data, tx_len);
+        }
+    break;
+    case EN_ToDo::RECEIVE_ENABLE:
+        if (Status != EN_Status::RECEIVING)
+        {
+            if (CLinuxSys::CUart::IsCarrierOn(mo_port) == EN_Bool::TRUE8)
+            {
+                CLinuxSys::CUart::SetCarrierOff(mo_port);
+            }
+
+            Status = EN_Status::RECEIVING;
+        }
+        break;
+    case EN_ToDo::RECEIVE_DISABLE:
+        Status = EN_Status::IDLE;
+        break;
+    }
+}
+
+EN_Bool CHMuartMacPort::Open(TY_Word port_, TY_DWord baudrate_, EN_CommType type_)
+{
+    if ((port_ == 0) || (port_ > 254))
+    {
+        // Only port numbers in the range 1..254 are supported
+        return EN_Bool::FALSE8;
+    }
+
+    // The channel is served by one of the kernel threads
+    mo_kernel = CLinuxSys::AcquireKernel();
+    if (mo_kernel == NULL)
+    {
+        return EN_Bool::FALSE8;
+    }
+
+    mo_port = CLinuxSys::CUart::Open((TY_Byte)port_, baudrate_, mo_kernel);
+    if (mo_port == NULL)
+    {
+        CLinuxSys::ReleaseKernel(mo_kernel);
+        mo_kernel = NULL;
+        return EN_Bool::FALSE8;
+    }
+
+    Status = EN_Status::IDLE;
+    CLinuxSys::AttachChannel(mo_kernel, mo_channel);
+    return EN_Bool::TRUE8;
+}
+
+void CHMuartMacPort::Close()
+{
+    if (mo_kernel == NULL)
+    {
+        return;
+    }
+
+    CLinuxSys::DetachChannel(mo_kernel, mo_channel);
+    CLinuxSys::CUart::Close(mo_port);
+    CLinuxSys::ReleaseKernel(mo_kernel);
+    mo_port = NULL;
+    mo_kernel = NULL;
+}
+
+void CHMuartMacPort::Init()
+{
+    mo_channel->UartL2SM.Init();
+}
+
+void CHMuartMacPort::WakeUp()
+{
+    CLinuxSys::WakeUp(mo_kernel);
+}
+
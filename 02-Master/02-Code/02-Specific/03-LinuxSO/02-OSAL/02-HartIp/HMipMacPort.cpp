@@ -0,0 +1,829 @@
+/*
+ *          File: HMipMacPort.cpp (CHMipMacPort)
+ *                The Execute method is called directly by the fast cyclic
+ *                handler. This basically drives all status machines in
+ *                the Hart implementation. Here too, the method is divided
+ *                into an Event handler and a ToDo handler.
+ *
+ *        Author: Walter Borst
+ *
+ *        E-Mail: info@borst-automation.de
+ *          Home: https://www.borst-automation.de
+ *
+ * No Warranties: https://www.borst-automation.com/legal/warranty-disclaimer
+ *
+ * Copyright 2006-2025 Walter Borst, Cuxhaven, Germany
+ */
+
+// Sockets
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netdb.h>
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+#include <new>
+#define INVALID_SOCKET (-1)
+#define SOCKET_ERROR   (-1)
+// End Sockets
+#include "LinuxSystem.h"
+#include "WbHartUser.h"
+#include "HMipMacPort.h"
+#include "HMipProtocol.h"
+#include "HMipLayer2.h"
+#include "WbHartM_Structures.h"
+#include "Monitor.h"
+#include "HartChannel.h"
+
+// Sockets
+// Data of a connection
+typedef struct st_IpPortData
+{
+    addrinfo*       Result;
+    addrinfo*          Ptr;
+    addrinfo      AddrInfo;
+    int       ServerSocket;
+    int       ListenSocket;
+} ST_IpPortData;
+
+// Hart Ip
+                                              // Ver      Type       ID         Stat  Sequence    ByteCount
+static TY_Byte        s_intiate_req_header[] = { MAX_VER, MSGTY_REQ, MSGID_INI, 0x00, 0x00, 0x00, 0x00, 13 };
+static int       s_initiate_req_header_len = 8;
+static TY_Byte          s_close_req_header[] = { MAX_VER, MSGTY_REQ, MSGID_CLS, 0x00, 0x00, 0x00, 0x00,  8 };
+static int          s_close_req_header_len = 8;
+static TY_Byte     s_keep_alive_req_header[] = { MAX_VER, MSGTY_REQ, MSGID_ALI, 0x00, 0x00, 0x00, 0x00,  8 };
+static int     s_keep_alive_req_header_len = 8;
+static TY_Byte                s_req_header[] = { MAX_VER, MSGTY_REQ, MSGID_PDU, 0x00, 0x00, 0x00, 0x00,  8 };
+static int                s_req_header_len = 8;
+
+// Construction
+CHMipMacPort::CHMipMacPort(CChannel* channel_)
+{
+    ST_IpPortData* port = new (std::nothrow) ST_IpPortData();
+
+    if (port != NULL)
+    {
+        port->Result = NULL;
+        port->Ptr = NULL;
+        port->ServerSocket = INVALID_SOCKET;
+        port->ListenSocket = INVALID_SOCKET;
+    }
+
+    mo_channel = channel_;
+    mo_kernel = NULL;
+    mo_port = port;
+    Status = EN_Status::IDLE;
+    m_rcv_len = 0;
+    m_tx_len = 0;
+    m_hart_ip_len = 0;
+    m_last_error = EN_LastError::NONE;
+    m_rx_err = 0;
+    m_last_hart_ip_info = EN_HartIP_Info::NO_TRAFFIC;
+    m_to_do = EN_ToDo::NOTHING;
+    m_close_request = EN_Bool::FALSE8;
+    m_hart_rx_len = 0;
+    m_hart_ip_version = 0;
+    m_hart_ip_message_type = 0;
+    m_hart_ip_message_id = 0;
+    m_hart_ip_comm_status = 0;
+    m_hart_ip_request_seq_number = 0;
+    m_hart_ip_response_seq_number = 0;
+    m_hart_ip_burst_seq_number = 0;
+    m_hart_ip_nak_seq_number = 0;
+    m_hart_ip_received_seq_number = 0;
+    m_hart_ip_byte_count = 0;
+    m_magic_number = 0xe0a3;
+    m_ms_counter = 0;
+    //   1, 60000
+    m_initiate_req_data[0] = 0x01;
+    m_initiate_req_data[1] = 0x00;
+    m_initiate_req_data[2] = 0x09;
+    m_initiate_req_data[3] = 0x27;
+    m_initiate_req_data[4] = 0xc7;
+}
+CHMipMacPort::~CHMipMacPort()
+{
+    Close();
+    delete (ST_IpPortData*)mo_port;
+}
+// Public Methods
+void CHMipMacPort::Init()
+{
+    mo_channel->IpL2SM.Init();
+}
+EN_Bool CHMipMacPort::Open(TY_Byte* host_name_, TY_Byte* port_, EN_CommType type_)
+{
+    if (mo_port == NULL)
+    {
+        return EN_Bool::FALSE8;
+    }
+
+    // The channel is served by one of the kernel threads
+    mo_kernel = CLinuxSys::AcquireKernel();
+    if (mo_kernel == NULL)
+    {
+        return EN_Bool::FALSE8;
+    }
+
+    Status = EN_Status::INITIALIZING;
+    m_last_error = EN_LastError::NONE;
+    CLinuxSys::AttachChannel(mo_kernel, mo_channel);
+    return EN_Bool::TRUE8;
+}
+void CHMipMacPort::Close()
+{
+    ST_IpPortData* port = (ST_IpPortData*)mo_port;
+
+    if (mo_kernel == NULL)
+    {
+        return;
+    }
+
+    // Try to tell the kernel thread to close
+    // the connection
+    m_close_request = EN_Bool::TRUE8;
+    WakeUp();
+    // Wait for the kernel
+    COSAL::Wait(50);
+    // Served no longer, whatever the state is
+    CLinuxSys::DetachChannel(mo_kernel, mo_channel);
+
+    // Get rid of the leftover mess
+    if (port->ServerSocket != INVALID_SOCKET)
+    {
+        CLinuxSys::RemoveEventSource(mo_kernel, port->ServerSocket);
+        close(port->ServerSocket);
+        port->ServerSocket = INVALID_SOCKET;
+    }
+
+    CLinuxSys::ReleaseKernel(mo_kernel);
+    mo_kernel = NULL;
+    m_close_request = EN_Bool::FALSE8;
+    Status = EN_Status::IDLE;
+}
+void CHMipMacPort::Execute(TY_Word time_ms_)
+{
+    // Note: This procedure is called whenever the kernel thread
+    // wakes up, i.e. on network data, on requests of the
+    // application and when the next timer expires
+
+    EN_HartIP_Info hart_ip_info = EN_HartIP_Info::NO_TRAFFIC;
+    EN_Status       last_status = Status;
+    ST_IpPortData*         port = (ST_IpPortData*)mo_port;
+
+    m_ms_counter += time_ms_;
+
+    switch (Status)
+    {
+    case EN_Status::IDLE:
+        // Do nothing
+        break;
+    case EN_Status::INITIALIZING:
+        mo_channel->IpL2SM.Init();
+        if (InitializeSocketHandler() == EN_Bool::TRUE8)
+        {
+            Status = EN_Status::WAIT_CONNECT;
+        }
+
+        break;
+    case EN_Status::WAIT_CONNECT:
+        ConnectToServer();
+        break;
+    case EN_Status::WAIT_INITIATE_RESPONSE:
+        if (ReceiveNetworkMessage() == EN_HartIP_Info::INITIATE_RESPONSE)
+        {
+            Status = EN_Status::CLIENT_READY;
+        }
+
+        break;
+    case EN_Status::CLIENT_READY:
+        if (m_close_request == EN_Bool::TRUE8)
+        {
+            Status = SendCloseRequest();
+            m_close_request = EN_Bool::FALSE8;
+            break;
+        }
+
+        hart_ip_info = ReceiveNetworkMessage();
+        if (hart_ip_info == EN_HartIP_Info::BURST)
+        {
+            // Keep alive not necessary
+            m_ms_counter = 0;
+            AcceptHartBurst();
+        }
+        else if (hart_ip_info == EN_HartIP_Info::NO_TRAFFIC)
+        {
+            EN_ToDo to_do = FetchNextToDo();
+
+            if (to_do == EN_ToDo::SEND_REQUEST)
+            {
+                Status = SendCommandRequest();
+            }
+            else if (m_ms_counter >= 5000)
+            {
+                m_ms_counter = 0;
+                if (mo_channel->HartIpSendKeepAlive == EN_Bool::TRUE8)
+                {
+                    Status = SendKeepAliveRequest();
+                }
+            }
+        }
+
+        break;
+    case EN_Status::WAIT_COMMAND_RESPONSE:
+        hart_ip_info = ReceiveNetworkMessage();
+        if (hart_ip_info == EN_HartIP_Info::COMMAND_RESPONSE)
+        {
+            AcceptCommandResponse();
+            Status = EN_Status::CLIENT_READY;
+        }
+        else if (hart_ip_info == EN_HartIP_Info::NAK_RESPONSE)
+        {
+            RejectCommandResponse();
+            Status = EN_Status::CLIENT_READY;
+        }
+
+        break;
+    case EN_Status::WAIT_ALIVE_RESPONSE:
+        hart_ip_info = ReceiveNetworkMessage();
+        if (hart_ip_info == EN_HartIP_Info::KEEP_ALIVE_RESPONSE)
+        {
+            AcceptKeepAliveResponse();
+            Status = EN_Status::CLIENT_READY;
+        }
+
+        if (m_ms_counter > 1000)
+        {
+            m_last_error = EN_LastError::KEEP_ALIVE;
+
+        }
+
+        break;
+    case EN_Status::SHUTTING_DOWN:
+        // HandleConnectionClosing();
+        CLinuxSys::RemoveEventSource(mo_kernel, port->ServerSocket);
+        close(port->ServerSocket);
+        port->ServerSocket = INVALID_SOCKET;
+        Status = EN_Status::IDLE;
+    }
+
+    if ((Status != last_status) ||
+        ((hart_ip_info != EN_HartIP_Info::NO_TRAFFIC) && (hart_ip_info != EN_HartIP_Info::NO_HART_IP)))
+    {
+        // Something is going on, the state machines
+        // are continued in the next cycle
+        CLinuxSys::RequestCycle();
+    }
+}
+TY_Word CHMipMacPort::GetStatus()
+{
+    // .15 .14 .13 .12 .11 .10 .09 .08 .07 .06 .05 .04 .03 .02 .01 .00
+    //  +   +   +   +--- Status ----+   +-------- Last Error -------+
+    //  |   |   +-- tbd
+    //  |   +------ tbd
+    //  +---------- tbd
+
+    return (TY_Word)((((TY_Byte)Status & 0x1f) << 8) + (TY_Byte)m_last_error);
+}
+TY_Word CHMipMacPort::GetMagicNumber()
+{
+    return m_magic_number;
+}
+TY_Word CHMipMacPort::GetSequenceNumber(TY_Byte msg_type_)
+{
+    switch (msg_type_)
+    {
+    case (TY_Byte)EN_Msg_Type::REQUEST:
+        return m_hart_ip_request_seq_number;
+        break;
+    case (TY_Byte)EN_Msg_Type::RESPONSE:
+        return m_hart_ip_response_seq_number;
+        break;
+    case (TY_Byte)EN_Msg_Type::BURST:
+        return m_hart_ip_burst_seq_number;
+        break;
+    case (TY_Byte)EN_Msg_Type::NAK:
+        return m_hart_ip_nak_seq_number;
+        break;
+    default:
+        return m_hart_ip_received_seq_number;
+        break;
+    }
+}
+void CHMipMacPort::SetSequenceNumber(TY_Byte msg_type_)
+{
+    switch (msg_type_)
+    {
+    case (TY_Byte)EN_Msg_Type::REQUEST:
+        m_hart_ip_request_seq_number++;
+        m_hart_ip_response_seq_number = m_hart_ip_request_seq_number;
+        break;
+    case (TY_Byte)EN_Msg_Type::RESPONSE:
+        m_hart_ip_response_seq_number = m_hart_ip_response_seq_number;
+        break;
+    case (TY_Byte)EN_Msg_Type::BURST:
+        m_hart_ip_burst_seq_number = m_hart_ip_received_seq_number;
+        break;
+    case (TY_Byte)EN_Msg_Type::NAK:
+        m_hart_ip_nak_seq_number = m_hart_ip_response_seq_number;
+        break;
+    default:
+        break;
+    }
+}
+void CHMipMacPort::GetIpFrameForMonitor(TY_Byte* dst_, TY_Byte* dst_len_, TY_Byte* src_, TY_Byte src_len_, TY_Byte msg_type_)
+{
+    TY_Word del_pos = 0;
+    TY_Word word;
+    TY_Word sequence_number = CHMipMacPort::GetSequenceNumber(msg_type_);
+
+    COSAL::CMem::Set(dst_, 0, MAX_TXRX_SIZE);
+
+    word = CHMipMacPort::GetMagicNumber();
+    dst_[0] = (TY_Byte)(word >> 8);
+    dst_[1] = (TY_Byte)(word);
+    dst_[2] = msg_type_;
+    word = GetSequenceNumber(msg_type_);
+    dst_[3] = (TY_Byte)(word >> 8);
+    dst_[4] = (TY_Byte)(word);
+    // Find delimiter pos
+    for (TY_Byte i = 0; i < src_len_; i++)
+    {
+        if (src_[i] != 0xff)
+        {
+            del_pos = i;
+            break;
+        }
+    }
+
+    *dst_len_ = src_len_ - del_pos;
+    // Copy starting from delimiter
+    COSAL::CMem::Copy(&dst_[5], &src_[del_pos], *dst_len_);
+    *dst_len_ = *dst_len_ + 5;
+}
+TY_Word CHMipMacPort::GetPayloadData(TY_Byte* data_)
+{
+    COSAL::CMem::Copy(data_, m_hart_ip_data, m_hart_ip_len);
+    return m_hart_ip_len;
+}
+void CHMipMacPort::WakeUp()
+{
+    CLinuxSys::WakeUp(mo_kernel);
+}
+// Private Methods
+EN_Bool CHMipMacPort::InitializeSocketHandler()
+{
+    ST_IpPortData* port = (ST_IpPortData*)mo_port;
+    int result;
+
+    port->ListenSocket = INVALID_SOCKET;
+    port->ServerSocket = INVALID_SOCKET;
+    port->Result = NULL;
+    port->Ptr = NULL;
+
+    memset(&port->AddrInfo, 0, sizeof(port->AddrInfo));
+    port->AddrInfo.ai_family = AF_UNSPEC;
+    port->AddrInfo.ai_socktype = SOCK_STREAM;
+    port->AddrInfo.ai_protocol = IPPROTO_TCP;
+
+    // Resolve the server address and port
+    if (mo_channel->HartIpUseAddress == EN_Bool::TRUE8)
+    {
+        result = getaddrinfo((const char*)mo_channel->HartIpAddress, (const char*)mo_channel->HartIpPort, &port->AddrInfo, &port->Result);
+    }
+    else
+    {
+        result = getaddrinfo((const char*)mo_channel->HartIpHostName, (const char*)mo_channel->HartIpPort, &port->AddrInfo, &port->Result);
+    }
+
+    if (result != 0)
+    {
+        m_last_error = EN_LastError::GET_ADDR_INFO;
+        return EN_Bool::FALSE8;
+    }
+
+    return EN_Bool::TRUE8;
+}
+EN_Bool CHMipMacPort::ConnectToServer()
+{
+    ST_IpPortData* port = (ST_IpPortData*)mo_port;
+    int result;
+    int error_code = 0;
+    // Set time_out to 2 ms (the Windows build reads
+    // the first member of the timeval as milliseconds)
+    timeval rcv_to = { 0, 2000 };
+
+    // Attempt to connect to an address until one succeeds
+    for (port->Ptr = port->Result; port->Ptr != NULL; port->Ptr = port->Ptr->ai_next) {
+
+        // Create a SOCKET for connecting to server
+        port->ServerSocket = socket(port->Ptr->ai_family, port->Ptr->ai_socktype,
+            port->Ptr->ai_protocol);
+        if (port->ServerSocket == INVALID_SOCKET)
+        {
+            // Socket failed with error.
+            Status = TerminateConnection(EN_LastError::CREATE_SOCKET);
+            return EN_Bool::FALSE8;
+        }
+
+        // Try connect to server.
+        result = connect(port->ServerSocket, port->Ptr->ai_addr, port->Ptr->ai_addrlen);
+        if (result == SOCKET_ERROR) {
+            close(port->ServerSocket);
+            port->ServerSocket = INVALID_SOCKET;
+            continue;
+        }
+
+        break;
+    }
+
+    freeaddrinfo(port->Result);
+
+    if (port->ServerSocket == INVALID_SOCKET)
+    {
+        Status = TerminateConnection(EN_LastError::NO_SERVER);
+        return EN_Bool::FALSE8;
+    }
+    else
+    {
+        // Set timeout of the server socket
+        if (setsockopt(port->ServerSocket, SOL_SOCKET, SO_RCVTIMEO, (char*)&rcv_to, sizeof(rcv_to)) == SOCKET_ERROR)
+        {
+            Status = TerminateConnection(EN_LastError::SET_TIMEOUT);
+            return EN_Bool::FALSE8;
+        }
+
+        // The kernel thread wakes up on incoming data
+        CLinuxSys::AddEventSource(mo_kernel, port->ServerSocket);
+        // Send an initiate request
+        Status = SendInitiateRequest();
+    }
+
+    return EN_Bool::TRUE8;
+}
+CHMipMacPort::EN_Status CHMipMacPort::SendInitiateRequest()
+{
+    ST_IpPortData* port = (ST_IpPortData*)mo_port;
+    SetSequenceNumber(MSGTY_REQ);
+    TY_Word sequence_number = GetSequenceNumber(MSGTY_REQ);
+
+    // Begin with the header
+    COSAL::CMem::Copy(m_tx_buf, s_intiate_req_header, s_initiate_req_header_len);
+    // Add payload data
+    COSAL::CMem::Copy(&m_tx_buf[s_initiate_req_header_len], m_initiate_req_data, 5);
+    m_tx_len = 13;
+    // Insert sequence number
+    m_tx_buf[4] = (TY_Byte)(sequence_number >> 8);
+    m_tx_buf[5] = (TY_Byte)(sequence_number);
+
+    int result = send(port->ServerSocket, (const char*)m_tx_buf, m_tx_len, MSG_NOSIGNAL);
+    if (result == m_tx_len)
+    {
+        return EN_Status::WAIT_INITIATE_RESPONSE;
+    }
+    else
+    {
+        return TerminateConnection(EN_LastError::TX_FAILED);
+    }
+}
+void CHMipMacPort::AcceptInitiateResponse()
+{
+    // tbd?
+}
+CHMipMacPort::EN_Status CHMipMacPort::SendKeepAliveRequest()
+{
+    ST_IpPortData* port = (ST_IpPortData*)mo_port;
+    int result;
+
+    SetSequenceNumber(MSGTY_REQ);
+    TY_Word sequence_number = GetSequenceNumber(MSGTY_REQ);
+    // Encode the request
+    COSAL::CMem::Copy(m_tx_buf, s_keep_alive_req_header, s_keep_alive_req_header_len);
+    m_tx_len = s_keep_alive_req_header_len;
+    // Update sequence number
+    m_tx_buf[4] = (TY_Byte)(sequence_number >> 8);
+    m_tx_buf[5] = (TY_Byte)(sequence_number);
+
+    // Send a the keep alive request
+    result = send(port->ServerSocket, (const char*)m_tx_buf, m_tx_len, MSG_NOSIGNAL);
+    if (result == SOCKET_ERROR)
+    {
+        return TerminateConnection(EN_LastError::TX_FAILED);
+    }
+
+    return EN_Status::WAIT_ALIVE_RESPONSE;
+}
+void CHMipMacPort::AcceptKeepAliveResponse()
+{
+
+}
+CHMipMacPort::EN_Status CHMipMacPort::SendCommandRequest()
+{
+    ST_IpPortData* port = (ST_IpPortData*)mo_port;
+    int result;
+
+    // Prepare the hart ip payload
+    TY_Word     del_pos = 0;
+    TY_Word      tx_len = 0;
+    TY_Word         idx = 0;
+    TY_Word payload_len = 0;
+
+
+    TY_Byte* tx_data = mo_channel->IpL2SM.GetTxData(&tx_len);
+    // Find delimiter
+    for (TY_Word i = 0; i < tx_len; i++)
+    {
+        if (tx_data[i] != 0xff)
+        {
+            del_pos = i;
+            break;
+        }
+    }
+
+    SetSequenceNumber(MSGTY_REQ);
+    TY_Word sequence_number = GetSequenceNumber(MSGTY_REQ);
+    // Begin with the header
+    COSAL::CMem::Copy(m_tx_buf, s_req_header, s_req_header_len);
+    idx = s_req_header_len;
+    // Add the hart ip payload
+    COSAL::CMem::Copy(&m_tx_buf[idx], &tx_data[del_pos], tx_len - del_pos);
+    payload_len = tx_len - del_pos;
+    m_tx_len = s_req_header_len + tx_len - del_pos;
+    m_tx_buf[4] = (TY_Byte)(sequence_number >> 8);
+    m_tx_buf[5] = (TY_Byte)(sequence_number);
+    payload_len = payload_len + 8;
+    m_tx_buf[6] = (TY_Byte)(payload_len >> 8);
+    m_tx_buf[7] = (TY_Byte)(payload_len);
+    mo_channel->Monitor.SetAdditionalData(m_tx_buf, m_tx_len);
+    // Send the paket
+    result = send(port->ServerSocket, (const char*)m_tx_buf, m_tx_len, MSG_NOSIGNAL);
+    SignalHartTxDone();
+    if (result == SOCKET_ERROR)
+    {
+        return TerminateConnection(EN_LastError::TX_FAILED);
+    }
+
+    return EN_Status::WAIT_COMMAND_RESPONSE;
+}
+void CHMipMacPort::AcceptCommandResponse()
+{
+    m_hart_ip_version = m_rcv_buf[0];
+    m_hart_ip_message_type = m_rcv_buf[1];
+    m_hart_ip_message_id = m_rcv_buf[2];
+    m_hart_ip_comm_status = m_rcv_buf[3];
+    m_hart_ip_received_seq_number = (TY_Word)((m_rcv_buf[4] << 8) + m_rcv_buf[5]);
+    m_hart_ip_byte_count = (TY_Word)((m_rcv_buf[6] << 8) + m_rcv_buf[7]);
+
+    // Copy frame  to the hart context
+    COSAL::CMem::Set(m_hart_rx_data, 0, MAX_TXRX_SIZE);
+    m_hart_rx_len = (TY_Byte)(m_rcv_len - HART_IP_HEADER_LEN);
+    COSAL::CMem::Copy(m_hart_rx_data, &m_rcv_buf[HART_IP_HEADER_LEN], m_hart_rx_len);
+    // Call the protocol state machine
+    CHMipMacPort::EN_ToDo todo = mo_channel->IpProtocol.EventHandler(CHMipProtocol::EN_Event::HART_IP_DATA_RECEIVED, m_hart_rx_data, m_hart_rx_len);
+}
+void CHMipMacPort::RejectCommandResponse()
+{
+    m_hart_ip_version = m_rcv_buf[0];
+    m_hart_ip_message_type = m_rcv_buf[1];
+    m_hart_ip_message_id = m_rcv_buf[2];
+    m_hart_ip_comm_status = m_rcv_buf[3];
+    m_hart_ip_received_seq_number = (TY_Word)((m_rcv_buf[4] << 8) + m_rcv_buf[5]);
+    m_hart_ip_byte_count = (TY_Word)((m_rcv_buf[6] << 8) + m_rcv_buf[7]);
+
+    // Copy frame  to the hart context
+    COSAL::CMem::Set(m_hart_rx_data, 0, MAX_TXRX_SIZE);
+    m_hart_rx_len = (TY_Byte)(m_rcv_len - HART_IP_HEADER_LEN);
+    COSAL::CMem::Copy(m_hart_rx_data, &m_rcv_buf[HART_IP_HEADER_LEN], m_hart_rx_len);
+    // Call the protocol state machine
+    CHMipMacPort::EN_ToDo todo = mo_channel->IpProtocol.EventHandler(CHMipProtocol::EN_Event::REQUEST_REJECTED, m_hart_rx_data, m_hart_rx_len);
+}
+void CHMipMacPort::AcceptHartBurst()
+{
+    if (m_rcv_len < 9)
+    {
+        return;
+    }
+
+    // Get the hart ip header details
+    m_hart_ip_version = m_rcv_buf[0];
+    m_hart_ip_message_type = m_rcv_buf[1];
+    m_hart_ip_message_id = m_rcv_buf[2];
+    m_hart_ip_comm_status = m_rcv_buf[3];
+    m_hart_ip_burst_seq_number = (TY_Word)((m_rcv_buf[4] << 8) + m_rcv_buf[5]);
+    m_hart_ip_byte_count = (TY_Word)((m_rcv_buf[6] << 8) + m_rcv_buf[7]);
+
+    SetSequenceNumber((TY_Byte)EN_Msg_Type::BURST);
+    // Copy frame  to the hart context
+    COSAL::CMem::Set(m_hart_rx_data, 0, MAX_TXRX_SIZE);
+    m_hart_rx_len = (TY_Byte)(m_rcv_len - HART_IP_HEADER_LEN);
+    COSAL::CMem::Copy(m_hart_rx_data, &m_rcv_buf[HART_IP_HEADER_LEN], m_hart_rx_len);
+    // Call the protocol state machine
+    CHMipMacPort::EN_ToDo todo = mo_channel->IpProtocol.EventHandler(CHMipProtocol::EN_Event::HART_IP_DATA_RECEIVED, m_hart_rx_data, m_hart_rx_len);
+
+    return;
+}
+CHMipMacPort::EN_Status CHMipMacPort::SendCloseRequest()
+{
+    ST_IpPortData* port = (ST_IpPortData*)mo_port;
+    int result;
+
+    SetSequenceNumber((TY_Byte)EN_Msg_Type::REQUEST);
+    TY_Word sequence_number = GetSequenceNumber(MSGTY_REQ);
+
+    // Encode the request
+    COSAL::CMem::Copy(m_tx_buf, s_close_req_header, s_close_req_header_len);
+    m_tx_len = s_close_req_header_len;
+    // Update sequence number
+    m_tx_buf[4] = (TY_Byte)(sequence_number >> 8);
+    m_tx_buf[5] = (TY_Byte)(sequence_number);
+    // Send a the close request
+    result = send(port->ServerSocket, (const char*)m_tx_buf, m_tx_len, MSG_NOSIGNAL);
+
+    return EN_Status::SHUTTING_DOWN;
+}
+void CHMipMacPort::AcceptCloseResponse()
+{
+    // tbd ?
+}
+EN_Bool CHMipMacPort::HandleConnectionClosing()
+{
+    ST_IpPortData* port = (ST_IpPortData*)mo_port;
+    int result;
+
+    // Receive until the peer closes the connection
+    do {
+        m_rcv_len = MAX_IP_TXRX_SIZE;
+        result = recv(port->ServerSocket, (char*)(&m_rcv_buf), m_rcv_len, 0);
+        if (result > 0)
+            // Bytes received
+            m_rcv_len = result;
+        else if (result == 0)
+            // Connection closed
+            m_rcv_len = 0;
+        else
+            m_last_error = EN_LastError::SHUTDOWN;
+
+    } while (result > 0);
+
+    if (result == 0)
+    {
+        return EN_Bool::TRUE8;
+    }
+
+    return EN_Bool::FALSE8;
+}
+// Receive from the network
+CHMipMacPort::EN_HartIP_Info CHMipMacPort::ReceiveNetworkMessage()
+{
+    ST_IpPortData* port = (ST_IpPortData*)mo_port;
+    int result;
+    int error_code = 0;
+    EN_HartIP_Info hart_ip_info = EN_HartIP_Info::NO_HART_IP;
+
+    m_rcv_len = MAX_IP_TXRX_SIZE;
+    // Never block, the kernel thread is woken up by the socket
+    result = recv(port->ServerSocket, (char*)&m_rcv_buf, m_rcv_len, MSG_PEEK | MSG_DONTWAIT);
+    if (result > 0)
+    {
+        // Take the message out of the buffer in the sockets
+        result = recv(port->ServerSocket, (char*)&m_rcv_buf, m_rcv_len, MSG_DONTWAIT);
+    }
+
+    if (result == 0)
+    {
+        // Closed by the server
+        Status = TerminateConnection(EN_LastError::RECEIVING);
+        return EN_HartIP_Info::NET_ERR;
+    }
+
+    if (result == SOCKET_ERROR)
+    {
+        error_code = errno;
+        if ((error_code == EAGAIN) || (error_code == EWOULDBLOCK))
+        {
+            // Nothing there, bursts may be sent
+            // (published) by the slave
+            if (Status == EN_Status::CLIENT_READY)
+            {
+                SaveNextToDo(SignalHartSilence());
+            }
+
+            return EN_HartIP_Info::NO_TRAFFIC;
+        }
+        else
+        {
+            Status = TerminateConnection(EN_LastError::RECEIVING);
+            return EN_HartIP_Info::NET_ERR;
+        }
+    }
+
+    if ((result >= 8) &&
+        (result <= MAX_IP_TXRX_SIZE))
+    {
+        m_rcv_len = (TY_Byte)result;
+
+        // Possibly a Hart IP frame
+        if ((m_rcv_buf[IDX_VER] != 0) &&
+            (m_rcv_buf[IDX_VER] <= MAX_VER))
+        {
+            // Hart IP, look for details
+            if (m_rcv_buf[IDX_TYPE] == (TY_Byte)EN_Msg_Type::BURST)
+            {
+                if ((m_rcv_buf[IDX_ID] == (TY_Byte)EN_Msg_ID::HART_PDU) &&
+                    (m_rcv_len > 8))
+                {
+                    hart_ip_info = EN_HartIP_Info::BURST;
+                }
+            }
+            else if (m_rcv_buf[IDX_TYPE] == (TY_Byte)EN_Msg_Type::RESPONSE)
+            {
+                // What kind of a response?
+                if ((m_rcv_buf[IDX_ID] == (TY_Byte)EN_Msg_ID::INITIATE) &&
+                    (m_rcv_len == 13))
+                {
+                    COSAL::CMem::Copy(m_initiate_req_data, &m_rcv_buf[IDX_PDU], 5);
+                    hart_ip_info = EN_HartIP_Info::INITIATE_RESPONSE;
+                }
+                else if ((m_rcv_buf[IDX_ID] == (TY_Byte)EN_Msg_ID::CLOSE) &&
+                    (m_rcv_len == 8))
+                {
+                    hart_ip_info = EN_HartIP_Info::CLOSE_RESPONSE;
+                }
+                else if ((m_rcv_buf[IDX_ID] == (TY_Byte)EN_Msg_ID::HART_PDU) &&
+                    (m_rcv_len > 8))
+                {
+                    hart_ip_info = EN_HartIP_Info::COMMAND_RESPONSE;
+                }
+                else if ((m_rcv_buf[IDX_ID] == (TY_Byte)EN_Msg_ID::KEEP_ALIVE) &&
+                    (m_rcv_len == 8))
+                {
+                    hart_ip_info = EN_HartIP_Info::KEEP_ALIVE_RESPONSE;
+                }
+            }
+            else if (m_rcv_buf[IDX_TYPE] == (TY_Byte)EN_Msg_Type::NAK)
+            {
+                hart_ip_info = EN_HartIP_Info::NAK_RESPONSE;
+            }
+        }
+    }
+
+    return hart_ip_info;
+}
+// Signal to the Hart protocol
+CHMipMacPort::EN_ToDo CHMipMacPort::SignalHartPDUreceiving()
+{
+    AcceptCommandResponse();
+    // Call the protocol state machine
+    CHMipMacPort::EN_ToDo todo = mo_channel->IpProtocol.EventHandler(CHMipProtocol::EN_Event::HART_IP_DATA_RECEIVED, m_hart_rx_data, m_hart_rx_len);
+    return todo;
+}
+CHMipMacPort::EN_ToDo CHMipMacPort::SignalHartSilence()
+{
+    CHMipMacPort::EN_ToDo todo = mo_channel->IpProtocol.EventHandler(CHMipProtocol::EN_Event::SILENCE_DETECTED, m_hart_rx_data, m_hart_rx_len);
+
+    return todo;
+}
+void CHMipMacPort::SignalHartTxDone()
+{
+    mo_channel->IpProtocol.EventHandler(CHMipProtocol::EN_Event::HART_IP_TX_DONE, NULL, NULL);
+}
+void CHMipMacPort::SignalNetworkError()
+{
+    mo_channel->IpProtocol.EventHandler(CHMipProtocol::EN_Event::NETWORK_ERROR, NULL, NULL);
+}
+CHMipMacPort::EN_Status CHMipMacPort::TerminateConnection(EN_LastError last_err_)
+{
+    ST_IpPortData* port = (ST_IpPortData*)mo_port;
+    SignalNetworkError();
+    if (port->ServerSocket != INVALID_SOCKET)
+    {
+        CLinuxSys::RemoveEventSource(mo_kernel, port->ServerSocket);
+        close(port->ServerSocket);
+        port->ServerSocket = INVALID_SOCKET;
+    }
+
+    m_last_error = last_err_;
+    return EN_Status::INITIALIZING;
+}
+void CHMipMacPort::SaveNextToDo(EN_ToDo to_do_)
+{
+    if (to_do_ == EN_ToDo::SEND_REQUEST)
+    {
+        m_to_do = to_do_;
+    }
+
+    // Test
+    if (m_to_do == EN_ToDo::NOTHING)
+    {
+        m_to_do = to_do_;
+    }
+}
+CHMipMacPort::EN_ToDo CHMipMacPort::FetchNextToDo()
+{
+    EN_ToDo tmp;
+    tmp = m_to_do;
+    m_to_do = EN_ToDo::NOTHING;
+    return tmp;
+}
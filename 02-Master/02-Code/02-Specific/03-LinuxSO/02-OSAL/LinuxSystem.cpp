@@ -0,0 +1,1062 @@
+/*
+ *          File: LinuxSystem.cpp (CLinuxSys)
+ *                The OSAL concept cannot be applied to all functions that
+ *                are required. These functions were implemented in the code
+ *                of this module. It is the Linux counterpart of CWinSys.
+ *                The channels are served by a small pool of kernel
+ *                threads. A kernel is event driven. It sleeps in epoll
+ *                until the uart receiver, the network, the application
+ *                or the next expiring timer of one of its channels
+ *                (timerfd on the monotonic clock) wakes it up.
+ *
+ *        Author: Walter Borst
+ *
+ *        E-Mail: info@borst-automation.de
+ *          Home: https://www.borst-automation.de
+ *
+ * No Warranties: https://www.borst-automation.com/legal/warranty-disclaimer
+ *
+ * Copyright 2006-2025 Walter Borst, Cuxhaven, Germany
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <termios.h>
+#include <time.h>
+#include <errno.h>
+#include <stdio.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/timerfd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <linux/serial.h>
+#include <atomic>
+#include <new>
+#include "OSAL.h"
+#include "WbHartUser.h"
+#include "WbHartM_Structures.h"
+#include "LinuxSystem.h"
+#include "HartMasterIface.h"
+#include "HartChannel.h"
+
+// Receiver of the uarts, the ring of a port is written by
+// the receiver thread and read by the kernel thread
+static const TY_Word UART_RX_RING_SIZE = 512;
+
+typedef struct st_RcvStamp
+{
+    TY_Byte        Data;
+    TY_Byte       Error;
+    TY_UInt64    TimeNs;
+} ST_RcvStamp;
+
+typedef struct st_UartData
+{
+    ST_UartPortData                   Port;
+    PTR_Handle                      Kernel;
+    TY_UInt64                   ByteTimeNs;
+    EN_Bool                    HasCounters;
+    struct serial_icounter_struct Counters;
+    TY_Byte                      MarkState;
+    std::atomic<TY_Word>             RdIdx;
+    std::atomic<TY_Word>             WrIdx;
+    ST_RcvStamp     Ring[UART_RX_RING_SIZE];
+} ST_UartData;
+
+// Pool of kernel threads, the event sources of a kernel
+// are created once and kept for the lifetime of the library
+static const TY_Byte    KERNEL_MAX_THREADS = 4;
+static const TY_DWord     KERNEL_MAX_SLEEP = 100;
+static const TY_Byte  KERNEL_LINGER_CYCLES = 4;
+static const int         KERNEL_MAX_EVENTS = 8;
+
+typedef struct st_KernelData
+{
+    CLinuxSys::CThread::ST_ThreadContr Control;
+    TY_Word                   NumUsers = 0;
+    int                    EpollHandle = -1;
+    int                     WakeHandle = -1;
+    int                    TimerHandle = -1;
+    EN_Bool             CycleRequested = EN_Bool::FALSE8;
+    TY_Byte               LingerCycles = 0;
+    // Channels served by this kernel. They are executed without
+    // the lock, their handlers may close or open any channel.
+    pthread_mutex_t        ChannelLock;
+    pthread_cond_t         ChannelDone;
+    CChannel*    Channels[MAX_NUM_CHANNELS];
+    TY_Word                NumChannels = 0;
+    CChannel*                Executing = NULL;
+    // Receiver of the uarts of the channels
+    pthread_t                 RxThread;
+    EN_Bool                RxIsRunning = EN_Bool::FALSE8;
+    int                  RxEpollHandle = -1;
+    int                   RxStopHandle = -1;
+    pthread_mutex_t             RxLock;
+    ST_UartData*    Uarts[MAX_NUM_CHANNELS];
+    TY_Word                   NumUarts = 0;
+} ST_KernelData;
+
+static ST_KernelData                 kernel_data[KERNEL_MAX_THREADS];
+static pthread_mutex_t          kernel_pool_lock = PTHREAD_MUTEX_INITIALIZER;
+static thread_local ST_KernelData* current_kernel = NULL;
+
+// Local helpers
+static speed_t GetSpeed(TY_DWord baudrate_)
+{
+    switch (baudrate_)
+    {
+    case COSAL::CBitRates::CBR_Win::BR_2400:
+        return B2400;
+    case COSAL::CBitRates::CBR_Win::BR_4800:
+        return B4800;
+    case COSAL::CBitRates::CBR_Win::BR_9600:
+        return B9600;
+    case COSAL::CBitRates::CBR_Win::BR_19200:
+        return B19200;
+    case COSAL::CBitRates::CBR_Win::BR_38400:
+        return B38400;
+    case COSAL::CBitRates::CBR_Win::BR_57600:
+        return B57600;
+    default:
+        return B1200;
+    }
+}
+
+static void GetDeviceName(TY_Char* name_, TY_Word max_len_, TY_Byte com_port_)
+{
+    if (com_port_ >= 200)
+    {
+        snprintf(name_, max_len_, "/dev/ttyACM%d", com_port_ - 200);
+    }
+    else if (com_port_ >= 100)
+    {
+        snprintf(name_, max_len_, "/dev/ttyUSB%d", com_port_ - 100);
+    }
+    else
+    {
+        snprintf(name_, max_len_, "/dev/ttyS%d", com_port_ - 1);
+    }
+}
+
+static EN_Bool IsStopRequested(ST_KernelData* kernel_, struct epoll_event* events_, int num_events_)
+{
+    for (int e = 0; e < num_events_; e++)
+    {
+        if (events_[e].data.fd == kernel_->RxStopHandle)
+        {
+            return EN_Bool::TRUE8;
+        }
+    }
+
+    return EN_Bool::FALSE8;
+}
+
+static ST_UartData* FindUart(ST_KernelData* kernel_, int handle_)
+{
+    // Note: Called under the rx lock of the kernel
+    for (TY_Word e = 0; e < kernel_->NumUarts; e++)
+    {
+        if (kernel_->Uarts[e]->Port.Handle == handle_)
+        {
+            return kernel_->Uarts[e];
+        }
+    }
+
+    return NULL;
+}
+
+static TY_Byte GetErrorClass(ST_UartData* uart_)
+{
+    // Which error caused the marked characters?
+    struct serial_icounter_struct counters;
+    TY_Byte                             err = COSAL::CRcvErr::ERR_None;
+
+    if (uart_->HasCounters == EN_Bool::FALSE8)
+    {
+        return COSAL::CRcvErr::ERR_Parity;
+    }
+
+    if (ioctl(uart_->Port.Handle, TIOCGICOUNT, &counters) != 0)
+    {
+        return COSAL::CRcvErr::ERR_Parity;
+    }
+
+    if (counters.frame != uart_->Counters.frame)
+        err |= COSAL::CRcvErr::ERR_Frame;
+    if (counters.parity != uart_->Counters.parity)
+        err |= COSAL::CRcvErr::ERR_Parity;
+    if ((counters.overrun != uart_->Counters.overrun) ||
+        (counters.buf_overrun != uart_->Counters.buf_overrun))
+        err |= COSAL::CRcvErr::ERR_Over;
+
+    uart_->Counters = counters;
+    return err;
+}
+
+static void StoreReceived(ST_UartData* uart_, TY_Byte* data_, TY_Word len_, TY_Byte err_, TY_UInt64 time_ns_)
+{
+    // Decode the PARMRK sequences first
+    //   0xff 0xff       -> 0xff
+    //   0xff 0x00 <chr> -> <chr> with error
+    TY_Byte   bytes[MAX_TXRX_SIZE];
+    TY_Byte  errors[MAX_TXRX_SIZE];
+    TY_Word      len = 0;
+    TY_Word   wr_idx = uart_->WrIdx.load(std::memory_order_relaxed);
+    TY_Word   rd_idx = uart_->RdIdx.load(std::memory_order_acquire);
+    TY_Byte      err = err_;
+
+    for (TY_Word e = 0; e < len_; e++)
+    {
+        TY_Byte data = data_[e];
+
+        switch (uart_->MarkState)
+        {
+        case 0:
+            if (data == 0xff)
+            {
+                uart_->MarkState = 1;
+            }
+            else
+            {
+                bytes[len] = data;
+                errors[len] = COSAL::CRcvErr::ERR_None;
+                len++;
+            }
+            break;
+        case 1:
+            if (data == 0xff)
+            {
+                bytes[len] = 0xff;
+                errors[len] = COSAL::CRcvErr::ERR_None;
+                len++;
+                uart_->MarkState = 0;
+            }
+            else
+            {
+                uart_->MarkState = 2;
+            }
+            break;
+        default:
+            if (err == COSAL::CRcvErr::ERR_None)
+            {
+                err = COSAL::CRcvErr::ERR_Parity;
+            }
+
+            bytes[len] = data;
+            errors[len] = err;
+            len++;
+            uart_->MarkState = 0;
+            break;
+        }
+    }
+
+    // The last character was completed at the time of
+    // reading, the ones before are one byte time earlier each
+    for (TY_Word e = 0; e < len; e++)
+    {
+        TY_Word next_idx = (TY_Word)((wr_idx + 1) & (UART_RX_RING_SIZE - 1));
+
+        if (next_idx == rd_idx)
+        {
+            // Ring full, the kernel is not taking the data
+            break;
+        }
+
+        uart_->Ring[wr_idx].Data = bytes[e];
+        uart_->Ring[wr_idx].Error = errors[e];
+        uart_->Ring[wr_idx].TimeNs = time_ns_ - ((TY_UInt64)(len - 1 - e) * uart_->ByteTimeNs);
+        wr_idx = next_idx;
+    }
+
+    uart_->WrIdx.store(wr_idx, std::memory_order_release);
+}
+
+static EN_Bool CreateKernelWaitHandles(ST_KernelData* kernel_)
+{
+    struct epoll_event event;
+
+    if (kernel_->EpollHandle >= 0)
+    {
+        return EN_Bool::TRUE8;
+    }
+
+    kernel_->EpollHandle = epoll_create1(EPOLL_CLOEXEC);
+    kernel_->WakeHandle = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    kernel_->TimerHandle = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
+    kernel_->RxEpollHandle = epoll_create1(EPOLL_CLOEXEC);
+    kernel_->RxStopHandle = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if ((kernel_->EpollHandle < 0) ||
+        (kernel_->WakeHandle < 0) ||
+        (kernel_->TimerHandle < 0) ||
+        (kernel_->RxEpollHandle < 0) ||
+        (kernel_->RxStopHandle < 0))
+    {
+        if (kernel_->EpollHandle >= 0)
+            close(kernel_->EpollHandle);
+        if (kernel_->WakeHandle >= 0)
+            close(kernel_->WakeHandle);
+        if (kernel_->TimerHandle >= 0)
+            close(kernel_->TimerHandle);
+        if (kernel_->RxEpollHandle >= 0)
+            close(kernel_->RxEpollHandle);
+        if (kernel_->RxStopHandle >= 0)
+            close(kernel_->RxStopHandle);
+
+        kernel_->EpollHandle = -1;
+        kernel_->WakeHandle = -1;
+        kernel_->TimerHandle = -1;
+        kernel_->RxEpollHandle = -1;
+        kernel_->RxStopHandle = -1;
+        return EN_Bool::FALSE8;
+    }
+
+    event.events = EPOLLIN;
+    event.data.fd = kernel_->WakeHandle;
+    epoll_ctl(kernel_->EpollHandle, EPOLL_CTL_ADD, kernel_->WakeHandle, &event);
+    event.events = EPOLLIN;
+    event.data.fd = kernel_->TimerHandle;
+    epoll_ctl(kernel_->EpollHandle, EPOLL_CTL_ADD, kernel_->TimerHandle, &event);
+    event.events = EPOLLIN;
+    event.data.fd = kernel_->RxStopHandle;
+    epoll_ctl(kernel_->RxEpollHandle, EPOLL_CTL_ADD, kernel_->RxStopHandle, &event);
+    pthread_mutex_init(&kernel_->ChannelLock, NULL);
+    pthread_cond_init(&kernel_->ChannelDone, NULL);
+    pthread_mutex_init(&kernel_->RxLock, NULL);
+    return EN_Bool::TRUE8;
+}
+
+static EN_Bool StartKernel(ST_KernelData* kernel_)
+{
+    // Note: Called under the pool lock
+    TY_UInt64 stop;
+
+    if (CreateKernelWaitHandles(kernel_) == EN_Bool::FALSE8)
+    {
+        return EN_Bool::FALSE8;
+    }
+
+    // A stop event of the last run may still be pending
+    read(kernel_->RxStopHandle, &stop, sizeof(stop));
+    if (pthread_create(&kernel_->RxThread, NULL, CLinuxSys::CUart::Receive, kernel_) != 0)
+    {
+        return EN_Bool::FALSE8;
+    }
+
+    kernel_->RxIsRunning = EN_Bool::TRUE8;
+    kernel_->CycleRequested = EN_Bool::FALSE8;
+    kernel_->LingerCycles = 0;
+    kernel_->Control.RunFlag = EN_Bool::TRUE8;
+    kernel_->Control.Handler = CHartMaster::FastCyclicHandler;
+    kernel_->Control.Terminated = EN_Bool::FALSE8;
+    kernel_->Control.Priority = CLinuxSys::CThread::CPrio::High;
+    kernel_->Control.Cycle = 1;
+    kernel_->Control.Kernel = kernel_;
+    if (CLinuxSys::CThread::Start(&kernel_->Control) != EN_Error::NONE)
+    {
+        TY_UInt64 signal = 1;
+
+        write(kernel_->RxStopHandle, &signal, sizeof(signal));
+        pthread_join(kernel_->RxThread, NULL);
+        kernel_->RxIsRunning = EN_Bool::FALSE8;
+        return EN_Bool::FALSE8;
+    }
+
+    return EN_Bool::TRUE8;
+}
+
+static void StopKernel(ST_KernelData* kernel_)
+{
+    // Note: Called under the pool lock
+    TY_UInt64 signal = 1;
+
+    CLinuxSys::CThread::Terminate(&kernel_->Control);
+    if (kernel_->RxIsRunning == EN_Bool::TRUE8)
+    {
+        write(kernel_->RxStopHandle, &signal, sizeof(signal));
+        pthread_join(kernel_->RxThread, NULL);
+        kernel_->RxIsRunning = EN_Bool::FALSE8;
+    }
+}
+
+static TY_Byte GetNumKernels()
+{
+    long num_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+
+    if (num_cpus < 1)
+    {
+        return 1;
+    }
+
+    if (num_cpus > KERNEL_MAX_THREADS)
+    {
+        return KERNEL_MAX_THREADS;
+    }
+
+    return (TY_Byte)num_cpus;
+}
+
+static TY_UInt64 GetNextCycleTime(ST_KernelData* kernel_, TY_UInt64 last_time_ns_, TY_Word cycle_, EN_Bool is_active_)
+{
+    // Sleep until the earliest timer expires, but not longer than
+    // KERNEL_MAX_SLEEP to serve the counters of the mac ports
+    TY_DWord sleep_time = KERNEL_MAX_SLEEP;
+    TY_DWord     expiry;
+
+    if (COSAL::CTimer::GetNextExpiry(&expiry) == EN_Bool::TRUE8)
+    {
+        int remaining = (int)(expiry - COSAL::CTimer::GetTime());
+
+        if (remaining <= (int)cycle_)
+        {
+            // A timer has just expired
+            remaining = (int)cycle_;
+            is_active_ = EN_Bool::TRUE8;
+        }
+
+        if ((TY_DWord)remaining < sleep_time)
+        {
+            sleep_time = (TY_DWord)remaining;
+        }
+    }
+
+    // After any activity the kernel keeps on cycling for a
+    // while, the state machines take some calls to settle
+    if ((is_active_ == EN_Bool::TRUE8) ||
+        (kernel_->CycleRequested == EN_Bool::TRUE8))
+    {
+        kernel_->LingerCycles = KERNEL_LINGER_CYCLES;
+    }
+
+    if (kernel_->LingerCycles > 0)
+    {
+        kernel_->LingerCycles--;
+        sleep_time = cycle_;
+    }
+
+    return last_time_ns_ + ((TY_UInt64)sleep_time * 1000000ULL);
+}
+
+static TY_DWord ToKernelTime(TY_UInt64 time_ns_)
+{
+    // The kernel time (ms) is taken from the same clock
+    return (TY_DWord)(time_ns_ / 1000000ULL);
+}
+
+TY_UInt64 CLinuxSys::GetTimeNs()
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((TY_UInt64)now.tv_sec * 1000000000ULL) + (TY_UInt64)now.tv_nsec;
+}
+
+PTR_Handle CLinuxSys::AcquireKernel()
+{
+    ST_KernelData* kernel = NULL;
+    TY_Byte   num_kernels = GetNumKernels();
+
+    pthread_mutex_lock(&kernel_pool_lock);
+    // Take the kernel with the least load
+    for (TY_Byte e = 0; e < num_kernels; e++)
+    {
+        if ((kernel == NULL) || (kernel_data[e].NumUsers < kernel->NumUsers))
+        {
+            kernel = &kernel_data[e];
+        }
+    }
+
+    if (kernel->NumUsers == 0)
+    {
+        if (StartKernel(kernel) == EN_Bool::FALSE8)
+        {
+            pthread_mutex_unlock(&kernel_pool_lock);
+            return NULL;
+        }
+    }
+
+    kernel->NumUsers++;
+    pthread_mutex_unlock(&kernel_pool_lock);
+    return kernel;
+}
+
+void CLinuxSys::ReleaseKernel(PTR_Handle kernel_)
+{
+    ST_KernelData* kernel = (ST_KernelData*)kernel_;
+
+    if (kernel == NULL)
+    {
+        return;
+    }
+
+    pthread_mutex_lock(&kernel_pool_lock);
+    if (kernel->NumUsers > 0)
+    {
+        kernel->NumUsers--;
+        if (kernel->NumUsers == 0)
+        {
+            // Last channel gone, stop the threads
+            StopKernel(kernel);
+        }
+    }
+    pthread_mutex_unlock(&kernel_pool_lock);
+}
+
+void CLinuxSys::AttachChannel(PTR_Handle kernel_, CChannel* channel_)
+{
+    ST_KernelData* kernel = (ST_KernelData*)kernel_;
+
+    pthread_mutex_lock(&kernel->ChannelLock);
+    if (kernel->NumChannels < MAX_NUM_CHANNELS)
+    {
+        kernel->Channels[kernel->NumChannels] = channel_;
+        kernel->NumChannels++;
+    }
+    pthread_mutex_unlock(&kernel->ChannelLock);
+    WakeUp(kernel_);
+}
+
+void CLinuxSys::DetachChannel(PTR_Handle kernel_, CChannel* channel_)
+{
+    // The kernel is not executing the channel
+    // any more as soon as this returns
+    ST_KernelData* kernel = (ST_KernelData*)kernel_;
+
+    pthread_mutex_lock(&kernel->ChannelLock);
+    for (TY_Word e = 0; e < kernel->NumChannels; e++)
+    {
+        if (kernel->Channels[e] == channel_)
+        {
+            kernel->NumChannels--;
+            kernel->Channels[e] = kernel->Channels[kernel->NumChannels];
+            break;
+        }
+    }
+
+    // The kernel thread itself detaches only between two
+    // channels, otherwise wait for the running call. Its
+    // handlers may call the interface meanwhile, so the
+    // lock is left completely, the caller may hold it
+    // more than once.
+    if ((current_kernel != kernel) && (kernel->Executing == channel_))
+    {
+        TY_Word depth = COSAL::ReleaseLock();
+
+        while (kernel->Executing == channel_)
+        {
+            pthread_cond_wait(&kernel->ChannelDone, &kernel->ChannelLock);
+        }
+        pthread_mutex_unlock(&kernel->ChannelLock);
+        COSAL::RestoreLock(depth);
+        return;
+    }
+    pthread_mutex_unlock(&kernel->ChannelLock);
+}
+
+static EN_Bool IsAttached(ST_KernelData* kernel_, CChannel* channel_)
+{
+    // Note: Called under the channel lock of the kernel
+    for (TY_Word e = 0; e < kernel_->NumChannels; e++)
+    {
+        if (kernel_->Channels[e] == channel_)
+        {
+            return EN_Bool::TRUE8;
+        }
+    }
+
+    return EN_Bool::FALSE8;
+}
+
+void CLinuxSys::ExecuteChannels(TY_Word time_ms_)
+{
+    // Called by the kernel thread. The channels are taken
+    // from a copy of the list, a handler may detach any of
+    // them while the pass is running.
+    ST_KernelData* kernel = current_kernel;
+    CChannel*    channels[MAX_NUM_CHANNELS];
+    TY_Word      num_channels;
+
+    pthread_mutex_lock(&kernel->ChannelLock);
+    num_channels = kernel->NumChannels;
+    for (TY_Word e = 0; e < num_channels; e++)
+    {
+        channels[e] = kernel->Channels[e];
+    }
+    pthread_mutex_unlock(&kernel->ChannelLock);
+
+    for (TY_Word e = 0; e < num_channels; e++)
+    {
+        pthread_mutex_lock(&kernel->ChannelLock);
+        if (IsAttached(kernel, channels[e]) == EN_Bool::FALSE8)
+        {
+            pthread_mutex_unlock(&kernel->ChannelLock);
+            continue;
+        }
+
+        kernel->Executing = channels[e];
+        pthread_mutex_unlock(&kernel->ChannelLock);
+
+        channels[e]->Execute(time_ms_);
+
+        pthread_mutex_lock(&kernel->ChannelLock);
+        kernel->Executing = NULL;
+        pthread_cond_broadcast(&kernel->ChannelDone);
+        pthread_mutex_unlock(&kernel->ChannelLock);
+    }
+}
+
+void CLinuxSys::WakeUp(PTR_Handle kernel_)
+{
+    ST_KernelData* kernel = (ST_KernelData*)kernel_;
+    TY_UInt64      signal = 1;
+
+    if ((kernel != NULL) && (kernel->WakeHandle >= 0))
+    {
+        write(kernel->WakeHandle, &signal, sizeof(signal));
+    }
+}
+
+void CLinuxSys::RequestCycle()
+{
+    // Called by the kernel thread, the state machines
+    // want to be served again in the next cycle
+    if (current_kernel != NULL)
+    {
+        current_kernel->CycleRequested = EN_Bool::TRUE8;
+    }
+}
+
+void CLinuxSys::AddEventSource(PTR_Handle kernel_, int handle_)
+{
+    ST_KernelData* kernel = (ST_KernelData*)kernel_;
+    struct epoll_event event;
+
+    event.events = EPOLLIN;
+    event.data.fd = handle_;
+    epoll_ctl(kernel->EpollHandle, EPOLL_CTL_ADD, handle_, &event);
+}
+
+void CLinuxSys::RemoveEventSource(PTR_Handle kernel_, int handle_)
+{
+    ST_KernelData* kernel = (ST_KernelData*)kernel_;
+
+    epoll_ctl(kernel->EpollHandle, EPOLL_CTL_DEL, handle_, NULL);
+}
+
+PTR_Handle CLinuxSys::CUart::Open(TY_Byte com_port_, TY_DWord baudrate_, PTR_Handle kernel_)
+{
+    ST_KernelData*       kernel = (ST_KernelData*)kernel_;
+    ST_UartData*           uart;
+    TY_Char         dev_name[32];
+    struct termios          tio;
+    struct serial_struct serial;
+    struct epoll_event    event;
+
+    uart = new (std::nothrow) ST_UartData();
+    if (uart == NULL)
+    {
+        return NULL;
+    }
+
+    uart->Port.Handle = -1;
+    uart->Port.CarrOn = EN_Bool::FALSE8;
+    uart->Kernel = kernel_;
+    GetDeviceName(dev_name, sizeof(dev_name), com_port_);
+
+    uart->Port.Handle = open(dev_name, O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+    if (uart->Port.Handle < 0)
+    {
+        // Error stop here
+        delete uart;
+        return NULL;
+    }
+
+    // Exclusive access
+    ioctl(uart->Port.Handle, TIOCEXCL);
+
+    if (tcgetattr(uart->Port.Handle, &tio) != 0)
+    {
+        close(uart->Port.Handle);
+        delete uart;
+        return NULL;
+    }
+
+    //Initialize the com port interface
+    uart->Port.ByteTime = (TY_Byte)COSAL::CTimer::GetByteTime(baudrate_);
+    // 11 bits per character (start, 8 data, parity, stop)
+    uart->ByteTimeNs = (11ULL * 1000000000ULL) / (baudrate_ != 0 ? baudrate_ : 1200);
+    // Raw mode, 8 data bits, odd parity, one stop bit
+    cfmakeraw(&tio);
+    tio.c_cflag &= ~(CSIZE | CSTOPB | CRTSCTS);
+    tio.c_cflag |= CS8 | PARENB | PARODD | CLOCAL | CREAD;
+    // Mark erroneous characters as 0xff 0x00 <char>
+    tio.c_iflag &= ~(IGNPAR | ISTRIP);
+    tio.c_iflag |= INPCK | PARMRK;
+    // Every single character wakes up the receiver
+    tio.c_cc[VMIN] = 1;
+    tio.c_cc[VTIME] = 0;
+    cfsetispeed(&tio, GetSpeed(baudrate_));
+    cfsetospeed(&tio, GetSpeed(baudrate_));
+    //purge any information in the buffer
+    tcflush(uart->Port.Handle, TCIOFLUSH);
+    if (tcsetattr(uart->Port.Handle, TCSANOW, &tio) != 0)
+    {
+        close(uart->Port.Handle);
+        delete uart;
+        return NULL;
+    }
+
+    // Low latency mode of the driver, not supported by all devices
+    if (ioctl(uart->Port.Handle, TIOCGSERIAL, &serial) == 0)
+    {
+        serial.flags |= ASYNC_LOW_LATENCY;
+        ioctl(uart->Port.Handle, TIOCSSERIAL, &serial);
+    }
+
+    // Error counters of the driver, if any
+    uart->HasCounters = EN_Bool::FALSE8;
+    if (ioctl(uart->Port.Handle, TIOCGICOUNT, &uart->Counters) == 0)
+    {
+        uart->HasCounters = EN_Bool::TRUE8;
+    }
+
+    uart->MarkState = 0;
+    uart->RdIdx.store(0, std::memory_order_relaxed);
+    uart->WrIdx.store(0, std::memory_order_relaxed);
+    SetCarrierOff(uart);
+
+    // Hand the port over to the receiver thread of the kernel
+    pthread_mutex_lock(&kernel->RxLock);
+    if (kernel->NumUarts >= MAX_NUM_CHANNELS)
+    {
+        pthread_mutex_unlock(&kernel->RxLock);
+        close(uart->Port.Handle);
+        delete uart;
+        return NULL;
+    }
+
+    kernel->Uarts[kernel->NumUarts] = uart;
+    kernel->NumUarts++;
+    event.events = EPOLLIN;
+    event.data.fd = uart->Port.Handle;
+    epoll_ctl(kernel->RxEpollHandle, EPOLL_CTL_ADD, uart->Port.Handle, &event);
+    pthread_mutex_unlock(&kernel->RxLock);
+    return uart;
+}
+
+void CLinuxSys::CUart::Close(PTR_Handle uart_)
+{
+    ST_UartData*     uart = (ST_UartData*)uart_;
+    ST_KernelData* kernel;
+
+    if (uart == NULL)
+    {
+        return;
+    }
+
+    // The receiver does not touch the port any more
+    // as soon as it is removed under the lock
+    kernel = (ST_KernelData*)uart->Kernel;
+    pthread_mutex_lock(&kernel->RxLock);
+    epoll_ctl(kernel->RxEpollHandle, EPOLL_CTL_DEL, uart->Port.Handle, NULL);
+    for (TY_Word e = 0; e < kernel->NumUarts; e++)
+    {
+        if (kernel->Uarts[e] == uart)
+        {
+            kernel->NumUarts--;
+            kernel->Uarts[e] = kernel->Uarts[kernel->NumUarts];
+            break;
+        }
+    }
+    pthread_mutex_unlock(&kernel->RxLock);
+
+    close(uart->Port.Handle);
+    delete uart;
+}
+
+TY_Len CLinuxSys::CUart::Rx(PTR_Handle uart_, TY_Word max_len_, ST_RcvByte* rcv_bytes_)
+{
+    ST_UartData* uart = (ST_UartData*)uart_;
+    TY_Word    rd_idx = uart->RdIdx.load(std::memory_order_relaxed);
+    TY_Word    wr_idx = uart->WrIdx.load(std::memory_order_acquire);
+    TY_Len     length = 0;
+
+    // Take the bytes stamped by the receiver thread
+    while ((rd_idx != wr_idx) && (length < max_len_))
+    {
+        ST_RcvStamp* stamp = &uart->Ring[rd_idx];
+
+        rcv_bytes_[length].Data = stamp->Data;
+        rcv_bytes_[length].Error = stamp->Error;
+        rcv_bytes_[length].Time = ToKernelTime(stamp->TimeNs);
+        rd_idx = (TY_Word)((rd_idx + 1) & (UART_RX_RING_SIZE - 1));
+        length++;
+    }
+
+    uart->RdIdx.store(rd_idx, std::memory_order_release);
+    return length;
+}
+
+void* CLinuxSys::CUart::Receive(void* data_)
+{
+    ST_KernelData* kernel = (ST_KernelData*)data_;
+    struct epoll_event events[KERNEL_MAX_EVENTS];
+
+    while (true)
+    {
+        int num_events = epoll_wait(kernel->RxEpollHandle, events, KERNEL_MAX_EVENTS, -1);
+
+        if (num_events < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            break;
+        }
+
+        if (IsStopRequested(kernel, events, num_events) == EN_Bool::TRUE8)
+        {
+            break;
+        }
+
+        pthread_mutex_lock(&kernel->RxLock);
+        for (int e = 0; e < num_events; e++)
+        {
+            TY_Byte   data[MAX_TXRX_SIZE];
+            ssize_t  length;
+            TY_UInt64  time;
+            TY_Byte     err;
+            ST_UartData* uart = FindUart(kernel, events[e].data.fd);
+
+            if (uart == NULL)
+            {
+                // Closed in the meantime
+                continue;
+            }
+
+            length = read(uart->Port.Handle, data, sizeof(data));
+            // Stamp at the earliest possible point
+            time = CLinuxSys::GetTimeNs();
+            if (length <= 0)
+            {
+                continue;
+            }
+
+            err = GetErrorClass(uart);
+            StoreReceived(uart, data, (TY_Word)length, err, time);
+        }
+        pthread_mutex_unlock(&kernel->RxLock);
+
+        CLinuxSys::WakeUp(kernel);
+    }
+
+    return NULL;
+}
+
+EN_Error CLinuxSys::CUart::Tx(PTR_Handle uart_, TY_Byte* data_, TY_Word len_)
+{
+    ST_UartData* uart = (ST_UartData*)uart_;
+    TY_Word   written = 0;
+
+    while (written < len_)
+    {
+        ssize_t result = write(uart->Port.Handle, &data_[written], len_ - written);
+        if (result < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            if (errno == EAGAIN)
+            {
+                // The output buffer of the driver is full, sleep until
+                // it drains instead of spinning on the write
+                struct pollfd out = { uart->Port.Handle, POLLOUT, 0 };
+                int ready = poll(&out, 1, TX_POLL_TIMEOUT);
+
+                if ((ready > 0) || ((ready < 0) && (errno == EINTR)))
+                {
+                    continue;
+                }
+            }
+
+            return EN_Error::ERR;
+        }
+
+        written += (TY_Word)result;
+    }
+
+    return EN_Error::NONE;
+}
+
+void CLinuxSys::CUart::SetCarrierOn(PTR_Handle uart_)
+{
+    ST_UartData* uart = (ST_UartData*)uart_;
+    int           rts = TIOCM_RTS;
+    int           dtr = TIOCM_DTR;
+
+    uart->Port.CarrOn = EN_Bool::TRUE8;
+    ioctl(uart->Port.Handle, TIOCMBIS, &rts); //Request to Send
+    ioctl(uart->Port.Handle, TIOCMBIC, &dtr); //Data Terminal Ready
+}
+
+void CLinuxSys::CUart::SetCarrierOff(PTR_Handle uart_)
+{
+    ST_UartData* uart = (ST_UartData*)uart_;
+    int           rts = TIOCM_RTS;
+    int           dtr = TIOCM_DTR;
+
+    uart->Port.CarrOn = EN_Bool::FALSE8;
+    ioctl(uart->Port.Handle, TIOCMBIC, &rts); //Request to Send
+    ioctl(uart->Port.Handle, TIOCMBIS, &dtr); //Data Terminal Ready
+}
+
+EN_Bool CLinuxSys::CUart::IsCarrierOn(PTR_Handle uart_)
+{
+    ST_UartData* uart = (ST_UartData*)uart_;
+
+    return uart->Port.CarrOn;
+}
+
+EN_Error CLinuxSys::CThread::Start(CLinuxSys::CThread::ST_ThreadContr* thread_contr_)
+{
+    thread_contr_->Terminated = EN_Bool::FALSE8;
+    thread_contr_->LastTimeNs = CLinuxSys::GetTimeNs();
+
+    if (pthread_create(&thread_contr_->Handle, NULL, CLinuxSys::CThread::Execute, thread_contr_) != 0)
+    {
+        return EN_Error::ERR;
+    }
+
+    thread_contr_->IsRunning = EN_Bool::TRUE8;
+    if (thread_contr_->Priority == CPrio::High)
+    {
+        struct sched_param param;
+
+        // Requires CAP_SYS_NICE, otherwise the thread
+        // keeps running with the default policy
+        param.sched_priority = sched_get_priority_max(SCHED_FIFO);
+        pthread_setschedparam(thread_contr_->Handle, SCHED_FIFO, &param);
+    }
+
+    return EN_Error::NONE;
+}
+
+void CLinuxSys::CThread::Terminate(CLinuxSys::CThread::ST_ThreadContr* task_contr_)
+{
+    task_contr_->RunFlag = EN_Bool::FALSE8;
+    CLinuxSys::WakeUp(task_contr_->Kernel);
+
+    if (task_contr_->IsRunning == EN_Bool::TRUE8)
+    {
+        if (pthread_equal(task_contr_->Handle, pthread_self()))
+        {
+            // Called from the cyclic handler itself
+            pthread_detach(task_contr_->Handle);
+        }
+        else
+        {
+            pthread_join(task_contr_->Handle, NULL);
+        }
+
+        task_contr_->IsRunning = EN_Bool::FALSE8;
+    }
+}
+
+void* CLinuxSys::CThread::Execute(void* data_)
+{
+    CLinuxSys::CThread::ST_ThreadContr* thread_control = (ST_ThreadContr*)data_;
+    ST_KernelData*                             kernel = (ST_KernelData*)thread_control->Kernel;
+    TY_UInt64                            next_time_ns;
+
+    current_kernel = kernel;
+    next_time_ns = thread_control->LastTimeNs + ((TY_UInt64)thread_control->Cycle * 1000000ULL);
+
+    while (thread_control->RunFlag == EN_Bool::TRUE8)
+    {
+        struct epoll_event events[KERNEL_MAX_EVENTS];
+        struct itimerspec                        due;
+        TY_UInt64                            counter;
+        TY_UInt64                               time;
+        TY_UInt64                        passed_time;
+        int                               num_events;
+        EN_Bool                            is_active = EN_Bool::FALSE8;
+
+        // Arm the timer for the next expiry
+        due.it_interval.tv_sec = 0;
+        due.it_interval.tv_nsec = 0;
+        due.it_value.tv_sec = (time_t)(next_time_ns / 1000000000ULL);
+        due.it_value.tv_nsec = (long)(next_time_ns % 1000000000ULL);
+        timerfd_settime(kernel->TimerHandle, TFD_TIMER_ABSTIME, &due, NULL);
+
+        // Blocks until something is to be done
+        num_events = epoll_wait(kernel->EpollHandle, events, KERNEL_MAX_EVENTS, -1);
+        if (num_events < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            break;
+        }
+
+        for (int e = 0; e < num_events; e++)
+        {
+            if ((events[e].data.fd == kernel->WakeHandle) ||
+                (events[e].data.fd == kernel->TimerHandle))
+            {
+                read(events[e].data.fd, &counter, sizeof(counter));
+            }
+
+            if (events[e].data.fd != kernel->TimerHandle)
+            {
+                // Woken up by data or the application
+                is_active = EN_Bool::TRUE8;
+            }
+        }
+
+        if (thread_control->RunFlag == EN_Bool::FALSE8)
+        {
+            break;
+        }
+
+        time = CLinuxSys::GetTimeNs();
+        passed_time = (time - thread_control->LastTimeNs) / 1000000ULL;
+
+        // Correct passed time in debugging sessions
+        if (passed_time > (TY_UInt64)(KERNEL_MAX_SLEEP + 10 * thread_control->Cycle))
+        {
+            thread_control->LastTimeNs = time;
+            passed_time = 0;
+        }
+
+        // Only the full milliseconds are consumed, the
+        // remainder is carried over to the next cycle
+        thread_control->LastTimeNs += passed_time * 1000000ULL;
+
+        kernel->CycleRequested = EN_Bool::FALSE8;
+        COSAL::CTimer::ClearNextExpiry();
+        if (thread_control->Handler != NULL)
+        {
+            thread_control->Handler((TY_Word)passed_time);
+        }
+
+        next_time_ns = GetNextCycleTime(kernel, thread_control->LastTimeNs, thread_control->Cycle, is_active);
+    }
+
+    thread_control->Terminated = EN_Bool::TRUE8;
+    return NULL;
+}
+
+void CHartMaster::FastCyclicHandler(TY_Word time_ms_)
+{
+    // Call the Hart master protocol handler
+    // of all channels served by this kernel
+    CLinuxSys::ExecuteChannels(time_ms_);
+}
@@ -0,0 +1,112 @@
+/*
+ *          File: LinuxSystem.h (CLinuxSys)
+ *                The OSAL concept cannot be applied to all functions that
+ *                are required. These functions were implemented in the code
+ *                of this module. It is the Linux counterpart of CWinSys.
+ *
+ *        Author: Walter Borst
+ *
+ *        E-Mail: info@borst-automation.de
+ *          Home: https://www.borst-automation.de
+ *
+ * No Warranties: https://www.borst-automation.com/legal/warranty-disclaimer
+ *
+ * Copyright 2006-2025 Walter Borst, Cuxhaven, Germany
+ */
+
+// Once
+#ifndef __linuxsystem_h__
+#define __linuxsystem_h__
+
+#include <pthread.h>
+#include "OSAL.h"
+
+typedef struct st_UartPortData
+{
+    // Note: This is a file descriptor
+    int               Handle;
+    TY_Byte         ByteTime;
+    EN_Bool           CarrOn;
+} ST_UartPortData;
+
+class CChannel;
+
+class CLinuxSys
+{
+public:
+    // Monotonic clock in nanoseconds
+    static TY_UInt64      GetTimeNs();
+    // The channels are served by a small pool of kernel threads.
+    // A kernel sleeps until an event arrives or the next timer
+    // of one of its channels expires.
+    static PTR_Handle  AcquireKernel();
+    static void        ReleaseKernel(PTR_Handle kernel_);
+    static void        AttachChannel(PTR_Handle kernel_, CChannel* channel_);
+    static void        DetachChannel(PTR_Handle kernel_, CChannel* channel_);
+    static void     ExecuteChannels(TY_Word time_ms_);
+    static void               WakeUp(PTR_Handle kernel_);
+    static void         RequestCycle();
+    static void       AddEventSource(PTR_Handle kernel_, int handle_);
+    static void    RemoveEventSource(PTR_Handle kernel_, int handle_);
+
+    class CThread
+    {
+    public:
+        typedef struct st_ThreadContr
+        {
+            EN_Bool      RunFlag;
+            TY_Byte     Priority;
+            void       (*Handler)(TY_Word time_);
+            EN_Bool   Terminated;
+            TY_Word        Cycle;
+            TY_UInt64 LastTimeNs;
+            pthread_t     Handle;
+            EN_Bool    IsRunning;
+            PTR_Handle    Kernel;
+        } ST_ThreadContr;
+
+        class CPrio
+        {
+        public:
+            static const TY_Byte  Low = 0;
+            static const TY_Byte High = 1;
+        };
+
+        // Create cyclically running process
+        static EN_Error                    Start(CLinuxSys::CThread::ST_ThreadContr* task_contr_);
+        static void                    Terminate(CLinuxSys::CThread::ST_ThreadContr* task_contr_);
+        static void*                     Execute(void* data_);
+    };
+
+    class CUart
+    {
+    public:
+        // Longest wait in milliseconds for the driver to accept
+        // more bytes to transmit
+        static const int           TX_POLL_TIMEOUT = 1000;
+        // Port numbers are mapped to device names:
+        //   1..99    -> /dev/ttyS0..   (COM1 = ttyS0)
+        //   100..199 -> /dev/ttyUSB0..
+        //   200..254 -> /dev/ttyACM0..
+        // The received bytes are time stamped by the receiver
+        // thread of the kernel as soon as the driver delivers them.
+        static PTR_Handle                     Open(TY_Byte com_port_, TY_DWord baudrate_, PTR_Handle kernel_);
+        static void                          Close(PTR_Handle uart_);
+        static TY_Len                           Rx(PTR_Handle uart_, TY_Word max_len_, ST_RcvByte* rcv_bytes_);
+        static EN_Error                         Tx(PTR_Handle uart_, TY_Byte* data_, TY_Word len_);
+        static void                   SetCarrierOn(PTR_Handle uart_);
+        static void                  SetCarrierOff(PTR_Handle uart_);
+        static EN_Bool                 IsCarrierOn(PTR_Handle uart_);
+        // Receiver thread, stamps the bytes on arrival
+        static void*                       Receive(void* data_);
+    };
+
+private:
+    // Hide Defaults
+    CLinuxSys();
+    ~CLinuxSys();
+    CLinuxSys(const CLinuxSys& rhs);              /* Hide copy constructor */
+    CLinuxSys& operator=(const CLinuxSys& rhs);   /* Hide assignment operator */
+};
+
+#endif // __linuxsystem_h__
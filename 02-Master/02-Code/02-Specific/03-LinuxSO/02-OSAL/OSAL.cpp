@@ -0,0 +1,619 @@
+/*
+ *          File: OSAL.cpp (COSAL)
+ *                The Operating System Abstraction Layer maps general
+ *                functions to the operating system.
+ *                This is the POSIX (Linux) variant. The lock is based on
+ *                a pthread mutex and all waiting is done against the
+ *                monotonic clock, which is also the time base of the
+ *                timers. The timers keep track of their next expiry,
+ *                which is where the kernel thread wakes up. Each kernel
+ *                thread has its own next expiry.
+ *
+ *        Author: Walter Borst
+ *
+ *        E-Mail: info@borst-automation.de
+ *          Home: https://www.borst-automation.de
+ *
+ * No Warranties: https://www.borst-automation.com/legal/warranty-disclaimer
+ *
+ * Copyright 2006-2025 Walter Borst, Cuxhaven, Germany
+ */
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "OSAL.h"
+#include "LinuxSystem.h"
+
+// Local Types
+typedef struct st_SignalData
+{
+    pthread_mutex_t   Mutex;
+    pthread_cond_t    Cond;
+    TY_DWord          Count;
+    int               EventHandle;
+} ST_SignalData;
+
+typedef struct st_FileMapData
+{
+    TY_Byte*          Data;
+    TY_UInt64         Size;
+} ST_FileMapData;
+
+COSAL::CLock m_lock;
+
+COSAL::CLock::CLock()
+{
+    pthread_mutexattr_t attr;
+
+    m_lock_semaphore = malloc(sizeof(pthread_mutex_t));
+    if (m_lock_semaphore != NULL)
+    {
+        // A critical section under Windows may be entered
+        // recursively by the same thread, keep that behaviour
+        pthread_mutexattr_init(&attr);
+        pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+        pthread_mutex_init((pthread_mutex_t*)m_lock_semaphore, &attr);
+        pthread_mutexattr_destroy(&attr);
+    }
+}
+
+COSAL::CLock::~CLock()
+{
+    if (m_lock_semaphore != NULL)
+    {
+        pthread_mutex_destroy((pthread_mutex_t*)m_lock_semaphore);
+        free(m_lock_semaphore);
+    }
+}
+
+void COSAL::CLock::Lock()
+{
+    if (m_lock_semaphore != NULL)
+    {
+        pthread_mutex_lock((pthread_mutex_t*)m_lock_semaphore);
+    }
+}
+
+void COSAL::CLock::Unlock()
+{
+    if (m_lock_semaphore != NULL)
+    {
+        pthread_mutex_unlock((pthread_mutex_t*)m_lock_semaphore);
+    }
+}
+
+COSAL::CSignal::CSignal()
+{
+    ST_SignalData*     data = (ST_SignalData*)malloc(sizeof(ST_SignalData));
+    pthread_condattr_t attr;
+
+    m_signal_data = data;
+    if (data != NULL)
+    {
+        pthread_mutex_init(&data->Mutex, NULL);
+        // Timeouts are measured against the monotonic clock
+        pthread_condattr_init(&attr);
+        pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+        pthread_cond_init(&data->Cond, &attr);
+        pthread_condattr_destroy(&attr);
+        data->Count = 0;
+        data->EventHandle = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    }
+}
+
+COSAL::CSignal::~CSignal()
+{
+    ST_SignalData* data = (ST_SignalData*)m_signal_data;
+
+    if (data != NULL)
+    {
+        if (data->EventHandle >= 0)
+        {
+            close(data->EventHandle);
+        }
+
+        pthread_cond_destroy(&data->Cond);
+        pthread_mutex_destroy(&data->Mutex);
+        free(data);
+    }
+}
+
+void COSAL::CSignal::Set()
+{
+    ST_SignalData* data = (ST_SignalData*)m_signal_data;
+    TY_UInt64      signal = 1;
+
+    if (data == NULL)
+    {
+        return;
+    }
+
+    pthread_mutex_lock(&data->Mutex);
+    data->Count++;
+    pthread_cond_broadcast(&data->Cond);
+    pthread_mutex_unlock(&data->Mutex);
+    if (data->EventHandle >= 0)
+    {
+        write(data->EventHandle, &signal, sizeof(signal));
+    }
+}
+
+TY_DWord COSAL::CSignal::GetCount()
+{
+    ST_SignalData* data = (ST_SignalData*)m_signal_data;
+    TY_DWord       count;
+
+    if (data == NULL)
+    {
+        return 0;
+    }
+
+    pthread_mutex_lock(&data->Mutex);
+    count = data->Count;
+    pthread_mutex_unlock(&data->Mutex);
+    return count;
+}
+
+EN_Bool COSAL::CSignal::Wait(TY_DWord count_, TY_DWord timeout_ms_)
+{
+    ST_SignalData*  data = (ST_SignalData*)m_signal_data;
+    struct timespec deadline;
+    EN_Bool         result = EN_Bool::TRUE8;
+
+    if (data == NULL)
+    {
+        return EN_Bool::FALSE8;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += (time_t)(timeout_ms_ / 1000);
+    deadline.tv_nsec += (long)(timeout_ms_ % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L)
+    {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    pthread_mutex_lock(&data->Mutex);
+    while (data->Count == count_)
+    {
+        if (pthread_cond_timedwait(&data->Cond, &data->Mutex, &deadline) == ETIMEDOUT)
+        {
+            if (data->Count == count_)
+            {
+                result = EN_Bool::FALSE8;
+            }
+            break;
+        }
+    }
+    pthread_mutex_unlock(&data->Mutex);
+    return result;
+}
+
+PTR_Handle COSAL::CSignal::GetWaitHandle()
+{
+    ST_SignalData* data = (ST_SignalData*)m_signal_data;
+
+    if (data == NULL)
+    {
+        return (PTR_Handle)(intptr_t)-1;
+    }
+
+    // Note: The file descriptor is passed as a handle
+    return (PTR_Handle)(intptr_t)data->EventHandle;
+}
+
+COSAL::CFileMap::CFileMap()
+{
+    ST_FileMapData* data = (ST_FileMapData*)malloc(sizeof(ST_FileMapData));
+
+    m_map_data = data;
+    if (data != NULL)
+    {
+        data->Data = NULL;
+        data->Size = 0;
+    }
+}
+
+COSAL::CFileMap::~CFileMap()
+{
+    Close();
+    free(m_map_data);
+}
+
+EN_Bool COSAL::CFileMap::Open(const TY_Char* file_name_)
+{
+    ST_FileMapData* data = (ST_FileMapData*)m_map_data;
+    struct stat     status;
+    void*           view;
+    int             handle;
+
+    if (data == NULL)
+    {
+        return EN_Bool::FALSE8;
+    }
+
+    Close();
+    handle = open(file_name_, O_RDONLY | O_CLOEXEC);
+    if (handle < 0)
+    {
+        return EN_Bool::FALSE8;
+    }
+
+    if ((fstat(handle, &status) != 0) || (status.st_size <= 0))
+    {
+        close(handle);
+        return EN_Bool::FALSE8;
+    }
+
+    // The mapping holds a reference to the file
+    view = mmap(NULL, (size_t)status.st_size, PROT_READ, MAP_PRIVATE, handle, 0);
+    close(handle);
+    if (view == MAP_FAILED)
+    {
+        return EN_Bool::FALSE8;
+    }
+
+    madvise(view, (size_t)status.st_size, MADV_SEQUENTIAL);
+    data->Data = (TY_Byte*)view;
+    data->Size = (TY_UInt64)status.st_size;
+    return EN_Bool::TRUE8;
+}
+
+void COSAL::CFileMap::Close()
+{
+    ST_FileMapData* data = (ST_FileMapData*)m_map_data;
+
+    if ((data != NULL) && (data->Data != NULL))
+    {
+        munmap(data->Data, (size_t)data->Size);
+        data->Data = NULL;
+        data->Size = 0;
+    }
+}
+
+const TY_Byte* COSAL::CFileMap::GetData()
+{
+    ST_FileMapData* data = (ST_FileMapData*)m_map_data;
+
+    return (data != NULL) ? data->Data : NULL;
+}
+
+TY_UInt64 COSAL::CFileMap::GetSize()
+{
+    ST_FileMapData* data = (ST_FileMapData*)m_map_data;
+
+    return (data != NULL) ? data->Size : 0;
+}
+
+void COSAL::Init(void)
+{
+
+}
+
+void COSAL::Terminate(void)
+{
+
+}
+
+void COSAL::Wait(TY_DWord time_)
+{
+    struct timespec delay;
+
+    delay.tv_sec = (time_t)(time_ / 1000);
+    delay.tv_nsec = (long)(time_ % 1000) * 1000000L;
+
+    // Sleep the full time even if a signal interrupts
+    while (clock_nanosleep(CLOCK_MONOTONIC, 0, &delay, &delay) == EINTR)
+    {
+    }
+}
+
+// Depth of the lock held by the calling thread
+static thread_local TY_Word s_lock_depth = 0;
+
+void COSAL::Lock()
+{
+    m_lock.Lock();
+    s_lock_depth++;
+}
+
+void COSAL::Unlock()
+{
+    s_lock_depth--;
+    m_lock.Unlock();
+}
+
+TY_Word COSAL::ReleaseLock()
+{
+    TY_Word depth = s_lock_depth;
+
+    for (TY_Word e = 0; e < depth; e++)
+    {
+        Unlock();
+    }
+
+    return depth;
+}
+
+void COSAL::RestoreLock(TY_Word depth_)
+{
+    for (TY_Word e = 0; e < depth_; e++)
+    {
+        Lock();
+    }
+}
+
+bool COSAL::IsInvalidIntHandle(WRD_Handle handle_)
+{
+    if (handle_ == INVALID_WRD_HANDLE)
+    {
+        return true;
+    }
+
+    return false;
+}
+
+void COSAL::CopyRcvBytes(ST_RcvByte* dst_, ST_RcvByte* src_, TY_Word len_)
+{
+    TY_Word e;
+
+    if (len_ == 0)
+    {
+        return;
+    }
+    for (e = 0; e < len_; e++)
+    {
+        dst_[e] = src_[e];
+    }
+}
+
+void COSAL::ExtractRcvBytes(TY_Byte* dst_, ST_RcvByte* src_, TY_Word len_)
+{
+    TY_Word e;
+
+    if (len_ == 0)
+    {
+        return;
+    }
+    for (e = 0; e < len_; e++)
+    {
+        dst_[e] = src_[e].Data;
+    }
+}
+
+void COSAL::ExtractRcvErrors(TY_Byte* dst_, ST_RcvByte* src_, TY_Word len_)
+{
+    TY_Word e;
+
+    if (len_ == 0)
+    {
+        return;
+    }
+    for (e = 0; e < len_; e++)
+    {
+        dst_[e] = src_[e].Error;
+    }
+}
+
+thread_local TY_DWord COSAL::CTimer::s_next_expiry = 0;
+thread_local EN_Bool  COSAL::CTimer::s_has_next_expiry = EN_Bool::FALSE8;
+
+void COSAL::CTimer::InitNoneStatic()
+{
+    m_locked = EN_Bool::FALSE8;
+    m_active = EN_Bool::FALSE8;
+    m_start_time = 0;
+    m_time_limit = 0;
+    m_last_time_limit = 0;
+}
+
+COSAL::CTask::CTask()
+{
+    m_terminated = EN_Bool::FALSE8;
+}
+
+void COSAL::CTimer::Start(TY_DWord limit_ms_)
+{
+    m_locked = EN_Bool::TRUE8;
+    m_start_time = COSAL::CTimer::GetTime();
+    m_time_limit = limit_ms_;
+    m_last_time_limit = limit_ms_;
+    m_active = EN_Bool::TRUE8;
+    m_locked = EN_Bool::FALSE8;
+    RegisterExpiry(m_start_time + m_time_limit + 1);
+}
+
+void COSAL::CTimer::Restart()
+{
+    m_locked = EN_Bool::TRUE8;
+    m_start_time = COSAL::CTimer::GetTime();
+    m_time_limit = m_last_time_limit;
+    m_active = EN_Bool::TRUE8;
+    m_locked = EN_Bool::FALSE8;
+    RegisterExpiry(m_start_time + m_time_limit + 1);
+}
+
+void COSAL::CTimer::Continue(TY_DWord limit_ms_)
+{
+    m_locked = EN_Bool::TRUE8;
+    if (m_time_limit == 0)
+    {
+        m_start_time = COSAL::CTimer::GetTime();
+        m_time_limit = limit_ms_;
+    }
+    else
+    {
+        m_time_limit += limit_ms_;
+    }
+    m_active = EN_Bool::TRUE8;
+    m_locked = EN_Bool::FALSE8;
+    RegisterExpiry(m_start_time + m_time_limit + 1);
+}
+
+void COSAL::CTimer::Stop()
+{
+    m_active = EN_Bool::FALSE8;
+}
+
+void COSAL::CTimer::Expire()
+{
+    m_locked = EN_Bool::TRUE8;
+    m_start_time = COSAL::CTimer::GetTime() - m_time_limit - 1;
+    m_locked = EN_Bool::FALSE8;
+}
+
+EN_Bool COSAL::CTimer::IsExpired()
+{
+    TY_DWord current_time = COSAL::CTimer::GetTime();
+
+    if (m_active == EN_Bool::FALSE8)
+    {
+        return EN_Bool::FALSE8;
+    }
+
+    if (m_locked == EN_Bool::TRUE8)
+    {
+        return EN_Bool::FALSE8;
+    }
+
+    if ((current_time - m_start_time) > m_time_limit)
+    {
+        m_active = EN_Bool::FALSE8;
+        m_time_limit = 0;
+        // The owner reacts on the next call, come back soon
+        RegisterExpiry(current_time + 1);
+        return EN_Bool::TRUE8;
+    }
+
+    // Still running, the kernel has to come back in time
+    RegisterExpiry(m_start_time + m_time_limit + 1);
+    return EN_Bool::FALSE8;
+}
+
+EN_Bool COSAL::CTimer::IsActive()
+{
+    return m_active;
+}
+
+void COSAL::CTimer::Init()
+{
+    // Nothing to do, the time is taken from the monotonic clock
+}
+
+TY_DWord COSAL::CTimer::GetTime()
+{
+    // All kernel threads and the application
+    // share the same time base
+    return (TY_DWord)(CLinuxSys::GetTimeNs() / 1000000ULL);
+}
+
+void COSAL::CTimer::ClearNextExpiry()
+{
+    s_has_next_expiry = EN_Bool::FALSE8;
+}
+
+EN_Bool COSAL::CTimer::GetNextExpiry(TY_DWord* time_)
+{
+    *time_ = s_next_expiry;
+    return s_has_next_expiry;
+}
+
+void COSAL::CTimer::RegisterExpiry(TY_DWord expiry_)
+{
+    // Note: IsExpired() is true as soon as the
+    // time limit is exceeded (start + limit + 1)
+    if ((s_has_next_expiry == EN_Bool::FALSE8) ||
+        ((int)(expiry_ - s_next_expiry) < 0))
+    {
+        s_next_expiry = expiry_;
+        s_has_next_expiry = EN_Bool::TRUE8;
+    }
+}
+
+TY_DWord COSAL::CTimer::GetDelay(TY_Word num_bytes_, TY_DWord baudrate_)
+{
+    TY_Float num_bytes = (TY_Float)num_bytes_;
+    TY_Float baudrate = (TY_Float)baudrate_;
+    TY_Float delay = (num_bytes / baudrate) * 11000.0f;
+    return (TY_DWord)delay;
+}
+
+TY_DWord COSAL::CTimer::GetTxDuration(TY_Word num_bytes_, TY_DWord baudrate_)
+{
+    TY_Float num_bytes = (TY_Float)num_bytes_;
+    TY_Float baudrate = (TY_Float)baudrate_;
+    TY_Float duration = ((num_bytes / baudrate) * 11000.0f + 2.0f);
+    return (TY_DWord)duration;
+}
+
+TY_DWord COSAL::CTimer::GetByteTime(TY_DWord bitrate_)
+{
+    switch (bitrate_)
+    {
+    case COSAL::CBitRates::CBR_Win::BR_1200:
+        return COSAL::CBitRates::CByteTime::BT_1200;
+        break;
+    case COSAL::CBitRates::CBR_Win::BR_2400:
+        return COSAL::CBitRates::CByteTime::BT_2400;
+        break;
+    case COSAL::CBitRates::CBR_Win::BR_4800:
+        return COSAL::CBitRates::CByteTime::BT_4800;
+        break;
+    case COSAL::CBitRates::CBR_Win::BR_9600:
+        return COSAL::CBitRates::CByteTime::BT_9600;
+        break;
+    default:
+        return COSAL::CBitRates::CByteTime::BT_Default;
+        break;
+    }
+}
+
+void COSAL::CTimer::UpdateTime(TY_Word time_ms_)
+{
+    // Nothing to do, the time is taken from the monotonic clock
+}
+
+EN_Error COSAL::CTask::Start(void (*handler_)(TY_Word time_))
+{
+    return EN_Error::NONE;
+}
+
+void COSAL::CTask::Terminate()
+{
+
+}
+
+EN_Bool COSAL::CTask::IsTerminated()
+{
+    return m_terminated;
+}
+
+void COSAL::CMem::Copy(TY_Byte* dst_, const TY_Byte* pu8_Src, TY_DWord u32_Len)
+{
+    memcpy(dst_, pu8_Src, u32_Len);
+}
+
+void COSAL::CMem::Set(TY_Byte* dst_, TY_Byte u8_Val, TY_DWord u32_Len)
+{
+    memset(dst_, u8_Val, u32_Len);
+}
+
+EN_Bool COSAL::CMem::IsEqual(TY_Byte* mem1_, TY_Byte* mem2_, TY_DWord len_)
+{
+    if (memcmp(mem1_, mem2_, len_) == 0)
+    {
+        return EN_Bool::TRUE8;
+    }
+
+    return EN_Bool::FALSE8;
+}
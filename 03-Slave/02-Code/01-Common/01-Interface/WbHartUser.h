@@ -38,6 +38,7 @@ static const TY_Byte MAX_COMPORT_ID = 254;
 
 // Monitor
 static const TY_Word MON_MAX_FRAME_DATA_SIZE = 256;
-static const TY_Word MON_MAX_NUM_FRAMES = 5000;
+// Bytes of the log of the frames, a power of two
+static const TY_DWord MON_LOG_SIZE = 1024 * 1024;
 
 #endif // __wbhartuser_h__
@@ -27,6 +27,7 @@ EN_Bool CChannel::HartEnabledChanged = EN_Bool::TRUE8;
 EN_Bool CChannel::BurstModeChanged = EN_Bool::FALSE8;
 CService CChannel::PrimMasterService;
 CService CChannel::ScndMasterService;
+CMonitor CChannel::Monitor;
 
 // Private
 EN_Bool     CChannel::m_is_open = EN_Bool::FALSE8;
@@ -17,6 +17,8 @@
 #ifndef __chart_channel_h__
 #define __chart_channel_h__
 
+#include "Monitor.h"
+
 class CService;
 class CChannel
 {
@@ -29,6 +31,7 @@ public:
     static EN_Bool  BurstModeChanged;
     static CService PrimMasterService; // SRV_Handle == 0
     static CService ScndMasterService; // SRV_handle == 1
+    static CMonitor Monitor;
 
     // Methods
     static EN_Bool                   Open(TY_Word port_number_, EN_CommType type_);
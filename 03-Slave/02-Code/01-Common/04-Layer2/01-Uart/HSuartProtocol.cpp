@@ -62,7 +62,7 @@ CHSuartMacPort::EN_ToDo CHSuartProtocol::EventHandler(EN_Event event_, TY_Byte*
         {
             if (rx_tx_len_ == 1)
             {
-                CMonitor::StartReceive(COSAL::CTimer::GetTime());
+                CChannel::Monitor.StartReceive(COSAL::CTimer::GetTime());
                 // Just to be sure
                 CHSuartProtocol::WorkFrame.Init();
                 // Just inform Hart layer 2 that the first byte was received
@@ -116,24 +116,24 @@ CHSuartMacPort::EN_ToDo CHSuartProtocol::EventHandler(EN_Event event_, TY_Byte*
         diff = debug_now - debug_start;
 
         frame_type = CHSuartProtocol::WorkFrame.Type;
-        CMonitor::StoreData(rx_tx_bytes_, rx_tx_len_);
+        CChannel::Monitor.StoreData(rx_tx_bytes_, rx_tx_len_);
 
         switch (frame_type)
         {
         case CFrame::EN_Type::REQUEST:
-            CMonitor::EndRcvValidFrame(COSAL::CTimer::GetTime());
+            CChannel::Monitor.EndRcvValidFrame(COSAL::CTimer::GetTime());
             me_to_do = CHSuartL2SM::EventHandler(CHSuartL2SM::EN_Event::RCV_MSG_STX);
             break;
         case CFrame::EN_Type::RESPONSE:
-            CMonitor::EndRcvValidFrame(COSAL::CTimer::GetTime());
+            CChannel::Monitor.EndRcvValidFrame(COSAL::CTimer::GetTime());
             me_to_do = CHSuartL2SM::EventHandler(CHSuartL2SM::EN_Event::RCV_MSG_ACK);
             break;
         case CFrame::EN_Type::BURST:
-            CMonitor::EndRcvValidFrame(COSAL::CTimer::GetTime());
+            CChannel::Monitor.EndRcvValidFrame(COSAL::CTimer::GetTime());
             me_to_do = CHSuartL2SM::EventHandler(CHSuartL2SM::EN_Event::RCV_MSG_BACK);
             break;
         case CFrame::EN_Type::JUNK:
-            CMonitor::EndRcvGapTO(COSAL::CTimer::GetTime());
+            CChannel::Monitor.EndRcvGapTO(COSAL::CTimer::GetTime());
             me_to_do = CHSuartL2SM::EventHandler(CHSuartL2SM::EN_Event::RCV_MSG_ERR);
             CHSuartProtocol::WorkFrame.Init();
             break;
@@ -210,12 +210,12 @@ CHSuartMacPort::EN_ToDo CHSuartProtocol::EventHandler(EN_Event event_, TY_Byte*
             mac_to_do = CHSuartMacPort::EN_ToDo::SEND_DATA;
             if (m_tx_len > 0)
             {
-                CMonitor::StartTransmit(COSAL::CTimer::GetTime() + 1);
-                CMonitor::StoreData(m_tx_data_ref, m_tx_len);
+                CChannel::Monitor.StartTransmit(COSAL::CTimer::GetTime() + 1);
+                CChannel::Monitor.StoreData(m_tx_data_ref, m_tx_len);
             }
             break;
         case EN_ToDo::END_TRANSMIT:
-            CMonitor::EndTransmit(COSAL::CTimer::GetTime() - 1);
+            CChannel::Monitor.EndTransmit(COSAL::CTimer::GetTime() - 1);
             me_to_do = CHSuartL2SM::EventHandler(CHSuartL2SM::EN_Event::XMT_MSG_done);
             if (me_to_do == EN_ToDo::RECEIVE_ENABLE)
             {
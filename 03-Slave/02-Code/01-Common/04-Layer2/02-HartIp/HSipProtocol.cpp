@@ -157,9 +157,9 @@ CHSipMacPort::EN_ToDo CHSipProtocol::EventHandler(EN_Event event_, TY_Byte* rx_t
                 TY_Byte tx_len = 0;
 
                 CHSipMacPort::SetMessageType(1);
-                CMonitor::StartTransmit(COSAL::CTimer::GetTime() + 1);
+                CChannel::Monitor.StartTransmit(COSAL::CTimer::GetTime() + 1);
                 CHSipMacPort::GetIpFrameForMonitor(tx_data, &tx_len, m_tx_data, (TY_Byte)m_tx_len);
-                CMonitor::StoreData(tx_data, tx_len);
+                CChannel::Monitor.StoreData(tx_data, tx_len);
             }
 
             break;
@@ -172,14 +172,14 @@ CHSipMacPort::EN_ToDo CHSipProtocol::EventHandler(EN_Event event_, TY_Byte* rx_t
                 TY_Byte tx_len = 0;
 
                 CHSipMacPort::SetMessageType(2);
-                CMonitor::StartTransmit(COSAL::CTimer::GetTime() + 1);
+                CChannel::Monitor.StartTransmit(COSAL::CTimer::GetTime() + 1);
                 CHSipMacPort::GetIpFrameForMonitor(tx_data, &tx_len, m_tx_data, (TY_Byte)m_tx_len);
-                CMonitor::StoreData(tx_data, tx_len);
+                CChannel::Monitor.StoreData(tx_data, tx_len);
             }
 
             break;
         case EN_ToDo::END_TRANSMIT:
-            CMonitor::EndTransmit(COSAL::CTimer::GetTime() - 1);
+            CChannel::Monitor.EndTransmit(COSAL::CTimer::GetTime() - 1);
             me_to_do = CHSipL2SM::EventHandler(CHSipL2SM::EN_Event::XMT_MSG_done);
             if (me_to_do == EN_ToDo::RECEIVE_ENABLE)
             {
@@ -215,7 +215,7 @@ CHSipProtocol::EN_ToDo CHSipProtocol::HandleHartIpPayloadPacket(TY_Byte* rx_tx_b
     CFrame::EN_Type   frame_type = CFrame::EN_Type::NO_HART_IP;
 
 
-    CMonitor::StartReceive(COSAL::CTimer::GetTime());
+    CChannel::Monitor.StartReceive(COSAL::CTimer::GetTime());
     // Just inform Hart layer 2 that the first byte (at least) was received
     EN_ToDo to_do = CHSipL2SM::EventHandler(CHSipL2SM::EN_Event::ACTIVITY_DETECTED);
 
@@ -228,25 +228,25 @@ CHSipProtocol::EN_ToDo CHSipProtocol::HandleHartIpPayloadPacket(TY_Byte* rx_tx_b
 
     CHSipMacPort::SetMessageType(0);
     CHSipMacPort::GetIpFrameForMonitor(rx_data, &rx_len, rx_tx_bytes_, (TY_Byte)rx_tx_len_);
-    CMonitor::StoreData(rx_data, rx_len);
+    CChannel::Monitor.StoreData(rx_data, rx_len);
 
     frame_type = CHSipProtocol::WorkFrame.Type;
     switch (frame_type)
     {
     case CFrame::EN_Type::REQUEST:
-        CMonitor::EndRcvValidFrame(COSAL::CTimer::GetTime());
+        CChannel::Monitor.EndRcvValidFrame(COSAL::CTimer::GetTime());
         to_do = CHSipL2SM::EventHandler(CHSipL2SM::EN_Event::RCV_MSG_STX);
         break;
     case CFrame::EN_Type::RESPONSE:
-        CMonitor::EndRcvValidFrame(COSAL::CTimer::GetTime());
+        CChannel::Monitor.EndRcvValidFrame(COSAL::CTimer::GetTime());
         to_do = CHSipL2SM::EventHandler(CHSipL2SM::EN_Event::RCV_MSG_ACK);
         break;
     case CFrame::EN_Type::BURST:
-        CMonitor::EndRcvValidFrame(COSAL::CTimer::GetTime());
+        CChannel::Monitor.EndRcvValidFrame(COSAL::CTimer::GetTime());
         to_do = CHSipL2SM::EventHandler(CHSipL2SM::EN_Event::RCV_MSG_BACK);
         break;
     case CFrame::EN_Type::JUNK:
-        CMonitor::EndRcvGapTO(COSAL::CTimer::GetTime());
+        CChannel::Monitor.EndRcvGapTO(COSAL::CTimer::GetTime());
         to_do = CHSipL2SM::EventHandler(CHSipL2SM::EN_Event::RCV_MSG_ERR);
         CHSipProtocol::WorkFrame.Init();
         break;
@@ -17,6 +17,7 @@
 
 #include "HartFrame.h"
 #include "HartConsts.h"
+#include "HartCoding.h"
  // Only in case of a slave
  // for the function encode
 #include "WbHartS_Structures.h"
@@ -145,10 +146,7 @@ void CFrame::Encode()
     // Move to next position
     actual_pos = (TY_Byte)(actual_pos + payload_len + add_data_len + 1);
     // Insert Checksum
-    for (e = start_chk_pos; e < actual_pos; e++)
-    {
-        chk ^= data[e];
-    }
+    chk = CCoding::CheckSum(&data[start_chk_pos], (TY_Word)(actual_pos - start_chk_pos));
 
     data[actual_pos++] = chk;
     TxBufferLen = actual_pos;
@@ -178,11 +176,6 @@ void CFrame::GetOtherUniqueID(TY_Byte* bytes_of_unique_id_)
     COSAL::CMem::Copy(bytes_of_unique_id_, m_address, 5);
 }
 
-EN_Bool CFrame::GetRemoteMaster()
-{
-    return m_remote_master;
-}
-
 // Special function
 TY_Byte CFrame::GetDeviceStatus(EN_Master master_, CFrame::EN_Type frame_type_)
 {
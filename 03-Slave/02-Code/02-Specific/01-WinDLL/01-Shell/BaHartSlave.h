@@ -137,7 +137,14 @@ HARTDLL_API void    WINAPI BAHASL_TerminateMonitor();
 HARTDLL_API void    WINAPI BAHASL_StartMonitor();
 HARTDLL_API void    WINAPI BAHASL_StopMonitor();
 HARTDLL_API EN_Bool WINAPI BAHASL_GetMonitorData(TY_MonFrame* mon_frame);
+HARTDLL_API TY_Word WINAPI BAHASL_GetMonitorFrames(TY_MonFrame* mon_frames, TY_Word max_frames);
+HARTDLL_API TY_DWord WINAPI BAHASL_GetMonitorDropped(void);
 HARTDLL_API EN_Bit  WINAPI BAHASL_GetMonitorStatus(void);
 HARTDLL_API TY_Word WINAPI BAHASL_GetMonitorAddData(TY_Byte* data_);
+// Streaming of the monitor frames to pcapng files, ServeCapture is
+// called cyclically by the application instead of GetMonitorData
+HARTDLL_API EN_Bool WINAPI BAHASL_StartCapture(const TY_Char* file_name, TY_DWord max_file_size, TY_DWord max_file_time);
+HARTDLL_API TY_DWord WINAPI BAHASL_ServeCapture(void);
+HARTDLL_API void    WINAPI BAHASL_StopCapture(void);
 
 #endif // __bahartslave_h__
\ No newline at end of file
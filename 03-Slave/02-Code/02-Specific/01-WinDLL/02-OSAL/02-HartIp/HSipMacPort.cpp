@@ -583,7 +583,7 @@ void CHSipMacPort::EncodeResponse()
     m_tx_buf[6] = (TY_Byte)(payload_len >> 8);
     m_tx_buf[7] = (TY_Byte)(payload_len);
     m_hart_ip_message_type = 1;
-    CMonitor::SetAdditionalData(m_tx_buf, m_tx_len);
+    CChannel::Monitor.SetAdditionalData(m_tx_buf, m_tx_len);
 }
 
 void CHSipMacPort::EncodeBurst()
@@ -618,7 +618,7 @@ void CHSipMacPort::EncodeBurst()
     m_tx_buf[6] = (TY_Byte)(payload_len >> 8);
     m_tx_buf[7] = (TY_Byte)(payload_len);
     m_hart_ip_message_type = 2;
-    CMonitor::SetAdditionalData(m_tx_buf, m_tx_len);
+    CChannel::Monitor.SetAdditionalData(m_tx_buf, m_tx_len);
 }
 
 void CHSipMacPort::EncodeInitiateResponse()
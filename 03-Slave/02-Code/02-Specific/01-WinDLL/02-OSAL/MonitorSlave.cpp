@@ -23,42 +23,71 @@
 #include "WinSystem.h"
 #include "HSuartMacPort.h"
 #include "Monitor.h"
+#include "MonitorCapture.h"
+#include "HartChannel.h"
 
 #include "BaHartSlave.h"
 
+// Capture of the monitor frames to pcapng files
+static CMonitorCapture capture;
+
 // Windows specific part
 HARTDLL_API void WINAPI BAHASL_InitMonitor()
 {
-    CMonitor::Init();
+    CChannel::Monitor.Init();
 }
 
 HARTDLL_API void WINAPI BAHASL_TerminateMonitor()
 {
-    CMonitor::Terminate();
+    CChannel::Monitor.Terminate();
 }
 
 HARTDLL_API void WINAPI BAHASL_StartMonitor()
 {
-    CMonitor::Start();
+    CChannel::Monitor.Start();
 }
 
 HARTDLL_API void WINAPI BAHASL_StopMonitor()
 {
-    CMonitor::Stop();
+    CChannel::Monitor.Stop();
 }
 
 HARTDLL_API EN_Bool WINAPI BAHASL_GetMonitorData(TY_MonFrame* mon_frame_)
 {
-    return CMonitor::GetData(mon_frame_);
+    return CChannel::Monitor.GetData(mon_frame_);
+}
+
+HARTDLL_API TY_Word WINAPI BAHASL_GetMonitorFrames(TY_MonFrame* mon_frames_, TY_Word max_frames_)
+{
+    return CChannel::Monitor.GetData(mon_frames_, max_frames_);
+}
+
+HARTDLL_API TY_DWord WINAPI BAHASL_GetMonitorDropped(void)
+{
+    return CChannel::Monitor.GetNumDropped();
 }
 
 HARTDLL_API EN_Bit WINAPI BAHASL_GetMonitorStatus(void)
 {
-    return CMonitor::GetStatus();
+    return CChannel::Monitor.GetStatus();
 }
 
 HARTDLL_API TY_Word WINAPI BAHASL_GetMonitorAddData(TY_Byte* data_)
 {
-    return CMonitor::GetPayloadData(data_);
+    return CChannel::Monitor.GetPayloadData(data_);
 }
 
+HARTDLL_API EN_Bool WINAPI BAHASL_StartCapture(const TY_Char* file_name_, TY_DWord max_file_size_, TY_DWord max_file_time_)
+{
+    return capture.Open(file_name_, max_file_size_, max_file_time_);
+}
+
+HARTDLL_API TY_DWord WINAPI BAHASL_ServeCapture(void)
+{
+    return capture.Serve(&CChannel::Monitor);
+}
+
+HARTDLL_API void WINAPI BAHASL_StopCapture(void)
+{
+    capture.Close();
+}
@@ -72,16 +72,41 @@ void COSAL::Wait(TY_DWord time_)
     Sleep(time_);
 }
 
+// Depth of the lock held by the calling thread
+static thread_local TY_Word s_lock_depth = 0;
+
 void COSAL::Lock()
 {
     m_lock.Lock();
+    s_lock_depth++;
 }
 
 void COSAL::Unlock()
 {
+    s_lock_depth--;
     m_lock.Unlock();
 }
 
+TY_Word COSAL::ReleaseLock()
+{
+    TY_Word depth = s_lock_depth;
+
+    for (TY_Word e = 0; e < depth; e++)
+    {
+        Unlock();
+    }
+
+    return depth;
+}
+
+void COSAL::RestoreLock(TY_Word depth_)
+{
+    for (TY_Word e = 0; e < depth_; e++)
+    {
+        Lock();
+    }
+}
+
 TY_DWord COSAL::CTimer::s_time = 0;
 
 void COSAL::CTimer::InitNoneStatic()
@@ -133,6 +158,13 @@ void COSAL::CTimer::Stop()
     m_active = EN_Bool::FALSE8;
 }
 
+void COSAL::CTimer::Expire()
+{
+    m_locked = EN_Bool::TRUE8;
+    m_start_time = COSAL::CTimer::GetTime() - m_time_limit - 1;
+    m_locked = EN_Bool::FALSE8;
+}
+
 EN_Bool COSAL::CTimer::IsExpired()
 {
     TY_DWord current_time = COSAL::CTimer::GetTime();
@@ -0,0 +1,654 @@
+/*
+ *          File: LinuxSystem.cpp (CLinuxSys)
+ *                The OSAL concept cannot be applied to all functions that
+ *                are required. These functions were implemented in the code
+ *                of this module. It is the Linux counterpart of CWinSys.
+ *                The cyclic thread is clocked by a timerfd on the
+ *                monotonic clock. The elapsed time is accounted in
+ *                nanoseconds, so no fraction of a millisecond gets lost.
+ *
+ *        Author: Walter Borst
+ *
+ *        E-Mail: info@borst-automation.de
+ *          Home: https://www.borst-automation.de
+ *
+ * No Warranties: https://www.borst-automation.com/legal/warranty-disclaimer
+ *
+ * Copyright 2006-2025 Walter Borst, Cuxhaven, Germany
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <termios.h>
+#include <time.h>
+#include <errno.h>
+#include <stdio.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/timerfd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <linux/serial.h>
+#include <atomic>
+#include "WbHartSlave.h"
+#include "LinuxSystem.h"
+#include "HSuartMacPort.h"
+#include "HSipMacPort.h"
+#include "HartSlaveIface.h"
+#include "HartChannel.h"
+
+static ST_UartPortData uart_port_data = { -1, 0, EN_Bool::FALSE8 };
+static CLinuxSys::CThread::ST_ThreadContr cyclic_thread_control;
+static CLinuxSys::CCyclicTask CyclicTask;
+pthread_t CLinuxSys::CThread::m_handle;
+EN_Bool   CLinuxSys::CThread::m_is_running = EN_Bool::FALSE8;
+
+// Receiver of the uart, the ring is written by the
+// receiver thread and read by the cyclic thread
+static const TY_Word UART_RX_RING_SIZE = 512;
+
+typedef struct st_RcvStamp
+{
+    TY_Byte        Data;
+    TY_Byte       Error;
+} ST_RcvStamp;
+
+typedef struct st_UartRxData
+{
+    pthread_t                       Thread;
+    EN_Bool                      IsRunning = EN_Bool::FALSE8;
+    int                        EpollHandle = -1;
+    int                         StopHandle = -1;
+    EN_Bool                    HasCounters = EN_Bool::FALSE8;
+    struct serial_icounter_struct Counters;
+    TY_Byte                      MarkState = 0;
+    std::atomic<TY_Word>             RdIdx;
+    std::atomic<TY_Word>             WrIdx;
+    ST_RcvStamp     Ring[UART_RX_RING_SIZE];
+} ST_UartRxData;
+
+static ST_UartRxData uart_rx_data;
+
+// Local helpers
+static speed_t GetSpeed(TY_DWord baudrate_)
+{
+    switch (baudrate_)
+    {
+    case COSAL::CBitRates::CBR_Win::BR_2400:
+        return B2400;
+    case COSAL::CBitRates::CBR_Win::BR_4800:
+        return B4800;
+    case COSAL::CBitRates::CBR_Win::BR_9600:
+        return B9600;
+    case COSAL::CBitRates::CBR_Win::BR_19200:
+        return B19200;
+    case COSAL::CBitRates::CBR_Win::BR_38400:
+        return B38400;
+    case COSAL::CBitRates::CBR_Win::BR_57600:
+        return B57600;
+    default:
+        return B1200;
+    }
+}
+
+static void GetDeviceName(TY_Char* name_, TY_Word max_len_, TY_Byte com_port_)
+{
+    if (com_port_ >= 200)
+    {
+        snprintf(name_, max_len_, "/dev/ttyACM%d", com_port_ - 200);
+    }
+    else if (com_port_ >= 100)
+    {
+        snprintf(name_, max_len_, "/dev/ttyUSB%d", com_port_ - 100);
+    }
+    else
+    {
+        snprintf(name_, max_len_, "/dev/ttyS%d", com_port_ - 1);
+    }
+}
+
+static EN_Bool IsStopRequested(struct epoll_event* events_, int num_events_)
+{
+    for (int e = 0; e < num_events_; e++)
+    {
+        if (events_[e].data.fd == uart_rx_data.StopHandle)
+        {
+            return EN_Bool::TRUE8;
+        }
+    }
+
+    return EN_Bool::FALSE8;
+}
+
+static TY_Byte GetErrorClass()
+{
+    // Which error caused the marked characters?
+    struct serial_icounter_struct counters;
+    TY_Byte                             err = COSAL::CRcvErr::ERR_None;
+
+    if (uart_rx_data.HasCounters == EN_Bool::FALSE8)
+    {
+        return COSAL::CRcvErr::ERR_Parity;
+    }
+
+    if (ioctl(uart_port_data.Handle, TIOCGICOUNT, &counters) != 0)
+    {
+        return COSAL::CRcvErr::ERR_Parity;
+    }
+
+    if (counters.frame != uart_rx_data.Counters.frame)
+        err |= COSAL::CRcvErr::ERR_Frame;
+    if (counters.parity != uart_rx_data.Counters.parity)
+        err |= COSAL::CRcvErr::ERR_Parity;
+    if ((counters.overrun != uart_rx_data.Counters.overrun) ||
+        (counters.buf_overrun != uart_rx_data.Counters.buf_overrun))
+        err |= COSAL::CRcvErr::ERR_Over;
+
+    uart_rx_data.Counters = counters;
+    return err;
+}
+
+static void StoreReceived(TY_Byte* data_, TY_Word len_, TY_Byte err_)
+{
+    // Decode the PARMRK sequences first
+    //   0xff 0xff       -> 0xff
+    //   0xff 0x00 <chr> -> <chr> with error
+    TY_Byte   bytes[MAX_TXRX_SIZE];
+    TY_Byte  errors[MAX_TXRX_SIZE];
+    TY_Word      len = 0;
+    TY_Word   wr_idx = uart_rx_data.WrIdx.load(std::memory_order_relaxed);
+    TY_Word   rd_idx = uart_rx_data.RdIdx.load(std::memory_order_acquire);
+    TY_Byte      err = err_;
+
+    for (TY_Word e = 0; e < len_; e++)
+    {
+        TY_Byte data = data_[e];
+
+        switch (uart_rx_data.MarkState)
+        {
+        case 0:
+            if (data == 0xff)
+            {
+                uart_rx_data.MarkState = 1;
+            }
+            else
+            {
+                bytes[len] = data;
+                errors[len] = COSAL::CRcvErr::ERR_None;
+                len++;
+            }
+            break;
+        case 1:
+            if (data == 0xff)
+            {
+                bytes[len] = 0xff;
+                errors[len] = COSAL::CRcvErr::ERR_None;
+                len++;
+                uart_rx_data.MarkState = 0;
+            }
+            else
+            {
+                uart_rx_data.MarkState = 2;
+            }
+            break;
+        default:
+            if (err == COSAL::CRcvErr::ERR_None)
+            {
+                err = COSAL::CRcvErr::ERR_Parity;
+            }
+
+            bytes[len] = data;
+            errors[len] = err;
+            len++;
+            uart_rx_data.MarkState = 0;
+            break;
+        }
+    }
+
+    for (TY_Word e = 0; e < len; e++)
+    {
+        TY_Word next_idx = (TY_Word)((wr_idx + 1) & (UART_RX_RING_SIZE - 1));
+
+        if (next_idx == rd_idx)
+        {
+            // Ring full, the kernel is not taking the data
+            break;
+        }
+
+        uart_rx_data.Ring[wr_idx].Data = bytes[e];
+        uart_rx_data.Ring[wr_idx].Error = errors[e];
+        wr_idx = next_idx;
+    }
+
+    uart_rx_data.WrIdx.store(wr_idx, std::memory_order_release);
+}
+
+TY_UInt64 CLinuxSys::GetTimeNs()
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((TY_UInt64)now.tv_sec * 1000000000ULL) + (TY_UInt64)now.tv_nsec;
+}
+
+EN_Bool CLinuxSys::CUart::Open(TY_Byte com_port_, TY_DWord baudrate_)
+{
+    TY_Char                 dev_name[32];
+    struct termios               tio;
+    struct serial_struct      serial;
+    struct epoll_event         event;
+
+    GetDeviceName(dev_name, sizeof(dev_name), com_port_);
+
+    uart_port_data.Handle = open(dev_name, O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+    if (uart_port_data.Handle < 0)
+    {
+        // Error stop here
+        uart_port_data.Handle = -1;
+        return EN_Bool::FALSE8;
+    }
+
+    // Exclusive access
+    ioctl(uart_port_data.Handle, TIOCEXCL);
+
+    if (tcgetattr(uart_port_data.Handle, &tio) != 0)
+    {
+        Close();
+        return EN_Bool::FALSE8;
+    }
+
+    //Initialize the com port interface
+    uart_port_data.ByteTime = (TY_Byte)COSAL::CTimer::GetByteTime(baudrate_);
+    // Raw mode, 8 data bits, odd parity, one stop bit
+    cfmakeraw(&tio);
+    tio.c_cflag &= ~(CSIZE | CSTOPB | CRTSCTS);
+    tio.c_cflag |= CS8 | PARENB | PARODD | CLOCAL | CREAD;
+    // Mark erroneous characters as 0xff 0x00 <char>
+    tio.c_iflag &= ~(IGNPAR | ISTRIP);
+    tio.c_iflag |= INPCK | PARMRK;
+    // Every single character wakes up the receiver
+    tio.c_cc[VMIN] = 1;
+    tio.c_cc[VTIME] = 0;
+    cfsetispeed(&tio, GetSpeed(baudrate_));
+    cfsetospeed(&tio, GetSpeed(baudrate_));
+    //purge any information in the buffer
+    tcflush(uart_port_data.Handle, TCIOFLUSH);
+    if (tcsetattr(uart_port_data.Handle, TCSANOW, &tio) != 0)
+    {
+        Close();
+        return EN_Bool::FALSE8;
+    }
+
+    // Low latency mode of the driver, not supported by all devices
+    if (ioctl(uart_port_data.Handle, TIOCGSERIAL, &serial) == 0)
+    {
+        serial.flags |= ASYNC_LOW_LATENCY;
+        ioctl(uart_port_data.Handle, TIOCSSERIAL, &serial);
+    }
+
+    // Error counters of the driver, if any
+    uart_rx_data.HasCounters = EN_Bool::FALSE8;
+    if (ioctl(uart_port_data.Handle, TIOCGICOUNT, &uart_rx_data.Counters) == 0)
+    {
+        uart_rx_data.HasCounters = EN_Bool::TRUE8;
+    }
+
+    // Receiver thread waiting for the port and the stop event
+    uart_rx_data.MarkState = 0;
+    uart_rx_data.RdIdx.store(0, std::memory_order_relaxed);
+    uart_rx_data.WrIdx.store(0, std::memory_order_relaxed);
+    uart_rx_data.EpollHandle = epoll_create1(EPOLL_CLOEXEC);
+    uart_rx_data.StopHandle = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if ((uart_rx_data.EpollHandle < 0) || (uart_rx_data.StopHandle < 0))
+    {
+        Close();
+        return EN_Bool::FALSE8;
+    }
+
+    event.events = EPOLLIN;
+    event.data.fd = uart_port_data.Handle;
+    epoll_ctl(uart_rx_data.EpollHandle, EPOLL_CTL_ADD, uart_port_data.Handle, &event);
+    event.events = EPOLLIN;
+    event.data.fd = uart_rx_data.StopHandle;
+    epoll_ctl(uart_rx_data.EpollHandle, EPOLL_CTL_ADD, uart_rx_data.StopHandle, &event);
+
+    if (pthread_create(&uart_rx_data.Thread, NULL, CLinuxSys::CUart::Receive, NULL) != 0)
+    {
+        Close();
+        return EN_Bool::FALSE8;
+    }
+
+    uart_rx_data.IsRunning = EN_Bool::TRUE8;
+    SetCarrierOff();
+    return EN_Bool::TRUE8;
+}
+
+void CLinuxSys::CUart::Close()
+{
+    TY_UInt64 stop = 1;
+
+    COSAL::Unlock();
+    if (uart_rx_data.IsRunning == EN_Bool::TRUE8)
+    {
+        // Wake up and stop the receiver thread
+        write(uart_rx_data.StopHandle, &stop, sizeof(stop));
+        pthread_join(uart_rx_data.Thread, NULL);
+        uart_rx_data.IsRunning = EN_Bool::FALSE8;
+    }
+
+    if (uart_rx_data.EpollHandle >= 0)
+    {
+        close(uart_rx_data.EpollHandle);
+        uart_rx_data.EpollHandle = -1;
+    }
+
+    if (uart_rx_data.StopHandle >= 0)
+    {
+        close(uart_rx_data.StopHandle);
+        uart_rx_data.StopHandle = -1;
+    }
+
+    if (uart_port_data.Handle >= 0)
+    {
+        close(uart_port_data.Handle);
+        uart_port_data.Handle = -1;
+        CLinuxSys::CThread::Terminate(&cyclic_thread_control);
+    }
+    COSAL::Lock();
+}
+
+EN_Bool CLinuxSys::CUart::Rx(TY_Byte* rx_tx_buffer_, TY_Byte* rx_tx_len_, TY_Byte* rx_tx_err_)
+{
+    TY_Word rd_idx = uart_rx_data.RdIdx.load(std::memory_order_relaxed);
+    TY_Word wr_idx = uart_rx_data.WrIdx.load(std::memory_order_acquire);
+
+    *rx_tx_err_ = 0;
+
+    if ((rd_idx == wr_idx) || (*rx_tx_len_ >= MAX_TXRX_SIZE))
+    {
+        return EN_Bool::FALSE8;
+    }
+
+    // Only one byte per call, as in the Windows implementation
+    rx_tx_buffer_[*rx_tx_len_] = uart_rx_data.Ring[rd_idx].Data;
+    *rx_tx_err_ = uart_rx_data.Ring[rd_idx].Error;
+    uart_rx_data.RdIdx.store((TY_Word)((rd_idx + 1) & (UART_RX_RING_SIZE - 1)), std::memory_order_release);
+
+    *rx_tx_len_ += 1;
+    return EN_Bool::TRUE8;
+}
+
+void* CLinuxSys::CUart::Receive(void* data_)
+{
+    struct epoll_event events[2];
+
+    while (true)
+    {
+        TY_Byte   data[MAX_TXRX_SIZE];
+        ssize_t  length;
+        TY_Byte     err;
+        int    num_events = epoll_wait(uart_rx_data.EpollHandle, events, 2, -1);
+
+        if (num_events < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            break;
+        }
+
+        if (IsStopRequested(events, num_events) == EN_Bool::TRUE8)
+        {
+            break;
+        }
+
+        length = read(uart_port_data.Handle, data, sizeof(data));
+        if (length <= 0)
+        {
+            continue;
+        }
+
+        err = GetErrorClass();
+        StoreReceived(data, (TY_Word)length, err);
+    }
+
+    return NULL;
+}
+
+EN_Error CLinuxSys::CUart::Tx(TY_Byte* data_, TY_Word len_)
+{
+    TY_Word written = 0;
+
+    while (written < len_)
+    {
+        ssize_t result = write(uart_port_data.Handle, &data_[written], len_ - written);
+        if (result < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            if (errno == EAGAIN)
+            {
+                // The output buffer of the driver is full, sleep until
+                // it drains instead of spinning on the write
+                struct pollfd out = { uart_port_data.Handle, POLLOUT, 0 };
+                int ready = poll(&out, 1, TX_POLL_TIMEOUT);
+
+                if ((ready > 0) || ((ready < 0) && (errno == EINTR)))
+                {
+                    continue;
+                }
+            }
+
+            return EN_Error::ERR;
+        }
+
+        written += (TY_Word)result;
+    }
+
+    return EN_Error::NONE;
+}
+
+void CLinuxSys::CUart::SetCarrierOn()
+{
+    int rts = TIOCM_RTS;
+    int dtr = TIOCM_DTR;
+
+    uart_port_data.CarrOn = EN_Bool::TRUE8;
+    ioctl(uart_port_data.Handle, TIOCMBIS, &rts); //Request to Send
+    ioctl(uart_port_data.Handle, TIOCMBIC, &dtr); //Data Terminal Ready
+}
+
+void CLinuxSys::CUart::SetCarrierOff()
+{
+    int rts = TIOCM_RTS;
+    int dtr = TIOCM_DTR;
+
+    uart_port_data.CarrOn = EN_Bool::FALSE8;
+    ioctl(uart_port_data.Handle, TIOCMBIC, &rts); //Request to Send
+    ioctl(uart_port_data.Handle, TIOCMBIS, &dtr); //Data Terminal Ready
+}
+
+EN_Bool CLinuxSys::CUart::IsCarrierOn(void)
+{
+    return uart_port_data.CarrOn;
+}
+
+void CLinuxSys::CyclicTaskStart()
+{
+    // Start the task for the cyclic handler
+    CyclicTask.Start(CHartSlave::FastCyclicHandler);
+}
+
+void CLinuxSys::CyclicTaskTerminate()
+{
+    CLinuxSys::CThread::Terminate(&cyclic_thread_control);
+}
+
+void CLinuxSys::CyclicTaskKill()
+{
+    CLinuxSys::CThread::Kill();
+}
+
+EN_Error CLinuxSys::CThread::Start(CLinuxSys::CThread::ST_ThreadContr* thread_contr_)
+{
+    thread_contr_->Terminated = EN_Bool::FALSE8;
+
+    if (pthread_create(&m_handle, NULL, CLinuxSys::CThread::Execute, thread_contr_) != 0)
+    {
+        return EN_Error::ERR;
+    }
+
+    m_is_running = EN_Bool::TRUE8;
+    if (thread_contr_->Priority == CPrio::High)
+    {
+        struct sched_param param;
+
+        // Requires CAP_SYS_NICE, otherwise the thread
+        // keeps running with the default policy
+        param.sched_priority = sched_get_priority_max(SCHED_FIFO);
+        pthread_setschedparam(m_handle, SCHED_FIFO, &param);
+    }
+
+    // Initialze the central timer
+    COSAL::CTimer::Init();
+
+    return EN_Error::NONE;
+}
+
+void CLinuxSys::CThread::Terminate(CLinuxSys::CThread::ST_ThreadContr* task_contr_)
+{
+    cyclic_thread_control.RunFlag = EN_Bool::FALSE8;
+
+    if (m_is_running == EN_Bool::TRUE8)
+    {
+        if (pthread_equal(m_handle, pthread_self()))
+        {
+            // Called from the cyclic handler itself
+            pthread_detach(m_handle);
+        }
+        else
+        {
+            pthread_join(m_handle, NULL);
+        }
+
+        m_is_running = EN_Bool::FALSE8;
+    }
+}
+
+void CLinuxSys::CThread::Kill()
+{
+    if (m_is_running == EN_Bool::TRUE8)
+    {
+        pthread_cancel(m_handle);
+        pthread_join(m_handle, NULL);
+        m_is_running = EN_Bool::FALSE8;
+    }
+}
+
+void* CLinuxSys::CThread::Execute(void* data_)
+{
+    CLinuxSys::CThread::ST_ThreadContr* thread_control = (ST_ThreadContr*)data_;
+    struct itimerspec                    cycle;
+    TY_UInt64                          cycle_ns = (TY_UInt64)thread_control->Cycle * 1000000ULL;
+    int                                timer_fd;
+
+    timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+    if (timer_fd < 0)
+    {
+        thread_control->Terminated = EN_Bool::TRUE8;
+        return NULL;
+    }
+
+    cycle.it_interval.tv_sec = (time_t)(cycle_ns / 1000000000ULL);
+    cycle.it_interval.tv_nsec = (long)(cycle_ns % 1000000000ULL);
+    cycle.it_value = cycle.it_interval;
+    timerfd_settime(timer_fd, 0, &cycle, NULL);
+
+    thread_control->LastTimeNs = CLinuxSys::GetTimeNs();
+
+    while (thread_control->RunFlag == EN_Bool::TRUE8)
+    {
+        TY_UInt64  expirations;
+        TY_UInt64 time;
+        TY_UInt64 passed_time;
+
+        // Blocks until the next cycle is due
+        if (read(timer_fd, &expirations, sizeof(expirations)) < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            break;
+        }
+
+        time = CLinuxSys::GetTimeNs();
+        passed_time = (time - thread_control->LastTimeNs) / 1000000ULL;
+
+        // Correct passed time in debugging sessions
+        if (passed_time > (TY_UInt64)(10 * thread_control->Cycle))
+        {
+            thread_control->LastTimeNs = time;
+            continue;
+        }
+
+        if (passed_time > 0)
+        {
+            // Only the full milliseconds are consumed, the
+            // remainder is carried over to the next cycle
+            thread_control->LastTimeNs += passed_time * 1000000ULL;
+
+            if (thread_control->Handler != NULL)
+            {
+                thread_control->Handler((TY_Word)passed_time);
+            }
+        }
+    }
+
+    close(timer_fd);
+    thread_control->Terminated = EN_Bool::TRUE8;
+    return NULL;
+}
+
+EN_Error CLinuxSys::CCyclicTask::Start(void (*handler_)(TY_Word time_))
+{
+    // Start the thread for the uart handler
+    cyclic_thread_control.RunFlag = EN_Bool::TRUE8;
+    cyclic_thread_control.Handler = CHartSlave::FastCyclicHandler;
+    cyclic_thread_control.Terminated = EN_Bool::FALSE8;
+    cyclic_thread_control.Priority = 1;
+    cyclic_thread_control.Cycle = 1;
+
+    return CLinuxSys::CThread::Start(&cyclic_thread_control);
+}
+
+EN_Bool CLinuxSys::CCyclicTask::IsTerminated()
+{
+    if (cyclic_thread_control.Terminated == EN_Bool::TRUE8)
+    {
+        m_terminated = EN_Bool::TRUE8;
+    }
+
+    return m_terminated;
+}
+
+void CHartSlave::FastCyclicHandler(TY_Word time_ms_)
+{
+    // Call the Hart slave protocol handler
+    if (CChannel::GetCommType() == EN_CommType::HART_IP)
+    {
+        CHSipMacPort::Execute(time_ms_);
+    }
+    else
+    {
+        CHSuartMacPort::Execute(time_ms_);
+    }
+}
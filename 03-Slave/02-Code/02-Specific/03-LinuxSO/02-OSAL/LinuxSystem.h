@@ -0,0 +1,110 @@
+/*
+ *          File: LinuxSystem.h (CLinuxSys)
+ *                The OSAL concept cannot be applied to all functions that
+ *                are required. These functions were implemented in the code
+ *                of this module. It is the Linux counterpart of CWinSys.
+ *
+ *        Author: Walter Borst
+ *
+ *        E-Mail: info@borst-automation.de
+ *          Home: https://www.borst-automation.de
+ *
+ * No Warranties: https://www.borst-automation.com/legal/warranty-disclaimer
+ *
+ * Copyright 2006-2025 Walter Borst, Cuxhaven, Germany
+ */
+
+// Once
+#ifndef __linuxsystem_h__
+#define __linuxsystem_h__
+
+#include <pthread.h>
+#include "WbHartSlave.h"
+
+typedef struct st_UartPortData
+{
+    // Note: This is a file descriptor
+    int               Handle;
+    TY_Byte         ByteTime;
+    EN_Bool           CarrOn;
+} ST_UartPortData;
+
+class CLinuxSys
+{
+public:
+    static void     CyclicTaskStart();
+    static void CyclicTaskTerminate();
+    static void      CyclicTaskKill();
+    // Monotonic clock in nanoseconds
+    static TY_UInt64      GetTimeNs();
+
+    class CThread
+    {
+    public:
+        typedef struct st_ThreadContr
+        {
+            EN_Bool      RunFlag;
+            TY_Byte     Priority;
+            void       (*Handler)(TY_Word time_);
+            EN_Bool   Terminated;
+            TY_Word        Cycle;
+            TY_UInt64 LastTimeNs;
+        } ST_ThreadContr;
+
+        class CPrio
+        {
+        public:
+            static const TY_Byte  Low = 0;
+            static const TY_Byte High = 1;
+        };
+
+        // Create cyclically running process
+        static EN_Error                    Start(CLinuxSys::CThread::ST_ThreadContr* task_contr_);
+        static void                    Terminate(CLinuxSys::CThread::ST_ThreadContr* task_contr_);
+        static void*                     Execute(void* data_);
+        static void                         Kill();
+    private:
+        static pthread_t m_handle;
+        static EN_Bool   m_is_running;
+    };
+
+    class CUart
+    {
+    public:
+        // Longest wait in milliseconds for the driver to accept
+        // more bytes to transmit
+        static const int           TX_POLL_TIMEOUT = 1000;
+        // Port numbers are mapped to device names:
+        //   1..99    -> /dev/ttyS0..   (COM1 = ttyS0)
+        //   100..199 -> /dev/ttyUSB0..
+        //   200..254 -> /dev/ttyACM0..
+        // The bytes are taken from the driver by a separate
+        // thread as soon as they arrive.
+        static EN_Bool                        Open(TY_Byte com_port_, TY_DWord baudrate_);
+        static void                          Close();
+        static EN_Bool                          Rx(TY_Byte* rx_tx_buffer_, TY_Byte* rx_tx_len_, TY_Byte* rx_tx_err_);
+        static EN_Error                         Tx(TY_Byte* data_, TY_Word len_);
+        static void                   SetCarrierOn();
+        static void                  SetCarrierOff();
+        static EN_Bool                 IsCarrierOn(void);
+    private:
+        // Receiver thread, empties the driver on arrival
+        static void*                       Receive(void* data_);
+    };
+
+    class CCyclicTask:public COSAL::CTask
+    {
+    public:
+        EN_Error        Start(void (*handler_)(TY_Word time_)) override;
+        EN_Bool  IsTerminated() override;
+    };
+
+private:
+    // Hide Defaults
+    CLinuxSys();
+    ~CLinuxSys();
+    CLinuxSys(const CLinuxSys& rhs);              /* Hide copy constructor */
+    CLinuxSys& operator=(const CLinuxSys& rhs);   /* Hide assignment operator */
+};
+
+#endif // __linuxsystem_h__
@@ -0,0 +1,173 @@
+/*
+ *          File: BenchBurstCache.cpp
+ *                Storing a burst frame by the kernel and reading the
+ *                latest value by the application, with some devices
+ *                bursting some commands each. With subscriptions the
+ *                store includes the check for a change.
+ *
+ *        Author: Walter Borst
+ *
+ *        E-Mail: info@borst-automation.de
+ *          Home: https://www.borst-automation.de
+ *
+ * No Warranties: https://www.borst-automation.com/legal/warranty-disclaimer
+ *
+ * Copyright 2006-2025 Walter Borst, Cuxhaven, Germany
+ */
+
+#include <benchmark/benchmark.h>
+#include "OSAL.h"
+#include "HartConsts.h"
+#include "HartCoding.h"
+#include "HartFrame.h"
+#include "HartBurstCache.h"
+
+static const TY_Byte NUM_DEVICES = 8;
+static const TY_Byte NUM_COMMANDS = 3;
+static const TY_Byte Commands[NUM_COMMANDS] = { 1, 3, 9 };
+
+// Burst response of command 3 size with the unique ID of a device
+static void MakeBurstFrame(CFrame* frame_, TY_Byte device_, TY_Byte command_)
+{
+    TY_Byte data[MAX_TXRX_SIZE];
+    TY_Byte errors[MAX_TXRX_SIZE] = { 0 };
+    TY_Word pos = 0;
+    TY_Word parsed;
+
+    data[pos++] = CHart::CDelimiter::BACK | 0x80;
+    data[pos++] = 0x80 | 0x26;
+    data[pos++] = 0x4e;
+    data[pos++] = 0x12;
+    data[pos++] = 0x34;
+    data[pos++] = device_;
+    data[pos++] = command_;
+    data[pos++] = 24 + 2;
+    data[pos++] = 0;
+    data[pos++] = 0x40;
+    for (TY_Byte e = 0; e < 24; e++)
+    {
+        data[pos++] = (TY_Byte)(e * 7 + command_);
+    }
+
+    data[pos] = CCoding::CheckSum(data, pos);
+    pos++;
+    frame_->Init();
+    frame_->NoPreamb = EN_Bool::TRUE8;
+    frame_->TryParse(&parsed, data, errors, pos, EN_Bool::FALSE8);
+}
+
+static void BM_BurstStore(benchmark::State& state)
+{
+    CBurstCache* cache = new CBurstCache();
+    CFrame*      frames = new CFrame[NUM_DEVICES * NUM_COMMANDS];
+    TY_Word      next = 0;
+
+    for (TY_Byte e = 0; e < NUM_DEVICES * NUM_COMMANDS; e++)
+    {
+        MakeBurstFrame(&frames[e], (TY_Byte)(e / NUM_COMMANDS), Commands[e % NUM_COMMANDS]);
+        cache->Store(&frames[e]);
+    }
+
+    // The entries exist, each store is an update
+    for (auto _ : state)
+    {
+        cache->Store(&frames[next]);
+        if (++next >= (NUM_DEVICES * NUM_COMMANDS))
+        {
+            next = 0;
+        }
+    }
+
+    if (cache->GetNumEntries() != (NUM_DEVICES * NUM_COMMANDS))
+    {
+        state.SkipWithError("Entries lost");
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    delete[] frames;
+    delete cache;
+}
+
+static void CountNotification(WRD_Handle subscription_, TY_BurstData* data_, void* context_)
+{
+    (*(int64_t*)context_)++;
+}
+
+static void BM_BurstStoreSubscribed(benchmark::State& state)
+{
+    // Each device and command is subscribed, the values do not change
+    CBurstCache* cache = new CBurstCache();
+    CFrame*      frames = new CFrame[NUM_DEVICES * NUM_COMMANDS];
+    TY_Byte      unique_id[5] = { 0x26, 0x4e, 0x12, 0x34, 0 };
+    TY_Word      next = 0;
+    int64_t      num_notified = 0;
+
+    for (TY_Byte e = 0; e < NUM_DEVICES * NUM_COMMANDS; e++)
+    {
+        MakeBurstFrame(&frames[e], (TY_Byte)(e / NUM_COMMANDS), Commands[e % NUM_COMMANDS]);
+        unique_id[4] = (TY_Byte)(e / NUM_COMMANDS);
+        cache->Subscribe(unique_id, Commands[e % NUM_COMMANDS], 5, 0.1f, CountNotification, &num_notified);
+        cache->Store(&frames[e]);
+    }
+
+    for (auto _ : state)
+    {
+        cache->Store(&frames[next]);
+        if (++next >= (NUM_DEVICES * NUM_COMMANDS))
+        {
+            next = 0;
+        }
+    }
+
+    if (num_notified != (NUM_DEVICES * NUM_COMMANDS))
+    {
+        state.SkipWithError("Unchanged values notified");
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    delete[] frames;
+    delete cache;
+}
+
+static void BM_BurstRead(benchmark::State& state)
+{
+    CBurstCache* cache = new CBurstCache();
+    CFrame*      frame = new CFrame();
+    TY_BurstData data;
+    TY_Byte      unique_id[5] = { 0x26, 0x4e, 0x12, 0x34, 0 };
+    TY_Word      next = 0;
+    int64_t      num_read = 0;
+
+    for (TY_Byte e = 0; e < NUM_DEVICES * NUM_COMMANDS; e++)
+    {
+        MakeBurstFrame(frame, (TY_Byte)(e / NUM_COMMANDS), Commands[e % NUM_COMMANDS]);
+        cache->Store(frame);
+    }
+
+    for (auto _ : state)
+    {
+        unique_id[4] = (TY_Byte)(next / NUM_COMMANDS);
+        if (cache->Read(unique_id, Commands[next % NUM_COMMANDS], &data) == EN_Bool::TRUE8)
+        {
+            num_read++;
+        }
+
+        if (++next >= (NUM_DEVICES * NUM_COMMANDS))
+        {
+            next = 0;
+        }
+    }
+
+    if (num_read != (int64_t)state.iterations())
+    {
+        state.SkipWithError("Entries not found");
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    delete frame;
+    delete cache;
+}
+
+BENCHMARK(BM_BurstStore);
+BENCHMARK(BM_BurstStoreSubscribed);
+BENCHMARK(BM_BurstRead);
@@ -0,0 +1,114 @@
+/*
+ *          File: BenchCheckSum.cpp
+ *                Compares the checksum kernel of CCoding with the byte
+ *                by byte loop formerly used by the encoders. The loop is
+ *                measured as compiled (gcc -O3 vectorizes it on its own)
+ *                and with the vectorization switched off, as it is built
+ *                by most embedded and MSVC tool chains.
+ *
+ *        Author: Walter Borst
+ *
+ *        E-Mail: info@borst-automation.de
+ *          Home: https://www.borst-automation.de
+ *
+ * No Warranties: https://www.borst-automation.com/legal/warranty-disclaimer
+ *
+ * Copyright 2006-2025 Walter Borst, Cuxhaven, Germany
+ */
+
+#include <benchmark/benchmark.h>
+#include <vector>
+#include "OSAL.h"
+#include "HartCoding.h"
+
+static TY_Byte CheckSumScalar(const TY_Byte* data_, TY_Word len_)
+{
+    TY_Byte chk = 0;
+
+    for (TY_Word e = 0; e < len_; e++)
+    {
+        chk ^= data_[e];
+    }
+
+    return chk;
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+__attribute__((noinline, optimize("no-tree-vectorize")))
+#else
+__attribute__((noinline))
+#endif
+static TY_Byte CheckSumBytewise(const TY_Byte* data_, TY_Word len_)
+{
+    TY_Byte chk = 0;
+
+#if defined(__clang__)
+#pragma clang loop vectorize(disable) interleave(disable)
+#endif
+    for (TY_Word e = 0; e < len_; e++)
+    {
+        chk ^= data_[e];
+    }
+
+    return chk;
+}
+
+static std::vector<TY_Byte> MakeData(TY_Word len_)
+{
+    std::vector<TY_Byte> data(len_);
+
+    for (TY_Word e = 0; e < len_; e++)
+    {
+        data[e] = (TY_Byte)(e * 37 + 11);
+    }
+
+    return data;
+}
+
+static void BM_CheckSumScalar(benchmark::State& state)
+{
+    std::vector<TY_Byte> data = MakeData((TY_Word)state.range(0));
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(data.data());
+        benchmark::DoNotOptimize(CheckSumScalar(data.data(), (TY_Word)data.size()));
+    }
+    state.SetBytesProcessed(state.iterations() * (int64_t)data.size());
+}
+
+static void BM_CheckSumBytewise(benchmark::State& state)
+{
+    std::vector<TY_Byte> data = MakeData((TY_Word)state.range(0));
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(data.data());
+        benchmark::DoNotOptimize(CheckSumBytewise(data.data(), (TY_Word)data.size()));
+    }
+    state.SetBytesProcessed(state.iterations() * (int64_t)data.size());
+}
+
+static void BM_CheckSum(benchmark::State& state)
+{
+    std::vector<TY_Byte> data = MakeData((TY_Word)state.range(0));
+
+    if (CCoding::CheckSum(data.data(), (TY_Word)data.size()) !=
+        CheckSumScalar(data.data(), (TY_Word)data.size()))
+    {
+        state.SkipWithError("Checksum differs from the scalar loop");
+        return;
+    }
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(data.data());
+        benchmark::DoNotOptimize(CCoding::CheckSum(data.data(), (TY_Word)data.size()));
+    }
+    state.SetBytesProcessed(state.iterations() * (int64_t)data.size());
+}
+
+// Short request, long response, maximum frame and a capture block
+BENCHMARK(BM_CheckSumScalar)->Arg(9)->Arg(31)->Arg(75)->Arg(128)->Arg(4096)->Arg(65535);
+BENCHMARK(BM_CheckSumBytewise)->Arg(9)->Arg(31)->Arg(75)->Arg(128)->Arg(4096)->Arg(65535);
+BENCHMARK(BM_CheckSum)->Arg(9)->Arg(31)->Arg(75)->Arg(128)->Arg(4096)->Arg(65535);
@@ -0,0 +1,281 @@
+/*
+ *          File: BenchCoding.cpp
+ *                Encoding and decoding of the data objects by CCoding.
+ *                The bytes are those of the encoded object.
+ *
+ *        Author: Walter Borst
+ *
+ *        E-Mail: info@borst-automation.de
+ *          Home: https://www.borst-automation.de
+ *
+ * No Warranties: https://www.borst-automation.com/legal/warranty-disclaimer
+ *
+ * Copyright 2006-2025 Walter Borst, Cuxhaven, Germany
+ */
+
+#include <benchmark/benchmark.h>
+#include "OSAL.h"
+#include "HartCoding.h"
+
+// Long tag of command 20, 32 characters in 24 bytes
+static TY_Byte LongTag[] = "PT-100 TANK 4 OUTLET TEMPERATURE";
+static const TY_Byte LONG_TAG_LEN = 32;
+static const TY_Byte LONG_TAG_SIZE = 24;
+
+static void Done(benchmark::State& state, TY_Word size_)
+{
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * (int64_t)size_);
+}
+
+// Encoding
+static void BM_PutWord(benchmark::State& state)
+{
+    TY_Byte data[MAX_PAYLOAD_SIZE];
+    TY_Word value = 0x1234;
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(value);
+        CCoding::PutWord(value, 1, data, EN_Endian::MSB_First);
+        benchmark::ClobberMemory();
+    }
+    Done(state, 2);
+}
+
+static void BM_PutInt24(benchmark::State& state)
+{
+    TY_Byte  data[MAX_PAYLOAD_SIZE];
+    TY_DWord value = 0x123456;
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(value);
+        CCoding::PutInt24(value, 1, data, EN_Endian::MSB_First);
+        benchmark::ClobberMemory();
+    }
+    Done(state, 3);
+}
+
+static void BM_PutDWord(benchmark::State& state)
+{
+    TY_Byte  data[MAX_PAYLOAD_SIZE];
+    TY_DWord value = 0x12345678;
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(value);
+        CCoding::PutDWord(value, 1, data, EN_Endian::MSB_First);
+        benchmark::ClobberMemory();
+    }
+    Done(state, 4);
+}
+
+static void BM_PutInt64(benchmark::State& state)
+{
+    TY_Byte   data[MAX_PAYLOAD_SIZE];
+    TY_UInt64 value = 0x123456789abcdef0ULL;
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(value);
+        CCoding::PutInt64(value, 1, data, EN_Endian::MSB_First);
+        benchmark::ClobberMemory();
+    }
+    Done(state, 8);
+}
+
+static void BM_PutFloat(benchmark::State& state)
+{
+    TY_Byte  data[MAX_PAYLOAD_SIZE];
+    TY_Float value = 21.5f;
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(value);
+        CCoding::PutFloat(value, 1, data, EN_Endian::MSB_First);
+        benchmark::ClobberMemory();
+    }
+    Done(state, 4);
+}
+
+static void BM_PutDFloat(benchmark::State& state)
+{
+    TY_Byte   data[MAX_PAYLOAD_SIZE];
+    TY_DFloat value = 21.5;
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(value);
+        CCoding::PutDFloat(value, 1, data, EN_Endian::MSB_First);
+        benchmark::ClobberMemory();
+    }
+    Done(state, 8);
+}
+
+static void BM_PutPackedASCII(benchmark::State& state)
+{
+    TY_Byte data[MAX_PAYLOAD_SIZE];
+
+    for (auto _ : state)
+    {
+        CCoding::PutPackedASCII(LongTag, LONG_TAG_LEN, 0, data);
+        benchmark::ClobberMemory();
+    }
+    Done(state, LONG_TAG_SIZE);
+}
+
+static void BM_PutOctets(benchmark::State& state)
+{
+    TY_Byte data[MAX_PAYLOAD_SIZE];
+
+    for (auto _ : state)
+    {
+        CCoding::PutOctets(LongTag, LONG_TAG_LEN, 0, data);
+        benchmark::ClobberMemory();
+    }
+    Done(state, LONG_TAG_LEN);
+}
+
+static void BM_PutString(benchmark::State& state)
+{
+    TY_Byte data[MAX_PAYLOAD_SIZE];
+
+    for (auto _ : state)
+    {
+        CCoding::PutString(LongTag, LONG_TAG_LEN, 0, data);
+        benchmark::ClobberMemory();
+    }
+    Done(state, LONG_TAG_LEN);
+}
+
+// Decoding
+static void BM_PickWord(benchmark::State& state)
+{
+    TY_Byte data[MAX_PAYLOAD_SIZE] = { 0, 0x12, 0x34 };
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(CCoding::PickWord(1, data, EN_Endian::MSB_First));
+    }
+    Done(state, 2);
+}
+
+static void BM_PickInt24(benchmark::State& state)
+{
+    TY_Byte data[MAX_PAYLOAD_SIZE] = { 0, 0x12, 0x34, 0x56 };
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(CCoding::PickInt24(1, data, EN_Endian::MSB_First));
+    }
+    Done(state, 3);
+}
+
+static void BM_PickDWord(benchmark::State& state)
+{
+    TY_Byte data[MAX_PAYLOAD_SIZE] = { 0, 0x12, 0x34, 0x56, 0x78 };
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(CCoding::PickDWord(1, data, EN_Endian::MSB_First));
+    }
+    Done(state, 4);
+}
+
+static void BM_PickInt64(benchmark::State& state)
+{
+    TY_Byte data[MAX_PAYLOAD_SIZE] = { 0, 0x12, 0x34, 0x56, 0x78, 0x9a, 0xbc, 0xde, 0xf0 };
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(CCoding::PickInt64(1, data, EN_Endian::MSB_First));
+    }
+    Done(state, 8);
+}
+
+static void BM_PickFloat(benchmark::State& state)
+{
+    TY_Byte data[MAX_PAYLOAD_SIZE] = { 0, 0x41, 0xac, 0x00, 0x00 };
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(CCoding::PickFloat(1, data, EN_Endian::MSB_First));
+    }
+    Done(state, 4);
+}
+
+static void BM_PickDouble(benchmark::State& state)
+{
+    TY_Byte data[MAX_PAYLOAD_SIZE] = { 0, 0x40, 0x35, 0x80, 0, 0, 0, 0, 0 };
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(CCoding::PickDouble(1, data, EN_Endian::MSB_First));
+    }
+    Done(state, 8);
+}
+
+static void BM_PickPackedASCII(benchmark::State& state)
+{
+    TY_Byte data[MAX_PAYLOAD_SIZE];
+    TY_Byte tag[LONG_TAG_LEN + 1];
+
+    CCoding::PutPackedASCII(LongTag, LONG_TAG_LEN, 0, data);
+    for (auto _ : state)
+    {
+        CCoding::PickPackedASCII(tag, LONG_TAG_LEN, 0, data);
+        benchmark::DoNotOptimize(tag);
+        benchmark::ClobberMemory();
+    }
+    Done(state, LONG_TAG_SIZE);
+}
+
+static void BM_PickOctets(benchmark::State& state)
+{
+    TY_Byte data[MAX_PAYLOAD_SIZE];
+    TY_Byte octets[LONG_TAG_LEN];
+
+    CCoding::PutOctets(LongTag, LONG_TAG_LEN, 0, data);
+    for (auto _ : state)
+    {
+        CCoding::PickOctets(octets, LONG_TAG_LEN, 0, data);
+        benchmark::DoNotOptimize(octets);
+        benchmark::ClobberMemory();
+    }
+    Done(state, LONG_TAG_LEN);
+}
+
+static void BM_PickString(benchmark::State& state)
+{
+    TY_Byte data[MAX_PAYLOAD_SIZE];
+    TY_Byte text[LONG_TAG_LEN];
+
+    CCoding::PutOctets(LongTag, LONG_TAG_LEN, 0, data);
+    for (auto _ : state)
+    {
+        CCoding::PickString(text, LONG_TAG_LEN, 0, data);
+        benchmark::DoNotOptimize(text);
+        benchmark::ClobberMemory();
+    }
+    Done(state, LONG_TAG_LEN);
+}
+
+BENCHMARK(BM_PutWord);
+BENCHMARK(BM_PutInt24);
+BENCHMARK(BM_PutDWord);
+BENCHMARK(BM_PutInt64);
+BENCHMARK(BM_PutFloat);
+BENCHMARK(BM_PutDFloat);
+BENCHMARK(BM_PutPackedASCII);
+BENCHMARK(BM_PutOctets);
+BENCHMARK(BM_PutString);
+BENCHMARK(BM_PickWord);
+BENCHMARK(BM_PickInt24);
+BENCHMARK(BM_PickDWord);
+BENCHMARK(BM_PickInt64);
+BENCHMARK(BM_PickFloat);
+BENCHMARK(BM_PickDouble);
+BENCHMARK(BM_PickPackedASCII);
+BENCHMARK(BM_PickOctets);
+BENCHMARK(BM_PickString);
@@ -0,0 +1,185 @@
+/*
+ *          File: BenchFrame.cpp
+ *                Parsing and encoding of typical hart frames (commands
+ *                0, 3, 9 and 48). The time of an iteration is the time
+ *                per frame. The encoder is the one of the master, it
+ *                builds requests only.
+ *
+ *        Author: Walter Borst
+ *
+ *        E-Mail: info@borst-automation.de
+ *          Home: https://www.borst-automation.de
+ *
+ * No Warranties: https://www.borst-automation.com/legal/warranty-disclaimer
+ *
+ * Copyright 2006-2025 Walter Borst, Cuxhaven, Germany
+ */
+
+#include <benchmark/benchmark.h>
+#include "OSAL.h"
+#include "HartConsts.h"
+#include "HartFrame.h"
+#include "HartCoding.h"
+
+static TY_Byte UniqueID[5] = { 0x26, 0x4e, 0x12, 0x34, 0x56 };
+
+// Size of the request and the response data of a command
+static TY_Byte GetDataLen(TY_Byte command_, EN_Bool response_)
+{
+    switch (command_)
+    {
+    case 0:
+        return (response_ == EN_Bool::TRUE8) ? 22 : 0;
+    case 3:
+        return (response_ == EN_Bool::TRUE8) ? 24 : 0;
+    case 9:
+        // Four slots
+        return (response_ == EN_Bool::TRUE8) ? 37 : 4;
+    case 48:
+        return (response_ == EN_Bool::TRUE8) ? 25 : 0;
+    }
+
+    return 0;
+}
+
+// A frame as it is seen on the wire, command 0 is sent
+// with the polling address, the others with the unique one
+static TY_Word MakeFrame(TY_Byte* frame_, TY_Byte num_preambles_, TY_Byte command_, EN_Bool response_)
+{
+    TY_Word pos = 0;
+    TY_Word start;
+    TY_Byte data_len = GetDataLen(command_, response_);
+    TY_Byte delimiter = (response_ == EN_Bool::TRUE8) ? CHart::CDelimiter::ACK : CHart::CDelimiter::STX;
+
+    for (TY_Byte e = 0; e < num_preambles_; e++)
+    {
+        frame_[pos++] = 0xff;
+    }
+
+    start = pos;
+    if (command_ == 0)
+    {
+        frame_[pos++] = delimiter;
+        frame_[pos++] = 0x80;
+    }
+    else
+    {
+        frame_[pos++] = delimiter | 0x80;
+        COSAL::CMem::Copy(&frame_[pos], UniqueID, 5);
+        frame_[pos] |= 0x80;
+        pos += 5;
+    }
+
+    frame_[pos++] = command_;
+    if (response_ == EN_Bool::TRUE8)
+    {
+        frame_[pos++] = (TY_Byte)(data_len + 2);
+        frame_[pos++] = 0;
+        frame_[pos++] = 0x40;
+    }
+    else
+    {
+        frame_[pos++] = data_len;
+    }
+
+    for (TY_Byte e = 0; e < data_len; e++)
+    {
+        frame_[pos++] = (TY_Byte)(e * 7 + command_);
+    }
+
+    frame_[pos] = CCoding::CheckSum(&frame_[start], (TY_Word)(pos - start));
+    pos++;
+    return pos;
+}
+
+static void ParseFrame(benchmark::State& state, TY_Byte num_preambles_, TY_Word chunk_)
+{
+    TY_Byte command = (TY_Byte)state.range(0);
+    TY_Byte data[MAX_TXRX_SIZE];
+    TY_Byte errors[MAX_TXRX_SIZE] = { 0 };
+    TY_Word len = MakeFrame(data, num_preambles_, command, EN_Bool::TRUE8);
+    TY_Word pos;
+    TY_Word parsed;
+    CFrame  frame;
+
+    for (auto _ : state)
+    {
+        frame.Init();
+        frame.NoPreamb = (num_preambles_ == 0) ? EN_Bool::TRUE8 : EN_Bool::FALSE8;
+        pos = 0;
+        while (pos < len)
+        {
+            TY_Word chunk = ((len - pos) < chunk_) ? (TY_Word)(len - pos) : chunk_;
+
+            if (frame.TryParse(&parsed, &data[pos], &errors[pos], chunk, EN_Bool::FALSE8) == EN_Bool::TRUE8)
+            {
+                break;
+            }
+            pos += parsed;
+        }
+        benchmark::DoNotOptimize(frame.Type);
+    }
+
+    if (frame.Type != CFrame::EN_Type::RESPONSE)
+    {
+        state.SkipWithError("Frame not parsed");
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * (int64_t)len);
+}
+
+// A HART-IP frame, received at once
+static void BM_TryParseHartIp(benchmark::State& state)
+{
+    ParseFrame(state, 0, MAX_TXRX_SIZE);
+}
+
+// A uart frame with 5 preambles, received at once
+static void BM_TryParseUart(benchmark::State& state)
+{
+    ParseFrame(state, 5, MAX_TXRX_SIZE);
+}
+
+// The same frame passed byte by byte, as on a slow port
+static void BM_TryParseUartBytewise(benchmark::State& state)
+{
+    ParseFrame(state, 5, 1);
+}
+
+static void BM_Encode(benchmark::State& state)
+{
+    TY_Byte     command = (TY_Byte)state.range(0);
+    TY_Byte     data[MAX_PAYLOAD_SIZE];
+    TY_Byte     data_len = GetDataLen(command, EN_Bool::FALSE8);
+    ST_TxBuffer tx_buffer;
+    CFrame      frame;
+
+    for (TY_Byte e = 0; e < data_len; e++)
+    {
+        data[e] = e;
+    }
+
+    frame.AttachTxBuffer(&tx_buffer);
+    frame.Init();
+    frame.Command = command;
+    frame.NumPreambles = 5;
+    frame.AddrMode = (command == 0) ? CHart::CAddrMode::POLLING : CHart::CAddrMode::UNIQUE;
+    frame.SetUniqueAddr(UniqueID);
+    frame.SetData(data, data_len);
+    frame.SetLocalMaster(EN_Bool::TRUE8);
+    for (auto _ : state)
+    {
+        frame.Encode();
+        benchmark::DoNotOptimize(tx_buffer.Bytes);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * (int64_t)tx_buffer.Len);
+}
+
+BENCHMARK(BM_TryParseHartIp)->ArgName("cmd")->Arg(0)->Arg(3)->Arg(9)->Arg(48);
+BENCHMARK(BM_TryParseUart)->ArgName("cmd")->Arg(0)->Arg(3)->Arg(9)->Arg(48);
+BENCHMARK(BM_TryParseUartBytewise)->ArgName("cmd")->Arg(0)->Arg(3)->Arg(9)->Arg(48);
+BENCHMARK(BM_Encode)->ArgName("cmd")->Arg(0)->Arg(3)->Arg(9)->Arg(48);
@@ -0,0 +1,79 @@
+/*
+ *          File: BenchLoopback.cpp
+ *                Transactions of the master with simulated devices on a
+ *                loopback channel, one command 3 per iteration. Besides
+ *                the throughput the latency is reported as percentiles.
+ *
+ *        Author: Walter Borst
+ *
+ *        E-Mail: info@borst-automation.de
+ *          Home: https://www.borst-automation.de
+ *
+ * No Warranties: https://www.borst-automation.com/legal/warranty-disclaimer
+ *
+ * Copyright 2006-2025 Walter Borst, Cuxhaven, Germany
+ */
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include "OSAL.h"
+#include "WbHartM_Structures.h"
+#include "HartMasterIface.h"
+
+static void BM_LoopbackCommand3(benchmark::State& state)
+{
+    // range(0): baud rate, range(1): 1 = model the baud rate
+    TY_LoopbackConfig    loop_config;
+    TY_Configuration     config;
+    TY_Connection        connection;
+    TY_Confirmation      confirmation;
+    WRD_Handle           channel = CHartMaster::CreateChannel();
+    std::vector<double>  latency;
+    int64_t              num_failed = 0;
+
+    CHartMaster::GetLoopbackConfig(channel, &loop_config);
+    loop_config.NumDevices = 1;
+    loop_config.ModelBaudRate = (state.range(1) != 0) ? EN_Bool::TRUE8 : EN_Bool::FALSE8;
+    loop_config.TurnaroundTime = 0;
+    CHartMaster::SetLoopbackConfig(channel, &loop_config);
+    CHartMaster::GetConfiguration(channel, &config);
+    config.BaudRate = (TY_DWord)state.range(0);
+    CHartMaster::SetConfiguration(channel, &config);
+    if (CHartMaster::OpenChannel(channel, 1, EN_CommType::LOOPBACK) == EN_Bool::FALSE8)
+    {
+        state.SkipWithError("Loopback channel not available");
+        CHartMaster::DeleteChannel(channel);
+        return;
+    }
+
+    CHartMaster::FetchConnection(channel,
+        CHartMaster::ConnectByAddr(channel, 0, EN_Wait::WAIT, 2), &connection);
+    for (auto _ : state)
+    {
+        auto start = std::chrono::steady_clock::now();
+        SRV_Handle service = CHartMaster::LaunchCommand(channel, 3, EN_Wait::WAIT,
+            NULL, 0, connection.BytesOfUniqueID);
+        CHartMaster::FetchConfirmation(channel, service, &confirmation);
+        latency.push_back(std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count());
+        if (confirmation.SrvResultCode != EN_SRV_Result::SUCCESSFUL)
+        {
+            num_failed++;
+        }
+    }
+
+    CHartMaster::CloseChannel(channel);
+    CHartMaster::DeleteChannel(channel);
+    std::sort(latency.begin(), latency.end());
+    state.SetItemsProcessed(state.iterations());
+    state.counters["p50_ms"] = latency[latency.size() / 2];
+    state.counters["p99_ms"] = latency[(latency.size() * 99) / 100];
+    state.counters["failed"] = (double)num_failed;
+}
+
+// Full speed, a transaction is run through at once
+BENCHMARK(BM_LoopbackCommand3)->Args({ 115200, 0 })->Unit(benchmark::kMillisecond)->UseRealTime();
+// A Hart loop at 1200 baud
+BENCHMARK(BM_LoopbackCommand3)->Args({ 1200, 1 })->Unit(benchmark::kMillisecond)->UseRealTime()->Iterations(10);
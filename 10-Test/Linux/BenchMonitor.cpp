@@ -0,0 +1,131 @@
+/*
+ *          File: BenchMonitor.cpp
+ *                Recording of frames by the monitor and fetching them
+ *                by the application, one frame per iteration or a batch
+ *                of frames per call.
+ *
+ *        Author: Walter Borst
+ *
+ *        E-Mail: info@borst-automation.de
+ *          Home: https://www.borst-automation.de
+ *
+ * No Warranties: https://www.borst-automation.com/legal/warranty-disclaimer
+ *
+ * Copyright 2006-2025 Walter Borst, Cuxhaven, Germany
+ */
+
+#include <benchmark/benchmark.h>
+#include <vector>
+#include "OSAL.h"
+#include "Monitor.h"
+
+// About the size of a response to command 3 on the uart
+static const TY_Word FRAME_LEN = 44;
+
+static void BM_MonitorStoreData(benchmark::State& state)
+{
+    // The frame is stored in chunks as delivered by the port
+    TY_Word   chunk = (TY_Word)state.range(0);
+    TY_Byte   data[FRAME_LEN];
+    CMonitor* monitor = new CMonitor();
+    TY_DWord  time = 0;
+
+    for (TY_Word e = 0; e < FRAME_LEN; e++)
+    {
+        data[e] = (TY_Byte)e;
+    }
+
+    monitor->Start();
+    for (auto _ : state)
+    {
+        monitor->StartReceive(time);
+        for (TY_Word pos = 0; pos < FRAME_LEN; pos += chunk)
+        {
+            monitor->StoreData(&data[pos], ((FRAME_LEN - pos) < chunk) ? (TY_Word)(FRAME_LEN - pos) : chunk);
+        }
+        monitor->EndRcvValidFrame(time++);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * (int64_t)FRAME_LEN);
+    delete monitor;
+}
+
+static void BM_MonitorGetData(benchmark::State& state)
+{
+    // Each frame is fetched right after it was recorded
+    TY_Byte      data[FRAME_LEN];
+    CMonitor*    monitor = new CMonitor();
+    TY_MonFrame* frame = new TY_MonFrame();
+    TY_DWord     time = 0;
+    int64_t      num_fetched = 0;
+
+    for (TY_Word e = 0; e < FRAME_LEN; e++)
+    {
+        data[e] = (TY_Byte)e;
+    }
+
+    monitor->Start();
+    for (auto _ : state)
+    {
+        monitor->StartReceive(time);
+        monitor->StoreData(data, FRAME_LEN);
+        monitor->EndRcvValidFrame(time++);
+        if (monitor->GetData(frame) == EN_Bool::TRUE8)
+        {
+            num_fetched++;
+        }
+    }
+
+    if (num_fetched != (int64_t)state.iterations())
+    {
+        state.SkipWithError("Frames lost");
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * (int64_t)FRAME_LEN);
+    delete frame;
+    delete monitor;
+}
+
+static void BM_MonitorGetDataBatch(benchmark::State& state)
+{
+    // range(0) frames are recorded and then fetched by a single call
+    TY_Word                   num_frames = (TY_Word)state.range(0);
+    TY_Byte                   data[FRAME_LEN];
+    CMonitor*                 monitor = new CMonitor();
+    std::vector<TY_MonFrame>  frames(num_frames);
+    TY_DWord                  time = 0;
+    int64_t                   num_fetched = 0;
+
+    for (TY_Word e = 0; e < FRAME_LEN; e++)
+    {
+        data[e] = (TY_Byte)e;
+    }
+
+    monitor->Start();
+    for (auto _ : state)
+    {
+        for (TY_Word e = 0; e < num_frames; e++)
+        {
+            monitor->StartReceive(time);
+            monitor->StoreData(data, FRAME_LEN);
+            monitor->EndRcvValidFrame(time++);
+        }
+
+        num_fetched += monitor->GetData(frames.data(), num_frames);
+    }
+
+    if ((num_fetched != (int64_t)state.iterations() * num_frames) || (monitor->GetNumDropped() > 0))
+    {
+        state.SkipWithError("Frames lost");
+    }
+
+    state.SetItemsProcessed(num_fetched);
+    state.SetBytesProcessed(num_fetched * (int64_t)FRAME_LEN);
+    delete monitor;
+}
+
+BENCHMARK(BM_MonitorStoreData)->ArgName("chunk")->Arg(1)->Arg(8)->Arg(FRAME_LEN);
+BENCHMARK(BM_MonitorGetData);
+BENCHMARK(BM_MonitorGetDataBatch)->ArgName("frames")->Arg(1)->Arg(16)->Arg(256)->Arg(4096);
@@ -0,0 +1,163 @@
+/*
+ *          File: BenchReplay.cpp
+ *                Offline replay of a capture of command 3 transactions
+ *                with several devices, once from the records of the
+ *                monitor in memory and once from a mapped pcapng file.
+ *                The time of an iteration is the time per capture.
+ *
+ *        Author: Walter Borst
+ *
+ *        E-Mail: info@borst-automation.de
+ *          Home: https://www.borst-automation.de
+ *
+ * No Warranties: https://www.borst-automation.com/legal/warranty-disclaimer
+ *
+ * Copyright 2006-2025 Walter Borst, Cuxhaven, Germany
+ */
+
+#include <benchmark/benchmark.h>
+#include <stdio.h>
+#include <vector>
+#include "OSAL.h"
+#include "HartConsts.h"
+#include "HartCoding.h"
+#include "Monitor.h"
+#include "MonitorCapture.h"
+#include "HartReplay.h"
+
+static const TY_Byte   NUM_DEVICES = 8;
+static const TY_DWord  NUM_TRANSACTIONS = 10000;
+static const TY_Char*  PCAPNG_FILE = "/tmp/WbHartBenchReplay.pcapng";
+
+// Command 3 with five preambles, the request or the response
+static TY_Word MakeFrame(TY_Byte* frame_, TY_Byte device_, EN_Bool response_)
+{
+    TY_Word pos = 0;
+    TY_Word start;
+    TY_Byte data_len = (response_ == EN_Bool::TRUE8) ? 24 : 0;
+
+    for (TY_Byte e = 0; e < 5; e++)
+    {
+        frame_[pos++] = 0xff;
+    }
+
+    start = pos;
+    frame_[pos++] = ((response_ == EN_Bool::TRUE8) ? CHart::CDelimiter::ACK : CHart::CDelimiter::STX) | 0x80;
+    frame_[pos++] = 0x80 | 0x26;
+    frame_[pos++] = 0x4e;
+    frame_[pos++] = 0x12;
+    frame_[pos++] = 0x34;
+    frame_[pos++] = device_;
+    frame_[pos++] = 3;
+    if (response_ == EN_Bool::TRUE8)
+    {
+        frame_[pos++] = (TY_Byte)(data_len + 2);
+        frame_[pos++] = 0;
+        frame_[pos++] = 0x40;
+    }
+    else
+    {
+        frame_[pos++] = 0;
+    }
+
+    for (TY_Byte e = 0; e < data_len; e++)
+    {
+        frame_[pos++] = (TY_Byte)(e * 7 + 3);
+    }
+
+    frame_[pos] = CCoding::CheckSum(&frame_[start], (TY_Word)(pos - start));
+    pos++;
+    return pos;
+}
+
+// Request and response of each transaction, 50 ms per transaction
+static void MakeCapture(std::vector<TY_MonFrame>& frames_)
+{
+    frames_.resize(2 * NUM_TRANSACTIONS);
+    for (TY_DWord e = 0; e < NUM_TRANSACTIONS; e++)
+    {
+        TY_MonFrame* request = &frames_[2 * e];
+        TY_MonFrame* response = &frames_[2 * e + 1];
+        TY_Byte      device = (TY_Byte)(e % NUM_DEVICES);
+
+        COSAL::CMem::Set((TY_Byte*)request, 0, sizeof(TY_MonFrame));
+        request->StartTime = e * 50;
+        request->EndTime = request->StartTime + 10;
+        request->Detail = CMonitor::CDetail::CLIENT_TX;
+        request->IsReceiveReady = EN_Bool::TRUE8;
+        request->Len = MakeFrame(request->BytesOfData, device, EN_Bool::FALSE8);
+        COSAL::CMem::Set((TY_Byte*)response, 0, sizeof(TY_MonFrame));
+        response->StartTime = request->EndTime + 20;
+        response->EndTime = response->StartTime + 30;
+        response->IsReceiveReady = EN_Bool::TRUE8;
+        response->Len = MakeFrame(response->BytesOfData, device, EN_Bool::TRUE8);
+    }
+}
+
+static void CheckResult(benchmark::State& state, CReplay* replay_)
+{
+    TY_ReplayStats total;
+
+    replay_->GetTotal(&total);
+    if ((replay_->GetNumEntries() != NUM_DEVICES) || (total.NumResponses != NUM_TRANSACTIONS) ||
+        (total.NumNoResponses != 0))
+    {
+        state.SkipWithError("Transactions lost");
+    }
+}
+
+static void BM_ReplayMonitor(benchmark::State& state)
+{
+    std::vector<TY_MonFrame> frames;
+    CReplay*                 replay = new CReplay();
+
+    MakeCapture(frames);
+    for (auto _ : state)
+    {
+        replay->Run((const TY_Byte*)frames.data(), frames.size() * sizeof(TY_MonFrame));
+    }
+
+    CheckResult(state, replay);
+    state.SetItemsProcessed(state.iterations() * (int64_t)frames.size());
+    state.SetBytesProcessed(state.iterations() * (int64_t)(frames.size() * sizeof(TY_MonFrame)));
+    delete replay;
+}
+
+static void BM_ReplayPcapng(benchmark::State& state)
+{
+    std::vector<TY_MonFrame> frames;
+    CMonitorCapture*         capture = new CMonitorCapture();
+    CReplay*                 replay = new CReplay();
+    COSAL::CFileMap          file_map;
+
+    MakeCapture(frames);
+    capture->Open(PCAPNG_FILE, 0, 0);
+    for (TY_MonFrame& frame : frames)
+    {
+        capture->Write(&frame);
+    }
+
+    capture->Close();
+    delete capture;
+    if (file_map.Open(PCAPNG_FILE) == EN_Bool::FALSE8)
+    {
+        state.SkipWithError("Capture not written");
+        delete replay;
+        return;
+    }
+
+    for (auto _ : state)
+    {
+        replay->Run(file_map.GetData(), file_map.GetSize());
+    }
+
+    CheckResult(state, replay);
+    state.SetItemsProcessed(state.iterations() * (int64_t)frames.size());
+    state.SetBytesProcessed(state.iterations() * (int64_t)file_map.GetSize());
+    file_map.Close();
+    remove(PCAPNG_FILE);
+    delete replay;
+}
+
+BENCHMARK(BM_ReplayMonitor)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ReplayPcapng)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,43 @@
+/*
+ *          File: Test.h
+ *                Check macro and test cases of the modules. The cases
+ *                are listed in TestMaster.cpp, which runs the one that
+ *                is named on the command line.
+ *
+ *        Author: Walter Borst
+ *
+ *        E-Mail: info@borst-automation.de
+ *          Home: https://www.borst-automation.de
+ *
+ * No Warranties: https://www.borst-automation.com/legal/warranty-disclaimer
+ *
+ * Copyright 2006-2025 Walter Borst, Cuxhaven, Germany
+ */
+
+// Once
+#ifndef __test_h__
+#define __test_h__
+
+#include <stdio.h>
+
+#define CHECK(condition_)                                                   \
+    if (!(condition_))                                                      \
+    {                                                                       \
+        printf("%s:%d: Failed: %s\n", __FILE__, __LINE__, #condition_);    \
+        return 1;                                                           \
+    }
+
+// TestBurstCache.cpp
+int TestBurstCacheStore();
+int TestBurstCacheNotify();
+
+// TestBurstSched.cpp
+int TestBurstSchedLearn();
+int TestBurstSchedReplace();
+int TestBurstSchedDefer();
+
+// TestFrame.cpp
+int TestFrameBlockParser();
+int TestCheckSum();
+
+#endif // __test_h__
@@ -0,0 +1,280 @@
+/*
+ *          File: TestBurstCache.cpp
+ *                Tests of the burst cache of a channel. The burst frames
+ *                are parsed from octets as they come from the bus and
+ *                stored directly, no channel is required.
+ *
+ *        Author: Walter Borst
+ *
+ *        E-Mail: info@borst-automation.de
+ *          Home: https://www.borst-automation.de
+ *
+ * No Warranties: https://www.borst-automation.com/legal/warranty-disclaimer
+ *
+ * Copyright 2006-2025 Walter Borst, Cuxhaven, Germany
+ */
+
+#include <math.h>
+#include <string.h>
+#include "OSAL.h"
+#include "WbHartUser.h"
+#include "HartConsts.h"
+#include "HartCoding.h"
+#include "HartFrame.h"
+#include "HartBurstCache.h"
+#include "Test.h"
+
+// Helpers
+static void MakeUniqueID(TY_Byte* bytes_of_unique_id_, TY_Byte device_)
+{
+    bytes_of_unique_id_[0] = 0x26;
+    bytes_of_unique_id_[1] = 0xa0;
+    bytes_of_unique_id_[2] = 0x00;
+    bytes_of_unique_id_[3] = 0x00;
+    bytes_of_unique_id_[4] = device_;
+}
+
+// A burst frame of the device as it is parsed from the bus
+static EN_Bool MakeBurst(CFrame* frame_, TY_Byte device_, TY_Byte command_, TY_Byte rsp1_,
+    TY_Byte rsp2_, const TY_Byte* data_, TY_Byte data_len_)
+{
+    TY_Byte octets[MAX_TXRX_SIZE];
+    TY_Byte errors[MAX_TXRX_SIZE];
+    TY_Word len = 0;
+    TY_Word parsed = 0;
+    TY_Word start;
+
+    for (TY_Byte e = 0; e < 5; e++)
+    {
+        octets[len++] = 0xff;
+    }
+
+    start = len;
+    octets[len++] = CHart::CDelimiter::BACK | CHart::CFlags::UNIQUE_ADDR;
+    MakeUniqueID(&octets[len], device_);
+    octets[len] |= CHart::CFlags::BURST_MODE;
+    len += 5;
+    octets[len++] = command_;
+    octets[len++] = (TY_Byte)(data_len_ + 2);
+    octets[len++] = rsp1_;
+    octets[len++] = rsp2_;
+    memcpy(&octets[len], data_, data_len_);
+    len += data_len_;
+    octets[len] = CCoding::CheckSum(&octets[start], (TY_Word)(len - start));
+    len++;
+
+    memset(errors, 0, sizeof(errors));
+    frame_->Init();
+    frame_->TryParse(&parsed, octets, errors, len, EN_Bool::FALSE8);
+    if ((frame_->GetStatus() != CFrame::EN_Status::FRAME_COMPLETED) ||
+        (frame_->Type != CFrame::EN_Type::BURST))
+    {
+        return EN_Bool::FALSE8;
+    }
+
+    return EN_Bool::TRUE8;
+}
+
+// Notifications of a subscription
+typedef struct st_Notified
+{
+    int          Count;
+    TY_BurstData Data;
+} ST_Notified;
+
+static void Notified(WRD_Handle subscription_, TY_BurstData* data_, void* context_)
+{
+    ST_Notified* notified = (ST_Notified*)context_;
+
+    notified->Count++;
+    notified->Data = *data_;
+}
+
+// Command 1: Units and the primary variable
+static void StorePV(CBurstCache* cache_, TY_Byte units_, TY_Float value_, TY_Byte rsp1_, TY_Byte rsp2_)
+{
+    TY_Byte data[5];
+    CFrame  frame;
+
+    data[0] = units_;
+    CCoding::PutFloat(value_, 1, data, EN_Endian::MSB_First);
+    if (value_ != value_)
+    {
+        // Not available, as sent by the devices
+        CCoding::PutDWord(0x7fa00000, 1, data, EN_Endian::MSB_First);
+    }
+
+    MakeBurst(&frame, 1, 1, rsp1_, rsp2_, data, sizeof(data));
+    cache_->Store(&frame);
+}
+
+// Test cases
+int TestBurstCacheStore()
+{
+    static CBurstCache cache;
+    static const TY_Byte pv[5] = { 32, 0x41, 0xac, 0x00, 0x00 };
+    static const TY_Byte ext[5] = { 0x03, 0xe8, 0x01, 0x02, 0x03 };
+
+    TY_Byte      unique_id[5];
+    TY_Byte      payload[MAX_PAYLOAD_SIZE];
+    TY_BurstData data;
+    CFrame       frame;
+
+    MakeUniqueID(unique_id, 1);
+    CHECK(cache.Read(unique_id, 1, &data) == EN_Bool::FALSE8);
+
+    // A normal burst, read back by the device and the command
+    CHECK(MakeBurst(&frame, 1, 1, 0, 0x40, pv, sizeof(pv)) == EN_Bool::TRUE8);
+    cache.Store(&frame);
+    CHECK(cache.GetNumEntries() == 1);
+    CHECK(cache.Read(unique_id, 1, &data) == EN_Bool::TRUE8);
+    CHECK(data.PollAddress == 0xff);
+    CHECK(memcmp(data.BytesOfUniqueID, unique_id, 5) == 0);
+    CHECK(data.Command == 1);
+    CHECK(data.SequenceNumber == 1);
+    CHECK(data.RespCode1 == 0);
+    CHECK(data.RespCode2 == 0x40);
+    CHECK(data.DataLen == sizeof(pv));
+    CHECK(memcmp(data.BytesOfData, pv, sizeof(pv)) == 0);
+    CHECK(cache.Read(unique_id, 2, &data) == EN_Bool::FALSE8);
+
+    // The same key again updates the entry
+    cache.Store(&frame);
+    CHECK(cache.GetNumEntries() == 1);
+    CHECK(cache.Read(unique_id, 1, &data) == EN_Bool::TRUE8);
+    CHECK(data.SequenceNumber == 2);
+
+    // An extended command is filed under its 16 bit number,
+    // without the number in the data
+    CHECK(MakeBurst(&frame, 1, 31, 0, 0, ext, sizeof(ext)) == EN_Bool::TRUE8);
+    cache.Store(&frame);
+    CHECK(cache.Read(unique_id, 31, &data) == EN_Bool::FALSE8);
+    CHECK(cache.Read(unique_id, 1000, &data) == EN_Bool::TRUE8);
+    CHECK(data.Command == 1000);
+    CHECK(data.DataLen == 3);
+    CHECK(memcmp(data.BytesOfData, &ext[2], 3) == 0);
+
+    // Command 31 without a number stays command 31
+    CHECK(MakeBurst(&frame, 1, 31, 0, 0, ext, 1) == EN_Bool::TRUE8);
+    cache.Store(&frame);
+    CHECK(cache.Read(unique_id, 31, &data) == EN_Bool::TRUE8);
+    CHECK(data.DataLen == 1);
+    CHECK(cache.GetNumEntries() == 3);
+
+    // A payload size beyond the buffers is cut to what they hold
+    for (TY_Word e = 0; e < sizeof(payload); e++)
+    {
+        payload[e] = (TY_Byte)e;
+    }
+
+    CHECK(MakeBurst(&frame, 1, 3, 0, 0, payload, sizeof(payload)) == EN_Bool::TRUE8);
+    frame.PayloadSize = MAX_CYCLIC_DATA_SIZE + 10;
+    cache.Store(&frame);
+    CHECK(cache.Read(unique_id, 3, &data) == EN_Bool::TRUE8);
+    CHECK(data.DataLen == ((MAX_PAYLOAD_SIZE < MAX_CYCLIC_DATA_SIZE) ? MAX_PAYLOAD_SIZE : MAX_CYCLIC_DATA_SIZE));
+    CHECK(memcmp(data.BytesOfData, payload, data.DataLen) == 0);
+    CHECK(cache.GetNumEntries() == 4);
+
+    // Fill the table with other devices, one burst too many is dropped
+    for (TY_Byte e = 2; cache.GetNumEntries() < MAX_NUM_CYCLIC_BUFFERS; e++)
+    {
+        CHECK(MakeBurst(&frame, e, 1, 0, 0, pv, sizeof(pv)) == EN_Bool::TRUE8);
+        cache.Store(&frame);
+    }
+
+    CHECK(cache.GetNumDropped() == 0);
+    MakeUniqueID(unique_id, 200);
+    CHECK(MakeBurst(&frame, 200, 1, 0, 0, pv, sizeof(pv)) == EN_Bool::TRUE8);
+    cache.Store(&frame);
+    CHECK(cache.GetNumEntries() == MAX_NUM_CYCLIC_BUFFERS);
+    CHECK(cache.GetNumDropped() == 1);
+    CHECK(cache.Read(unique_id, 1, &data) == EN_Bool::FALSE8);
+
+    // The known ones are still updated
+    MakeUniqueID(unique_id, 1);
+    CHECK(MakeBurst(&frame, 1, 1, 0, 0, pv, sizeof(pv)) == EN_Bool::TRUE8);
+    cache.Store(&frame);
+    CHECK(cache.GetNumDropped() == 1);
+    CHECK(cache.Read(unique_id, 1, &data) == EN_Bool::TRUE8);
+    CHECK(data.SequenceNumber == 3);
+    CHECK(cache.FetchEntry(0, &data) == EN_Bool::TRUE8);
+    CHECK(data.Command == 1);
+    CHECK(cache.FetchEntry(MAX_NUM_CYCLIC_BUFFERS, &data) == EN_Bool::FALSE8);
+
+    // A reset clears the table and the count of the dropped bursts
+    cache.Reset();
+    CHECK(cache.GetNumEntries() == 0);
+    CHECK(cache.GetNumDropped() == 0);
+    CHECK(cache.Read(unique_id, 1, &data) == EN_Bool::FALSE8);
+    cache.Store(&frame);
+    CHECK(cache.Read(unique_id, 1, &data) == EN_Bool::TRUE8);
+    CHECK(data.SequenceNumber == 1);
+    return 0;
+}
+
+int TestBurstCacheNotify()
+{
+    static CBurstCache cache;
+
+    TY_Byte     unique_id[5];
+    TY_Byte     other_id[5];
+    ST_Notified any = { 0 };
+    ST_Notified band = { 0 };
+    ST_Notified exact = { 0 };
+    ST_Notified other = { 0 };
+    WRD_Handle  h_band;
+
+    MakeUniqueID(unique_id, 1);
+    MakeUniqueID(other_id, 2);
+    CHECK(cache.Subscribe(unique_id, 1, CBurstCache::NO_VALUE, 0, Notified, &any) != INVALID_WRD_HANDLE);
+    h_band = cache.Subscribe(unique_id, 1, 1, -1.0f, Notified, &band);
+    CHECK(h_band != INVALID_WRD_HANDLE);
+    CHECK(cache.Subscribe(unique_id, 1, 1, 0, Notified, &exact) != INVALID_WRD_HANDLE);
+    CHECK(cache.Subscribe(other_id, 1, CBurstCache::NO_VALUE, 0, Notified, &other) != INVALID_WRD_HANDLE);
+
+    // The first burst is notified to all of the device
+    StorePV(&cache, 32, 10.0f, 0, 0);
+    CHECK((any.Count == 1) && (band.Count == 1) && (exact.Count == 1) && (other.Count == 0));
+    CHECK(band.Data.Command == 1);
+    CHECK(band.Data.SequenceNumber == 1);
+    CHECK(CCoding::PickFloat(1, band.Data.BytesOfData, EN_Endian::MSB_First) == 10.0f);
+
+    // Nothing changed
+    StorePV(&cache, 32, 10.0f, 0, 0);
+    CHECK((any.Count == 1) && (band.Count == 1) && (exact.Count == 1));
+
+    // Below the deadband (the negative one counts as positive),
+    // which is measured from the last notified value
+    StorePV(&cache, 32, 10.5f, 0, 0);
+    CHECK((any.Count == 2) && (band.Count == 1) && (exact.Count == 2));
+    StorePV(&cache, 32, 11.0f, 0, 0);
+    CHECK((any.Count == 3) && (band.Count == 2) && (exact.Count == 3));
+    CHECK(band.Data.SequenceNumber == 4);
+    StorePV(&cache, 32, 10.2f, 0, 0);
+    CHECK((any.Count == 4) && (band.Count == 2) && (exact.Count == 4));
+
+    // Other octets than the value count without a value only
+    StorePV(&cache, 33, 10.2f, 0, 0);
+    CHECK((any.Count == 5) && (band.Count == 2) && (exact.Count == 4));
+
+    // Changed response codes are notified always
+    StorePV(&cache, 33, 10.2f, 0, 0x40);
+    CHECK((any.Count == 6) && (band.Count == 3) && (exact.Count == 5));
+    StorePV(&cache, 33, 10.2f, 8, 0x40);
+    CHECK((any.Count == 7) && (band.Count == 4) && (exact.Count == 6));
+    CHECK(band.Data.RespCode1 == 8);
+
+    // The value gets lost and comes back
+    StorePV(&cache, 33, NAN, 8, 0x40);
+    CHECK((any.Count == 8) && (band.Count == 5) && (exact.Count == 7));
+    StorePV(&cache, 33, NAN, 8, 0x40);
+    CHECK((any.Count == 8) && (band.Count == 5) && (exact.Count == 7));
+    StorePV(&cache, 33, 10.2f, 8, 0x40);
+    CHECK((any.Count == 9) && (band.Count == 6) && (exact.Count == 8));
+
+    // Not notified once the subscription ended
+    cache.Unsubscribe(h_band);
+    StorePV(&cache, 33, 20.0f, 8, 0x40);
+    CHECK((any.Count == 10) && (band.Count == 6) && (exact.Count == 9) && (other.Count == 0));
+    return 0;
+}
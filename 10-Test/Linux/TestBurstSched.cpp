@@ -0,0 +1,162 @@
+/*
+ *          File: TestBurstSched.cpp
+ *                Tests of the burst scheduling of the uart layer 2. The
+ *                burst frames are made up with their start and end times,
+ *                no channel is required.
+ *
+ *        Author: Walter Borst
+ *
+ *        E-Mail: info@borst-automation.de
+ *          Home: https://www.borst-automation.de
+ *
+ * No Warranties: https://www.borst-automation.com/legal/warranty-disclaimer
+ *
+ * Copyright 2006-2025 Walter Borst, Cuxhaven, Germany
+ */
+
+#include "OSAL.h"
+#include "WbHartUser.h"
+#include "HartConsts.h"
+#include "HartFrame.h"
+#include "HMuartBurstSched.h"
+#include "Test.h"
+
+// Length of the requests, the transaction time is learned
+static const TY_Word TX_LEN = 20;
+
+// Helpers
+static void Burst(CHMuartBurstSched* sched_, TY_Byte device_, TY_DWord start_, TY_DWord duration_)
+{
+    TY_Byte unique_id[5] = { 0x26, 0xa0, 0x00, 0x00, device_ };
+    CFrame  frame;
+
+    frame.Init();
+    frame.Type = CFrame::EN_Type::BURST;
+    frame.AddrMode = CHart::CAddrMode::UNIQUE;
+    frame.SetUniqueAddr(unique_id);
+    frame.SetStartTime(start_);
+    frame.SetEndTime(start_ + duration_);
+    sched_->Learn(&frame);
+}
+
+// Test cases
+int TestBurstSchedLearn()
+{
+    CHMuartBurstSched sched;
+
+    // Transactions of 100 ms, the guard in front of a burst
+    // is 5 ms and 1/16 of the period
+    sched.LearnTransaction(100);
+
+    // The period is not known after the first burst
+    Burst(&sched, 1, 1000, 50);
+    CHECK(sched.GetWaitTime(1950, TX_LEN, 1200) == 0);
+
+    // Next burst at 3000 .. 3050
+    Burst(&sched, 1, 2000, 50);
+    CHECK(sched.GetWaitTime(2500, TX_LEN, 1200) == 0);
+    CHECK(sched.GetWaitTime(2900, TX_LEN, 1200) == 150);
+    // Overdue, the burst didn't come
+    CHECK(sched.GetWaitTime(3060, TX_LEN, 1200) == 0);
+
+    // Missed bursts count as a multiple of the period
+    Burst(&sched, 1, 5000, 50);
+    CHECK(sched.GetWaitTime(5900, TX_LEN, 1200) == 150);
+
+    // A delayed burst moves the period by a quarter of the
+    // deviation: 1000 + 40 / 4, the next one at 7050
+    Burst(&sched, 1, 6040, 50);
+    CHECK(sched.GetWaitTime(7000, TX_LEN, 1200) == 100);
+
+    // A single misfit keeps the period, the next one at 8550
+    Burst(&sched, 1, 7540, 50);
+    CHECK(sched.GetWaitTime(8500, TX_LEN, 1200) == 100);
+
+    // The second misfit in a row, the period is learned
+    // again from the next burst: 1500
+    Burst(&sched, 1, 9040, 50);
+    CHECK(sched.GetWaitTime(10000, TX_LEN, 1200) == 100);
+    Burst(&sched, 1, 10540, 50);
+    CHECK(sched.GetWaitTime(11500, TX_LEN, 1200) == 0);
+    CHECK(sched.GetWaitTime(11990, TX_LEN, 1200) == 100);
+
+    // A longer transaction time (100 + (200 - 100) / 4)
+    // brings the burst into the way earlier
+    CHECK(sched.GetWaitTime(11832, TX_LEN, 1200) == 0);
+    sched.LearnTransaction(200);
+    CHECK(sched.GetWaitTime(11832, TX_LEN, 1200) == 258);
+
+    // Nothing learned, a response as long as the request
+    sched.Init();
+    Burst(&sched, 1, 1000, 50);
+    Burst(&sched, 1, 2000, 50);
+    CHECK(sched.GetWaitTime(2500, TX_LEN, 1200) == 0);
+    CHECK(sched.GetWaitTime(2600, TX_LEN, 1200) == 450);
+    return 0;
+}
+
+int TestBurstSchedReplace()
+{
+    CHMuartBurstSched sched;
+
+    sched.LearnTransaction(20);
+
+    // A period of 1000, device 7 is a bit faster (920)
+    // and the first one of the second round
+    for (TY_Byte e = 0; e < MAX_NUM_BURST_DEVICES; e++)
+    {
+        Burst(&sched, e, e * 10, 5);
+    }
+
+    Burst(&sched, 7, 990, 5);
+    for (TY_Byte e = 0; e < MAX_NUM_BURST_DEVICES; e++)
+    {
+        if (e != 7)
+        {
+            Burst(&sched, e, 1000 + e * 10, 5);
+        }
+    }
+
+    // Device 7 is due at 1910
+    CHECK(sched.GetWaitTime(1880, TX_LEN, 1200) == 35);
+
+    // One device too many, the one which was silent
+    // for the longest time is forgotten
+    Burst(&sched, MAX_NUM_BURST_DEVICES, 1200, 5);
+    CHECK(sched.GetWaitTime(1880, TX_LEN, 1200) == 0);
+
+    // The others are still known, devices 0 .. 4 are
+    // in the way, the last one ends at 2045
+    CHECK(sched.GetWaitTime(1960, TX_LEN, 1200) == 85);
+
+    // Device 7 comes back, it has to be learned again
+    Burst(&sched, 7, 1910, 5);
+    CHECK(sched.GetWaitTime(2780, TX_LEN, 1200) == 0);
+    Burst(&sched, 7, 2830, 5);
+    CHECK(sched.GetWaitTime(3700, TX_LEN, 1200) == 55);
+    return 0;
+}
+
+int TestBurstSchedDefer()
+{
+    CHMuartBurstSched sched;
+
+    sched.LearnTransaction(100);
+    Burst(&sched, 1, 1000, 50);
+    Burst(&sched, 1, 2000, 50);
+
+    // Enough time before the burst at 3000
+    CHECK(sched.DeferRequest(2500, TX_LEN, 1200) == 0);
+
+    // The request waits for the burst at 3000, but not for the
+    // one at 4000 after it, neither if that burst didn't come
+    CHECK(sched.DeferRequest(2900, TX_LEN, 1200) == 150);
+    Burst(&sched, 1, 3000, 50);
+    CHECK(sched.DeferRequest(3950, TX_LEN, 1200) == 0);
+    CHECK(sched.GetWaitTime(3950, TX_LEN, 1200) == 100);
+
+    // The next request may wait again
+    sched.ReleaseRequest();
+    CHECK(sched.DeferRequest(3950, TX_LEN, 1200) == 100);
+    return 0;
+}
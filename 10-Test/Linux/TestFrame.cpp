@@ -0,0 +1,239 @@
+/*
+ *          File: TestFrame.cpp
+ *                Tests of the frame parser. The block parser of
+ *                CFrame::TryParse has to give the same result as the
+ *                state machine, which is fed byte by byte. The check
+ *                byte of CCoding is compared with a plain loop.
+ *
+ *        Author: Walter Borst
+ *
+ *        E-Mail: info@borst-automation.de
+ *          Home: https://www.borst-automation.de
+ *
+ * No Warranties: https://www.borst-automation.com/legal/warranty-disclaimer
+ *
+ * Copyright 2006-2025 Walter Borst, Cuxhaven, Germany
+ */
+
+#include <string.h>
+#include "OSAL.h"
+#include "WbHartUser.h"
+#include "HartConsts.h"
+#include "HartCoding.h"
+#include "HartFrame.h"
+#include "Test.h"
+
+// Helpers
+static TY_DWord s_seed = 1;
+
+static TY_Byte Random(TY_Word range_)
+{
+    // Reproducible sequence, the failing case can be debugged
+    s_seed = s_seed * 1103515245 + 12345;
+    return (TY_Byte)((s_seed >> 16) % range_);
+}
+
+static void AddJunk(TY_Byte* data_, TY_Word* len_, TY_Byte num_bytes_)
+{
+    for (TY_Byte e = 0; e < num_bytes_; e++)
+    {
+        data_[(*len_)++] = (Random(4) == 0) ? 0xff : Random(256);
+    }
+}
+
+static TY_Word MakeFrame(TY_Byte* data_)
+{
+    static const TY_Byte delimiters[] =
+    {
+        CHart::CDelimiter::STX, CHart::CDelimiter::ACK, CHart::CDelimiter::BACK
+    };
+
+    TY_Word len = 0;
+    TY_Word num_preambles;
+    TY_Word start;
+    TY_Byte delimiter = delimiters[Random(3)];
+    TY_Byte payload_size = Random(30);
+    TY_Byte byte_count;
+    TY_Byte chk = 0;
+
+    AddJunk(data_, &len, Random(4));
+    switch (Random(8))
+    {
+    case 0:
+        // More preambles than a frame may have
+        num_preambles = CHart::CLimit::MAX_NUM_PREAMBLES + 1 + Random(4);
+        break;
+    case 1:
+        // A single preamble and a delimiter are junk
+        data_[len++] = 0xff;
+        data_[len++] = delimiter;
+        num_preambles = 2 + Random(4);
+        break;
+    default:
+        num_preambles = 2 + Random(8);
+        break;
+    }
+
+    for (TY_Word e = 0; e < num_preambles; e++)
+    {
+        data_[len++] = 0xff;
+    }
+
+    if (Random(2) == 0)
+    {
+        delimiter |= 0x80;
+    }
+
+    if (Random(8) == 0)
+    {
+        delimiter |= (TY_Byte)(Random(4) << 5);
+    }
+
+    start = len;
+    data_[len++] = delimiter;
+    AddJunk(data_, &len, (TY_Byte)(((delimiter & 0x80) != 0) ? 5 : 1));
+    AddJunk(data_, &len, (TY_Byte)((delimiter & CHart::CMask::NUM_EXP_BYTES) >> 5));
+    data_[len++] = Random(256);
+
+    byte_count = payload_size;
+    if ((delimiter & CHart::CMask::DELIMITER) != CHart::CDelimiter::STX)
+    {
+        byte_count = (TY_Byte)(payload_size + 2);
+    }
+
+    switch (Random(16))
+    {
+    case 0:
+        // The payload is there, but does not fit into the frame
+        byte_count = (TY_Byte)(MAX_PAYLOAD_SIZE + 3 + Random(8));
+        payload_size = byte_count;
+        if ((delimiter & CHart::CMask::DELIMITER) != CHart::CDelimiter::STX)
+        {
+            payload_size = (TY_Byte)(byte_count - 2);
+        }
+        break;
+    case 1:
+        // No room for the response code of a response
+        byte_count = Random(2);
+        payload_size = 0;
+        break;
+    default:
+        break;
+    }
+
+    data_[len++] = byte_count;
+    if ((delimiter & CHart::CMask::DELIMITER) != CHart::CDelimiter::STX)
+    {
+        AddJunk(data_, &len, 2);
+    }
+
+    AddJunk(data_, &len, payload_size);
+    for (TY_Word e = start; e < len; e++)
+    {
+        chk ^= data_[e];
+    }
+
+    data_[len++] = (Random(8) == 0) ? (TY_Byte)(chk ^ 0x10) : chk;
+    AddJunk(data_, &len, Random(4));
+    if (Random(8) == 0)
+    {
+        // Cut off somewhere
+        len = Random(len);
+    }
+
+    return len;
+}
+
+// Test cases
+int TestFrameBlockParser()
+{
+    TY_Byte data[256];
+    TY_Byte errors[256];
+    TY_Byte block_id[5];
+    TY_Byte stream_id[5];
+
+    memset(errors, 0, sizeof(errors));
+    for (int e = 0; e < 100000; e++)
+    {
+        CFrame  block;
+        CFrame  stream;
+        TY_Word len = MakeFrame(data);
+        TY_Word block_parsed = 0;
+        TY_Word stream_parsed = len;
+        EN_Bool block_done;
+        EN_Bool stream_done = EN_Bool::FALSE8;
+
+        block.Init();
+        stream.Init();
+        block_done = block.TryParse(&block_parsed, data, errors, len, EN_Bool::FALSE8);
+        for (TY_Word b = 0; b < len; b++)
+        {
+            stream_done = stream.ParseByte(data[b], 0, EN_Bool::FALSE8);
+            if (stream_done == EN_Bool::TRUE8)
+            {
+                stream_parsed = (TY_Word)(b + 1);
+                break;
+            }
+        }
+
+        CHECK(block_done == stream_done);
+        CHECK(block_parsed == stream_parsed);
+        CHECK(block.GetStatus() == stream.GetStatus());
+        if ((block.GetStatus() != CFrame::EN_Status::FRAME_COMPLETED) &&
+            (block.GetStatus() != CFrame::EN_Status::CHECKSUM_ERR))
+        {
+            continue;
+        }
+
+        CHECK(block.Type == stream.Type);
+        CHECK(block.Command == stream.Command);
+        CHECK(block.AddrMode == stream.AddrMode);
+        CHECK(block.NumPreambles == stream.NumPreambles);
+        CHECK(block.PayloadSize == stream.PayloadSize);
+        CHECK(memcmp(block.PayloadData, stream.PayloadData, block.PayloadSize) == 0);
+        CHECK(block.GetRspCode1() == stream.GetRspCode1());
+        CHECK(block.GetRspCode2() == stream.GetRspCode2());
+        CHECK(block.GetRemoteMaster() == stream.GetRemoteMaster());
+        CHECK(block.IsBurstModeDevice() == stream.IsBurstModeDevice());
+        block.GetUniqueID(block_id);
+        stream.GetUniqueID(stream_id);
+        if (block.AddrMode == CHart::CAddrMode::UNIQUE)
+        {
+            CHECK(memcmp(block_id, stream_id, 5) == 0);
+        }
+        else
+        {
+            CHECK(block.GetShortAddr() == stream.GetShortAddr());
+        }
+    }
+
+    return 0;
+}
+
+int TestCheckSum()
+{
+    TY_Byte data[300 + 8];
+
+    for (TY_Word e = 0; e < sizeof(data); e++)
+    {
+        data[e] = Random(256);
+    }
+
+    // All lengths from all alignments of the start
+    for (TY_Word offset = 0; offset < 8; offset++)
+    {
+        for (TY_Word len = 0; len <= 300; len++)
+        {
+            TY_Byte chk = 0;
+
+            for (TY_Word e = 0; e < len; e++)
+            {
+                chk ^= data[offset + e];
+            }
+
+            CHECK(CCoding::CheckSum(&data[offset], len) == chk);
+        }
+    }
+
+    return 0;
+}
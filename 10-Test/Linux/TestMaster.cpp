@@ -0,0 +1,953 @@
+/*
+ *          File: TestMaster.cpp
+ *                Tests of the master on loopback channels. Each test
+ *                case is run by ctest on its own, the name of the case
+ *                is passed as the argument. Exit code 0: Passed. The
+ *                cases of the single modules are listed here as well.
+ *
+ *        Author: Walter Borst
+ *
+ *        E-Mail: info@borst-automation.de
+ *          Home: https://www.borst-automation.de
+ *
+ * No Warranties: https://www.borst-automation.com/legal/warranty-disclaimer
+ *
+ * Copyright 2006-2025 Walter Borst, Cuxhaven, Germany
+ */
+
+#include <atomic>
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+#include <thread>
+#include "OSAL.h"
+#include "WbHartM_Structures.h"
+#include "HartMasterIface.h"
+#include "HartConsts.h"
+#include "HartCoding.h"
+#include "HartFrame.h"
+#include "HartPreparedRequest.h"
+#include "Monitor.h"
+#include "MonitorCapture.h"
+#include "Test.h"
+
+// Helpers
+static WRD_Handle OpenBurstLoopback(TY_Byte num_devices_, TY_Word burst_period_, TY_Byte burst_command_,
+    EN_Bool model_baudrate_)
+{
+    TY_LoopbackConfig loop_config;
+    WRD_Handle        channel = CHartMaster::CreateChannel();
+
+    if (channel == INVALID_WRD_HANDLE)
+    {
+        return INVALID_WRD_HANDLE;
+    }
+
+    CHartMaster::GetLoopbackConfig(channel, &loop_config);
+    loop_config.NumDevices = num_devices_;
+    loop_config.ModelBaudRate = model_baudrate_;
+    loop_config.TurnaroundTime = 0;
+    loop_config.BurstPeriod = burst_period_;
+    loop_config.BurstCommand = burst_command_;
+    CHartMaster::SetLoopbackConfig(channel, &loop_config);
+    if (CHartMaster::OpenChannel(channel, 1, EN_CommType::LOOPBACK) == EN_Bool::FALSE8)
+    {
+        CHartMaster::DeleteChannel(channel);
+        return INVALID_WRD_HANDLE;
+    }
+
+    return channel;
+}
+
+static WRD_Handle OpenLoopback(TY_Byte num_devices_)
+{
+    return OpenBurstLoopback(num_devices_, 0, 1, EN_Bool::FALSE8);
+}
+
+static EN_Bool Connect(WRD_Handle channel_, TY_Byte address_, TY_Byte* bytes_of_unique_id_)
+{
+    TY_Connection connection;
+
+    CHartMaster::FetchConnection(channel_,
+        CHartMaster::ConnectByAddr(channel_, address_, EN_Wait::WAIT, 2), &connection);
+    if (connection.SrvResultCode != (TY_Byte)EN_SRV_Result::SUCCESSFUL)
+    {
+        return EN_Bool::FALSE8;
+    }
+
+    memcpy(bytes_of_unique_id_, connection.BytesOfUniqueID, 5);
+    return EN_Bool::TRUE8;
+}
+
+static EN_Bool WaitFor(std::atomic<bool>* flag_, TY_DWord timeout_ms_)
+{
+    auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms_);
+
+    while (flag_->load() == false)
+    {
+        if (std::chrono::steady_clock::now() > end)
+        {
+            return EN_Bool::FALSE8;
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    return EN_Bool::TRUE8;
+}
+
+// Close or delete a channel from its own completion handler
+typedef struct st_CloseContext
+{
+    WRD_Handle            Channel;
+    TY_Byte               UniqueID[5];
+    EN_Bool               Delete;
+    EN_SRV_Result         Result;
+    std::atomic<bool>     IsDone;
+} ST_CloseContext;
+
+static void CloseHandler(SRV_Handle service_, void* context_)
+{
+    ST_CloseContext* context = (ST_CloseContext*)context_;
+    TY_Confirmation  confirmation;
+
+    // Takes the interface lock on the kernel thread
+    CHartMaster::FetchConfirmation(context->Channel, service_, &confirmation);
+    context->Result = confirmation.SrvResultCode;
+    if (context->Delete == EN_Bool::TRUE8)
+    {
+        CHartMaster::DeleteChannel(context->Channel);
+    }
+    else
+    {
+        CHartMaster::CloseChannel(context->Channel);
+    }
+
+    context->IsDone.store(true);
+}
+
+static int TestCloseInHandler()
+{
+    ST_CloseContext  context;
+    TY_Confirmation  confirmation;
+    WRD_Handle       other = OpenLoopback(1);
+    TY_Byte          other_id[5];
+    SRV_Handle       service;
+
+    CHECK(other != INVALID_WRD_HANDLE);
+    CHECK(Connect(other, 0, other_id) == EN_Bool::TRUE8);
+
+    // Closed by the handler, then opened again by the application
+    context.Channel = OpenLoopback(1);
+    context.Delete = EN_Bool::FALSE8;
+    context.Result = EN_SRV_Result::EMPTY;
+    context.IsDone.store(false);
+    CHECK(context.Channel != INVALID_WRD_HANDLE);
+    CHECK(Connect(context.Channel, 0, context.UniqueID) == EN_Bool::TRUE8);
+    service = CHartMaster::LaunchCommand(context.Channel, 0, CloseHandler, &context, NULL, 0, context.UniqueID);
+    CHECK(service != INVALID_SRV_HANDLE);
+    CHECK(WaitFor(&context.IsDone, 5000) == EN_Bool::TRUE8);
+    CHECK(context.Result == EN_SRV_Result::SUCCESSFUL);
+    CHECK(CHartMaster::OpenChannel(context.Channel, 1, EN_CommType::LOOPBACK) == EN_Bool::TRUE8);
+    service = CHartMaster::LaunchCommand(context.Channel, 0, EN_Wait::WAIT, NULL, 0, context.UniqueID);
+    CHartMaster::FetchConfirmation(context.Channel, service, &confirmation);
+    CHECK(confirmation.SrvResultCode == EN_SRV_Result::SUCCESSFUL);
+
+    // Deleted by the handler, the handle is gone at once
+    context.Delete = EN_Bool::TRUE8;
+    context.Result = EN_SRV_Result::EMPTY;
+    context.IsDone.store(false);
+    service = CHartMaster::LaunchCommand(context.Channel, 0, CloseHandler, &context, NULL, 0, context.UniqueID);
+    CHECK(service != INVALID_SRV_HANDLE);
+    CHECK(WaitFor(&context.IsDone, 5000) == EN_Bool::TRUE8);
+    CHECK(context.Result == EN_SRV_Result::SUCCESSFUL);
+    CHECK(CHartMaster::GetChannel(context.Channel) == NULL);
+
+    // The kernel keeps on serving the other channel
+    service = CHartMaster::LaunchCommand(other, 0, EN_Wait::WAIT, NULL, 0, other_id);
+    CHartMaster::FetchConfirmation(other, service, &confirmation);
+    CHECK(confirmation.SrvResultCode == EN_SRV_Result::SUCCESSFUL);
+    CHartMaster::CloseChannel(other);
+    CHartMaster::DeleteChannel(other);
+    return 0;
+}
+
+// A channel deleted by a thread which holds the lock more than
+// once, while a handler of the channel waits for the lock
+typedef struct st_LockContext
+{
+    WRD_Handle            Channel;
+    std::atomic<bool>     IsEntered;
+    std::atomic<bool>     IsDone;
+} ST_LockContext;
+
+static void LockHandler(SRV_Handle service_, void* context_)
+{
+    ST_LockContext*  context = (ST_LockContext*)context_;
+    TY_Configuration config;
+
+    context->IsEntered.store(true);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    CHartMaster::GetConfiguration(context->Channel, &config);
+    context->IsDone.store(true);
+}
+
+static int TestNestedLockDelete()
+{
+    ST_LockContext context;
+    TY_Byte        unique_id[5];
+
+    context.Channel = OpenLoopback(1);
+    context.IsEntered.store(false);
+    context.IsDone.store(false);
+    CHECK(context.Channel != INVALID_WRD_HANDLE);
+    CHECK(Connect(context.Channel, 0, unique_id) == EN_Bool::TRUE8);
+    CHECK(CHartMaster::LaunchCommand(context.Channel, 0, LockHandler, &context, NULL, 0, unique_id) != INVALID_SRV_HANDLE);
+    CHECK(WaitFor(&context.IsEntered, 5000) == EN_Bool::TRUE8);
+
+    // The delete waits for the handler, which gets the lock meanwhile
+    COSAL::Lock();
+    COSAL::Lock();
+    CHartMaster::DeleteChannel(context.Channel);
+    COSAL::Unlock();
+    COSAL::Unlock();
+    CHECK(context.IsDone.load() == true);
+    return 0;
+}
+
+// A waiter keeps a deleted channel until it returns, the
+// handle of the deleted channel is not taken by the next one
+typedef struct st_WaitContext
+{
+    WRD_Handle            Channel;
+    SRV_Handle            Service;
+    EN_Bool               Result;
+} ST_WaitContext;
+
+static void WaitForService(ST_WaitContext* context_)
+{
+    context_->Result = CHartMaster::WaitForService(context_->Channel, context_->Service, 10000);
+}
+
+static int TestStaleChannel()
+{
+    TY_Configuration config;
+    ST_WaitContext   context;
+    WRD_Handle       channel = OpenBurstLoopback(1, 0, 1, EN_Bool::TRUE8);
+    WRD_Handle       other;
+    TY_Byte          unique_id[5];
+    TY_Byte          absent_id[5] = { 0x26, 0xa0, 0x00, 0x00, 0x99 };
+    TY_DWord         start;
+
+    CHECK(channel != INVALID_WRD_HANDLE);
+    CHECK(Connect(channel, 0, unique_id) == EN_Bool::TRUE8);
+    CHartMaster::GetConfiguration(channel, &config);
+    config.NumRetries = 10;
+    CHartMaster::SetConfiguration(channel, &config);
+
+    // No device answers, the timeouts take their real time
+    // and the service is pending at the delete
+    context.Channel = channel;
+    context.Service = CHartMaster::LaunchCommand(channel, 0, NULL, NULL, NULL, 0, absent_id);
+    context.Result = EN_Bool::TRUE8;
+    CHECK(context.Service != INVALID_SRV_HANDLE);
+    start = COSAL::CTimer::GetTime();
+    std::thread waiter(WaitForService, &context);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    CHartMaster::DeleteChannel(channel);
+    waiter.join();
+    CHECK(context.Result == EN_Bool::FALSE8);
+    CHECK((COSAL::CTimer::GetTime() - start) < 5000);
+
+    // The slot is used again with another handle
+    other = OpenLoopback(1);
+    CHECK(other != INVALID_WRD_HANDLE);
+    CHECK(other != channel);
+    CHECK(CHartMaster::GetChannel(channel) == NULL);
+    CHECK(CHartMaster::LaunchCommand(channel, 0, NULL, NULL, NULL, 0, unique_id) == INVALID_SRV_HANDLE);
+    CHECK(CHartMaster::OpenChannel(channel, 1, EN_CommType::LOOPBACK) == EN_Bool::FALSE8);
+    CHECK(Connect(other, 0, unique_id) == EN_Bool::TRUE8);
+    CHartMaster::DeleteChannel(channel);
+    CHECK(Connect(other, 0, unique_id) == EN_Bool::TRUE8);
+
+    CHartMaster::CloseChannel(other);
+    CHartMaster::DeleteChannel(other);
+    return 0;
+}
+
+// Data of batch requests at the limits of the payload
+static int TestBatchDataLength()
+{
+    static TY_BatchRequest requests[2];
+    WRD_Handle             channel = OpenLoopback(1);
+    TY_Byte                unique_id[5];
+    WRD_Handle             batch;
+
+    CHECK(channel != INVALID_WRD_HANDLE);
+    CHECK(Connect(channel, 0, unique_id) == EN_Bool::TRUE8);
+    memset(requests, 0, sizeof(requests));
+    for (TY_BatchRequest& request : requests)
+    {
+        memcpy(request.BytesOfUniqueID, unique_id, 5);
+    }
+
+    // An extended command leaves two bytes less for the data
+    requests[0].Command = 3;
+    requests[0].DataLen = MAX_PAYLOAD_SIZE;
+    requests[1].Command = 1000;
+    requests[1].DataLen = MAX_PAYLOAD_SIZE - 2;
+    batch = CHartMaster::LaunchBatch(channel, requests, 2, NULL, NULL);
+    CHECK(batch != INVALID_WRD_HANDLE);
+    CHECK(CHartMaster::WaitForBatch(channel, batch, 5000) == EN_Bool::TRUE8);
+    CHECK(requests[0].Confirmation.SrvResultCode == EN_SRV_Result::SUCCESSFUL);
+    CHECK(requests[1].Confirmation.SrvResultCode == EN_SRV_Result::SUCCESSFUL);
+    CHartMaster::ReleaseBatch(channel, batch);
+
+    requests[1].DataLen = MAX_PAYLOAD_SIZE - 1;
+    CHECK(CHartMaster::LaunchBatch(channel, requests, 2, NULL, NULL) == INVALID_WRD_HANDLE);
+    requests[1].Command = 3;
+    requests[1].DataLen = MAX_PAYLOAD_SIZE + 1;
+    CHECK(CHartMaster::LaunchBatch(channel, requests, 2, NULL, NULL) == INVALID_WRD_HANDLE);
+
+    CHartMaster::CloseChannel(channel);
+    CHartMaster::DeleteChannel(channel);
+    return 0;
+}
+
+// Handles of released batches and prepared requests are stale,
+// even if their slot is in use again
+static int TestStaleBatch()
+{
+    static TY_BatchRequest requests[MAX_NUM_BATCHES + 1];
+    WRD_Handle             channel = OpenLoopback(1);
+    TY_Byte                unique_id[5];
+    WRD_Handle             stale;
+    WRD_Handle             batches[MAX_NUM_BATCHES];
+    WRD_Handle             prepared[MAX_NUM_PREPARED_REQUESTS];
+    TY_Byte                data[1] = { 0 };
+    TY_DWord               start;
+
+    CHECK(channel != INVALID_WRD_HANDLE);
+    CHECK(Connect(channel, 0, unique_id) == EN_Bool::TRUE8);
+    memset(requests, 0, sizeof(requests));
+    for (TY_BatchRequest& request : requests)
+    {
+        memcpy(request.BytesOfUniqueID, unique_id, 5);
+    }
+
+    stale = CHartMaster::LaunchBatch(channel, &requests[MAX_NUM_BATCHES], 1, NULL, NULL);
+    CHECK(CHartMaster::WaitForBatch(channel, stale, 5000) == EN_Bool::TRUE8);
+    CHartMaster::ReleaseBatch(channel, stale);
+    start = COSAL::CTimer::GetTime();
+    // A waiter returns at once, not at the timeout
+    CHECK(CHartMaster::WaitForBatch(channel, stale, 5000) == EN_Bool::FALSE8);
+    CHECK((COSAL::CTimer::GetTime() - start) < 2500);
+
+    // All slots in use, one of them is the one of the stale handle
+    for (TY_Word e = 0; e < MAX_NUM_BATCHES; e++)
+    {
+        batches[e] = CHartMaster::LaunchBatch(channel, &requests[e], 1, NULL, NULL);
+        CHECK(batches[e] != INVALID_WRD_HANDLE);
+        CHECK(batches[e] != stale);
+    }
+
+    for (TY_Word e = 0; e < MAX_NUM_BATCHES; e++)
+    {
+        CHECK(CHartMaster::WaitForBatch(channel, batches[e], 5000) == EN_Bool::TRUE8);
+    }
+
+    CHECK(CHartMaster::IsBatchCompleted(channel, stale) == EN_Bool::FALSE8);
+    CHECK(CHartMaster::WaitForBatch(channel, stale, 5000) == EN_Bool::FALSE8);
+    CHartMaster::ReleaseBatch(channel, stale);
+    CHECK(CHartMaster::LaunchBatch(channel, &requests[MAX_NUM_BATCHES], 1, NULL, NULL) == INVALID_WRD_HANDLE);
+    for (TY_Word e = 0; e < MAX_NUM_BATCHES; e++)
+    {
+        CHECK(CHartMaster::IsBatchCompleted(channel, batches[e]) == EN_Bool::TRUE8);
+        CHartMaster::ReleaseBatch(channel, batches[e]);
+    }
+
+    // The same for the prepared requests
+    stale = CHartMaster::PrepareRequest(channel, 0, data, 1, unique_id);
+    CHECK(stale != INVALID_WRD_HANDLE);
+    CHartMaster::ReleasePrepared(channel, stale);
+    for (TY_Word e = 0; e < MAX_NUM_PREPARED_REQUESTS; e++)
+    {
+        prepared[e] = CHartMaster::PrepareRequest(channel, 0, data, 1, unique_id);
+        CHECK(prepared[e] != INVALID_WRD_HANDLE);
+        CHECK(prepared[e] != stale);
+    }
+
+    CHECK(CHartMaster::UpdatePreparedData(channel, stale, 0, data, 1) == EN_Bool::FALSE8);
+    CHECK(CHartMaster::LaunchPrepared(channel, stale, EN_Wait::WAIT) == INVALID_SRV_HANDLE);
+    CHartMaster::ReleasePrepared(channel, stale);
+    CHECK(CHartMaster::PrepareRequest(channel, 0, data, 1, unique_id) == INVALID_WRD_HANDLE);
+    for (TY_Word e = 0; e < MAX_NUM_PREPARED_REQUESTS; e++)
+    {
+        CHartMaster::ReleasePrepared(channel, prepared[e]);
+    }
+
+    CHartMaster::CloseChannel(channel);
+    CHartMaster::DeleteChannel(channel);
+    return 0;
+}
+
+// Services in flight at the close don't survive a reopen
+static int TestReopenPool()
+{
+    TY_LoopbackConfig loop_config;
+    TY_Confirmation   confirmation;
+    WRD_Handle        channel = OpenLoopback(1);
+    TY_Byte           unique_id[5];
+    SRV_Handle        services[MAX_NUM_SERVICES];
+
+    CHECK(channel != INVALID_WRD_HANDLE);
+    CHECK(Connect(channel, 0, unique_id) == EN_Bool::TRUE8);
+
+    // Slow enough to close while the requests are waiting
+    CHartMaster::CloseChannel(channel);
+    CHartMaster::GetLoopbackConfig(channel, &loop_config);
+    loop_config.ModelBaudRate = EN_Bool::TRUE8;
+    CHartMaster::SetLoopbackConfig(channel, &loop_config);
+    CHECK(CHartMaster::OpenChannel(channel, 1, EN_CommType::LOOPBACK) == EN_Bool::TRUE8);
+    for (SRV_Handle& service : services)
+    {
+        service = CHartMaster::LaunchCommand(channel, 0, EN_Wait::NO_WAIT, NULL, 0, unique_id);
+        CHECK(service != INVALID_SRV_HANDLE);
+    }
+
+    CHartMaster::CloseChannel(channel);
+    loop_config.ModelBaudRate = EN_Bool::FALSE8;
+    CHartMaster::SetLoopbackConfig(channel, &loop_config);
+    CHECK(CHartMaster::OpenChannel(channel, 1, EN_CommType::LOOPBACK) == EN_Bool::TRUE8);
+
+    // The old handles are stale, the whole pool is free again
+    CHECK(CHartMaster::WaitForService(channel, services[MAX_NUM_SERVICES - 1], 0) == EN_Bool::FALSE8);
+    for (SRV_Handle& service : services)
+    {
+        service = CHartMaster::LaunchCommand(channel, 0, EN_Wait::NO_WAIT, NULL, 0, unique_id);
+        CHECK(service != INVALID_SRV_HANDLE);
+    }
+
+    for (SRV_Handle& service : services)
+    {
+        CHECK(CHartMaster::WaitForService(channel, service, 5000) == EN_Bool::TRUE8);
+        CHartMaster::FetchConfirmation(channel, service, &confirmation);
+        CHECK(confirmation.SrvResultCode == EN_SRV_Result::SUCCESSFUL);
+    }
+
+    CHartMaster::CloseChannel(channel);
+    CHartMaster::DeleteChannel(channel);
+    return 0;
+}
+
+// The retries of a request which is not answered are confirmed
+static int TestUsedRetries()
+{
+    TY_Configuration config;
+    TY_Confirmation  confirmation;
+    WRD_Handle       channel = OpenLoopback(1);
+    TY_Byte          unique_id[5];
+    SRV_Handle       service;
+
+    CHECK(channel != INVALID_WRD_HANDLE);
+    CHECK(Connect(channel, 0, unique_id) == EN_Bool::TRUE8);
+    CHartMaster::GetConfiguration(channel, &config);
+    CHECK(config.NumRetries > 0);
+
+    service = CHartMaster::LaunchCommand(channel, 0, EN_Wait::WAIT, NULL, 0, unique_id);
+    CHartMaster::FetchConfirmation(channel, service, &confirmation);
+    CHECK(confirmation.SrvResultCode == EN_SRV_Result::SUCCESSFUL);
+    CHECK(confirmation.UsedRetries == 0);
+
+    // No device has got this ID
+    unique_id[4] ^= 0xff;
+    service = CHartMaster::LaunchCommand(channel, 0, EN_Wait::WAIT, NULL, 0, unique_id);
+    CHartMaster::FetchConfirmation(channel, service, &confirmation);
+    CHECK(confirmation.SrvResultCode == EN_SRV_Result::NO_DEV_RESP);
+    CHECK(confirmation.UsedRetries == config.NumRetries);
+
+    CHartMaster::CloseChannel(channel);
+    CHartMaster::DeleteChannel(channel);
+    return 0;
+}
+
+// A reset by the reader skips the frames which were not read
+static int TestMonitorReset()
+{
+    static CMonitor  monitor;
+    static TY_MonFrame frames[2];
+    TY_Byte          data[3] = { 0x82, 0x00, 0x01 };
+
+    monitor.Init();
+    monitor.StartTransmit(1);
+    monitor.StoreData(data, 3);
+    monitor.EndTransmit(2);
+    monitor.ResetReceive();
+    CHECK(monitor.GetData(frames, 2) == 0);
+
+    monitor.StartTransmit(3);
+    monitor.StoreData(data, 2);
+    monitor.EndTransmit(4);
+    CHECK(monitor.GetData(frames, 2) == 1);
+    CHECK(frames[0].StartTime == 3);
+    CHECK(frames[0].Len == 2);
+    return 0;
+}
+
+// A frame older than the file doesn't rotate it by time
+static int TestCaptureRotation()
+{
+    static CMonitorCapture capture;
+    TY_MonFrame            frame;
+    TY_DWord               now = COSAL::CTimer::GetTime();
+
+    memset(&frame, 0, sizeof(frame));
+    frame.Len = 2;
+    CHECK(capture.Open("/tmp/WbHartTest_capture.pcapng", 0, 1) == EN_Bool::TRUE8);
+    frame.StartTime = now - 100;
+    CHECK(capture.Write(&frame) == EN_Bool::TRUE8);
+    CHECK(capture.GetNumFiles() == 1);
+    frame.StartTime = now + 2000;
+    CHECK(capture.Write(&frame) == EN_Bool::TRUE8);
+    CHECK(capture.GetNumFiles() == 2);
+    capture.Close();
+    remove("/tmp/WbHartTest_capture_00001.pcapng");
+    remove("/tmp/WbHartTest_capture_00002.pcapng");
+    return 0;
+}
+
+// The handle of an ended subscription doesn't end its successor
+static void BurstHandler(WRD_Handle subscription_, TY_BurstData* data_, void* context_)
+{
+}
+
+static int TestStaleSubscription()
+{
+    WRD_Handle channel = OpenLoopback(1);
+    TY_Byte    unique_id[5] = { 0x26, 0x4e, 0x00, 0x00, 0x01 };
+    WRD_Handle stale;
+    WRD_Handle subscription = INVALID_WRD_HANDLE;
+
+    CHECK(channel != INVALID_WRD_HANDLE);
+    stale = CHartMaster::SubscribeBurst(channel, unique_id, 1, CHartMaster::NO_BURST_VALUE, 0, BurstHandler, NULL);
+    CHECK(stale != INVALID_WRD_HANDLE);
+    CHartMaster::UnsubscribeBurst(channel, stale);
+
+    // All entries in use, one of them with the index of the stale handle
+    for (TY_Word e = 0; e < MAX_NUM_BURST_SUBSCRIPTIONS; e++)
+    {
+        subscription = CHartMaster::SubscribeBurst(channel, unique_id, 1, CHartMaster::NO_BURST_VALUE, 0, BurstHandler, NULL);
+        CHECK(subscription != INVALID_WRD_HANDLE);
+        CHECK(subscription != stale);
+    }
+
+    CHartMaster::UnsubscribeBurst(channel, stale);
+    CHECK(CHartMaster::SubscribeBurst(channel, unique_id, 1, CHartMaster::NO_BURST_VALUE, 0, BurstHandler, NULL) == INVALID_WRD_HANDLE);
+    CHartMaster::UnsubscribeBurst(channel, subscription);
+    CHECK(CHartMaster::SubscribeBurst(channel, unique_id, 1, CHartMaster::NO_BURST_VALUE, 0, BurstHandler, NULL) != INVALID_WRD_HANDLE);
+
+    CHartMaster::CloseChannel(channel);
+    CHartMaster::DeleteChannel(channel);
+    return 0;
+}
+
+// Devices are taken offline as configured, or not at all
+static EN_SRV_Result LaunchAndFetch(WRD_Handle channel_, TY_Byte* unique_id_)
+{
+    TY_Confirmation confirmation;
+    SRV_Handle      service = CHartMaster::LaunchCommand(channel_, 1, EN_Wait::WAIT, NULL, 0, unique_id_);
+
+    CHartMaster::FetchConfirmation(channel_, service, &confirmation);
+    return confirmation.SrvResultCode;
+}
+
+static int TestHealthConfig()
+{
+    TY_Configuration config;
+    TY_HealthConfig  health_config;
+    TY_DeviceHealth  health;
+    WRD_Handle       channel = OpenLoopback(1);
+    TY_Byte          unique_id[5];
+
+    CHECK(channel != INVALID_WRD_HANDLE);
+    CHECK(Connect(channel, 0, unique_id) == EN_Bool::TRUE8);
+    CHartMaster::GetConfiguration(channel, &config);
+    config.NumRetries = 0;
+    CHartMaster::SetConfiguration(channel, &config);
+
+    CHartMaster::GetHealthConfig(channel, &health_config);
+    CHECK(health_config.IsAdaptive == EN_Bool::TRUE8);
+    CHECK(health_config.OfflineFailures == 3);
+    health_config.MinBackoff = 2000;
+    health_config.MaxBackoff = 1000;
+    CHECK(CHartMaster::SetHealthConfig(channel, &health_config) == EN_Bool::FALSE8);
+    health_config.OfflineFailures = 1;
+    health_config.MinBackoff = 60000;
+    health_config.MaxBackoff = 60000;
+    CHECK(CHartMaster::SetHealthConfig(channel, &health_config) == EN_Bool::TRUE8);
+
+    // No device has got this ID
+    unique_id[4] ^= 0xff;
+    CHECK(LaunchAndFetch(channel, unique_id) == EN_SRV_Result::NO_DEV_RESP);
+    CHECK(LaunchAndFetch(channel, unique_id) == EN_SRV_Result::DEVICE_OFFLINE);
+
+    health_config.IsAdaptive = EN_Bool::FALSE8;
+    CHECK(CHartMaster::SetHealthConfig(channel, &health_config) == EN_Bool::TRUE8);
+    CHECK(CHartMaster::GetDeviceHealth(channel, unique_id, &health) == EN_Bool::TRUE8);
+    CHECK(health.IsOffline == EN_Bool::FALSE8);
+    CHECK(LaunchAndFetch(channel, unique_id) == EN_SRV_Result::NO_DEV_RESP);
+    CHECK(LaunchAndFetch(channel, unique_id) == EN_SRV_Result::NO_DEV_RESP);
+
+    CHartMaster::CloseChannel(channel);
+    CHartMaster::DeleteChannel(channel);
+    return 0;
+}
+
+// At full speed a transaction doesn't wait for a tick of the kernel
+static int TestFullSpeed()
+{
+    WRD_Handle channel = OpenLoopback(1);
+    TY_Byte    unique_id[5];
+    TY_DWord   num_tick_waits;
+
+    CHECK(channel != INVALID_WRD_HANDLE);
+    CHECK(Connect(channel, 0, unique_id) == EN_Bool::TRUE8);
+
+    num_tick_waits = CHartMaster::GetChannel(channel)->LoopMacPort.GetNumTickWaits();
+    for (int e = 0; e < 100; e++)
+    {
+        CHECK(LaunchAndFetch(channel, unique_id) == EN_SRV_Result::SUCCESSFUL);
+    }
+
+    // Each request was served in the call of the port which picked it up
+    CHECK(CHartMaster::GetChannel(channel)->LoopMacPort.GetNumTickWaits() == num_tick_waits);
+
+    CHartMaster::CloseChannel(channel);
+    CHartMaster::DeleteChannel(channel);
+    return 0;
+}
+
+// The simulated devices burst without a request, requests still pass
+static void CountBursts(WRD_Handle subscription_, TY_BurstData* data_, void* context_)
+{
+    ((std::atomic<int>*)context_)->fetch_add(1);
+}
+
+static int TestBurstDevice()
+{
+    WRD_Handle       channel = OpenBurstLoopback(2, 10, 3, EN_Bool::FALSE8);
+    TY_Byte          unique_id[5];
+    TY_BurstData     data;
+    std::atomic<int> num_notified(0);
+    auto             end = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+
+    CHECK(channel != INVALID_WRD_HANDLE);
+    CHECK(Connect(channel, 1, unique_id) == EN_Bool::TRUE8);
+    CHECK(CHartMaster::SubscribeBurst(channel, unique_id, 3, CHartMaster::NO_BURST_VALUE, 0,
+        CountBursts, &num_notified) != INVALID_WRD_HANDLE);
+
+    // A few periods, with the requests in between
+    do
+    {
+        CHECK(std::chrono::steady_clock::now() < end);
+        CHECK(LaunchAndFetch(channel, unique_id) == EN_SRV_Result::SUCCESSFUL);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    while ((CHartMaster::ReadBurstData(channel, unique_id, 3, &data) == EN_Bool::FALSE8) ||
+        (data.SequenceNumber < 5));
+
+    // Loop current and the four dynamic variables
+    CHECK(data.PollAddress == 0xff);
+    CHECK(memcmp(data.BytesOfUniqueID, unique_id, 5) == 0);
+    CHECK(data.Command == 3);
+    CHECK(data.RespCode1 == CHart::CRespCode::SUCCESS);
+    CHECK(data.DataLen == 24);
+    CHECK(CCoding::PickFloat(5, data.BytesOfData, EN_Endian::MSB_First) == 22.5f);
+
+    // The value doesn't change, the first burst is notified only
+    CHECK(num_notified.load() == 1);
+    CHECK(CHartMaster::GetNumBurstEntries(channel) == 2);
+
+    CHartMaster::CloseChannel(channel);
+    CHartMaster::DeleteChannel(channel);
+    return 0;
+}
+
+// A request gets the bus although no gap between the bursts
+// is large enough for it
+static void SetDone(SRV_Handle service_, void* context_)
+{
+    ((std::atomic<bool>*)context_)->store(true);
+}
+
+static int TestBurstGap()
+{
+    // Bursts of 21 octets (192 ms) every 300 ms at 1200 baud
+    WRD_Handle        channel = OpenBurstLoopback(1, 300, 1, EN_Bool::TRUE8);
+    TY_Byte           unique_id[5] = { 0x26, 0xa0, 0x00, 0x00, 0x01 };
+    TY_BurstData      data;
+    TY_Confirmation   confirmation;
+    SRV_Handle        service;
+    std::atomic<bool> is_done(false);
+    auto              end = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+
+    CHECK(channel != INVALID_WRD_HANDLE);
+
+    // The period is known after the second burst
+    do
+    {
+        CHECK(std::chrono::steady_clock::now() < end);
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    while ((CHartMaster::ReadBurstData(channel, unique_id, 1, &data) == EN_Bool::FALSE8) ||
+        (data.SequenceNumber < 2));
+
+    service = CHartMaster::LaunchCommand(channel, 1, SetDone, &is_done, NULL, 0, unique_id);
+    CHECK(WaitFor(&is_done, 3000) == EN_Bool::TRUE8);
+    CHartMaster::FetchConfirmation(channel, service, &confirmation);
+    CHECK(confirmation.SrvResultCode == EN_SRV_Result::SUCCESSFUL);
+
+    CHartMaster::CloseChannel(channel);
+    CHartMaster::DeleteChannel(channel);
+    return 0;
+}
+
+// The patched frame of a prepared request is the one a
+// service would encode
+static EN_Bool IsEncodedAsFrame(CPreparedRequest* prepared_, TY_Word command_, TY_Byte* data_,
+    TY_Byte data_len_, TY_Byte* unique_id_, TY_Byte num_preambles_, EN_Bool primary_master_)
+{
+    ST_TxBuffer copy;
+    ST_TxBuffer encoded;
+    CFrame      frame;
+    TY_Byte     payload[MAX_PAYLOAD_SIZE];
+    TY_Byte     ext_len = 0;
+
+    if (command_ > 255)
+    {
+        CCoding::PutWord(command_, 0, payload, EN_Endian::MSB_First);
+        ext_len = 2;
+    }
+
+    memcpy(&payload[ext_len], data_, data_len_);
+    frame.AttachTxBuffer(&encoded);
+    frame.Init();
+    frame.Command = (ext_len > 0) ? 31 : (TY_Byte)command_;
+    frame.AddrMode = CHart::CAddrMode::UNIQUE;
+    frame.NumPreambles = num_preambles_;
+    frame.SetUniqueAddr(unique_id_);
+    frame.SetData(payload, (TY_Word)(data_len_ + ext_len));
+    frame.SetLocalMaster(primary_master_);
+    frame.Encode();
+
+    prepared_->CopyTo(&copy, num_preambles_, primary_master_);
+    if ((copy.Len != encoded.Len) || (memcmp(copy.Bytes, encoded.Bytes, copy.Len) != 0))
+    {
+        return EN_Bool::FALSE8;
+    }
+
+    return EN_Bool::TRUE8;
+}
+
+static int TestPreparedRequest()
+{
+    static const TY_Word       commands[] = { 9, 1000 };
+    static const TY_Byte num_preambles[] = { 5, 0, 20, 2 };
+
+    TY_Configuration config;
+    TY_Confirmation  confirmation;
+    CPreparedRequest prepared;
+    WRD_Handle       channel = OpenLoopback(1);
+    WRD_Handle       h_prepared;
+    TY_Byte          unique_id[5];
+    TY_Byte          slots[4] = { 0, 1, 2, 3 };
+    TY_Byte          update[2] = { 246, 247 };
+
+    CHECK(channel != INVALID_WRD_HANDLE);
+    CHECK(Connect(channel, 0, unique_id) == EN_Bool::TRUE8);
+
+    // The checksum is patched by updates and by the master flag
+    for (TY_Word command : commands)
+    {
+        TY_Byte data[4];
+
+        memcpy(data, slots, sizeof(data));
+        CHECK(prepared.Prepare(command, data, sizeof(data), unique_id, CHart::CAddrMode::UNIQUE) == EN_Bool::TRUE8);
+        CHECK(prepared.UpdateData(3, update, 2) == EN_Bool::FALSE8);
+        CHECK(prepared.UpdateData(2, update, 2) == EN_Bool::TRUE8);
+        memcpy(&data[2], update, 2);
+        for (TY_Byte preambles : num_preambles)
+        {
+            CHECK(IsEncodedAsFrame(&prepared, command, data, sizeof(data), unique_id, preambles, EN_Bool::FALSE8) == EN_Bool::TRUE8);
+            CHECK(IsEncodedAsFrame(&prepared, command, data, sizeof(data), unique_id, preambles, EN_Bool::TRUE8) == EN_Bool::TRUE8);
+        }
+
+        CHECK(prepared.UpdateData(0, update, 1) == EN_Bool::TRUE8);
+        data[0] = update[0];
+        CHECK(IsEncodedAsFrame(&prepared, command, data, sizeof(data), unique_id, 5, EN_Bool::FALSE8) == EN_Bool::TRUE8);
+    }
+
+    // The device answers only if the checksum is right
+    h_prepared = CHartMaster::PrepareRequest(channel, 9, slots, sizeof(slots), unique_id);
+    CHECK(h_prepared != INVALID_WRD_HANDLE);
+    CHECK(CHartMaster::UpdatePreparedData(channel, h_prepared, 1, update, 2) == EN_Bool::TRUE8);
+    for (TY_Word e = 0; e < sizeof(num_preambles); e++)
+    {
+        CHartMaster::GetConfiguration(channel, &config);
+        config.MasterType = ((e & 1) != 0) ? EN_Master::PRIMARY : EN_Master::SECONDARY;
+        config.NumPreambles = (num_preambles[e] >= 2) ? num_preambles[e] : 2;
+        CHartMaster::SetConfiguration(channel, &config);
+        CHartMaster::FetchConfirmation(channel,
+            CHartMaster::LaunchPrepared(channel, h_prepared, EN_Wait::WAIT), &confirmation);
+        CHECK(confirmation.SrvResultCode == EN_SRV_Result::SUCCESSFUL);
+        CHECK(confirmation.Cmd == 9);
+        CHECK(confirmation.RespCode1 == CHart::CRespCode::SUCCESS);
+    }
+
+    CHartMaster::ReleasePrepared(channel, h_prepared);
+    CHartMaster::CloseChannel(channel);
+    CHartMaster::DeleteChannel(channel);
+    return 0;
+}
+
+// The kernel serves the priority classes in order, within a class
+// the earliest deadline first and then in the order of the launch.
+// The requests are launched by the handler of the first one, so the
+// kernel takes them all at once.
+typedef struct st_Dispatch
+{
+    EN_Priority    Priority;
+    TY_DWord       Deadline;
+} ST_Dispatch;
+
+static const ST_Dispatch dispatches[] =
+{
+    { EN_Priority::CYCLIC, 0 },
+    { EN_Priority::CYCLIC, 0 },
+    { EN_Priority::CYCLIC, 0 },
+    { EN_Priority::OPERATOR, 0 },
+    { EN_Priority::CYCLIC, 5000 },
+    { EN_Priority::CYCLIC, 3000 },
+    // Missed while the handler sleeps
+    { EN_Priority::CYCLIC, 1 },
+    { EN_Priority::ALARM, 0 },
+    { EN_Priority::BACKGROUND, 3000 }
+};
+
+static const TY_Byte NUM_DISPATCHES = sizeof(dispatches) / sizeof(dispatches[0]);
+
+static WRD_Handle       s_dispatch_channel;
+static TY_Byte          s_dispatch_id[5];
+static SRV_Handle       s_dispatch_handles[NUM_DISPATCHES];
+static TY_Byte          s_dispatch_order[NUM_DISPATCHES];
+static std::atomic<int> s_num_dispatched;
+
+static void Dispatched(SRV_Handle service_, void* context_)
+{
+    TY_Byte idx = (TY_Byte)(size_t)context_;
+
+    s_dispatch_order[s_num_dispatched.load()] = idx;
+    if (idx == 0)
+    {
+        for (TY_Byte e = 1; e < NUM_DISPATCHES; e++)
+        {
+            s_dispatch_handles[e] = CHartMaster::LaunchCommand(s_dispatch_channel, 1,
+                dispatches[e].Priority, dispatches[e].Deadline, Dispatched, (void*)(size_t)e,
+                NULL, 0, s_dispatch_id);
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    s_num_dispatched.fetch_add(1);
+}
+
+static int TestDispatchOrder()
+{
+    static const TY_Byte expected[NUM_DISPATCHES] = { 0, 6, 7, 3, 5, 4, 1, 2, 8 };
+
+    TY_Confirmation confirmation;
+
+    s_dispatch_channel = OpenLoopback(1);
+    CHECK(s_dispatch_channel != INVALID_WRD_HANDLE);
+    CHECK(Connect(s_dispatch_channel, 0, s_dispatch_id) == EN_Bool::TRUE8);
+
+    s_num_dispatched.store(0);
+    s_dispatch_handles[0] = CHartMaster::LaunchCommand(s_dispatch_channel, 1, dispatches[0].Priority,
+        dispatches[0].Deadline, Dispatched, (void*)(size_t)0, NULL, 0, s_dispatch_id);
+    for (int e = 0; (e < 2000) && (s_num_dispatched.load() < NUM_DISPATCHES); e++)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    CHECK(s_num_dispatched.load() == NUM_DISPATCHES);
+    for (TY_Byte e = 0; e < NUM_DISPATCHES; e++)
+    {
+        CHECK(s_dispatch_order[e] == expected[e]);
+        CHartMaster::FetchConfirmation(s_dispatch_channel, s_dispatch_handles[e], &confirmation);
+        if (e == 6)
+        {
+            CHECK(confirmation.SrvResultCode == EN_SRV_Result::DEADLINE_MISSED);
+        }
+        else
+        {
+            CHECK(confirmation.SrvResultCode == EN_SRV_Result::SUCCESSFUL);
+        }
+    }
+
+    CHartMaster::CloseChannel(s_dispatch_channel);
+    CHartMaster::DeleteChannel(s_dispatch_channel);
+    return 0;
+}
+
+typedef struct st_TestCase
+{
+    const char*  Name;
+    int        (*Run)();
+} ST_TestCase;
+
+static const ST_TestCase test_cases[] =
+{
+    { "CloseInHandler", TestCloseInHandler },
+    { "NestedLockDelete", TestNestedLockDelete },
+    { "StaleChannel", TestStaleChannel },
+    { "BatchDataLength", TestBatchDataLength },
+    { "StaleBatch", TestStaleBatch },
+    { "ReopenPool", TestReopenPool },
+    { "UsedRetries", TestUsedRetries },
+    { "MonitorReset", TestMonitorReset },
+    { "CaptureRotation", TestCaptureRotation },
+    { "StaleSubscription", TestStaleSubscription },
+    { "HealthConfig", TestHealthConfig },
+    { "FullSpeed", TestFullSpeed },
+    { "FrameBlockParser", TestFrameBlockParser },
+    { "CheckSum", TestCheckSum },
+    { "PreparedRequest", TestPreparedRequest },
+    { "BurstDevice", TestBurstDevice },
+    { "BurstSchedLearn", TestBurstSchedLearn },
+    { "BurstSchedReplace", TestBurstSchedReplace },
+    { "BurstSchedDefer", TestBurstSchedDefer },
+    { "BurstGap", TestBurstGap },
+    { "BurstCacheStore", TestBurstCacheStore },
+    { "BurstCacheNotify", TestBurstCacheNotify },
+    { "DispatchOrder", TestDispatchOrder },
+};
+
+int main(int argc, char** argv)
+{
+    for (const ST_TestCase& test_case : test_cases)
+    {
+        if ((argc < 2) || (strcmp(argv[1], test_case.Name) == 0))
+        {
+            if (test_case.Run() != 0)
+            {
+                printf("%s: Failed\n", test_case.Name);
+                return 1;
+            }
+
+            printf("%s: Passed\n", test_case.Name);
+        }
+    }
+
+    return 0;
+}